@@ -43,6 +43,8 @@ struct cloud_data_battery {
 	int64_t bat_ts;
 	/** Flag signifying that the data entry is to be encoded. */
 	bool queued : 1;
+	/** Flag signifying that the timestamp has already been converted to UNIX time. */
+	bool ts_unix : 1;
 };
 
 struct cloud_data_gnss_pvt {
@@ -70,6 +72,8 @@ struct cloud_data_gnss {
 
 	/** Flag signifying that the data entry is to be encoded. */
 	bool queued : 1;
+	/** Flag signifying that the timestamp has already been converted to UNIX time. */
+	bool ts_unix : 1;
 };
 
 /** Structure containing boolean variables used to enable/disable inclusion of the corresponding
@@ -117,6 +121,8 @@ struct cloud_data_impact {
 	double magnitude;
 	/** Flag signifying that the data entry is to be published. */
 	bool queued : 1;
+	/** Flag signifying that the timestamp has already been converted to UNIX time. */
+	bool ts_unix : 1;
 };
 
 struct cloud_data_sensors {
@@ -134,6 +140,8 @@ struct cloud_data_sensors {
 	int bsec_air_quality;
 	/** Flag signifying that the data entry is to be encoded. */
 	bool queued : 1;
+	/** Flag signifying that the timestamp has already been converted to UNIX time. */
+	bool ts_unix : 1;
 };
 
 struct cloud_data_modem_static {
@@ -178,6 +186,8 @@ struct cloud_data_modem_dynamic {
 	char mccmnc[7];
 	/** Flag signifying that the data entry is to be encoded. */
 	bool queued : 1;
+	/** Flag signifying that the timestamp has already been converted to UNIX time. */
+	bool ts_unix : 1;
 };
 
 struct cloud_data_ui {
@@ -187,6 +197,8 @@ struct cloud_data_ui {
 	int64_t btn_ts;
 	/** Flag signifying that the data entry is to be encoded. */
 	bool queued : 1;
+	/** Flag signifying that the timestamp has already been converted to UNIX time. */
+	bool ts_unix : 1;
 };
 
 struct cloud_codec_data {
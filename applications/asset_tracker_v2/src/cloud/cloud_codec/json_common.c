@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/kernel.h>
+#include <math.h>
 #include <cJSON.h>
 #include <date_time.h>
 
@@ -153,10 +154,12 @@ int json_common_modem_dynamic_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *modem_obj = cJSON_CreateObject();
@@ -258,10 +261,12 @@ int json_common_sensor_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->env_ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->env_ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *sensor_obj = cJSON_CreateObject();
@@ -336,10 +341,12 @@ int json_common_gnss_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->gnss_ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->gnss_ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *gnss_obj = cJSON_CreateObject();
@@ -423,10 +430,12 @@ int json_common_ui_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->btn_ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->btn_ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *button_obj = cJSON_CreateObject();
@@ -474,10 +483,12 @@ int json_common_impact_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *impact_obj = cJSON_CreateObject();
@@ -967,10 +978,12 @@ int json_common_battery_data_add(cJSON *parent,
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->bat_ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->bat_ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *battery_obj = cJSON_CreateObject();
@@ -1205,7 +1218,7 @@ void json_common_config_get(cJSON *parent, struct cloud_data_cfg *data)
 	}
 }
 
-int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
+static int batch_data_rows_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
 			       size_t buf_count, const char *object_label)
 {
 	int err = 0;
@@ -1318,3 +1331,286 @@ int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type,
 	json_add_obj(parent, object_label, array_obj);
 	return 0;
 }
+
+/* Maximum number of value columns of a compact batch data type. */
+#define COMPACT_COLUMNS_MAX 6
+
+/* Columns of a compact batch data type, in addition to the timestamp column. */
+struct compact_layout {
+	const char *labels[COMPACT_COLUMNS_MAX];
+	double resolutions[COMPACT_COLUMNS_MAX];
+	size_t count;
+};
+
+/* Data types without a layout are encoded with one object per entry. */
+static const struct compact_layout compact_layouts[JSON_COMMON_COUNT] = {
+	[JSON_COMMON_UI] = {
+		.labels = { DATA_VALUE },
+		.resolutions = { JSON_COMMON_COMPACT_RES_INTEGER },
+		.count = 1
+	},
+	[JSON_COMMON_IMPACT] = {
+		.labels = { DATA_VALUE },
+		.resolutions = { JSON_COMMON_COMPACT_RES_IMPACT },
+		.count = 1
+	},
+	[JSON_COMMON_GNSS] = {
+		.labels = { DATA_GNSS_LONGITUDE, DATA_GNSS_LATITUDE, DATA_GNSS_ACCURACY,
+			    DATA_GNSS_ALTITUDE, DATA_GNSS_SPEED, DATA_GNSS_HEADING },
+		.resolutions = { JSON_COMMON_COMPACT_RES_COORDINATE,
+				 JSON_COMMON_COMPACT_RES_COORDINATE,
+				 JSON_COMMON_COMPACT_RES_GNSS, JSON_COMMON_COMPACT_RES_GNSS,
+				 JSON_COMMON_COMPACT_RES_GNSS, JSON_COMMON_COMPACT_RES_GNSS },
+		.count = 6
+	},
+	[JSON_COMMON_SENSOR] = {
+		.labels = { DATA_TEMPERATURE, DATA_HUMIDITY, DATA_PRESSURE, DATA_BSEC_IAQ },
+		.resolutions = { JSON_COMMON_COMPACT_RES_ENVIRONMENTAL,
+				 JSON_COMMON_COMPACT_RES_ENVIRONMENTAL,
+				 JSON_COMMON_COMPACT_RES_PRESSURE, JSON_COMMON_COMPACT_RES_INTEGER },
+		.count = 4
+	},
+	[JSON_COMMON_BATTERY] = {
+		.labels = { DATA_VALUE },
+		.resolutions = { JSON_COMMON_COMPACT_RES_INTEGER },
+		.count = 1
+	},
+};
+
+/* Timestamp and values of a batch entry, in the order of the columns of its layout. */
+struct compact_row {
+	int64_t ts;
+	double values[COMPACT_COLUMNS_MAX];
+};
+
+/* Check that a batch entry is queued and convert its timestamp to UNIX time, unless it has
+ * already been converted. If dequeue is set, the entry is marked as encoded. Returns from the
+ * calling function if the entry is not queued or the conversion fails.
+ */
+#define COMPACT_ENTRY_GET(_data, _ts, _row, _dequeue)					\
+	do {										\
+		int err;								\
+											\
+		if (!(_data)->queued) {							\
+			return -ENODATA;						\
+		}									\
+											\
+		if (!(_data)->ts_unix) {						\
+			err = date_time_uptime_to_unix_time_ms(&(_data)->_ts);		\
+			if (err) {							\
+				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err); \
+				return err;						\
+			}								\
+											\
+			(_data)->ts_unix = true;					\
+		}									\
+											\
+		(_row)->ts = (_data)->_ts;						\
+		(_data)->queued = !(_dequeue);						\
+	} while (0)
+
+static int compact_row_get(enum json_common_buffer_type type, void *buf, size_t index,
+			   struct compact_row *row, bool dequeue)
+{
+	switch (type) {
+	case JSON_COMMON_UI: {
+		struct cloud_data_ui *data = &((struct cloud_data_ui *)buf)[index];
+
+		COMPACT_ENTRY_GET(data, btn_ts, row, dequeue);
+		row->values[0] = data->btn;
+	}
+		break;
+	case JSON_COMMON_IMPACT: {
+		struct cloud_data_impact *data = &((struct cloud_data_impact *)buf)[index];
+
+		COMPACT_ENTRY_GET(data, ts, row, dequeue);
+		row->values[0] = data->magnitude;
+	}
+		break;
+	case JSON_COMMON_GNSS: {
+		struct cloud_data_gnss *data = &((struct cloud_data_gnss *)buf)[index];
+
+		COMPACT_ENTRY_GET(data, gnss_ts, row, dequeue);
+		row->values[0] = data->pvt.longi;
+		row->values[1] = data->pvt.lat;
+		row->values[2] = data->pvt.acc;
+		row->values[3] = data->pvt.alt;
+		row->values[4] = data->pvt.spd;
+		row->values[5] = data->pvt.hdg;
+	}
+		break;
+	case JSON_COMMON_SENSOR: {
+		struct cloud_data_sensors *data = &((struct cloud_data_sensors *)buf)[index];
+
+		COMPACT_ENTRY_GET(data, env_ts, row, dequeue);
+		row->values[0] = data->temperature;
+		row->values[1] = data->humidity;
+		row->values[2] = data->pressure;
+		row->values[3] = data->bsec_air_quality;
+	}
+		break;
+	case JSON_COMMON_BATTERY: {
+		struct cloud_data_battery *data = &((struct cloud_data_battery *)buf)[index];
+
+		COMPACT_ENTRY_GET(data, bat_ts, row, dequeue);
+		row->values[0] = data->bat;
+	}
+		break;
+	default:
+		return -ENODATA;
+	}
+
+	return 0;
+}
+
+/* Get the queued entry that follows the entry with the passed in timestamp and index in
+ * chronological order. Entries with equal timestamps are ordered by their index. The ring buffers
+ * wrap around, so the entries are not stored in chronological order.
+ */
+static int compact_next_row_get(enum json_common_buffer_type type, void *buf, size_t buf_count,
+				bool first, int64_t ts, size_t *index, struct compact_row *row)
+{
+	bool found = false;
+	size_t prev_index = *index;
+	struct compact_row candidate;
+
+	for (size_t i = 0; i < buf_count; i++) {
+		if (compact_row_get(type, buf, i, &candidate, false)) {
+			continue;
+		}
+
+		if (!first &&
+		    ((candidate.ts < ts) || ((candidate.ts == ts) && (i <= prev_index)))) {
+			continue;
+		}
+
+		if (found && (candidate.ts >= row->ts)) {
+			continue;
+		}
+
+		*row = candidate;
+		*index = i;
+		found = true;
+	}
+
+	return found ? 0 : -ENODATA;
+}
+
+int json_common_batch_data_compact_add(cJSON *parent, enum json_common_buffer_type type,
+				       void *buf, size_t buf_count, const char *object_label)
+{
+	int err;
+	size_t index = 0;
+	size_t count = 0;
+	const struct compact_layout *layout;
+	struct compact_row row;
+	cJSON *batch_obj;
+	cJSON *ts_array;
+	cJSON *value_arrays[COMPACT_COLUMNS_MAX];
+	int64_t prev_values[COMPACT_COLUMNS_MAX];
+	int64_t prev_ts = 0;
+
+	if ((unsigned int)type >= JSON_COMMON_COUNT || compact_layouts[type].count == 0) {
+		return batch_data_rows_add(parent, type, buf, buf_count, object_label);
+	}
+
+	if (parent == NULL) {
+		return -ENOMEM;
+	}
+
+	if (object_label == NULL) {
+		LOG_WRN("Missing object label");
+		return -EINVAL;
+	}
+
+	layout = &compact_layouts[type];
+
+	/* Convert all timestamps before the entries are ordered by them. */
+	for (size_t i = 0; i < buf_count; i++) {
+		err = compact_row_get(type, buf, i, &row, false);
+		if (err == -ENODATA) {
+			continue;
+		} else if (err) {
+			return err;
+		}
+
+		count++;
+	}
+
+	if (count == 0) {
+		return -ENODATA;
+	}
+
+	batch_obj = cJSON_CreateObject();
+	ts_array = cJSON_CreateArray();
+
+	if (batch_obj == NULL || ts_array == NULL) {
+		cJSON_Delete(batch_obj);
+		cJSON_Delete(ts_array);
+		return -ENOMEM;
+	}
+
+	json_add_obj(batch_obj, DATA_TIMESTAMP, ts_array);
+
+	for (size_t i = 0; i < layout->count; i++) {
+		value_arrays[i] = cJSON_CreateArray();
+		if (value_arrays[i] == NULL) {
+			err = -ENOMEM;
+			goto exit;
+		}
+
+		json_add_obj(batch_obj, layout->labels[i], value_arrays[i]);
+		prev_values[i] = 0;
+	}
+
+	for (size_t n = 0; n < count; n++) {
+		err = compact_next_row_get(type, buf, buf_count, n == 0, prev_ts, &index, &row);
+		if (err) {
+			goto exit;
+		}
+
+		/* Each value is encoded as the difference to the previous value in the column. */
+		err = json_add_number_to_array(ts_array, row.ts - prev_ts);
+		if (err) {
+			LOG_ERR("Encoding error: %d returned at %s:%d", err, __FILE__, __LINE__);
+			goto exit;
+		}
+
+		prev_ts = row.ts;
+
+		for (size_t i = 0; i < layout->count; i++) {
+			int64_t value = llround(row.values[i] * layout->resolutions[i]);
+
+			err = json_add_number_to_array(value_arrays[i], value - prev_values[i]);
+			if (err) {
+				LOG_ERR("Encoding error: %d returned at %s:%d", err, __FILE__, __LINE__);
+				goto exit;
+			}
+
+			prev_values[i] = value;
+		}
+	}
+
+	json_add_obj(parent, object_label, batch_obj);
+
+	for (size_t i = 0; i < buf_count; i++) {
+		(void)compact_row_get(type, buf, i, &row, true);
+	}
+
+	return 0;
+
+exit:
+	cJSON_Delete(batch_obj);
+	return err;
+}
+
+int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
+			       size_t buf_count, const char *object_label)
+{
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_BATCH_COMPACT)) {
+		return json_common_batch_data_compact_add(parent, type, buf, buf_count,
+							  object_label);
+	}
+
+	return batch_data_rows_add(parent, type, buf, buf_count, object_label);
+}
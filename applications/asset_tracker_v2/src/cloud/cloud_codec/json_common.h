@@ -43,6 +43,22 @@ enum json_common_buffer_type {
 	JSON_COMMON_COUNT
 };
 
+/* Resolution of the columns in compact batch data, see json_common_batch_data_compact_add().
+ * Values are multiplied with the resolution and rounded to integers before they are encoded.
+ */
+/** GNSS longitude and latitude, in microdegrees. */
+#define JSON_COMMON_COMPACT_RES_COORDINATE	1000000
+/** GNSS accuracy, altitude, speed and heading, in tenths. */
+#define JSON_COMMON_COMPACT_RES_GNSS		10
+/** Temperature and humidity, in hundredths. */
+#define JSON_COMMON_COMPACT_RES_ENVIRONMENTAL	100
+/** Atmospheric pressure, in pascal. */
+#define JSON_COMMON_COMPACT_RES_PRESSURE	1000
+/** Impact magnitude, in hundredths of G. */
+#define JSON_COMMON_COMPACT_RES_IMPACT		100
+/** Air quality, button number and battery level are integers. */
+#define JSON_COMMON_COMPACT_RES_INTEGER		1
+
 /** @brief Operation to be carried out with the passed in data. */
 enum json_common_op_code {
 	JSON_COMMON_INVALID,
@@ -295,12 +311,43 @@ void json_common_config_get(cJSON *parent, struct cloud_data_cfg *data);
  * @param[in] buf_count Number of entries in passed in data buffer.
  * @param[in] object_label Name of the array entry that is added to the parent object.
  *
+ * If CONFIG_CLOUD_CODEC_BATCH_COMPACT is enabled, the data is encoded with
+ * json_common_batch_data_compact_add() instead.
+ *
  * @return 0 on success. -ENODATA if the passed in data is not valid. Otherwise a negative error
  *         code is returned.
  */
 int json_common_batch_data_add(cJSON *parent, enum json_common_buffer_type type, void *buf,
 			       size_t buf_count, const char *object_label);
 
+/**
+ * @brief Encode all queued entries in the passed in buffer in a compact, columnar layout and add
+ *        it to the parent object.
+ *
+ * The entries are added as an object that contains one array per field, ordered by timestamp.
+ * The timestamp array has the label DATA_TIMESTAMP. Single values, such as the button number, have
+ * the label DATA_VALUE. Values are converted to integers using the JSON_COMMON_COMPACT_RES_*
+ * resolutions. The first element of each array is an absolute value, the following elements are
+ * the differences to the previous element. For example, two GNSS fixes taken one minute apart
+ * are encoded as:
+ *
+ *   {"ts":[1563968747123,60000],"lng":[10423412,-25],"lat":[63430123,14],...}
+ *
+ * Static and dynamic modem data are encoded with one object per entry, as in
+ * json_common_batch_data_add().
+ *
+ * @param[out] parent Pointer to object that the encoded data is added to.
+ * @param[in] type Type of data passed in to the function.
+ * @param[in] buf Pointer to data buffer that is to be encoded.
+ * @param[in] buf_count Number of entries in passed in data buffer.
+ * @param[in] object_label Name of the entry that is added to the parent object.
+ *
+ * @return 0 on success. -ENODATA if the passed in data is not valid. Otherwise a negative error
+ *         code is returned.
+ */
+int json_common_batch_data_compact_add(cJSON *parent, enum json_common_buffer_type type,
+				       void *buf, size_t buf_count, const char *object_label);
+
 #ifdef __cplusplus
 }
 #endif
@@ -173,11 +173,15 @@ static int add_pvt_data(cJSON *parent, struct cloud_data_gnss *gnss)
 		return -ENOMEM;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&gnss->gnss_ts);
-	if (err) {
-		LOG_WRN("date_time_uptime_to_unix_time_ms, error: %d", err);
-	} else {
+	if (gnss->ts_unix) {
 		gnss_pvt.ts_ms = gnss->gnss_ts;
+	} else {
+		err = date_time_uptime_to_unix_time_ms(&gnss->gnss_ts);
+		if (err) {
+			LOG_WRN("date_time_uptime_to_unix_time_ms, error: %d", err);
+		} else {
+			gnss_pvt.ts_ms = gnss->gnss_ts;
+		}
 	}
 
 	/* Encode the location data into a device message */
@@ -202,10 +206,12 @@ static int modem_dynamic_data_add(struct cloud_data_modem_dynamic *data, cJSON *
 		return -ENODATA;
 	}
 
-	err = date_time_uptime_to_unix_time_ms(&data->ts);
-	if (err) {
-		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-		return err;
+	if (!data->ts_unix) {
+		err = date_time_uptime_to_unix_time_ms(&data->ts);
+		if (err) {
+			LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+			return err;
+		}
 	}
 
 	cJSON *modem_val_obj = cJSON_CreateObject();
@@ -510,10 +516,12 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 				break;
 			}
 
-			err = date_time_uptime_to_unix_time_ms(&data[i].env_ts);
-			if (err) {
-				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-				return -EOVERFLOW;
+			if (!data[i].ts_unix) {
+				err = date_time_uptime_to_unix_time_ms(&data[i].env_ts);
+				if (err) {
+					LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+					return -EOVERFLOW;
+				}
 			}
 
 			len = snprintk(humidity, sizeof(humidity), "%.2f",
@@ -579,10 +587,12 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 				break;
 			}
 
-			err = date_time_uptime_to_unix_time_ms(&data[i].ts);
-			if (err) {
-				LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
-				return -EOVERFLOW;
+			if (!data[i].ts_unix) {
+				err = date_time_uptime_to_unix_time_ms(&data[i].ts);
+				if (err) {
+					LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+					return -EOVERFLOW;
+				}
 			}
 
 			len = snprintk(magnitude, sizeof(magnitude), "%.2f",
@@ -614,7 +624,7 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 			}
 
 			err =  add_data(array, NULL, APP_ID_BUTTON, button,
-					&data[i].btn_ts, data[i].queued, NULL, true);
+					&data[i].btn_ts, data[i].queued, NULL, !data[i].ts_unix);
 			if (err && err != -ENODATA) {
 				return err;
 			}
@@ -670,7 +680,7 @@ static int add_batch_data(cJSON *array, enum batch_data_type type, void *buf, si
 			}
 
 			err = add_data(array, NULL, APP_ID_BATTERY, batt_lvl, &data[i].bat_ts,
-				       data[i].queued, NULL, true);
+				       data[i].queued, NULL, !data[i].ts_unix);
 			if (err && err != -ENODATA) {
 				return err;
 			}
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+#include "data_store.h"
+
+LOG_MODULE_REGISTER(data_store, CONFIG_DATA_STORE_LOG_LEVEL);
+
+/* Identifies sectors written by the data store. Increment the version if the record
+ * layout changes, so that old sectors are not interpreted as records.
+ */
+#define DATA_STORE_MAGIC	0x44535430
+#define DATA_STORE_VERSION	1
+
+/* Acknowledgments are stored as records of this type, without data. */
+#define TYPE_ACK		DATA_STORE_TYPE_RESERVED
+
+/* Largest write block size of the flash that is supported. */
+#define WRITE_BLOCK_SIZE_MAX	16
+
+/* Header written in front of the data of each record. */
+struct record_hdr {
+	uint32_t seq;
+	uint8_t type;
+	uint8_t reserved[3];
+};
+
+static struct flash_sector sectors[CONFIG_DATA_STORE_SECTORS_MAX];
+static uint32_t sector_erases[CONFIG_DATA_STORE_SECTORS_MAX];
+
+static struct fcb fcb;
+
+/* Records are assembled here, so that they can be written in one aligned operation. */
+static uint8_t write_buf[ROUND_UP(sizeof(struct record_hdr) + CONFIG_DATA_STORE_RECORD_SIZE_MAX,
+				  WRITE_BLOCK_SIZE_MAX)];
+
+/* Sequence number of the last record that was appended. */
+static uint32_t last_seq;
+
+/* Sequence number of the last record that was acknowledged or dropped. */
+static uint32_t acked_seq;
+
+/* Incremented each time sectors are erased, invalidating the location of cursors. */
+static uint32_t generation;
+
+static struct data_store_stats stats;
+static bool is_initialized;
+
+static int hdr_read(const struct fcb_entry *loc, struct record_hdr *hdr)
+{
+	if (loc->fe_data_len < sizeof(*hdr)) {
+		return -EBADMSG;
+	}
+
+	return flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(*loc), hdr, sizeof(*hdr));
+}
+
+struct sector_scan {
+	/* Highest sequence number of the records in the sector. */
+	uint32_t max_seq;
+	/* Number of records in the sector that have not been acknowledged. */
+	uint32_t pending;
+};
+
+static int sector_scan_cb(struct fcb_entry_ctx *loc_ctx, void *arg)
+{
+	struct sector_scan *scan = arg;
+	struct record_hdr hdr;
+
+	if (hdr_read(&loc_ctx->loc, &hdr) || (hdr.type == TYPE_ACK)) {
+		return 0;
+	}
+
+	scan->max_seq = MAX(scan->max_seq, hdr.seq);
+
+	if (hdr.seq > acked_seq) {
+		scan->pending++;
+	}
+
+	return 0;
+}
+
+static int oldest_sector_erase(void)
+{
+	int err;
+	size_t idx = fcb.f_oldest - sectors;
+
+	err = fcb_rotate(&fcb);
+	if (err) {
+		LOG_ERR("fcb_rotate, error: %d", err);
+		return err;
+	}
+
+	sector_erases[idx]++;
+	stats.sector_erases++;
+	generation++;
+
+	return 0;
+}
+
+/* Erase sectors that only hold acknowledged records. The active sector is never erased. */
+static int acked_sectors_erase(void)
+{
+	int err;
+	struct sector_scan scan;
+
+	while (fcb.f_oldest != fcb.f_active.fe_sector) {
+		scan = (struct sector_scan){ 0 };
+
+		err = fcb_walk(&fcb, fcb.f_oldest, sector_scan_cb, &scan);
+		if (err) {
+			LOG_ERR("fcb_walk, error: %d", err);
+			return err;
+		}
+
+		if (scan.pending) {
+			break;
+		}
+
+		err = oldest_sector_erase();
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/* Make room by erasing the oldest sector, dropping the records that it holds. */
+static int oldest_sector_drop(void)
+{
+	int err;
+	struct sector_scan scan = { 0 };
+
+	err = fcb_walk(&fcb, fcb.f_oldest, sector_scan_cb, &scan);
+	if (err) {
+		LOG_ERR("fcb_walk, error: %d", err);
+		return err;
+	}
+
+	err = oldest_sector_erase();
+	if (err) {
+		return err;
+	}
+
+	if (scan.pending) {
+		LOG_WRN("Data store full, %d records dropped", scan.pending);
+	}
+
+	/* Dropped records are never read again, treat them as acknowledged. */
+	acked_seq = MAX(acked_seq, scan.max_seq);
+	stats.records_dropped += scan.pending;
+
+	return 0;
+}
+
+static int record_write(uint32_t seq, uint8_t type, const void *data, size_t len)
+{
+	int err;
+	struct fcb_entry loc;
+	struct record_hdr hdr = {
+		.seq = seq,
+		.type = type,
+	};
+	size_t total = sizeof(hdr) + len;
+
+	memcpy(write_buf, &hdr, sizeof(hdr));
+
+	if (len) {
+		memcpy(&write_buf[sizeof(hdr)], data, len);
+	}
+
+	err = fcb_append(&fcb, total, &loc);
+	if (err == -ENOSPC) {
+		err = oldest_sector_drop();
+		if (err) {
+			return err;
+		}
+
+		err = fcb_append(&fcb, total, &loc);
+	}
+
+	if (err) {
+		LOG_ERR("fcb_append, error: %d", err);
+		return err;
+	}
+
+	/* The space reserved by fcb_append() is padded to the write alignment. */
+	memset(&write_buf[total], 0, ROUND_UP(total, fcb.f_align) - total);
+
+	err = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), write_buf,
+			       ROUND_UP(total, fcb.f_align));
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+		return err;
+	}
+
+	err = fcb_append_finish(&fcb, &loc);
+	if (err) {
+		LOG_ERR("fcb_append_finish, error: %d", err);
+		return err;
+	}
+
+	stats.bytes_written += total;
+
+	return 0;
+}
+
+/* Recover the sequence numbers from the records in flash. */
+static int records_scan(void)
+{
+	int err;
+	struct fcb_entry loc = { 0 };
+	struct record_hdr hdr;
+
+	while (fcb_getnext(&fcb, &loc) == 0) {
+		err = hdr_read(&loc, &hdr);
+		if (err) {
+			LOG_WRN("Skipping unreadable record, error: %d", err);
+			continue;
+		}
+
+		if (hdr.type == TYPE_ACK) {
+			acked_seq = MAX(acked_seq, hdr.seq);
+		} else {
+			last_seq = MAX(last_seq, hdr.seq);
+		}
+	}
+
+	/* Keep sequence numbers increasing, also when all records have been erased. */
+	last_seq = MAX(last_seq, acked_seq);
+
+	return 0;
+}
+
+static int sectors_setup(const struct flash_area *fa, uint32_t *sector_cnt)
+{
+	int err;
+	struct flash_pages_info info;
+
+	err = flash_get_page_info_by_offs(flash_area_get_device(fa), fa->fa_off, &info);
+	if (err) {
+		LOG_ERR("flash_get_page_info_by_offs, error: %d", err);
+		return err;
+	}
+
+	*sector_cnt = MIN(fa->fa_size / info.size, ARRAY_SIZE(sectors));
+	if (*sector_cnt < 2) {
+		LOG_ERR("The flash area must have at least two sectors");
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < *sector_cnt; i++) {
+		sectors[i].fs_off = i * info.size;
+		sectors[i].fs_size = info.size;
+	}
+
+	return 0;
+}
+
+int data_store_init(uint8_t area_id)
+{
+	int err;
+	uint32_t sector_cnt;
+	const struct flash_area *fa;
+	const struct flash_parameters *fparam;
+
+	is_initialized = false;
+
+	err = flash_area_open(area_id, &fa);
+	if (err) {
+		LOG_ERR("flash_area_open, error: %d", err);
+		return -ENODEV;
+	}
+
+	err = sectors_setup(fa, &sector_cnt);
+	if (err) {
+		flash_area_close(fa);
+		return err;
+	}
+
+	fparam = flash_get_parameters(flash_area_get_device(fa));
+
+	flash_area_close(fa);
+
+	fcb = (struct fcb) {
+		.f_magic = DATA_STORE_MAGIC,
+		.f_version = DATA_STORE_VERSION,
+		.f_erase_value = fparam->erase_value,
+		.f_sector_cnt = sector_cnt,
+		.f_sectors = sectors,
+	};
+
+	last_seq = 0;
+	acked_seq = 0;
+	generation++;
+	stats = (struct data_store_stats){ 0 };
+	memset(sector_erases, 0, sizeof(sector_erases));
+
+	err = fcb_init(area_id, &fcb);
+	if (err) {
+		LOG_WRN("fcb_init, error: %d, erasing data store", err);
+
+		err = flash_area_open(area_id, &fa);
+		if (err) {
+			return -ENODEV;
+		}
+
+		err = flash_area_erase(fa, 0, sector_cnt * sectors[0].fs_size);
+		flash_area_close(fa);
+		if (err) {
+			LOG_ERR("flash_area_erase, error: %d", err);
+			return err;
+		}
+
+		for (size_t i = 0; i < sector_cnt; i++) {
+			sector_erases[i]++;
+		}
+
+		stats.sector_erases += sector_cnt;
+
+		err = fcb_init(area_id, &fcb);
+		if (err) {
+			LOG_ERR("fcb_init, error: %d", err);
+			return err;
+		}
+	}
+
+	if (fcb.f_align > WRITE_BLOCK_SIZE_MAX) {
+		LOG_ERR("Unsupported write block size: %d", fcb.f_align);
+		return -ENOTSUP;
+	}
+
+	err = records_scan();
+	if (err) {
+		return err;
+	}
+
+	is_initialized = true;
+
+	err = acked_sectors_erase();
+	if (err) {
+		return err;
+	}
+
+	LOG_DBG("Data store initialized, sectors: %d, pending records: %d",
+		sector_cnt, last_seq - acked_seq);
+
+	return 0;
+}
+
+int data_store_append(uint8_t type, const void *data, size_t len)
+{
+	int err;
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	if ((data == NULL) || (type == TYPE_ACK)) {
+		return -EINVAL;
+	}
+
+	if (len > CONFIG_DATA_STORE_RECORD_SIZE_MAX) {
+		return -EMSGSIZE;
+	}
+
+	err = record_write(last_seq + 1, type, data, len);
+	if (err) {
+		return err;
+	}
+
+	last_seq++;
+	stats.records_written++;
+
+	return 0;
+}
+
+void data_store_cursor_init(struct data_store_cursor *cursor)
+{
+	__ASSERT_NO_MSG(cursor != NULL);
+
+	*cursor = (struct data_store_cursor) {
+		.generation = generation - 1,
+	};
+}
+
+int data_store_read(struct data_store_cursor *cursor, struct data_store_record *record,
+		    void *buf, size_t size)
+{
+	int err;
+	struct fcb_entry prev;
+	struct record_hdr hdr;
+
+	__ASSERT_NO_MSG(cursor != NULL);
+	__ASSERT_NO_MSG(record != NULL);
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	/* The location of the cursor may have been erased, restart from the oldest record and
+	 * skip the records that have already been read.
+	 */
+	if (cursor->generation != generation) {
+		cursor->loc = (struct fcb_entry){ 0 };
+		cursor->generation = generation;
+	}
+
+	while (true) {
+		prev = cursor->loc;
+
+		err = fcb_getnext(&fcb, &cursor->loc);
+		if (err) {
+			/* Stay on the last record, new records are read from there. */
+			cursor->loc = prev;
+			return -ENODATA;
+		}
+
+		err = hdr_read(&cursor->loc, &hdr);
+		if (err) {
+			LOG_WRN("Skipping unreadable record, error: %d", err);
+			continue;
+		}
+
+		if ((hdr.type != TYPE_ACK) && (hdr.seq > acked_seq) && (hdr.seq >= cursor->seq)) {
+			break;
+		}
+	}
+
+	cursor->seq = hdr.seq + 1;
+
+	record->seq = hdr.seq;
+	record->type = hdr.type;
+	record->len = cursor->loc.fe_data_len - sizeof(hdr);
+
+	if (record->len > size) {
+		return -ENOMEM;
+	}
+
+	return flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(cursor->loc) + sizeof(hdr), buf,
+			       record->len);
+}
+
+int data_store_ack(uint32_t seq)
+{
+	int err;
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	if (seq > last_seq) {
+		return -EINVAL;
+	}
+
+	if (seq <= acked_seq) {
+		return 0;
+	}
+
+	acked_seq = seq;
+
+	/* Erase first, the acknowledgment must be stored after the records it covers. */
+	err = acked_sectors_erase();
+	if (err) {
+		return err;
+	}
+
+	return record_write(seq, TYPE_ACK, NULL, 0);
+}
+
+int data_store_clear(void)
+{
+	int err;
+
+	if (!is_initialized) {
+		return -EPERM;
+	}
+
+	while (!fcb_is_empty(&fcb)) {
+		err = oldest_sector_erase();
+		if (err) {
+			return err;
+		}
+	}
+
+	acked_seq = last_seq;
+
+	return 0;
+}
+
+void data_store_stats_get(struct data_store_stats *out)
+{
+	__ASSERT_NO_MSG(out != NULL);
+
+	*out = stats;
+	out->records_pending = last_seq - acked_seq;
+	out->sector_erases_max = 0;
+	out->sector_erases_min = UINT32_MAX;
+
+	for (size_t i = 0; i < fcb.f_sector_cnt; i++) {
+		out->sector_erases_max = MAX(out->sector_erases_max, sector_erases[i]);
+		out->sector_erases_min = MIN(out->sector_erases_min, sector_erases[i]);
+	}
+
+	if (out->sector_erases_min == UINT32_MAX) {
+		out->sector_erases_min = 0;
+	}
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef DATA_STORE_H__
+#define DATA_STORE_H__
+
+/**
+ * @brief Persistent store-and-forward queue for sampled data.
+ * @defgroup data_store Data store
+ * @{
+ *
+ * Records are appended to a flash circular buffer (FCB) and are identified by a sequence
+ * number that increases with every record. Records are read back in order using a cursor and
+ * remain in flash until they have been acknowledged by their sequence number. Sectors that
+ * only contain acknowledged records are erased lazily. If the store is full, the oldest
+ * sector is erased and its unacknowledged records are dropped.
+ *
+ * The store is not thread safe, all functions must be called from the same thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/fs/fcb.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Record type reserved for internal use by the store. */
+#define DATA_STORE_TYPE_RESERVED 0xFF
+
+/** @brief Metadata of a record that has been read from the store. */
+struct data_store_record {
+	/** Sequence number of the record, used to acknowledge it. */
+	uint32_t seq;
+	/** User defined type of the record. */
+	uint8_t type;
+	/** Length of the record data. */
+	size_t len;
+};
+
+/** @brief Read position in the store. Must be initialized with data_store_cursor_init(). */
+struct data_store_cursor {
+	/** Location of the last record read. */
+	struct fcb_entry loc;
+	/** Lowest sequence number that has not been read. */
+	uint32_t seq;
+	/** Store generation the location belongs to. */
+	uint32_t generation;
+};
+
+/** @brief Data store statistics, counted since initialization. */
+struct data_store_stats {
+	/** Number of records appended. */
+	uint32_t records_written;
+	/** Number of bytes appended, including record headers. */
+	uint32_t bytes_written;
+	/** Number of records that have not been acknowledged. */
+	uint32_t records_pending;
+	/** Number of unacknowledged records that were dropped because the store was full. */
+	uint32_t records_dropped;
+	/** Number of sector erases. */
+	uint32_t sector_erases;
+	/** Highest number of erases of a single sector. */
+	uint32_t sector_erases_max;
+	/** Lowest number of erases of a single sector. */
+	uint32_t sector_erases_min;
+};
+
+/** @brief Initialize the data store on a flash area.
+ *
+ *  Existing records are recovered, together with the position of the last acknowledgment.
+ *  At most CONFIG_DATA_STORE_SECTORS_MAX sectors of the flash area are used.
+ *
+ *  @param[in] area_id ID of the flash area used by the store.
+ *
+ *  @retval 0 on success.
+ *  @retval -ENODEV if the flash area cannot be opened.
+ *  @retval -EINVAL if the flash area has less than two sectors.
+ *  @retval -ENOTSUP if the write block size of the flash is not supported.
+ *  @return Otherwise a negative error code from the flash or FCB API.
+ */
+int data_store_init(uint8_t area_id);
+
+/** @brief Append a record to the store.
+ *
+ *  If the store is full, the oldest sector is erased to make room for the record.
+ *
+ *  @param[in] type User defined type of the record, must not be DATA_STORE_TYPE_RESERVED.
+ *  @param[in] data Record data.
+ *  @param[in] len Length of the record data.
+ *
+ *  @retval 0 on success.
+ *  @retval -EINVAL if the type is reserved or data is NULL.
+ *  @retval -EMSGSIZE if the record is larger than CONFIG_DATA_STORE_RECORD_SIZE_MAX.
+ *  @retval -EPERM if the store is not initialized.
+ *  @return Otherwise a negative error code from the flash or FCB API.
+ */
+int data_store_append(uint8_t type, const void *data, size_t len);
+
+/** @brief Initialize a cursor to read from the oldest unacknowledged record.
+ *
+ *  @param[out] cursor Cursor to initialize.
+ */
+void data_store_cursor_init(struct data_store_cursor *cursor);
+
+/** @brief Read the next unacknowledged record and advance the cursor.
+ *
+ *  @param[in,out] cursor Read position.
+ *  @param[out] record Metadata of the record that was read.
+ *  @param[out] buf Buffer for the record data.
+ *  @param[in] size Size of the buffer.
+ *
+ *  @retval 0 on success.
+ *  @retval -ENODATA if there are no more records.
+ *  @retval -ENOMEM if the record does not fit in the buffer. The cursor is advanced past it.
+ *  @retval -EPERM if the store is not initialized.
+ *  @return Otherwise a negative error code from the flash API.
+ */
+int data_store_read(struct data_store_cursor *cursor, struct data_store_record *record,
+		    void *buf, size_t size);
+
+/** @brief Acknowledge all records up to and including a sequence number.
+ *
+ *  The acknowledgment is persisted, and sectors that only hold acknowledged records are
+ *  erased.
+ *
+ *  @param[in] seq Sequence number of the last record to acknowledge.
+ *
+ *  @retval 0 on success.
+ *  @retval -EINVAL if no record with the sequence number has been appended.
+ *  @retval -EPERM if the store is not initialized.
+ *  @return Otherwise a negative error code from the flash or FCB API.
+ */
+int data_store_ack(uint32_t seq);
+
+/** @brief Erase all records in the store.
+ *
+ *  @retval 0 on success.
+ *  @retval -EPERM if the store is not initialized.
+ *  @return Otherwise a negative error code from the FCB API.
+ */
+int data_store_clear(void);
+
+/** @brief Get statistics of the store.
+ *
+ *  @param[out] stats Statistics.
+ */
+void data_store_stats_get(struct data_store_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* DATA_STORE_H__ */
@@ -88,6 +88,14 @@ enum cloud_module_event_type {
 	 */
 	CLOUD_EVT_DATA_SEND_QOS,
 
+	/** A batch message has been acknowledged by the cloud service.
+	 *  The event carries the QoS message ID (message_id) of the acknowledged message, as
+	 *  given in DATA_EVT_DATA_SEND_BATCH.
+	 *
+	 *  Only sent if CONFIG_DATA_STORE is enabled.
+	 */
+	CLOUD_EVT_DATA_ACK,
+
 	/** The cloud module has performed all procedures to prepare for
 	 *  a shutdown of the system. The event carries the ID (id) of the module.
 	 */
@@ -123,6 +131,8 @@ struct cloud_module_event {
 		struct cloud_module_data_ack ack;
 		/** Variable that contains the message that should be sent to cloud. */
 		struct qos_data message;
+		/** QoS message ID of an acknowledged batch message. */
+		uint16_t message_id;
 		/** Module ID, used when acknowledging shutdown requests. */
 		uint32_t id;
 		/** Code signifying the cause of error. */
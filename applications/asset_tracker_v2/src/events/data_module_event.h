@@ -128,6 +128,8 @@ enum data_module_event_type {
 struct data_module_data_buffers {
 	char *buf;
 	size_t len;
+	/** QoS message ID to use for the message, or 0 to let the cloud module assign one. */
+	uint16_t message_id;
 	/** Object paths used in lwM2M. NULL terminated. */
 	struct lwm2m_obj_path paths[CONFIG_CLOUD_CODEC_LWM2M_PATH_LIST_ENTRIES_MAX];
 	uint8_t valid_object_paths;
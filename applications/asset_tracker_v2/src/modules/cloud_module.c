@@ -98,6 +98,11 @@ static int connect_retries;
 
 /* Local copy of the device configuration. */
 static struct cloud_data_cfg copy_cfg;
+
+/* ID of the message that is being removed from the QoS library due to an acknowledgment.
+ * Used to tell acknowledged messages apart from messages that are removed for other reasons.
+ */
+static uint32_t acked_message_id;
 const k_tid_t cloud_module_thread;
 
 /* Message IDs that are used with the QoS library. */
@@ -130,6 +135,8 @@ static void connect_check_work_fn(struct k_work *work);
 static void send_config_received(void);
 static void add_qos_message(uint8_t *ptr, size_t len, uint8_t type,
 			    uint32_t flags, bool heap_allocated);
+static void add_qos_message_with_id(uint8_t *ptr, size_t len, uint8_t type,
+				    uint32_t flags, bool heap_allocated, uint16_t id);
 
 /* Convenience functions used in internal state handling. */
 static char *state2str(enum state_type state)
@@ -416,8 +423,12 @@ static void cloud_wrap_event_handler(const struct cloud_wrap_event *const evt)
 	case CLOUD_WRAP_EVT_DATA_ACK: {
 		LOG_DBG("CLOUD_WRAP_EVT_DATA_ACK: %d", evt->message_id);
 
+		acked_message_id = evt->message_id;
+
 		int err = qos_message_remove(evt->message_id);
 
+		acked_message_id = 0;
+
 		if (err == -ENODATA) {
 			LOG_DBG("Message Acknowledgment not in pending QoS list, ID: %d",
 				evt->message_id);
@@ -505,16 +516,16 @@ static void disconnect_cloud(void)
 	k_work_cancel_delayable(&connect_check_work);
 }
 
-/* Convenience function used to add messages to the QoS library. */
-static void add_qos_message(uint8_t *ptr, size_t len, uint8_t type,
-			    uint32_t flags, bool heap_allocated)
+/* Convenience functions used to add messages to the QoS library. */
+static void add_qos_message_with_id(uint8_t *ptr, size_t len, uint8_t type,
+				    uint32_t flags, bool heap_allocated, uint16_t id)
 {
 	int err;
 	struct qos_data message = {
 		.heap_allocated = heap_allocated,
 		.data.buf = ptr,
 		.data.len = len,
-		.id = qos_message_id_get_next(),
+		.id = id,
 		.type = type,
 		.flags = flags
 	};
@@ -528,6 +539,13 @@ static void add_qos_message(uint8_t *ptr, size_t len, uint8_t type,
 	}
 }
 
+static void add_qos_message(uint8_t *ptr, size_t len, uint8_t type,
+			    uint32_t flags, bool heap_allocated)
+{
+	add_qos_message_with_id(ptr, len, type, flags, heap_allocated,
+				qos_message_id_get_next());
+}
+
 static void qos_event_handler(const struct qos_evt *evt)
 {
 	switch (evt->type) {
@@ -559,6 +577,21 @@ static void qos_event_handler(const struct qos_evt *evt)
 	case QOS_EVT_MESSAGE_REMOVED_FROM_LIST:
 		LOG_DBG("QOS_EVT_MESSAGE_REMOVED_FROM_LIST");
 
+		/* Let the data module know that batch data has been delivered, so that it can be
+		 * removed from the data store.
+		 */
+		if (IS_ENABLED(CONFIG_DATA_STORE) && (evt->message.type == BATCH) &&
+		    (evt->message.id == acked_message_id)) {
+			struct cloud_module_event *cloud_module_event = new_cloud_module_event();
+
+			__ASSERT(cloud_module_event, "Not enough heap left to allocate event");
+
+			cloud_module_event->type = CLOUD_EVT_DATA_ACK;
+			cloud_module_event->data.message_id = evt->message.id;
+
+			APP_EVENT_SUBMIT(cloud_module_event);
+		}
+
 		if (evt->message.heap_allocated) {
 			LOG_DBG("Freeing pointer: %p", (void *)evt->message.data.buf);
 			k_free(evt->message.data.buf);
@@ -761,11 +794,14 @@ static void on_sub_state_cloud_connected(struct cloud_msg_data *msg)
 	}
 
 	if (IS_EVENT(msg, data, DATA_EVT_DATA_SEND_BATCH)) {
-		add_qos_message(msg->module.data.data.buffer.buf,
-				msg->module.data.data.buffer.len,
-				BATCH,
-				QOS_FLAG_RELIABILITY_ACK_REQUIRED,
-				true);
+		uint16_t id = msg->module.data.data.buffer.message_id;
+
+		add_qos_message_with_id(msg->module.data.data.buffer.buf,
+					msg->module.data.data.buffer.len,
+					BATCH,
+					QOS_FLAG_RELIABILITY_ACK_REQUIRED,
+					true,
+					id ? id : qos_message_id_get_next());
 	}
 
 	if ((IS_EVENT(msg, data, DATA_EVT_UI_DATA_SEND)) ||
@@ -20,6 +20,11 @@
 #include <net/nrf_cloud_pgps.h>
 #endif
 
+#if defined(CONFIG_DATA_STORE)
+#include <zephyr/storage/flash_map.h>
+#include "data_store.h"
+#endif
+
 #include "cloud/cloud_codec/cloud_codec.h"
 
 #define MODULE data_module
@@ -89,6 +94,59 @@ static int head_ui_buf;
 static int head_impact_buf;
 static int head_bat_buf;
 
+#if defined(CONFIG_DATA_STORE)
+/* Types of the ringbuffer entries that are moved to the data store. */
+enum stored_data_type {
+	STORED_GNSS,
+	STORED_SENSORS,
+	STORED_MODEM_DYNAMIC,
+	STORED_UI,
+	STORED_IMPACT,
+	STORED_BATTERY,
+};
+
+union stored_data {
+	struct cloud_data_gnss gnss;
+	struct cloud_data_sensors sensors;
+	struct cloud_data_modem_dynamic modem_dyn;
+	struct cloud_data_ui ui;
+	struct cloud_data_impact impact;
+	struct cloud_data_battery bat;
+};
+
+BUILD_ASSERT(sizeof(union stored_data) <= CONFIG_DATA_STORE_RECORD_SIZE_MAX,
+	     "CONFIG_DATA_STORE_RECORD_SIZE_MAX is too small");
+
+/* Stored data that is encoded into one batch message. The number of entries of each type is
+ * limited to the size of the respective ringbuffer, the batch encoding is dimensioned for that.
+ */
+static struct {
+	struct cloud_data_gnss gnss[CONFIG_DATA_GNSS_BUFFER_COUNT];
+	struct cloud_data_sensors sensors[CONFIG_DATA_SENSOR_BUFFER_COUNT];
+	struct cloud_data_modem_dynamic modem_dyn[CONFIG_DATA_MODEM_DYNAMIC_BUFFER_COUNT];
+	struct cloud_data_ui ui[CONFIG_DATA_UI_BUFFER_COUNT];
+	struct cloud_data_impact impact[CONFIG_DATA_IMPACT_BUFFER_COUNT];
+	struct cloud_data_battery bat[CONFIG_DATA_BATTERY_BUFFER_COUNT];
+	size_t gnss_count;
+	size_t sensors_count;
+	size_t modem_dyn_count;
+	size_t ui_count;
+	size_t impact_count;
+	size_t bat_count;
+} stored_batch;
+
+/* Position of the next stored entry to be sent. */
+static struct data_store_cursor stored_cursor;
+
+/* Sequence number of the last entry in the batch message awaiting acknowledgment, zero if there
+ * is none. Only one batch message of stored data is in flight at a time.
+ */
+static uint32_t stored_in_flight_seq;
+
+/* QoS message ID of the batch message awaiting acknowledgment. */
+static uint16_t stored_in_flight_id;
+#endif /* CONFIG_DATA_STORE */
+
 static K_SEM_DEFINE(config_load_sem, 0, 1);
 
 /* Default device configuration. */
@@ -460,6 +518,16 @@ static int setup(void)
 		return err;
 	}
 
+#if defined(CONFIG_DATA_STORE)
+	err = data_store_init(FIXED_PARTITION_ID(DATA_STORE));
+	if (err) {
+		LOG_ERR("data_store_init, error: %d", err);
+		return err;
+	}
+
+	data_store_cursor_init(&stored_cursor);
+#endif
+
 	date_time_register_handler(date_time_event_handler);
 	return 0;
 }
@@ -514,14 +582,16 @@ static void config_distribute(enum data_module_event_type type)
 	APP_EVENT_SUBMIT(data_module_event);
 }
 
-static void data_send(enum data_module_event_type event,
-		      struct cloud_codec_data *data)
+static void data_send_with_id(enum data_module_event_type event,
+			      struct cloud_codec_data *data,
+			      uint16_t message_id)
 {
 	struct data_module_event *module_event = new_data_module_event();
 
 	__ASSERT(module_event, "Not enough heap left to allocate event");
 
 	module_event->type = event;
+	module_event->data.buffer.message_id = message_id;
 
 	BUILD_ASSERT((sizeof(data->paths) == sizeof(module_event->data.buffer.paths)),
 			"Size of the object path list does not match");
@@ -542,6 +612,252 @@ static void data_send(enum data_module_event_type event,
 	memset(data, 0, sizeof(struct cloud_codec_data));
 }
 
+static void data_send(enum data_module_event_type event,
+		      struct cloud_codec_data *data)
+{
+	data_send_with_id(event, data, 0);
+}
+
+#if defined(CONFIG_DATA_STORE)
+/* Move the queued entries of a ringbuffer to the data store. Timestamps are converted to UNIX
+ * time first, so that they remain valid after a reboot.
+ */
+#define STORED_DATA_ADD(_type, _buf, _ts)						\
+	for (size_t i = 0; i < ARRAY_SIZE(_buf); i++) {					\
+		__typeof__(_buf[0]) entry = _buf[i];					\
+		int err;								\
+											\
+		if (!entry.queued ||							\
+		    (!entry.ts_unix && date_time_uptime_to_unix_time_ms(&entry._ts))) {	\
+			continue;							\
+		}									\
+											\
+		entry.ts_unix = true;							\
+											\
+		err = data_store_append(_type, &entry, sizeof(entry));			\
+		if (err) {								\
+			LOG_ERR("data_store_append, error: %d", err);			\
+			continue;							\
+		}									\
+											\
+		_buf[i].queued = false;							\
+	}
+
+static void stored_data_add(void)
+{
+	if (!date_time_is_valid()) {
+		/* Keep the data in the ringbuffers until it can be timestamped. */
+		return;
+	}
+
+	STORED_DATA_ADD(STORED_GNSS, gnss_buf, gnss_ts);
+	STORED_DATA_ADD(STORED_SENSORS, sensors_buf, env_ts);
+	STORED_DATA_ADD(STORED_MODEM_DYNAMIC, modem_dyn_buf, ts);
+	STORED_DATA_ADD(STORED_UI, ui_buf, btn_ts);
+	STORED_DATA_ADD(STORED_IMPACT, impact_buf, ts);
+	STORED_DATA_ADD(STORED_BATTERY, bat_buf, bat_ts);
+}
+
+static size_t stored_data_size(uint8_t type)
+{
+	switch (type) {
+	case STORED_GNSS:
+		return sizeof(struct cloud_data_gnss);
+	case STORED_SENSORS:
+		return sizeof(struct cloud_data_sensors);
+	case STORED_MODEM_DYNAMIC:
+		return sizeof(struct cloud_data_modem_dynamic);
+	case STORED_UI:
+		return sizeof(struct cloud_data_ui);
+	case STORED_IMPACT:
+		return sizeof(struct cloud_data_impact);
+	case STORED_BATTERY:
+		return sizeof(struct cloud_data_battery);
+	default:
+		return 0;
+	}
+}
+
+/* Add a stored entry to the batch. Returns false if the batch has no room for the entry. */
+static bool stored_batch_add(uint8_t type, const union stored_data *data)
+{
+	switch (type) {
+	case STORED_GNSS:
+		if (stored_batch.gnss_count == ARRAY_SIZE(stored_batch.gnss)) {
+			return false;
+		}
+
+		stored_batch.gnss[stored_batch.gnss_count++] = data->gnss;
+		break;
+	case STORED_SENSORS:
+		if (stored_batch.sensors_count == ARRAY_SIZE(stored_batch.sensors)) {
+			return false;
+		}
+
+		stored_batch.sensors[stored_batch.sensors_count++] = data->sensors;
+		break;
+	case STORED_MODEM_DYNAMIC:
+		if (stored_batch.modem_dyn_count == ARRAY_SIZE(stored_batch.modem_dyn)) {
+			return false;
+		}
+
+		stored_batch.modem_dyn[stored_batch.modem_dyn_count++] = data->modem_dyn;
+		break;
+	case STORED_UI:
+		if (stored_batch.ui_count == ARRAY_SIZE(stored_batch.ui)) {
+			return false;
+		}
+
+		stored_batch.ui[stored_batch.ui_count++] = data->ui;
+		break;
+	case STORED_IMPACT:
+		if (stored_batch.impact_count == ARRAY_SIZE(stored_batch.impact)) {
+			return false;
+		}
+
+		stored_batch.impact[stored_batch.impact_count++] = data->impact;
+		break;
+	case STORED_BATTERY:
+		if (stored_batch.bat_count == ARRAY_SIZE(stored_batch.bat)) {
+			return false;
+		}
+
+		stored_batch.bat[stored_batch.bat_count++] = data->bat;
+		break;
+	default:
+		break;
+	}
+
+	return true;
+}
+
+/* Send the next batch of stored data, unless a batch is awaiting acknowledgment.
+ * This function allocates buffer on the heap, which needs to be freed after use.
+ */
+static void stored_data_send(void)
+{
+	int err;
+	size_t size = 0;
+	uint32_t last_seq = 0;
+	union stored_data data;
+	struct data_store_record record;
+	struct data_store_cursor prev;
+	struct cloud_codec_data codec = { 0 };
+
+	if (stored_in_flight_seq) {
+		return;
+	}
+
+	memset(&stored_batch, 0, sizeof(stored_batch));
+
+	while (size < CONFIG_DATA_STORE_BATCH_SIZE_MAX) {
+		prev = stored_cursor;
+
+		err = data_store_read(&stored_cursor, &record, &data, sizeof(data));
+		if (err == -ENODATA) {
+			break;
+		} else if (err && (err != -ENOMEM)) {
+			LOG_ERR("data_store_read, error: %d", err);
+			break;
+		}
+
+		/* Entries that cannot be decoded, for instance written by a different firmware
+		 * version, are acknowledged together with the batch.
+		 */
+		if (err || (record.len != stored_data_size(record.type))) {
+			LOG_WRN("Skipping stored entry of type %d, length %zu", record.type,
+				record.len);
+			last_seq = record.seq;
+			continue;
+		}
+
+		if (!stored_batch_add(record.type, &data)) {
+			/* Send the entry with the next batch. */
+			stored_cursor = prev;
+			break;
+		}
+
+		last_seq = record.seq;
+		size += record.len;
+	}
+
+	if (last_seq == 0) {
+		return;
+	}
+
+	err = cloud_codec_encode_batch_data(&codec,
+					    stored_batch.gnss,
+					    stored_batch.sensors,
+					    &modem_stat,
+					    stored_batch.modem_dyn,
+					    stored_batch.ui,
+					    stored_batch.impact,
+					    stored_batch.bat,
+					    ARRAY_SIZE(stored_batch.gnss),
+					    ARRAY_SIZE(stored_batch.sensors),
+					    MODEM_STATIC_ARRAY_SIZE,
+					    ARRAY_SIZE(stored_batch.modem_dyn),
+					    ARRAY_SIZE(stored_batch.ui),
+					    ARRAY_SIZE(stored_batch.impact),
+					    ARRAY_SIZE(stored_batch.bat));
+	switch (err) {
+	case 0:
+		LOG_DBG("Stored data encoded successfully, last sequence number: %d", last_seq);
+		stored_in_flight_seq = last_seq;
+		stored_in_flight_id = qos_message_id_get_next();
+		data_send_with_id(DATA_EVT_DATA_SEND_BATCH, &codec, stored_in_flight_id);
+		break;
+	case -ENODATA:
+		/* Only entries that were skipped, nothing to wait for. */
+		err = data_store_ack(last_seq);
+		if (err) {
+			LOG_ERR("data_store_ack, error: %d", err);
+		}
+		break;
+	case -ENOTSUP:
+		LOG_DBG("Encoding of batch data not supported");
+		break;
+	default:
+		LOG_ERR("Error batch-encoding stored data: %d", err);
+		data_store_cursor_init(&stored_cursor);
+		SEND_ERROR(data, DATA_EVT_ERROR, err);
+		return;
+	}
+}
+
+static void stored_data_ack(uint16_t message_id)
+{
+	int err;
+
+	if ((stored_in_flight_seq == 0) || (message_id != stored_in_flight_id)) {
+		return;
+	}
+
+	err = data_store_ack(stored_in_flight_seq);
+	if (err) {
+		LOG_ERR("data_store_ack, error: %d", err);
+	}
+
+	stored_in_flight_seq = 0;
+	stored_in_flight_id = 0;
+
+	/* Continue with the next batch. */
+	stored_data_send();
+}
+
+/* Batch messages that were not acknowledged may have been lost, start over from the first
+ * unacknowledged entry. This can lead to entries being sent more than once.
+ */
+static void stored_data_resend(void)
+{
+	stored_in_flight_seq = 0;
+	stored_in_flight_id = 0;
+
+	data_store_cursor_init(&stored_cursor);
+	stored_data_send();
+}
+#endif /* CONFIG_DATA_STORE */
+
 /* This function allocates buffer on the heap, which needs to be freed after use. */
 static void data_encode(void)
 {
@@ -633,6 +949,10 @@ static void data_encode(void)
 	}
 
 	if (grant_send(BATCH, &coneval, override)) {
+#if defined(CONFIG_DATA_STORE)
+		stored_data_add();
+		stored_data_send();
+#else
 		err = cloud_codec_encode_batch_data(&codec,
 						    gnss_buf,
 						    sensors_buf,
@@ -664,6 +984,7 @@ static void data_encode(void)
 			SEND_ERROR(data, DATA_EVT_ERROR, err);
 			return;
 		}
+#endif
 	}
 }
 
@@ -1124,8 +1445,19 @@ static void on_cloud_state_disconnected(struct data_msg_data *msg)
 			agps_request_handle(&agps_request_buffer);
 			agps_request_buffered = false;
 		}
+#if defined(CONFIG_DATA_STORE)
+		stored_data_resend();
+#endif
+		return;
+	}
+
+#if defined(CONFIG_DATA_STORE)
+	if (IS_EVENT(msg, data, DATA_EVT_DATA_READY)) {
+		/* Persist the sampled data while waiting for a cloud connection. */
+		stored_data_add();
 		return;
 	}
+#endif
 
 	if (IS_EVENT(msg, cloud, CLOUD_EVT_CONFIG_EMPTY) &&
 	    IS_ENABLED(CONFIG_NRF_CLOUD_MQTT)) {
@@ -1148,6 +1480,13 @@ static void on_cloud_state_connected(struct data_msg_data *msg)
 		return;
 	}
 
+#if defined(CONFIG_DATA_STORE)
+	if (IS_EVENT(msg, cloud, CLOUD_EVT_DATA_ACK)) {
+		stored_data_ack(msg->module.cloud.data.message_id);
+		return;
+	}
+#endif
+
 	if (IS_EVENT(msg, app, APP_EVT_CONFIG_GET)) {
 		config_get();
 		return;
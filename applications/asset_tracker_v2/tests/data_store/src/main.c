@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+
+#include "data_store.h"
+
+#define STORE_AREA_ID FIXED_PARTITION_ID(storage_partition)
+
+/* Number of times the capacity of the store is written in the wear test. */
+#define WEAR_ROUNDS 10
+
+/* Number of records sent and acknowledged at a time in the wear test. */
+#define WEAR_BATCH_RECORDS 20
+
+enum sample_type {
+	SAMPLE_GNSS,
+	SAMPLE_BATTERY,
+};
+
+/* Stand-in for the ringbuffer entries stored by the data module. */
+struct sample {
+	int64_t ts;
+	double value;
+	uint32_t id;
+};
+
+static struct data_store_cursor cursor;
+
+/* The unity_main is not declared in any header file. It is only defined in the generated test
+ * runner because of ncs' unity configuration. It is therefore declared here to avoid a compiler
+ * warning.
+ */
+extern int unity_main(void);
+
+static void store_geometry_get(uint32_t *sector_size, uint32_t *sector_cnt)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+
+	TEST_ASSERT_EQUAL(0, flash_area_open(STORE_AREA_ID, &fa));
+	TEST_ASSERT_EQUAL(0, flash_get_page_info_by_offs(flash_area_get_device(fa), fa->fa_off,
+							 &info));
+
+	*sector_size = info.size;
+	*sector_cnt = MIN(fa->fa_size / info.size, CONFIG_DATA_STORE_SECTORS_MAX);
+
+	flash_area_close(fa);
+}
+
+static void sample_append(uint32_t id)
+{
+	struct sample sample = {
+		.ts = 1680000000000 + id,
+		.value = id * 0.5,
+		.id = id,
+	};
+
+	TEST_ASSERT_EQUAL(0, data_store_append(id % 2 ? SAMPLE_BATTERY : SAMPLE_GNSS, &sample,
+					       sizeof(sample)));
+}
+
+static void sample_read_check(uint32_t id)
+{
+	struct sample sample;
+	struct data_store_record record;
+
+	TEST_ASSERT_EQUAL(0, data_store_read(&cursor, &record, &sample, sizeof(sample)));
+	TEST_ASSERT_EQUAL(id, record.seq);
+	TEST_ASSERT_EQUAL(id, sample.id);
+	TEST_ASSERT_EQUAL(1680000000000 + id, sample.ts);
+	TEST_ASSERT_EQUAL(sizeof(sample), record.len);
+	TEST_ASSERT_EQUAL(id % 2 ? SAMPLE_BATTERY : SAMPLE_GNSS, record.type);
+}
+
+void setUp(void)
+{
+	const struct flash_area *fa;
+
+	/* Start every test on erased flash. */
+	TEST_ASSERT_EQUAL(0, flash_area_open(STORE_AREA_ID, &fa));
+	TEST_ASSERT_EQUAL(0, flash_area_erase(fa, 0, fa->fa_size));
+	flash_area_close(fa);
+
+	TEST_ASSERT_EQUAL(0, data_store_init(STORE_AREA_ID));
+	data_store_cursor_init(&cursor);
+}
+
+void tearDown(void)
+{
+}
+
+/* Sequence numbers start at 1 on an erased store, so the ID of each sample in these tests is the
+ * sequence number of its record.
+ */
+void test_append_read_in_order(void)
+{
+	struct sample sample;
+	struct data_store_record record;
+
+	for (uint32_t id = 1; id <= 10; id++) {
+		sample_append(id);
+	}
+
+	for (uint32_t id = 1; id <= 10; id++) {
+		sample_read_check(id);
+	}
+
+	TEST_ASSERT_EQUAL(-ENODATA, data_store_read(&cursor, &record, &sample, sizeof(sample)));
+
+	/* The cursor continues with records appended after the end was reached. */
+	sample_append(11);
+	sample_read_check(11);
+}
+
+void test_read_small_buffer(void)
+{
+	uint8_t buf[4];
+	struct data_store_record record;
+
+	sample_append(1);
+	sample_append(2);
+
+	/* The record is skipped, so that reading does not get stuck on it. */
+	TEST_ASSERT_EQUAL(-ENOMEM, data_store_read(&cursor, &record, buf, sizeof(buf)));
+	TEST_ASSERT_EQUAL(1, record.seq);
+	sample_read_check(2);
+}
+
+void test_invalid_arguments(void)
+{
+	uint8_t big[CONFIG_DATA_STORE_RECORD_SIZE_MAX + 1] = { 0 };
+
+	TEST_ASSERT_EQUAL(-EINVAL, data_store_append(DATA_STORE_TYPE_RESERVED, big, 1));
+	TEST_ASSERT_EQUAL(-EINVAL, data_store_append(SAMPLE_GNSS, NULL, 1));
+	TEST_ASSERT_EQUAL(-EMSGSIZE, data_store_append(SAMPLE_GNSS, big, sizeof(big)));
+
+	sample_append(1);
+
+	TEST_ASSERT_EQUAL(-EINVAL, data_store_ack(2));
+	TEST_ASSERT_EQUAL(0, data_store_ack(1));
+
+	/* Acknowledging again has no effect. */
+	TEST_ASSERT_EQUAL(0, data_store_ack(1));
+}
+
+void test_ack_skips_records(void)
+{
+	for (uint32_t id = 1; id <= 5; id++) {
+		sample_append(id);
+	}
+
+	sample_read_check(1);
+	sample_read_check(2);
+
+	/* Records acknowledged beyond the cursor position are not read. */
+	TEST_ASSERT_EQUAL(0, data_store_ack(3));
+	sample_read_check(4);
+
+	/* A new cursor starts at the first unacknowledged record. */
+	data_store_cursor_init(&cursor);
+	sample_read_check(4);
+	sample_read_check(5);
+}
+
+void test_recovery_after_reboot(void)
+{
+	struct data_store_stats stats;
+
+	for (uint32_t id = 1; id <= 20; id++) {
+		sample_append(id);
+	}
+
+	TEST_ASSERT_EQUAL(0, data_store_ack(12));
+
+	/* Initialize again, as after a reboot. */
+	TEST_ASSERT_EQUAL(0, data_store_init(STORE_AREA_ID));
+	data_store_cursor_init(&cursor);
+
+	data_store_stats_get(&stats);
+	TEST_ASSERT_EQUAL(8, stats.records_pending);
+
+	sample_read_check(13);
+
+	/* Sequence numbers continue where they left off. */
+	sample_append(21);
+	data_store_stats_get(&stats);
+	TEST_ASSERT_EQUAL(9, stats.records_pending);
+}
+
+void test_full_store_drops_oldest(void)
+{
+	uint32_t id = 0;
+	struct data_store_stats stats;
+
+	do {
+		sample_append(++id);
+		data_store_stats_get(&stats);
+	} while ((stats.records_dropped == 0) && (id < 100000));
+
+	TEST_ASSERT_GREATER_THAN(0, stats.records_dropped);
+	TEST_ASSERT_EQUAL(1, stats.sector_erases);
+	TEST_ASSERT_EQUAL(id - stats.records_dropped, stats.records_pending);
+
+	/* Reading starts with the oldest record that was kept. */
+	sample_read_check(stats.records_dropped + 1);
+}
+
+void test_clear(void)
+{
+	struct sample sample;
+	struct data_store_record record;
+	struct data_store_stats stats;
+
+	for (uint32_t id = 1; id <= 5; id++) {
+		sample_append(id);
+	}
+
+	TEST_ASSERT_EQUAL(0, data_store_clear());
+
+	data_store_stats_get(&stats);
+	TEST_ASSERT_EQUAL(0, stats.records_pending);
+	TEST_ASSERT_EQUAL(-ENODATA, data_store_read(&cursor, &record, &sample, sizeof(sample)));
+
+	sample_append(6);
+	sample_read_check(6);
+}
+
+/* Send the data in batches the way the data module does, while measuring the time spent and the
+ * number of erases of each sector.
+ */
+void test_throughput_and_wear(void)
+{
+	int64_t start;
+	int64_t duration;
+	uint32_t id = 0;
+	uint32_t sector_size;
+	uint32_t sector_cnt;
+	uint32_t bytes_total;
+	struct data_store_stats stats;
+	struct data_store_record record;
+	struct sample sample;
+
+	store_geometry_get(&sector_size, &sector_cnt);
+
+	bytes_total = WEAR_ROUNDS * sector_size * sector_cnt;
+
+	start = k_uptime_get();
+
+	do {
+		for (int i = 0; i < WEAR_BATCH_RECORDS; i++) {
+			sample_append(++id);
+		}
+
+		for (int i = 0; i < WEAR_BATCH_RECORDS; i++) {
+			TEST_ASSERT_EQUAL(0, data_store_read(&cursor, &record, &sample,
+							     sizeof(sample)));
+		}
+
+		TEST_ASSERT_EQUAL(0, data_store_ack(record.seq));
+
+		data_store_stats_get(&stats);
+	} while (stats.bytes_written < bytes_total);
+
+	duration = k_uptime_get() - start;
+
+	printk("Wrote %d records, %d bytes, in %lld ms (%lld bytes/s)\n",
+	       stats.records_written, stats.bytes_written, duration,
+	       duration ? (int64_t)stats.bytes_written * MSEC_PER_SEC / duration : 0);
+	printk("%d sectors of %d bytes, %d erases, %d to %d erases per sector\n",
+	       sector_cnt, sector_size, stats.sector_erases, stats.sector_erases_min,
+	       stats.sector_erases_max);
+
+	TEST_ASSERT_EQUAL(0, stats.records_dropped);
+	TEST_ASSERT_EQUAL(0, stats.records_pending);
+
+	/* The sectors are used in turn, so they wear evenly. */
+	TEST_ASSERT_GREATER_OR_EQUAL(WEAR_ROUNDS - 1, stats.sector_erases_min);
+	TEST_ASSERT_LESS_OR_EQUAL(1, stats.sector_erases_max - stats.sector_erases_min);
+
+	/* Sectors are only erased once they are used up. The bound allows for the FCB entry
+	 * overhead and the acknowledgment records.
+	 */
+	TEST_ASSERT_LESS_OR_EQUAL(3 * stats.bytes_written / sector_size + sector_cnt,
+				  stats.sector_erases);
+}
+
+int main(void)
+{
+	(void)unity_main();
+	return 0;
+}
@@ -392,3 +392,19 @@
 					"}"							\
 				"]"								\
 			"}"
+
+#define TEST_VALIDATE_BATCH_COMPACT_JSON_SCHEMA							\
+			"{"									\
+				"\"bat\":{"							\
+					"\"ts\":[1563968747123,60000],"				\
+					"\"v\":[87,-1]"						\
+				"},"								\
+				"\"btn\":{"							\
+					"\"ts\":[1563968747123],"				\
+					"\"v\":[1]"						\
+				"},"								\
+				"\"impact\":{"							\
+					"\"ts\":[1563968747123],"				\
+					"\"v\":[346]"						\
+				"}"								\
+			"}"
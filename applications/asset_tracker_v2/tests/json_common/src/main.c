@@ -16,6 +16,7 @@
 #include "cloud_codec.h"
 #include "json_protocol_names.h"
 #include "json_validate.h"
+#include "sample_traces.h"
 
 /* Structure used to generate cJSON objects and encoded output string buffers. */
 static struct test_dummy {
@@ -1025,6 +1026,275 @@ void test_encode_batch_data_object(void)
 	TEST_ASSERT_EQUAL(-EINVAL, ret);
 }
 
+/* Compact batch data */
+
+/* Ring buffer position that the sample traces are stored from, so that the entries wrap around. */
+#define TRACE_HEAD 4
+
+/* Copy a sample trace to a buffer in the same way as the data module ring buffers store it. */
+#define TRACE_LOAD(_buf, _trace)								\
+	for (size_t i = 0; i < ARRAY_SIZE(_trace); i++) {					\
+		size_t index = (i + TRACE_HEAD) % ARRAY_SIZE(_buf);				\
+												\
+		_buf[index] = _trace[i];							\
+		_buf[index].queued = true;							\
+		_buf[index].ts_unix = true;							\
+	}
+
+/* Decode a column of compact batch data and compare it with the field of a sample trace. */
+#define COMPACT_COLUMN_CHECK(_batch_obj, _label, _resolution, _trace, _field)			\
+	do {											\
+		double values[ARRAY_SIZE(_trace)];						\
+												\
+		compact_column_decode(_batch_obj, _label, _resolution, values,			\
+				      ARRAY_SIZE(_trace));					\
+												\
+		for (size_t i = 0; i < ARRAY_SIZE(_trace); i++) {				\
+			TEST_ASSERT_DOUBLE_WITHIN(0.5 / (_resolution), _trace[i]._field,	\
+						  values[i]);					\
+		}										\
+	} while (0)
+
+/* Decode a column of compact batch data, in the same way as the cloud side does it. */
+static void compact_column_decode(cJSON *batch_obj, const char *label, double resolution,
+				  double *values, size_t count)
+{
+	size_t i = 0;
+	int64_t value = 0;
+	cJSON *item;
+	cJSON *array = cJSON_GetObjectItem(batch_obj, label);
+
+	TEST_ASSERT_NOT_NULL(array);
+	TEST_ASSERT_EQUAL(count, cJSON_GetArraySize(array));
+
+	cJSON_ArrayForEach(item, array) {
+		value += (int64_t)item->valuedouble;
+		values[i++] = value / resolution;
+	}
+}
+
+/* Encode a single data type in a batch and return the length of the encoded output. */
+static size_t batch_encoded_size_get(enum json_common_buffer_type type, void *buf,
+				     size_t buf_count, const char *label, bool compact)
+{
+	int ret;
+	size_t size;
+	char *buffer;
+	cJSON *obj = cJSON_CreateObject();
+
+	TEST_ASSERT_NOT_NULL(obj);
+
+	if (compact) {
+		ret = json_common_batch_data_compact_add(obj, type, buf, buf_count, label);
+	} else {
+		ret = json_common_batch_data_add(obj, type, buf, buf_count, label);
+	}
+
+	TEST_ASSERT_EQUAL(0, ret);
+
+	buffer = cJSON_PrintUnformatted(obj);
+	TEST_ASSERT_NOT_NULL(buffer);
+
+	size = strlen(buffer);
+
+	cJSON_FreeString(buffer);
+	cJSON_Delete(obj);
+
+	return size;
+}
+
+/* Encode the sample traces in a batch and return the length of the encoded output. Each data
+ * type is encoded separately to limit heap usage.
+ */
+static size_t trace_encoded_size_get(bool compact)
+{
+	size_t size = 0;
+	struct cloud_data_gnss gnss[ARRAY_SIZE(trace_gnss)] = { 0 };
+	struct cloud_data_sensors environmental[ARRAY_SIZE(trace_environmental)] = { 0 };
+	struct cloud_data_battery battery[ARRAY_SIZE(trace_battery)] = { 0 };
+
+	TRACE_LOAD(gnss, trace_gnss);
+	TRACE_LOAD(environmental, trace_environmental);
+	TRACE_LOAD(battery, trace_battery);
+
+	size += batch_encoded_size_get(JSON_COMMON_GNSS, gnss, ARRAY_SIZE(gnss), DATA_GNSS,
+				       compact);
+	size += batch_encoded_size_get(JSON_COMMON_SENSOR, environmental,
+				       ARRAY_SIZE(environmental), DATA_ENVIRONMENTALS, compact);
+	size += batch_encoded_size_get(JSON_COMMON_BATTERY, battery, ARRAY_SIZE(battery),
+				       DATA_BATTERY, compact);
+
+	return size;
+}
+
+void test_encode_batch_data_compact(void)
+{
+	int ret;
+	struct cloud_data_battery battery[2] = {
+		[0].bat = 86,
+		[0].bat_ts = 1563968807123,
+		[0].queued = true,
+		[0].ts_unix = true,
+		/* Second entry, sampled before the first one. */
+		[1].bat = 87,
+		[1].bat_ts = 1563968747123,
+		[1].queued = true,
+		[1].ts_unix = true
+	};
+	struct cloud_data_ui ui[2] = {
+		[0].btn = 1,
+		[0].btn_ts = 1000,
+		[0].queued = true,
+		/* Second entry, already encoded. */
+		[1].btn = 2,
+		[1].btn_ts = 1000,
+		[1].queued = false
+	};
+	struct cloud_data_impact impact[1] = {
+		[0].magnitude = 3.456,
+		[0].ts = 1563968747123,
+		[0].queued = true,
+		[0].ts_unix = true
+	};
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj,
+						 JSON_COMMON_BATTERY,
+						 &battery,
+						 ARRAY_SIZE(battery),
+						 DATA_BATTERY);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj,
+						 JSON_COMMON_UI,
+						 &ui,
+						 ARRAY_SIZE(ui),
+						 DATA_BUTTON);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj,
+						 JSON_COMMON_IMPACT,
+						 &impact,
+						 ARRAY_SIZE(impact),
+						 DATA_IMPACT);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	ret = encoded_output_check(dummy.root_obj, TEST_VALIDATE_BATCH_COMPACT_JSON_SCHEMA, -1);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	TEST_ASSERT_FALSE(battery[0].queued);
+	TEST_ASSERT_FALSE(battery[1].queued);
+	TEST_ASSERT_FALSE(ui[0].queued);
+	TEST_ASSERT_FALSE(impact[0].queued);
+
+	/* Check for invalid inputs. */
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj,
+						 JSON_COMMON_BATTERY,
+						 &battery,
+						 ARRAY_SIZE(battery),
+						 DATA_BATTERY);
+	TEST_ASSERT_EQUAL(-ENODATA, ret);
+
+	ret = json_common_batch_data_compact_add(NULL, JSON_COMMON_BATTERY, &battery, 0, "");
+	TEST_ASSERT_EQUAL(-ENOMEM, ret);
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj, JSON_COMMON_BATTERY, &battery, 0,
+						 NULL);
+	TEST_ASSERT_EQUAL(-EINVAL, ret);
+
+	/* Data types without a compact layout are encoded with one object per entry. */
+	ret = json_common_batch_data_compact_add(NULL, -1, NULL, 0, "");
+	TEST_ASSERT_EQUAL(-ENOMEM, ret);
+}
+
+/* Test used to verify that the sample traces can be decoded from compact batch data, within the
+ * resolution of the format. The entries are stored in ring buffer order and decoded in
+ * chronological order.
+ */
+void test_batch_data_compact_round_trip(void)
+{
+	int ret;
+	cJSON *decoded_obj;
+	cJSON *batch_obj;
+	struct cloud_data_gnss gnss[ARRAY_SIZE(trace_gnss)] = { 0 };
+	struct cloud_data_sensors environmental[ARRAY_SIZE(trace_environmental)] = { 0 };
+	struct cloud_data_battery battery[ARRAY_SIZE(trace_battery)] = { 0 };
+
+	TRACE_LOAD(gnss, trace_gnss);
+	TRACE_LOAD(environmental, trace_environmental);
+	TRACE_LOAD(battery, trace_battery);
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj, JSON_COMMON_GNSS, gnss,
+						 ARRAY_SIZE(gnss), DATA_GNSS);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj, JSON_COMMON_SENSOR, environmental,
+						 ARRAY_SIZE(environmental), DATA_ENVIRONMENTALS);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	ret = json_common_batch_data_compact_add(dummy.root_obj, JSON_COMMON_BATTERY, battery,
+						 ARRAY_SIZE(battery), DATA_BATTERY);
+	TEST_ASSERT_EQUAL(0, ret);
+
+	dummy.buffer = cJSON_PrintUnformatted(dummy.root_obj);
+	TEST_ASSERT_NOT_NULL(dummy.buffer);
+
+	decoded_obj = cJSON_Parse(dummy.buffer);
+	TEST_ASSERT_NOT_NULL(decoded_obj);
+
+	batch_obj = cJSON_GetObjectItem(decoded_obj, DATA_GNSS);
+	TEST_ASSERT_NOT_NULL(batch_obj);
+
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_TIMESTAMP, 1, trace_gnss, gnss_ts);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_GNSS_LONGITUDE, JSON_COMMON_COMPACT_RES_COORDINATE,
+			     trace_gnss, pvt.longi);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_GNSS_LATITUDE, JSON_COMMON_COMPACT_RES_COORDINATE,
+			     trace_gnss, pvt.lat);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_GNSS_ACCURACY, JSON_COMMON_COMPACT_RES_GNSS,
+			     trace_gnss, pvt.acc);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_GNSS_ALTITUDE, JSON_COMMON_COMPACT_RES_GNSS,
+			     trace_gnss, pvt.alt);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_GNSS_SPEED, JSON_COMMON_COMPACT_RES_GNSS,
+			     trace_gnss, pvt.spd);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_GNSS_HEADING, JSON_COMMON_COMPACT_RES_GNSS,
+			     trace_gnss, pvt.hdg);
+
+	batch_obj = cJSON_GetObjectItem(decoded_obj, DATA_ENVIRONMENTALS);
+	TEST_ASSERT_NOT_NULL(batch_obj);
+
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_TIMESTAMP, 1, trace_environmental, env_ts);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_TEMPERATURE, JSON_COMMON_COMPACT_RES_ENVIRONMENTAL,
+			     trace_environmental, temperature);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_HUMIDITY, JSON_COMMON_COMPACT_RES_ENVIRONMENTAL,
+			     trace_environmental, humidity);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_PRESSURE, JSON_COMMON_COMPACT_RES_PRESSURE,
+			     trace_environmental, pressure);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_BSEC_IAQ, JSON_COMMON_COMPACT_RES_INTEGER,
+			     trace_environmental, bsec_air_quality);
+
+	batch_obj = cJSON_GetObjectItem(decoded_obj, DATA_BATTERY);
+	TEST_ASSERT_NOT_NULL(batch_obj);
+
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_TIMESTAMP, 1, trace_battery, bat_ts);
+	COMPACT_COLUMN_CHECK(batch_obj, DATA_VALUE, JSON_COMMON_COMPACT_RES_INTEGER,
+			     trace_battery, bat);
+
+	cJSON_Delete(decoded_obj);
+}
+
+/* Test used to compare the size of the sample traces encoded in the two batch formats. */
+void test_batch_data_compact_size(void)
+{
+	size_t size = trace_encoded_size_get(false);
+	size_t size_compact = trace_encoded_size_get(true);
+
+	printk("Sample traces batch size: %zu bytes, compact: %zu bytes (%zu%%)\n", size,
+	       size_compact, size_compact * 100 / size);
+
+	/* The compact format is expected to be less than half the size. */
+	TEST_ASSERT_LESS_THAN(size / 2, size_compact);
+}
+
 /* Test used to verify encoding and decoding of data structures that contain floating point
  * values. Floating point values cannot be exactly represented in binary so they cannot be compared
  * with a predefined JSON string schema.
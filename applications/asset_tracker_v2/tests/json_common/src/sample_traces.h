@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SAMPLE_TRACES_H__
+#define SAMPLE_TRACES_H__
+
+#include "cloud_codec.h"
+
+/* Data sampled once a minute by a device carried on a walk, in chronological order. The number of
+ * entries matches the default size of the data module ring buffers.
+ */
+
+static const struct cloud_data_gnss trace_gnss[] = {
+	{
+		.gnss_ts = 1563968747671,
+		.pvt.longi = 10.43835393,
+		.pvt.lat = 63.42221289,
+		.pvt.acc = 3.9,
+		.pvt.alt = 45.6,
+		.pvt.spd = 1.18,
+		.pvt.hdg = 61.8
+	},
+	{
+		.gnss_ts = 1563968807211,
+		.pvt.longi = 10.43985868,
+		.pvt.lat = 63.42254159,
+		.pvt.acc = 4.8,
+		.pvt.alt = 46.4,
+		.pvt.spd = 1.39,
+		.pvt.hdg = 64.0
+	},
+	{
+		.gnss_ts = 1563968867969,
+		.pvt.longi = 10.44112469,
+		.pvt.lat = 63.42276546,
+		.pvt.acc = 6.0,
+		.pvt.alt = 45.7,
+		.pvt.spd = 1.13,
+		.pvt.hdg = 68.4
+	},
+	{
+		.gnss_ts = 1563968927186,
+		.pvt.longi = 10.44292415,
+		.pvt.lat = 63.42302608,
+		.pvt.acc = 7.0,
+		.pvt.alt = 46.0,
+		.pvt.spd = 1.57,
+		.pvt.hdg = 72.1
+	},
+	{
+		.gnss_ts = 1563968988002,
+		.pvt.longi = 10.44443838,
+		.pvt.lat = 63.42320497,
+		.pvt.acc = 3.8,
+		.pvt.alt = 46.8,
+		.pvt.spd = 1.30,
+		.pvt.hdg = 75.2
+	},
+	{
+		.gnss_ts = 1563969047696,
+		.pvt.longi = 10.44597317,
+		.pvt.lat = 63.42336941,
+		.pvt.acc = 6.9,
+		.pvt.alt = 47.0,
+		.pvt.spd = 1.31,
+		.pvt.hdg = 76.5
+	},
+	{
+		.gnss_ts = 1563969107504,
+		.pvt.longi = 10.44739409,
+		.pvt.lat = 63.42345463,
+		.pvt.acc = 7.3,
+		.pvt.alt = 47.1,
+		.pvt.spd = 1.19,
+		.pvt.hdg = 82.4
+	},
+	{
+		.gnss_ts = 1563969167631,
+		.pvt.longi = 10.44913830,
+		.pvt.lat = 63.42355612,
+		.pvt.acc = 7.2,
+		.pvt.alt = 47.3,
+		.pvt.spd = 1.46,
+		.pvt.hdg = 82.6
+	},
+	{
+		.gnss_ts = 1563969227587,
+		.pvt.longi = 10.45071556,
+		.pvt.lat = 63.42358049,
+		.pvt.acc = 7.0,
+		.pvt.alt = 47.0,
+		.pvt.spd = 1.31,
+		.pvt.hdg = 88.0
+	},
+	{
+		.gnss_ts = 1563969287206,
+		.pvt.longi = 10.45218533,
+		.pvt.lat = 63.42358226,
+		.pvt.acc = 8.2,
+		.pvt.alt = 46.5,
+		.pvt.spd = 1.22,
+		.pvt.hdg = 89.8
+	},
+};
+
+static const struct cloud_data_sensors trace_environmental[] = {
+	{
+		.env_ts = 1563968748869,
+		.temperature = 21.38,
+		.humidity = 38.23,
+		.pressure = 100.821,
+		.bsec_air_quality = 55
+	},
+	{
+		.env_ts = 1563968808551,
+		.temperature = 21.32,
+		.humidity = 38.51,
+		.pressure = 100.812,
+		.bsec_air_quality = 50
+	},
+	{
+		.env_ts = 1563968868163,
+		.temperature = 21.37,
+		.humidity = 38.30,
+		.pressure = 100.812,
+		.bsec_air_quality = 49
+	},
+	{
+		.env_ts = 1563968928444,
+		.temperature = 21.41,
+		.humidity = 38.35,
+		.pressure = 100.821,
+		.bsec_air_quality = 53
+	},
+	{
+		.env_ts = 1563968988590,
+		.temperature = 21.45,
+		.humidity = 38.40,
+		.pressure = 100.823,
+		.bsec_air_quality = 49
+	},
+	{
+		.env_ts = 1563969048803,
+		.temperature = 21.51,
+		.humidity = 38.67,
+		.pressure = 100.822,
+		.bsec_air_quality = 49
+	},
+	{
+		.env_ts = 1563969108820,
+		.temperature = 21.41,
+		.humidity = 38.79,
+		.pressure = 100.825,
+		.bsec_air_quality = 55
+	},
+	{
+		.env_ts = 1563969168146,
+		.temperature = 21.35,
+		.humidity = 38.72,
+		.pressure = 100.829,
+		.bsec_air_quality = 55
+	},
+	{
+		.env_ts = 1563969228346,
+		.temperature = 21.31,
+		.humidity = 38.79,
+		.pressure = 100.829,
+		.bsec_air_quality = 52
+	},
+	{
+		.env_ts = 1563969289015,
+		.temperature = 21.21,
+		.humidity = 38.64,
+		.pressure = 100.827,
+		.bsec_air_quality = 55
+	},
+};
+
+static const struct cloud_data_battery trace_battery[] = {
+	{ .bat_ts = 1563968749205, .bat = 87 },
+	{ .bat_ts = 1563968809293, .bat = 87 },
+	{ .bat_ts = 1563968869582, .bat = 87 },
+	{ .bat_ts = 1563968929534, .bat = 87 },
+	{ .bat_ts = 1563968989685, .bat = 86 },
+	{ .bat_ts = 1563969049407, .bat = 86 },
+	{ .bat_ts = 1563969110027, .bat = 86 },
+	{ .bat_ts = 1563969169263, .bat = 86 },
+	{ .bat_ts = 1563969229961, .bat = 85 },
+	{ .bat_ts = 1563969289563, .bat = 85 },
+};
+
+#endif /* SAMPLE_TRACES_H__ */
@@ -264,9 +264,14 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * This function is asynchronous. Discovery results are passed through
  * the supplied callback.
  *
- * @note Only one discovery procedure can be started simultaneously. To start
- * another one, wait for the result of the previous procedure to finish
- * and call @ref bt_gatt_dm_data_release if it was successful.
+ * @note Up to @kconfig{CONFIG_BT_GATT_DM_MAX_INSTANCES} discovery procedures
+ * can run simultaneously, but only one per connection. To start another one
+ * on the same connection, wait for the result of the previous procedure to
+ * finish and call @ref bt_gatt_dm_data_release if it was successful.
+ *
+ * @note If @kconfig{CONFIG_BT_GATT_DM_CACHE} is enabled and the peer is
+ * bonded, the service may be restored from the discovery cache instead of
+ * being discovered over the air.
  *
  * @param[in]     conn Connection object.
  * @param[in]     svc_uuid UUID of target service
@@ -284,6 +289,8 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * Call @ref bt_gatt_dm_continue to discover the next service instance.
  *
  * @retval 0 If the operation was successful.
+ * @retval -EALREADY If a discovery is already running on the connection,
+ *                   or all instances are in use.
  *           Otherwise, a (negative) error code is returned.
  */
 int bt_gatt_dm_start(struct bt_conn *conn,
@@ -146,6 +146,11 @@ struct dm_request {
 
 	/** Extra time to extend the ranging window. */
 	uint32_t extra_window_time_us;
+
+	/** Priority of the request. Scheduled requests of lower priority that
+	 *  overlap the request are dropped. The lowest priority is 0.
+	 */
+	uint8_t priority;
 };
 
 /** @brief Initialize the DM.
@@ -112,5 +112,20 @@ int event_manager_proxy_start(void);
  */
 int event_manager_proxy_wait_for_remotes(k_timeout_t timeout);
 
+/**
+ * @brief Send the events waiting in the batch frames.
+ *
+ * The function does not block when the IPC is busy. The frames that could not be sent
+ * are kept and their transmission is retried in the background.
+ *
+ * @note
+ * Call this function only after @ref event_manager_proxy_start.
+ * If @kconfig{CONFIG_EVENT_MANAGER_PROXY_BATCH} is disabled, the function does nothing.
+ *
+ * @retval 0 On success.
+ * @retval other The errno code returned by the IPC service. The frames are sent later.
+ */
+int event_manager_proxy_flush(void);
+
 /** @} */
 #endif /* _EVENT_MANAGER_PROXY_H_ */
@@ -106,6 +106,47 @@ int at_parser_max_params_from_str(const char *at_params_str,
 int at_parser_params_from_str(const char *at_params_str, char **next_param_str,
 			      struct at_param_list *const list);
 
+/**
+ * @brief Parse AT command or response parameters from a string without
+ *        copying them.
+ *
+ * This function parses the parameters from @p at_params_str like
+ * @ref at_parser_params_from_str, but instead of copying string and array
+ * parameters to the heap, it stores their offset and length in
+ * @p at_params_str. The string must remain valid and unchanged as long as
+ * @p list is used. No memory is allocated, and several threads can parse at
+ * the same time with separate lists.
+ *
+ * If an error is returned by the parser, the content of @p list should be
+ * ignored.
+ *
+ * @param at_params_str  AT parameters as a null-terminated string. Can be
+ *                       numeric or string parameters.
+ *
+ * @param next_param_str In the case a string contains multiple notifications,
+ *                       the parser will stop parsing when it is done parsing
+ *                       the first notification, and return the remainder of
+ *                       the string in this pointer. The return code will be
+ *                       EAGAIN. If multinotification is not used, this
+ *                       pointer can be set to NULL.
+ *
+ * @param list           Pointer to an initialized list of parameter views.
+ *                       Must not be NULL.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EAGAIN New notification detected in string re-run the parser
+ *                 with the string pointed to by @p next_param_str.
+ * @retval -E2BIG  The list supplied cannot hold all detected parameters in
+ *                 string. The list will contain the maximum number of
+ *                 parameters possible.
+ * @retval -EOVERFLOW A parameter is located beyond the first 65535
+ *                    characters of the string.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_param_views_from_str(const char *at_params_str,
+				   char **next_param_str,
+				   struct at_param_view_list *const list);
+
 enum at_cmd_type {
 	/** Unknown command, indicates that the actual command type could not
 	 *  be resolved.
@@ -30,6 +30,9 @@ extern "C" {
  * All parameters values are copied in the list. Parameters should be
  * cleared to free that memory. Getter and setter methods are available
  * to read and write parameter values.
+ *
+ * A parameter view list stores the location of string and array parameters
+ * in the parsed string instead of copies, and needs no dynamic memory.
  */
 
 /** @brief Parameter types that can be stored. */
@@ -74,6 +77,66 @@ struct at_param_list {
 	struct at_param *params;
 };
 
+/**
+ * @brief A parameter view is defined with a type and the location of the
+ * parameter in the parsed string.
+ */
+struct at_param_view {
+	/** Parameter type. */
+	enum at_param_type type;
+	/** Offset of a string or array parameter in the parsed string. */
+	uint16_t offset;
+	/** Number of characters of a string parameter, or number of values of
+	 *  an array parameter.
+	 */
+	uint16_t len;
+	/** Value of an integer parameter. */
+	int64_t int_val;
+};
+
+/**
+ * @brief List of parameter views into a parsed AT command or response.
+ *
+ * Unlike @ref at_param_list, the list does not hold copies of string and
+ * array parameters, and needs no dynamic memory. The parsed string must remain
+ * valid as long as the list is used.
+ */
+struct at_param_view_list {
+	/** Parsed string. */
+	const char *str;
+	/** Number of elements in @c params. */
+	size_t param_count;
+	/** Array of parameter views. */
+	struct at_param_view *params;
+};
+
+/**
+ * @brief Initialize a list of parameter views.
+ *
+ * @param[in] list             Parameter view list to initialize.
+ * @param[in] params           Array of parameter views used by the list.
+ * @param[in] max_params_count Number of elements in @p params.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_init(struct at_param_view_list *list,
+			struct at_param_view *params,
+			size_t max_params_count);
+
+/**
+ * @brief Define and initialize a list of parameter views.
+ *
+ * @param name             Name of the list.
+ * @param max_params_count Maximum number of parameters the list can store.
+ */
+#define AT_PARAM_VIEW_LIST_DEFINE(name, max_params_count)			\
+	struct at_param_view name##_params[max_params_count];			\
+	struct at_param_view_list name = {					\
+		.param_count = (max_params_count),				\
+		.params = name##_params,					\
+	}
+
 /**
  * @brief Create a list of parameters.
  *
@@ -316,6 +379,148 @@ uint32_t at_params_valid_count_get(const struct at_param_list *list);
 enum at_param_type at_params_type_get(const struct at_param_list *list,
 				      size_t index);
 
+/**
+ * @brief Get a parameter view value as a short number.
+ *
+ * @param[in] list    Parameter view list.
+ * @param[in] index   Parameter index in the list.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_short_get(const struct at_param_view_list *list,
+			     size_t index, int16_t *value);
+
+/**
+ * @brief Get a parameter view value as an unsigned short number.
+ *
+ * @param[in] list    Parameter view list.
+ * @param[in] index   Parameter index in the list.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_unsigned_short_get(const struct at_param_view_list *list,
+				      size_t index, uint16_t *value);
+
+/**
+ * @brief Get a parameter view value as an integer number.
+ *
+ * @param[in] list    Parameter view list.
+ * @param[in] index   Parameter index in the list.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_int_get(const struct at_param_view_list *list,
+			   size_t index, int32_t *value);
+
+/**
+ * @brief Get a parameter view value as an unsigned integer number.
+ *
+ * @param[in] list    Parameter view list.
+ * @param[in] index   Parameter index in the list.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_unsigned_int_get(const struct at_param_view_list *list,
+				    size_t index, uint32_t *value);
+
+/**
+ * @brief Get a parameter view value as a signed 64-bit integer number.
+ *
+ * @param[in] list    Parameter view list.
+ * @param[in] index   Parameter index in the list.
+ * @param[out] value  Parameter value.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_int64_get(const struct at_param_view_list *list,
+			     size_t index, int64_t *value);
+
+/**
+ * @brief Get a pointer to a string parameter in the parsed string.
+ *
+ * The parameter type must be a string, or an error is returned.
+ * The string is not copied and is not null-terminated.
+ *
+ * @param[in]  list   Parameter view list.
+ * @param[in]  index  Parameter index in the list.
+ * @param[out] str    Pointer to the string in the parsed string.
+ * @param[out] len    Number of characters of the string.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_string_ptr_get(const struct at_param_view_list *list,
+				  size_t index, const char **str, size_t *len);
+
+/**
+ * @brief Get a parameter view value as a string.
+ *
+ * The parameter type must be a string, or an error is returned.
+ * The string parameter value is copied to the buffer.
+ * @p len must be bigger than the string length, or an error is returned.
+ * The copied string is not null-terminated.
+ *
+ * @param[in]     list    Parameter view list.
+ * @param[in]     index   Parameter index in the list.
+ * @param[in]     value   Pointer to the buffer where to copy the value.
+ * @param[in,out] len     Available space in @p value, returns actual length
+ *                        copied into string buffer in bytes.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_string_get(const struct at_param_view_list *list,
+			      size_t index, char *value, size_t *len);
+
+/**
+ * @brief Get a parameter view value as an array.
+ *
+ * The parameter type must be an array, or an error is returned.
+ * The array values are parsed from the parsed string to the buffer.
+ * @p len must be equal or bigger than the array length,
+ * or an error is returned.
+ *
+ * @param[in]     list    Parameter view list.
+ * @param[in]     index   Parameter index in the list.
+ * @param[out]    array   Pointer to the buffer where to copy the array.
+ * @param[in,out] len     Available space in @p array, returns actual length
+ *                        copied into array buffer in bytes.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_param_views_array_get(const struct at_param_view_list *list,
+			     size_t index, uint32_t *array, size_t *len);
+
+/**
+ * @brief Get the number of valid parameters in the view list.
+ *
+ * @param[in] list    Parameter view list.
+ *
+ * @return The number of valid parameters until an empty parameter is found.
+ */
+uint32_t at_param_views_valid_count_get(const struct at_param_view_list *list);
+
+/**
+ * @brief Get parameter view type for parameter at index
+ *
+ * @param[in] list    Parameter view list.
+ * @param[in] index   Parameter index in the list.
+ *
+ * @return Return parameter type of @ref at_param_type.
+ */
+enum at_param_type at_param_views_type_get(const struct at_param_view_list *list,
+					   size_t index);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -135,6 +135,14 @@ struct modem_param_info {
 	struct device_param  device;/**< Device parameters. */
 };
 
+#if defined(CONFIG_MODEM_INFO_CACHE)
+/**@brief Modem parameter cache statistics. */
+struct modem_info_cache_stats {
+	uint32_t hits; /**< Parameters read from the cache. */
+	uint32_t misses; /**< Parameters read from the modem. */
+};
+#endif /* CONFIG_MODEM_INFO_CACHE */
+
 /** @brief Initialize the modem information module.
  *
  * @retval 0 If the operation was successful.
@@ -221,6 +229,30 @@ enum at_param_type modem_info_type_get(enum modem_info info);
  */
 int modem_info_params_get(struct modem_param_info *modem_param);
 
+#if defined(CONFIG_MODEM_INFO_CACHE)
+/** @brief Invalidate the cached modem parameters.
+ *
+ * The next call to @ref modem_info_params_get reads all parameters from the
+ * modem. Network parameters are invalidated automatically when the network
+ * registration changes. Call this function if other cached parameters might
+ * have changed, for example after the SIM card has been replaced.
+ *
+ * @note Requires @kconfig{CONFIG_MODEM_INFO_CACHE}.
+ */
+void modem_info_params_cache_invalidate(void);
+
+/** @brief Obtain the statistics of the modem parameter cache.
+ *
+ * The statistics count the parameters read by @ref modem_info_params_get
+ * since the system started.
+ *
+ * @note Requires @kconfig{CONFIG_MODEM_INFO_CACHE}.
+ *
+ * @param stats Pointer to the structure where to store the statistics.
+ */
+void modem_info_params_cache_stats_get(struct modem_info_cache_stats *stats);
+#endif /* CONFIG_MODEM_INFO_CACHE */
+
 /** @brief Obtain the UUID of the modem firmware build.
  *
  * The UUID is represented as a string, for example:
@@ -116,6 +116,23 @@ int nrf_modem_lib_trace_clear(void);
 uint32_t nrf_modem_lib_trace_backend_bitrate_get(void);
 #endif /* defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE) || defined(__DOXYGEN__) */
 
+#if (defined(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE) &&                                       \
+     defined(CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION)) ||                                           \
+	defined(__DOXYGEN__)
+/** @brief Get the last measured compression ratio of the trace data.
+ *
+ * This function returns the size of the data written to the trace backend, in percent of the
+ * size of the trace data received from the modem, calculated over the last
+ * @kconfig{CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE_PERIOD_MS} period.
+ * The rate at which the modem trace data is processed is the backend bitrate multiplied
+ * by 100 and divided by this value.
+ *
+ * @return Compressed size in percent of the trace data size, or 0 if there was no trace data
+ *         during the last period.
+ */
+uint32_t nrf_modem_lib_trace_compression_ratio_get(void);
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
@@ -112,6 +112,10 @@ struct download_client_cfg {
 	 * configured using Kconfig shall be used.
 	 */
 	size_t frag_size_override;
+	/** Number of HTTP Range requests to keep in flight. 0 indicates that the value
+	 * configured using Kconfig shall be used.
+	 */
+	uint8_t http_pipeline_depth;
 	/** Set hostname for TLS Server Name Indication extension */
 	bool set_tls_hostname;
 };
@@ -174,14 +178,45 @@ struct download_client {
 		bool connection_close;
 		/** Is using ranged query. */
 		bool ranged;
+		/** Offset of the first byte that has not been requested. */
+		size_t requested;
+		/** Offset of the byte following the range of the current response. */
+		size_t range_end;
 	} http;
 
 	struct {
 		/** CoAP block context. */
 		struct coap_block_context block_ctx;
 
-		/** CoAP pending object. */
-		struct coap_pending pending;
+		/** Block requests in flight, oldest first. */
+		struct download_client_coap_block {
+			/** CoAP pending object. */
+			struct coap_pending pending;
+			/** Offset of the block in the file. */
+			size_t offset;
+			/** Block size of the request. */
+			enum coap_block_size block_size;
+			/** The request must be (re)transmitted. */
+			bool send;
+			/** The response has been received. */
+			bool received;
+#if CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE > 1
+			/** Length of the payload. */
+			uint16_t len;
+			/** Payload received ahead of the preceding blocks. */
+			uint8_t data[1 << (CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE + 4)];
+#endif
+		} blocks[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE];
+		/** Index of the oldest block request. */
+		uint8_t head;
+		/** Number of block requests in flight. */
+		uint8_t count;
+		/** Maximum number of block requests in flight. */
+		uint8_t window;
+		/** Block size of the next request. */
+		enum coap_block_size block_size;
+		/** Number of blocks received since the last retransmission. */
+		uint16_t blocks_without_loss;
 	} coap;
 
 	/** Internal thread ID. */
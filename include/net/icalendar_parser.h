@@ -102,14 +102,27 @@ typedef int (*icalendar_parser_callback_t)(
 
 /**
  * @brief iCalendar parser instance.
+ *
+ * The parser keeps one unfolded content line at a time, so its size does not
+ * depend on the size of the calendar or on how the data stream is split.
  */
 struct icalendar_parser {
-	/** Internal Buffer for parsing incoming data stream */
-	char buf[CONFIG_ICAL_PARSER_BUFFER_SIZE + 1];
-	/** Offset of unparsed data in buf. */
-	size_t offset;
+	/** Unfolded content line being received, with room for a trailing CR. */
+	char line[CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE + 2];
+	/** Length of the content line. */
+	size_t line_len;
+	/** The content line did not fit in the line buffer. */
+	bool line_overflow;
+	/** Line break received, the content line continues if the next line is folded. */
+	bool line_break;
 	/** begin of iCalendar object delimiter pair */
 	bool icalobject_begin;
+	/** The component being parsed is reported to the application. */
+	bool com_reported;
+	/** Nesting level of the component being parsed, zero between components. */
+	uint8_t com_depth;
+	/** Event of the component being parsed. */
+	struct ical_parser_evt evt;
 	/** Event handler. */
 	icalendar_parser_callback_t callback;
 };
@@ -128,11 +141,19 @@ int ical_parser_init(struct icalendar_parser *ical,
 /**
  * @brief Parse the iCalendar data stream. Return the parsed bytes.
  *
+ * The data stream can be split at any point, for example into the fragments
+ * received from the download client. An event is sent to the application
+ * as soon as the line that ends its component is parsed.
+ *
+ * If the event handler returns non-zero, parsing stops after the line that
+ * ends the component. The remaining data can be passed in a new call to
+ * continue parsing.
+ *
  * @param[in,out] ical iCalendar parser instance.
  * @param[in] data Input data to be parsed.
  * @param[in] len  Length of input data stream.
  *
- * @retval size_t  Parsed bytes.
+ * @retval size_t  Parsed bytes. Less than @p len if the event handler stopped parsing.
  */
 size_t ical_parser_parse(struct icalendar_parser *ical,
 			const char *data, size_t len);
@@ -45,11 +45,33 @@ struct mqtt_helper_buf {
 	size_t size;
 };
 
+/** @brief Part of the payload of an incoming MQTT PUBLISH message. */
+struct mqtt_helper_payload_chunk {
+	/** Chunk data. Only valid for the duration of the callback. */
+	struct mqtt_helper_buf buf;
+
+	/** Offset of the chunk data in the payload. */
+	size_t offset;
+
+	/** Total length of the payload. */
+	size_t total_len;
+};
+
 typedef void (*mqtt_helper_handler_t)(struct mqtt_evt *evt);
 typedef void (*mqtt_helper_on_connack_t)(enum mqtt_conn_return_code return_code);
 typedef void (*mqtt_helper_on_disconnect_t)(int result);
 typedef void (*mqtt_helper_on_publish_t)(struct mqtt_helper_buf topic_buf,
 					 struct mqtt_helper_buf payload_buf);
+/** @brief Callback for consuming incoming payload in chunks.
+ *
+ *  The callback is called for consecutive chunks of the payload until the full payload has been
+ *  delivered. The last chunk is the one where offset + buf.size equals total_len. A message
+ *  without payload is delivered as a single empty chunk.
+ *
+ *  @return 0 to receive the next chunk. A negative value discards the rest of the payload.
+ */
+typedef int (*mqtt_helper_on_publish_chunk_t)(struct mqtt_helper_buf topic_buf,
+					      const struct mqtt_helper_payload_chunk *chunk);
 typedef void (*mqtt_helper_on_puback_t)(uint16_t message_id, int result);
 typedef void (*mqtt_helper_on_suback_t)(uint16_t message_id, int result);
 typedef void (*mqtt_helper_on_pingresp_t)(void);
@@ -60,11 +82,26 @@ struct mqtt_helper_cfg {
 		mqtt_helper_on_connack_t on_connack;
 		mqtt_helper_on_disconnect_t on_disconnect;
 		mqtt_helper_on_publish_t on_publish;
+		/** If set, incoming payload is delivered through this callback in chunks of up to
+		 *  CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN bytes, instead of through on_publish.
+		 *  This allows receiving messages that are larger than the payload buffer.
+		 */
+		mqtt_helper_on_publish_chunk_t on_publish_chunk;
 		mqtt_helper_on_puback_t on_puback;
 		mqtt_helper_on_suback_t on_suback;
 		mqtt_helper_on_pingresp_t on_pingresp;
 		mqtt_helper_on_error_t on_error;
 	} cb;
+	/** Topics that carry state, where only the latest message matters. A message that is
+	 *  queued for one of these topics while disconnected replaces the message already queued
+	 *  for the same topic. If the replaced message has QoS 1 or higher, its message ID is
+	 *  kept and the message ID of the replacing message is never acknowledged.
+	 *  Requires CONFIG_MQTT_HELPER_PUBLISH_QUEUE. The list must remain
+	 *  valid until the library is deinitialized.
+	 */
+	const struct mqtt_helper_buf *coalesce_topics;
+	/** Number of entries in coalesce_topics. */
+	size_t coalesce_topic_count;
 };
 
 struct mqtt_helper_conn_params {
@@ -108,9 +145,14 @@ int mqtt_helper_disconnect(void);
 int mqtt_helper_subscribe(struct mqtt_subscription_list *sub_list);
 
 /** @brief Publish an MQTT message.
+ *
+ *  If CONFIG_MQTT_HELPER_PUBLISH_QUEUE is enabled and the library is initialized but not
+ *  connected, the message is copied to a queue and published in order when the connection is
+ *  established. Messages with QoS 0 are dropped, oldest first, if the queue runs out of space.
  *
  *  @retval 0 if successful.
  *  @retval -EOPNOTSUPP if operation is not supported in the current state.
+ *  @retval -ENOMEM if the message could not be queued.
  *  @return Otherwise a negative error code.
  */
 int mqtt_helper_publish(const struct mqtt_publish_param *param);
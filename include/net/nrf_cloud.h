@@ -729,6 +729,28 @@ int nrf_cloud_sensor_data_send(const struct nrf_cloud_sensor_data *param);
  */
 int nrf_cloud_shadow_device_status_update(const struct nrf_cloud_device_status * const dev_status);
 
+#if defined(CONFIG_NRF_CLOUD_CBOR_MODEM_INFO)
+/**
+ * @brief Send the modem info as a CBOR device message.
+ *
+ * The sections of @p modem_info that are set to @ref NRF_CLOUD_INFO_SET are
+ * encoded with the same keys as in the shadow and sent on the binary topic.
+ *
+ * This API should only be called after receiving an
+ * @ref NRF_CLOUD_EVT_READY event.
+ *
+ * @param[in] modem_info Modem info to send.
+ * @param[in] ts_ms      Timestamp in UNIX milliseconds, or @ref NRF_CLOUD_NO_TIMESTAMP.
+ *
+ * @retval 0       If successful.
+ * @retval -EACCES Cloud connection is not established; wait for @ref NRF_CLOUD_EVT_READY.
+ * @retval -ENODATA No section of the modem info is set.
+ * @return A negative value indicates an error.
+ */
+int nrf_cloud_modem_info_send(const struct nrf_cloud_modem_info *const modem_info,
+			      const int64_t ts_ms);
+#endif
+
 /**
  * @brief Stream sensor data. Uses lowest QoS; no acknowledgment,
  *
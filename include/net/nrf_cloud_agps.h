@@ -58,6 +58,26 @@ int nrf_cloud_agps_request_all(void);
  */
 int nrf_cloud_agps_process(const char *buf, size_t buf_len);
 
+/** @brief Processes binary A-GPS data received from nRF Cloud in chunks.
+ *
+ * Can be used when the A-GPS data does not fit in one buffer. The chunks must be
+ * passed in order, starting at offset 0. Elements that are split between chunks
+ * are reassembled internally. If the first chunk contains all the data, it is
+ * processed by @ref nrf_cloud_agps_process.
+ *
+ * @param buf Pointer to a chunk of data received from nRF Cloud.
+ * @param buf_len Length of the chunk.
+ * @param offset Offset of the chunk in the data.
+ * @param total_len Length of all the data.
+ *
+ * @retval 0 A-GPS data in the chunk successfully processed.
+ * @retval -EINVAL buf was NULL, buf_len was zero or the chunk does not follow the previous one.
+ * @retval -EBADMSG Data is not in the A-GPS format.
+ * @return A negative value indicates an error. The rest of the data must not be passed.
+ */
+int nrf_cloud_agps_process_chunk(const char *buf, size_t buf_len, size_t offset,
+				 size_t total_len);
+
 /** @brief Query which A-GPS elements were actually received
  *
  * @param received_elements return copy of requested elements received
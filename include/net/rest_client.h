@@ -51,7 +51,11 @@ struct rest_client_req_context {
 	 */
 	int connect_socket;
 
-	/** Defines whether the connection should remain after API call. Default: false. */
+	/** Defines whether the connection should remain after API call. Default: false.
+	 *  If CONFIG_REST_CLIENT_CONN_POOL is enabled and connect_socket is
+	 *  REST_CLIENT_SCKT_CONNECT, a request with keep_alive set to false uses a connection
+	 *  from the pool, which remains open for following requests to the same server.
+	 */
 	bool keep_alive;
 
 	/** Security tag. Default: REST_CLIENT_SEC_TAG_NO_SEC. */
@@ -160,6 +164,16 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
  */
 void rest_client_request_defaults_set(struct rest_client_req_context *req_ctx);
 
+/**
+ * @brief Close the idle connections in the connection pool.
+ *
+ * @details Connections that are in use by a request are not affected.
+ *          Requires CONFIG_REST_CLIENT_CONN_POOL.
+ *
+ * @return Number of connections that were closed.
+ */
+int rest_client_conn_pool_flush(void);
+
 /** @} */
 
 #endif /* REST_CLIENT_H__ */
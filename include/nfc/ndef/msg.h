@@ -79,6 +79,97 @@ void nfc_ndef_msg_clear(struct nfc_ndef_msg_desc *msg);
 int nfc_ndef_msg_record_add(struct nfc_ndef_msg_desc *msg,
 			    struct nfc_ndef_record_desc const *record);
 
+/**
+ * @brief Encoded NDEF message cache.
+ *
+ * Keeps the layout of an NDEF message encoded with
+ * @ref nfc_ndef_msg_cache_encode, so that a single record can be re-encoded
+ * with @ref nfc_ndef_msg_cache_record_update without encoding the remaining
+ * records again.
+ */
+struct nfc_ndef_msg_cache {
+	/** Message descriptor of the encoded message. */
+	struct nfc_ndef_msg_desc const *msg;
+	/** Buffer holding the encoded message. */
+	uint8_t *buffer;
+	/** Size of the buffer. */
+	uint32_t size;
+	/** Offsets of the encoded records in the buffer. The element following
+	 *  the last record holds the length of the encoded message.
+	 */
+	uint32_t *offset;
+	/** Number of records the cache can hold. */
+	uint32_t max_record_count;
+};
+
+/**
+ * @brief Encode an NDEF message and cache its layout.
+ *
+ * This function encodes an NDEF message like @ref nfc_ndef_msg_encode and
+ * stores the offset of every record in the cache. The message descriptor and
+ * the buffer must remain valid as long as the cache is used.
+ *
+ * @param cache Pointer to the message cache.
+ * @param ndef_msg_desc Pointer to the message descriptor.
+ * @param msg_buffer Pointer to the message destination.
+ * @param msg_len Size of the available memory for the message as input. Size
+ * of the generated message as output.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int nfc_ndef_msg_cache_encode(struct nfc_ndef_msg_cache *cache,
+			      struct nfc_ndef_msg_desc const *ndef_msg_desc,
+			      uint8_t *msg_buffer,
+			      uint32_t *msg_len);
+
+/**
+ * @brief Re-encode a single record of a cached NDEF message.
+ *
+ * Only the record at the given index is encoded again. Bytes preceding the
+ * record are left untouched. If the record length changed, the records
+ * following it are moved within the buffer. The other records must not have
+ * changed since the message was encoded.
+ *
+ * If the record cannot be encoded, the cache is invalidated and the message
+ * must be encoded again with @ref nfc_ndef_msg_cache_encode.
+ *
+ * @param cache Pointer to the message cache.
+ * @param index Index of the record in the message.
+ * @param msg_len Size of the updated message as output.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int nfc_ndef_msg_cache_record_update(struct nfc_ndef_msg_cache *cache,
+				     uint32_t index,
+				     uint32_t *msg_len);
+
+/**
+ * @brief Macro for creating and initializing an NFC NDEF message cache.
+ *
+ * This macro creates and initializes an instance of type
+ * @ref nfc_ndef_msg_cache and an array of record offsets used by the cache.
+ *
+ * Use the macro @ref NFC_NDEF_MSG_CACHE to access the NDEF message cache
+ * instance.
+ *
+ * @param name Name of the related instance.
+ * @param max_record_cnt Maximal count of records in the cached message.
+ */
+#define NFC_NDEF_MSG_CACHE_DEF(name, max_record_cnt)			    \
+	uint32_t name##_nfc_ndef_msg_cache_offset[(max_record_cnt) + 1];   \
+	struct nfc_ndef_msg_cache name##_nfc_ndef_msg_cache =		    \
+	{								    \
+		.offset = name##_nfc_ndef_msg_cache_offset,		    \
+		.max_record_count = max_record_cnt,			    \
+	}
+
+/** @brief Macro for accessing the NFC NDEF message cache instance
+ *  that you created with @ref NFC_NDEF_MSG_CACHE_DEF.
+ */
+#define NFC_NDEF_MSG_CACHE(name) (name##_nfc_ndef_msg_cache)
+
 /**
  * @brief Macro for creating and initializing an NFC NDEF message descriptor.
  *
@@ -15,6 +15,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <zephyr/types.h>
 #include <nfc/ndef/record_parser.h>
 #include <nfc/ndef/msg.h>
@@ -86,6 +87,59 @@ int nfc_ndef_msg_parse(uint8_t  *result_buf,
 		       const uint8_t *raw_data,
 		       uint32_t *raw_data_len);
 
+/** @brief NDEF message iterator.
+ *
+ *  The iterator parses an NDEF message one record at a time, without
+ *  allocating record descriptors. Use @ref nfc_ndef_msg_iter_init to
+ *  initialize it.
+ */
+struct nfc_ndef_msg_iter {
+	/** Pointer to the raw NDEF message. */
+	const uint8_t *data;
+	/** Size of the raw data. */
+	uint32_t data_len;
+	/** Number of bytes parsed so far. After the last record, this is
+	 *  the size of the NDEF message.
+	 */
+	uint32_t offset;
+	/** Number of records parsed so far. */
+	uint32_t record_count;
+	/** The last record of the message was parsed. */
+	bool end;
+};
+
+/** @brief Initialize an NDEF message iterator.
+ *
+ *  @param[out] iter Pointer to the iterator.
+ *  @param[in] raw_data Pointer to the data to be parsed.
+ *  @param[in] raw_data_len Size of the NFC data in the @p raw_data buffer.
+ */
+void nfc_ndef_msg_iter_init(struct nfc_ndef_msg_iter *iter,
+			    const uint8_t *raw_data,
+			    uint32_t raw_data_len);
+
+/** @brief Get the next record of an NDEF message.
+ *
+ *  The record is returned as a view of the raw data. Only the record header
+ *  is parsed. The payload can be decoded on demand, for example by passing
+ *  the descriptor filled by @ref nfc_ndef_record_view_desc_get to a payload
+ *  type parser.
+ *
+ *  The iterator must not be used anymore after an error is returned.
+ *
+ *  @param[in,out] iter Pointer to the iterator.
+ *  @param[out] view Pointer to the record view that will be filled with
+ *                   the parsed record.
+ *
+ *  @retval 0 If the record was parsed successfully.
+ *  @retval -ENOENT If all records of the message were already parsed.
+ *  @retval -EINVAL If the record is malformed.
+ *  @retval -EFAULT If the record location flags are invalid or the message
+ *                  ends before its last record.
+ */
+int nfc_ndef_msg_iter_next(struct nfc_ndef_msg_iter *iter,
+			   struct nfc_ndef_record_view *view);
+
 /** @brief Print the parsed contents of an NDEF message.
  *
  *  @param[in] msg_desc Pointer to the descriptor of the message that should
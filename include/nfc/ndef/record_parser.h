@@ -7,6 +7,7 @@
 #define NFC_NDEF_RECORD_PARSER_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <zephyr/types.h>
 #include <nfc/ndef/record.h>
 
@@ -21,6 +22,77 @@ extern "C" {
  */
 
 
+/** @brief View of an NDEF record.
+ *
+ *  The view points to the fields of the record in the raw NFC data. No data
+ *  is copied, so the raw data must remain valid as long as the view is used.
+ */
+struct nfc_ndef_record_view {
+	/** Pointer to the type field. NULL if the type is empty. */
+	const uint8_t *type;
+	/** Pointer to the ID field. NULL if the record has no ID. */
+	const uint8_t *id;
+	/** Pointer to the payload. NULL if the payload is empty. */
+	const uint8_t *payload;
+	/** Length of the payload. */
+	uint32_t payload_length;
+	/** Value of the Type Name Format (TNF) field. */
+	enum nfc_ndef_record_tnf tnf;
+	/** Location of the record within the NDEF message. */
+	enum nfc_ndef_record_location location;
+	/** Length of the type field. */
+	uint8_t type_length;
+	/** Length of the ID field. */
+	uint8_t id_length;
+};
+
+/** @brief Parse the header of an NDEF record into a record view.
+ *
+ *  @param[out] view Pointer to the record view that will be filled with
+ *                   parsed data.
+ *  @param[in] nfc_data Pointer to the raw data to be parsed.
+ *  @param[in,out] nfc_data_len As input: size of the NFC data in the
+ *                              @p nfc_data buffer. As output: size of the
+ *                              parsed record.
+ *
+ *  @retval 0 If the operation was successful.
+ *            Otherwise, a (negative) error code is returned.
+ */
+int nfc_ndef_record_view_parse(struct nfc_ndef_record_view *view,
+			       const uint8_t *nfc_data,
+			       uint32_t *nfc_data_len);
+
+/** @brief Fill an NDEF record descriptor from a record view.
+ *
+ *  The record descriptor uses the binary payload descriptor
+ *  (@ref nfc_ndef_bin_payload_desc) to describe the payload, so it can be
+ *  passed to the payload type parsers.
+ *
+ *  @param[in] view Pointer to the record view.
+ *  @param[out] bin_pay_desc Pointer to the binary payload descriptor that
+ *                           will be filled and referenced by the record
+ *                           descriptor.
+ *  @param[out] rec_desc Pointer to the record descriptor that will be filled.
+ */
+void nfc_ndef_record_view_desc_get(const struct nfc_ndef_record_view *view,
+				   struct nfc_ndef_bin_payload_desc *bin_pay_desc,
+				   struct nfc_ndef_record_desc *rec_desc);
+
+/** @brief Check the type of an NDEF record view.
+ *
+ *  @param[in] view Pointer to the record view.
+ *  @param[in] tnf Expected Type Name Format (TNF) value.
+ *  @param[in] type Pointer to the expected type.
+ *  @param[in] type_length Length of the expected type.
+ *
+ *  @retval true If the record has the given TNF and type.
+ *  @retval false Otherwise.
+ */
+bool nfc_ndef_record_view_type_match(const struct nfc_ndef_record_view *view,
+				     enum nfc_ndef_record_tnf tnf,
+				     const uint8_t *type,
+				     uint8_t type_length);
+
 /** @brief Parse NDEF records.
  *
  *  This parsing implementation uses the binary payload descriptor
@@ -16,6 +16,7 @@
  */
 
 #include <zephyr/types.h>
+#include <nfc/ndef/msg.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +55,28 @@ extern "C" {
  */
 int nfc_t4t_ndef_file_encode(uint8_t *file_buf, uint32_t *size);
 
+/**@brief Update a single record of the NDEF Message in the NFC NDEF File.
+ *
+ * The NDEF Message must have been encoded with
+ * @ref nfc_ndef_msg_cache_encode into the buffer returned by
+ * @ref nfc_t4t_ndef_file_msg_get. Only the given record is re-encoded and the
+ * NDEF File is patched in place. The NLEN field is cleared while the message
+ * is modified, so that a concurrent read does not return a partially updated
+ * message.
+ *
+ * @param[in] file_buf Pointer to the NFC NDEF File.
+ * @param[in] cache Pointer to the NDEF Message cache.
+ * @param[in] index Index of the updated record.
+ * @param[out] size Size of the updated NDEF File.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int nfc_t4t_ndef_file_record_update(uint8_t *file_buf,
+				    struct nfc_ndef_msg_cache *cache,
+				    uint32_t index,
+				    uint32_t *size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,8 +15,6 @@
 #include <modem/at_cmd_parser.h>
 #include "at_utils.h"
 
-#define AT_CMD_MAX_ARRAY_SIZE 32
-
 #define AT_CMD_CGEV_LEN         5
 #define AT_CMD_CPIN_LEN         5
 #define AT_CMD_SHORTSWVER_LEN   11
@@ -37,20 +35,102 @@ enum at_parser_state {
 	CLAC,
 };
 
-static enum at_parser_state state;
+/* Parser context, so that several threads can parse at the same time.
+ * Parameters are stored either in a parameter list or as views into the
+ * parsed string.
+ */
+struct at_parser {
+	enum at_parser_state state;
+	bool set_type_string;
+	/* Start of the parsed string. */
+	const char *str;
+	struct at_param_list *list;
+	struct at_param_view_list *views;
+	/* First error storing a parameter view. */
+	int err;
+};
 
-static bool set_type_string;
+static inline void set_new_state(struct at_parser *parser,
+				 enum at_parser_state new_state)
+{
+	parser->state = new_state;
+}
 
-static inline void set_new_state(enum at_parser_state new_state)
+static inline void reset_state(struct at_parser *parser)
 {
-	state = new_state;
+	parser->state = IDLE;
+
+	parser->set_type_string = false;
 }
 
-static inline void reset_state(void)
+static void param_view_put(struct at_parser *parser, int index,
+			   enum at_param_type type, const char *str,
+			   size_t len)
 {
-	state = IDLE;
+	size_t offset = str - parser->str;
+	struct at_param_view *view;
+
+	if ((size_t)index >= parser->views->param_count) {
+		return;
+	}
 
-	set_type_string = false;
+	if ((offset > UINT16_MAX) || (len > UINT16_MAX)) {
+		if (!parser->err) {
+			parser->err = -EOVERFLOW;
+		}
+		return;
+	}
+
+	view = &parser->views->params[index];
+	view->type = type;
+	view->offset = offset;
+	view->len = len;
+	view->int_val = 0;
+}
+
+static void param_empty_put(struct at_parser *parser, int index)
+{
+	if (parser->views) {
+		param_view_put(parser, index, AT_PARAM_TYPE_EMPTY, parser->str, 0);
+	} else {
+		at_params_empty_put(parser->list, index);
+	}
+}
+
+static void param_int_put(struct at_parser *parser, int index, int64_t value)
+{
+	if (parser->views) {
+		param_view_put(parser, index, AT_PARAM_TYPE_NUM_INT, parser->str, 0);
+		if ((size_t)index < parser->views->param_count) {
+			parser->views->params[index].int_val = value;
+		}
+	} else {
+		at_params_int_put(parser->list, index, value);
+	}
+}
+
+static void param_string_put(struct at_parser *parser, int index,
+			     const char *str, size_t len)
+{
+	if (parser->views) {
+		param_view_put(parser, index, AT_PARAM_TYPE_STRING, str, len);
+	} else {
+		at_params_string_put(parser->list, index, str, len);
+	}
+}
+
+/* The view of an array holds the number of values, which are parsed again
+ * from the string when the array is read.
+ */
+static void param_array_put(struct at_parser *parser, int index,
+			    const char *str, const uint32_t *array, size_t count)
+{
+	if (parser->views) {
+		param_view_put(parser, index, AT_PARAM_TYPE_ARRAY, str, count);
+	} else {
+		at_params_array_put(parser->list, index, array,
+				    count * sizeof(uint32_t));
+	}
 }
 
 static inline void skip_command_prefix(const char **cmd)
@@ -100,7 +180,8 @@ static bool is_result(const char *str)
 	return false;
 }
 
-static int at_parse_detect_type(const char **str, int index)
+static int at_parse_detect_type(struct at_parser *parser, const char **str,
+				int index)
 {
 	const char *tmpstr = *str;
 
@@ -108,29 +189,29 @@ static int at_parse_detect_type(const char **str, int index)
 		/* Only first parameter in the string can be
 		 * notification ID, (eg +CEREG:)
 		 */
-		set_new_state(NOTIFICATION);
+		set_new_state(parser, NOTIFICATION);
 
 		/* Check for responses we know need to be strings */
-		set_type_string = check_response_for_forced_string(tmpstr);
+		parser->set_type_string = check_response_for_forced_string(tmpstr);
 
-	} else if (set_type_string) {
-		set_new_state(STRING);
+	} else if (parser->set_type_string) {
+		set_new_state(parser, STRING);
 	} else if ((index > 0) && is_clac(tmpstr)) {
 		/* Next, check if we deal with CLAC response (eg AT+, AT%)
 		 * NOTE - need to go back to index 0 and parse as CLAC state
 		 * NOTE - AT+CLAC always returns more than one line
 		 */
-		set_new_state(CLAC);
+		set_new_state(parser, CLAC);
 		return -2;
 	} else if ((index == 0) && is_command(tmpstr)) {
 		/* Next, check if we deal with command (eg AT+CCLK) */
-		set_new_state(COMMAND);
+		set_new_state(parser, COMMAND);
 	} else if (index == 0) {
 		/* If the string start without an notification
 		 * ID, we treat the whole string as one string
 		 * parameter
 		 */
-		set_new_state(STRING);
+		set_new_state(parser, STRING);
 	} else if ((index > 0) && is_notification(*tmpstr)) {
 		/* If notifications is detected later in the
 		 * string we should stop parsing and return
@@ -139,15 +220,15 @@ static int at_parse_detect_type(const char **str, int index)
 		*str = tmpstr;
 		return -1;
 	} else if (is_number(*tmpstr)) {
-		set_new_state(NUMBER);
+		set_new_state(parser, NUMBER);
 
 	} else if (is_dblquote(*tmpstr)) {
-		set_new_state(QUOTED_STRING);
+		set_new_state(parser, QUOTED_STRING);
 		tmpstr++;
 	} else if (is_array_start(*tmpstr)) {
-		set_new_state(ARRAY);
+		set_new_state(parser, ARRAY);
 		tmpstr++;
-	} else if (is_lfcr(*tmpstr) && (state == NUMBER)) {
+	} else if (is_lfcr(*tmpstr) && (parser->state == NUMBER)) {
 		/* If \n or \r is detected in the string and the
 		 * previous param was a number we assume the
 		 * next parameter is PDU data
@@ -157,14 +238,14 @@ static int at_parse_detect_type(const char **str, int index)
 			tmpstr++;
 		}
 
-		set_new_state(SMS_PDU);
-	} else if (is_lfcr(*tmpstr) && (state == OPTIONAL)) {
-		set_new_state(OPTIONAL);
+		set_new_state(parser, SMS_PDU);
+	} else if (is_lfcr(*tmpstr) && (parser->state == OPTIONAL)) {
+		set_new_state(parser, OPTIONAL);
 	} else if (is_separator(*tmpstr)) {
 		/* If a separator is detected we have detected
 		 * and empty optional parameter
 		 */
-		set_new_state(OPTIONAL);
+		set_new_state(parser, OPTIONAL);
 	} else {
 		/* The rule set is exhausted, and cannot
 		 * continue. Break the loop and return an error
@@ -177,8 +258,8 @@ static int at_parse_detect_type(const char **str, int index)
 	return 0;
 }
 
-static int at_parse_process_element(const char **str, int index,
-				    struct at_param_list *const list)
+static int at_parse_process_element(struct at_parser *parser,
+				    const char **str, int index)
 {
 	const char *tmpstr = *str;
 
@@ -186,16 +267,15 @@ static int at_parse_process_element(const char **str, int index,
 		return -1;
 	}
 
-	if (state == NOTIFICATION) {
+	if (parser->state == NOTIFICATION) {
 		const char *start_ptr = tmpstr++;
 
 		while (is_valid_notification_char(*tmpstr)) {
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
-	} else if (state == COMMAND) {
+		param_string_put(parser, index, start_ptr, tmpstr - start_ptr);
+	} else if (parser->state == COMMAND) {
 		const char *start_ptr = tmpstr;
 
 		skip_command_prefix(&tmpstr);
@@ -204,8 +284,7 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(parser, index, start_ptr, tmpstr - start_ptr);
 
 		/* Skip read/test special characters. */
 		if ((*tmpstr == AT_CMD_SEPARATOR) &&
@@ -215,87 +294,63 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-	} else if (state == OPTIONAL) {
-		at_params_empty_put(list, index);
+	} else if (parser->state == OPTIONAL) {
+		param_empty_put(parser, index);
 
-	} else if (state == STRING) {
+	} else if (parser->state == STRING) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_lfcr(*tmpstr) && !is_terminated(*tmpstr)) {
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(parser, index, start_ptr, tmpstr - start_ptr);
 
 		tmpstr++;
-	} else if (state == QUOTED_STRING) {
+	} else if (parser->state == QUOTED_STRING) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_dblquote(*tmpstr) && !is_terminated(*tmpstr)) {
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(parser, index, start_ptr, tmpstr - start_ptr);
 
 		tmpstr++;
-	} else if (state == ARRAY) {
-		char *next;
-		size_t i = 0;
+	} else if (parser->state == ARRAY) {
+		const char *start_ptr = tmpstr;
 		uint32_t tmparray[AT_CMD_MAX_ARRAY_SIZE];
+		size_t count;
 
-		tmparray[i++] = (uint32_t)strtoul(tmpstr, &next, 10);
-		tmpstr = next;
-
-		while (!is_array_stop(*tmpstr) && !is_terminated(*tmpstr)) {
-			if (is_separator(*tmpstr)) {
-				tmparray[i++] =
-					(uint32_t)strtoul(++tmpstr, &next, 10);
-
-				if (strlen(tmpstr) == strlen(next)) {
-					break;
-				} else {
-					tmpstr = next;
-				}
-
-			} else {
-				tmpstr++;
-			}
-
-			if (i == AT_CMD_MAX_ARRAY_SIZE) {
-				break;
-			}
-		}
+		/* Views do not need the values. */
+		count = array_parse(&tmpstr, parser->views ? NULL : tmparray);
 
-		at_params_array_put(list, index, tmparray, i * sizeof(uint32_t));
+		param_array_put(parser, index, start_ptr, tmparray, count);
 
 		tmpstr++;
-	} else if (state == NUMBER) {
+	} else if (parser->state == NUMBER) {
 		char *next;
 		int64_t value = (int64_t)strtoll(tmpstr, &next, 10);
 
 		tmpstr = next;
 
-		at_params_int_put(list, index, value);
-	} else if (state == SMS_PDU) {
+		param_int_put(parser, index, value);
+	} else if (parser->state == SMS_PDU) {
 		const char *start_ptr = tmpstr;
 
 		while (isxdigit((int)*tmpstr)) {
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
-	} else if (state == CLAC) {
+		param_string_put(parser, index, start_ptr, tmpstr - start_ptr);
+	} else if (parser->state == CLAC) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_terminated(*tmpstr)) {
 			tmpstr++;
 		}
 
-		at_params_string_put(list, index, start_ptr,
-				     tmpstr - start_ptr);
+		param_string_put(parser, index, start_ptr, tmpstr - start_ptr);
 	}
 
 	*str = tmpstr;
@@ -306,8 +361,8 @@ static int at_parse_process_element(const char **str, int index,
  * Internal function.
  * Parameters cannot be null. String must be null terminated.
  */
-static int at_parse_param(const char **at_params_str,
-			  struct at_param_list *const list,
+static int at_parse_param(struct at_parser *parser,
+			  const char **at_params_str,
 			  const size_t max_params)
 {
 	int index = 0;
@@ -315,7 +370,7 @@ static int at_parse_param(const char **at_params_str,
 	bool oversized = false;
 	int ret;
 
-	reset_state();
+	reset_state(parser);
 
 	/* trim leading CRLF */
 	while (is_lfcr(*str)) {
@@ -327,7 +382,7 @@ static int at_parse_param(const char **at_params_str,
 			str++;
 		}
 
-		ret = at_parse_detect_type(&str, index);
+		ret = at_parse_detect_type(parser, &str, index);
 		if (ret == -1) {
 			break;
 		}
@@ -337,7 +392,7 @@ static int at_parse_param(const char **at_params_str,
 			index = 0;
 		}
 
-		if (at_parse_process_element(&str, index, list) == -1) {
+		if (at_parse_process_element(parser, &str, index) == -1) {
 			break;
 		}
 
@@ -352,12 +407,12 @@ static int at_parse_param(const char **at_params_str,
 					break;
 				}
 
-				if (at_parse_detect_type(&str, index) == -1) {
+				if (at_parse_detect_type(parser, &str, index) == -1) {
 					break;
 				}
 
-				if (at_parse_process_element(&str, index,
-							     list) == -1) {
+				if (at_parse_process_element(parser, &str,
+							     index) == -1) {
 					break;
 				}
 			}
@@ -412,6 +467,10 @@ int at_parser_max_params_from_str(const char *at_params_str,
 				  size_t max_params_count)
 {
 	int err = 0;
+	struct at_parser parser = {
+		.str = at_params_str,
+		.list = list,
+	};
 
 	if (at_params_str == NULL || list == NULL || list->params == NULL) {
 		return -EINVAL;
@@ -421,7 +480,7 @@ int at_parser_max_params_from_str(const char *at_params_str,
 
 	max_params_count = MIN(max_params_count, list->param_count);
 
-	err = at_parse_param(&at_params_str, list, max_params_count);
+	err = at_parse_param(&parser, &at_params_str, max_params_count);
 
 	if (next_param_str) {
 		*next_param_str = (char *)at_params_str;
@@ -430,6 +489,32 @@ int at_parser_max_params_from_str(const char *at_params_str,
 	return err;
 }
 
+int at_parser_param_views_from_str(const char *at_params_str,
+				   char **next_param_str,
+				   struct at_param_view_list *const list)
+{
+	int err = 0;
+	struct at_parser parser = {
+		.str = at_params_str,
+		.views = list,
+	};
+
+	if (at_params_str == NULL || list == NULL || list->params == NULL) {
+		return -EINVAL;
+	}
+
+	memset(list->params, 0, list->param_count * sizeof(struct at_param_view));
+	list->str = at_params_str;
+
+	err = at_parse_param(&parser, &at_params_str, list->param_count);
+
+	if (next_param_str) {
+		*next_param_str = (char *)at_params_str;
+	}
+
+	return parser.err ? parser.err : err;
+}
+
 enum at_cmd_type at_parser_cmd_type_get(const char *at_cmd)
 {
 	enum at_cmd_type type;
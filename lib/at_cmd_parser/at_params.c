@@ -13,6 +13,7 @@
 #include <zephyr/kernel.h>
 
 #include <modem/at_params.h>
+#include "at_utils.h"
 
 /* Internal function. Parameter cannot be null. */
 static void at_param_init(struct at_param *param)
@@ -437,3 +438,255 @@ enum at_param_type at_params_type_get(const struct at_param_list *list,
 
 	return param->type;
 }
+
+/* Internal function. Parameter cannot be null. */
+static struct at_param_view *at_param_views_get(const struct at_param_view_list *list,
+						size_t index)
+{
+	__ASSERT(list != NULL, "Parameter list cannot be NULL.");
+
+	if (index >= list->param_count) {
+		return NULL;
+	}
+
+	return &list->params[index];
+}
+
+/* Internal function. Get an integer parameter within the given range. */
+static int at_param_views_num_get(const struct at_param_view_list *list, size_t index,
+				  int64_t min, int64_t max, int64_t *value)
+{
+	if (list == NULL || list->params == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	struct at_param_view *param = at_param_views_get(list, index);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->type != AT_PARAM_TYPE_NUM_INT) {
+		return -EINVAL;
+	}
+
+	if ((param->int_val > max) || (param->int_val < min)) {
+		return -EINVAL;
+	}
+
+	*value = param->int_val;
+	return 0;
+}
+
+int at_param_views_init(struct at_param_view_list *list,
+			struct at_param_view *params,
+			size_t max_params_count)
+{
+	if (list == NULL || params == NULL) {
+		return -EINVAL;
+	}
+
+	memset(params, 0, max_params_count * sizeof(struct at_param_view));
+
+	list->str = NULL;
+	list->params = params;
+	list->param_count = max_params_count;
+	return 0;
+}
+
+int at_param_views_short_get(const struct at_param_view_list *list,
+			     size_t index, int16_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_param_views_num_get(list, index, INT16_MIN, INT16_MAX, &tmp);
+	if (!err) {
+		*value = (int16_t)tmp;
+	}
+
+	return err;
+}
+
+int at_param_views_unsigned_short_get(const struct at_param_view_list *list,
+				      size_t index, uint16_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_param_views_num_get(list, index, 0, UINT16_MAX, &tmp);
+	if (!err) {
+		*value = (uint16_t)tmp;
+	}
+
+	return err;
+}
+
+int at_param_views_int_get(const struct at_param_view_list *list,
+			   size_t index, int32_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_param_views_num_get(list, index, INT32_MIN, INT32_MAX, &tmp);
+	if (!err) {
+		*value = (int32_t)tmp;
+	}
+
+	return err;
+}
+
+int at_param_views_unsigned_int_get(const struct at_param_view_list *list,
+				    size_t index, uint32_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_param_views_num_get(list, index, 0, UINT32_MAX, &tmp);
+	if (!err) {
+		*value = (uint32_t)tmp;
+	}
+
+	return err;
+}
+
+int at_param_views_int64_get(const struct at_param_view_list *list,
+			     size_t index, int64_t *value)
+{
+	return at_param_views_num_get(list, index, INT64_MIN, INT64_MAX, value);
+}
+
+int at_param_views_string_ptr_get(const struct at_param_view_list *list,
+				  size_t index, const char **str, size_t *len)
+{
+	if (list == NULL || list->params == NULL || str == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	struct at_param_view *param = at_param_views_get(list, index);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->type != AT_PARAM_TYPE_STRING) {
+		return -EINVAL;
+	}
+
+	*str = list->str + param->offset;
+	*len = param->len;
+
+	return 0;
+}
+
+int at_param_views_string_get(const struct at_param_view_list *list,
+			      size_t index, char *value, size_t *len)
+{
+	const char *str;
+	size_t param_len;
+	int err;
+
+	if (value == NULL || len == NULL) {
+		return -EINVAL;
+	}
+
+	err = at_param_views_string_ptr_get(list, index, &str, &param_len);
+	if (err) {
+		return err;
+	}
+
+	if (*len < param_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, str, param_len);
+	*len = param_len;
+
+	return 0;
+}
+
+int at_param_views_array_get(const struct at_param_view_list *list,
+			     size_t index, uint32_t *array, size_t *len)
+{
+	if (list == NULL || list->params == NULL || array == NULL ||
+	    len == NULL) {
+		return -EINVAL;
+	}
+
+	struct at_param_view *param = at_param_views_get(list, index);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->type != AT_PARAM_TYPE_ARRAY) {
+		return -EINVAL;
+	}
+
+	size_t param_len = param->len * sizeof(uint32_t);
+	uint32_t tmparray[AT_CMD_MAX_ARRAY_SIZE];
+	const char *str = list->str + param->offset;
+
+	if (*len < param_len) {
+		return -ENOMEM;
+	}
+
+	/* The array is parsed again from the string, which yields the same
+	 * number of values as when the string was parsed.
+	 */
+	(void)array_parse(&str, tmparray);
+
+	memcpy(array, tmparray, param_len);
+	*len = param_len;
+
+	return 0;
+}
+
+uint32_t at_param_views_valid_count_get(const struct at_param_view_list *list)
+{
+	if (list == NULL || list->params == NULL) {
+		return -EINVAL;
+	}
+
+	size_t valid_i = 0;
+	struct at_param_view *param = at_param_views_get(list, valid_i);
+
+	while (param != NULL && param->type != AT_PARAM_TYPE_INVALID) {
+		valid_i += 1;
+		param = at_param_views_get(list, valid_i);
+	}
+
+	return valid_i;
+}
+
+enum at_param_type at_param_views_type_get(const struct at_param_view_list *list,
+					   size_t index)
+{
+	if (list == NULL || list->params == NULL) {
+		return AT_PARAM_TYPE_INVALID;
+	}
+
+	struct at_param_view *param = at_param_views_get(list, index);
+
+	if (param == NULL) {
+		return AT_PARAM_TYPE_INVALID;
+	}
+
+	return param->type;
+}
@@ -18,6 +18,7 @@
 
 #include <zephyr/types.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <ctype.h>
 
 #define AT_PARAM_SEPARATOR ','
@@ -29,6 +30,7 @@
 #define AT_STANDARD_NOTIFICATION_PREFIX '+'
 #define AT_PROP_NOTIFICATION_PREFX '%'
 #define AT_CUSTOM_COMMAND_PREFX '#'
+#define AT_CMD_MAX_ARRAY_SIZE 32
 
 /**
  * @brief Check if character is a notification start character
@@ -241,10 +243,6 @@ static inline bool is_number(char chr)
  */
 static inline bool is_command(const char *str)
 {
-	if (strlen(str) < 2) {
-		return false;
-	}
-
 	if ((toupper((int)str[0]) != 'A') || (toupper((int)str[1]) != 'T')) {
 		return false;
 	}
@@ -273,17 +271,13 @@ static inline bool is_command(const char *str)
  * @retval true  If the string is a CLAC response
  * @retval false Otherwise
  */
-static bool is_clac(const char *str)
+static inline bool is_clac(const char *str)
 {
 	/* skip leading <CR><LF>, if any, as check not from index 0 */
 	while (is_lfcr(*str)) {
 		str++;
 	}
 
-	if (strlen(str) < 4) {
-		return false;
-	}
-
 	if ((toupper(str[0]) != 'A') || (toupper(str[1]) != 'T')) {
 		/* Not an AT command */
 		return false;
@@ -294,6 +288,10 @@ static bool is_clac(const char *str)
 		return false;
 	}
 
+	if (is_terminated(str[3])) {
+		return false;
+	}
+
 	if ((toupper(str[2]) == '%') && (toupper(str[3]) == 'X')) {
 		/* Ignore AT%X to avoid false detect (read resp XCOEX0 etc.) */
 		return false;
@@ -301,6 +299,61 @@ static bool is_clac(const char *str)
 
 	return true;
 }
+
+/**
+ * @brief Parse the numbers of an array parameter
+ *
+ * Numbers are parsed until the array stop character, the end of the string or
+ * AT_CMD_MAX_ARRAY_SIZE numbers. Compound values are converted like
+ * strtoul() does, ie. 5-23 results in 5.
+ *
+ * @param[in,out] str   Pointer to the first character after the array start
+ *                      character. Returns a pointer to the character where
+ *                      parsing stopped.
+ * @param[out]    array Buffer of AT_CMD_MAX_ARRAY_SIZE numbers, or NULL to
+ *                      count the numbers only.
+ *
+ * @return Number of values in the array
+ */
+static inline size_t array_parse(const char **str, uint32_t *array)
+{
+	const char *tmpstr = *str;
+	char *next;
+	uint32_t value;
+	size_t i = 0;
+
+	value = (uint32_t)strtoul(tmpstr, &next, 10);
+	if (array) {
+		array[i] = value;
+	}
+	i++;
+	tmpstr = next;
+
+	while (!is_array_stop(*tmpstr) && !is_terminated(*tmpstr)) {
+		if (is_separator(*tmpstr)) {
+			value = (uint32_t)strtoul(++tmpstr, &next, 10);
+			if (array) {
+				array[i] = value;
+			}
+			i++;
+
+			if (next == tmpstr) {
+				break;
+			}
+
+			tmpstr = next;
+		} else {
+			tmpstr++;
+		}
+
+		if (i == AT_CMD_MAX_ARRAY_SIZE) {
+			break;
+		}
+	}
+
+	*str = tmpstr;
+	return i;
+}
 /** @} */
 
 #endif /* AT_UTILS_H__ */
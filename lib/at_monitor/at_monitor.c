@@ -7,6 +7,8 @@
 #include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/init.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/math_extras.h>
 #include <zephyr/device.h>
 #include <nrf_modem_at.h>
 #include <modem/at_monitor.h>
@@ -17,6 +19,7 @@ LOG_MODULE_REGISTER(at_monitor, CONFIG_AT_MONITOR_LOG_LEVEL);
 
 struct at_notif_fifo {
 	void *fifo_reserved;
+	uint32_t match; /* Monitors matched by the index */
 	char data[]; /* Null-terminated AT notification string */
 };
 
@@ -41,6 +44,208 @@ static bool has_match(const struct at_monitor_entry *mon, const char *notif)
 	return (mon->filter == ANY || strstr(notif, mon->filter));
 }
 
+#if defined(CONFIG_AT_MONITOR_INDEX)
+
+/* Monitors are identified by a bit in the match mask. */
+#define INDEX_MONITORS_MAX 32
+#define INDEX_ROOT 0
+
+/* The filters are kept in a trie with failure links (Aho-Corasick), so that all filters found
+ * anywhere in a notification, as with strstr(), are matched in a single pass over it.
+ * Index 0 is the root, which is never a child, so 0 also marks a missing link.
+ */
+struct index_node {
+	/* Monitors whose filter ends the text matched so far. */
+	uint32_t match;
+	uint8_t child;
+	uint8_t sibling;
+	uint8_t fail;
+	char c;
+};
+
+static struct index_node index_nodes[CONFIG_AT_MONITOR_INDEX_NODES];
+static uint8_t index_node_cnt;
+/* Monitors matching any notification. */
+static uint32_t index_any;
+static bool index_ready;
+
+static uint8_t index_child_find(uint8_t node, char c)
+{
+	uint8_t child = index_nodes[node].child;
+
+	while (child && index_nodes[child].c != c) {
+		child = index_nodes[child].sibling;
+	}
+
+	return child;
+}
+
+static uint8_t index_next(uint8_t node, char c)
+{
+	uint8_t next;
+
+	while (!(next = index_child_find(node, c)) && node != INDEX_ROOT) {
+		node = index_nodes[node].fail;
+	}
+
+	return next;
+}
+
+static int index_insert(const char *filter, uint32_t mon_bit)
+{
+	uint8_t node = INDEX_ROOT;
+	uint8_t next;
+
+	for (; *filter; filter++) {
+		next = index_child_find(node, *filter);
+		if (!next) {
+			if (index_node_cnt >= CONFIG_AT_MONITOR_INDEX_NODES) {
+				return -ENOMEM;
+			}
+
+			next = index_node_cnt++;
+			index_nodes[next] = (struct index_node) {
+				.c = *filter,
+				.sibling = index_nodes[node].child,
+			};
+			index_nodes[node].child = next;
+		}
+		node = next;
+	}
+
+	index_nodes[node].match |= mon_bit;
+
+	return 0;
+}
+
+static void index_links_resolve(void)
+{
+	uint8_t queue[CONFIG_AT_MONITOR_INDEX_NODES];
+	uint8_t head = 0;
+	uint8_t tail = 0;
+
+	for (uint8_t n = index_nodes[INDEX_ROOT].child; n; n = index_nodes[n].sibling) {
+		index_nodes[n].fail = INDEX_ROOT;
+		queue[tail++] = n;
+	}
+
+	/* Visit nodes breadth-first, so that the failure link of a node points to a node
+	 * whose match mask is already complete.
+	 */
+	while (head < tail) {
+		uint8_t node = queue[head++];
+
+		for (uint8_t n = index_nodes[node].child; n; n = index_nodes[n].sibling) {
+			index_nodes[n].fail = index_next(index_nodes[node].fail, index_nodes[n].c);
+			index_nodes[n].match |= index_nodes[index_nodes[n].fail].match;
+			queue[tail++] = n;
+		}
+	}
+}
+
+static int index_build(void)
+{
+	size_t cnt;
+	uint32_t mon_bit = BIT(0);
+	int err;
+
+	STRUCT_SECTION_COUNT(at_monitor_entry, &cnt);
+	if (cnt > INDEX_MONITORS_MAX) {
+		return -ENOMEM;
+	}
+
+	index_node_cnt = 1;
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (e->filter == ANY || e->filter[0] == '\0') {
+			index_any |= mon_bit;
+		} else {
+			err = index_insert(e->filter, mon_bit);
+			if (err) {
+				return err;
+			}
+		}
+		mon_bit <<= 1;
+	}
+
+	index_links_resolve();
+	index_ready = true;
+
+	LOG_DBG("Indexed %u monitors, %u nodes", (unsigned int)cnt, index_node_cnt);
+
+	return 0;
+}
+
+static bool index_is_ready(void)
+{
+	return index_ready;
+}
+
+static uint32_t index_match(const char *notif)
+{
+	uint32_t match = index_any;
+	uint8_t node = INDEX_ROOT;
+
+	for (; *notif; notif++) {
+		node = index_next(node, *notif);
+		match |= index_nodes[node].match;
+	}
+
+	return match;
+}
+
+static struct at_monitor_entry *index_monitor_get(uint32_t *match)
+{
+	struct at_monitor_entry *mon;
+
+	STRUCT_SECTION_GET(at_monitor_entry, u32_count_trailing_zeros(*match), &mon);
+	*match &= *match - 1;
+
+	return mon;
+}
+
+#else
+
+static int index_build(void)
+{
+	return -ENOTSUP;
+}
+
+static bool index_is_ready(void)
+{
+	return false;
+}
+
+static uint32_t index_match(const char *notif)
+{
+	return 0;
+}
+
+static struct at_monitor_entry *index_monitor_get(uint32_t *match)
+{
+	return NULL;
+}
+
+#endif /* defined(CONFIG_AT_MONITOR_INDEX) */
+
+/* Dispatch to a matching monitor in the ISR, if it is a direct monitor.
+ * Returns true if the notification must be dispatched to the monitor in the workqueue.
+ */
+static bool dispatch_isr(const struct at_monitor_entry *mon, const char *notif)
+{
+	if (is_paused(mon)) {
+		return false;
+	}
+
+	if (is_direct(mon)) {
+		LOG_DBG("Dispatching to %p (ISR)", mon->handler);
+		mon->handler(notif);
+		return false;
+	}
+
+	return true;
+}
+
 /* Dispatch AT notifications immediately, or schedules a workqueue task to do that.
  * Keep this function public so that it can be called by tests.
  * This function is called from an ISR.
@@ -48,20 +253,25 @@ static bool has_match(const struct at_monitor_entry *mon, const char *notif)
 void at_monitor_dispatch(const char *notif)
 {
 	bool monitored;
+	uint32_t match = 0;
 	struct at_notif_fifo *at_notif;
 	size_t sz_needed;
 
 	__ASSERT_NO_MSG(notif != NULL);
 
 	monitored = false;
-	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!is_paused(e) && has_match(e, notif)) {
-			if (is_direct(e)) {
-				LOG_DBG("Dispatching to %p (ISR)", e->handler);
-				e->handler(notif);
-			} else {
-				/* Copy and schedule work-queue task */
-				monitored = true;
+	if (index_is_ready()) {
+		/* The match includes paused monitors, which might be resumed
+		 * by the time the notification is dispatched in the workqueue.
+		 */
+		match = index_match(notif);
+		for (uint32_t m = match; m;) {
+			monitored |= dispatch_isr(index_monitor_get(&m), notif);
+		}
+	} else {
+		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+			if (has_match(e, notif)) {
+				monitored |= dispatch_isr(e, notif);
 			}
 		}
 	}
@@ -80,6 +290,7 @@ void at_monitor_dispatch(const char *notif)
 		return;
 	}
 
+	at_notif->match = match;
 	strcpy(at_notif->data, notif);
 
 	k_fifo_put(&at_monitor_fifo, at_notif);
@@ -93,10 +304,22 @@ static void at_monitor_task(struct k_work *work)
 	while ((at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT))) {
 		/* Match notification with all monitors */
 		LOG_DBG("AT notif: %.*s", strlen(at_notif->data) - strlen("\r\n"), at_notif->data);
-		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data)) {
-				LOG_DBG("Dispatching to %p", e->handler);
-				e->handler(at_notif->data);
+		if (index_is_ready()) {
+			/* Reuse the match from the ISR */
+			for (uint32_t m = at_notif->match; m;) {
+				struct at_monitor_entry *e = index_monitor_get(&m);
+
+				if (!is_paused(e) && !is_direct(e)) {
+					LOG_DBG("Dispatching to %p", e->handler);
+					e->handler(at_notif->data);
+				}
+			}
+		} else {
+			STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+				if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data)) {
+					LOG_DBG("Dispatching to %p", e->handler);
+					e->handler(at_notif->data);
+				}
 			}
 		}
 		k_heap_free(&at_monitor_heap, at_notif);
@@ -107,6 +330,13 @@ static int at_monitor_sys_init(void)
 {
 	int err;
 
+	if (IS_ENABLED(CONFIG_AT_MONITOR_INDEX)) {
+		err = index_build();
+		if (err) {
+			LOG_WRN("Monitor filters not indexed, err %d", err);
+		}
+	}
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
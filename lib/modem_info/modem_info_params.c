@@ -7,12 +7,186 @@
 #include <zephyr/kernel.h>
 #include <string.h>
 #include <stdlib.h>
+#include <nrf_modem_at.h>
 #include <modem/modem_info.h>
+#include <modem/at_monitor.h>
 #include <modem/at_params.h>
+#include <modem/at_cmd_parser.h>
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_REGISTER(modem_info_params);
 
+#define AT_CMD_XMONITOR		"AT%%XMONITOR"
+#define XMONITOR_RESPONSE_SIZE	256
+
+/* Format of the %XMONITOR response:
+ * %XMONITOR: <reg_status>,[<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,<cell_id>,
+ * <phys_cell_id>,<EARFCN>,<rsrp>,<snr>,<NW-provided_eDRX_value>,<Active-Time>,
+ * <Periodic-TAU-ext>,<Periodic-TAU>]
+ */
+#define XMONITOR_PARAMS_COUNT	17
+#define XMONITOR_PLMN_INDEX	4
+#define XMONITOR_TAC_INDEX	5
+#define XMONITOR_BAND_INDEX	7
+#define XMONITOR_CELL_ID_INDEX	8
+#define XMONITOR_RSRP_INDEX	11
+
+/* Number of parameters read with %XMONITOR. */
+#define XMONITOR_PARAMS_READ	5
+
+/* Protects the %XMONITOR response buffer and the cache. */
+static K_MUTEX_DEFINE(params_mutex);
+static char xmonitor_response[XMONITOR_RESPONSE_SIZE];
+
+#if defined(CONFIG_MODEM_INFO_CACHE)
+
+struct cache_entry {
+	enum modem_info type;
+	/* The value changes with the network registration. Otherwise, it does
+	 * not change while the modem is running.
+	 */
+	bool network;
+};
+
+static const struct cache_entry cache_entries[] = {
+	{ MODEM_INFO_SUP_BAND,		false },
+	{ MODEM_INFO_FW_VERSION,	false },
+	{ MODEM_INFO_ICCID,		false },
+	{ MODEM_INFO_IMSI,		false },
+	{ MODEM_INFO_IMEI,		false },
+	{ MODEM_INFO_UE_MODE,		true },
+	{ MODEM_INFO_IP_ADDRESS,	true },
+	{ MODEM_INFO_APN,		true },
+	{ MODEM_INFO_LTE_MODE,		true },
+	{ MODEM_INFO_NBIOT_MODE,	true },
+	{ MODEM_INFO_GPS_MODE,		true },
+};
+
+static struct {
+	uint16_t value;
+	char value_string[MODEM_INFO_MAX_RESPONSE_SIZE];
+} cache[ARRAY_SIZE(cache_entries)];
+
+/* Bitmask of the valid cache entries. */
+static atomic_t cache_valid;
+/* Incremented when the cache is invalidated, so that a value read from the
+ * modem during an invalidation is not stored as valid.
+ */
+static atomic_t cache_generation;
+static struct modem_info_cache_stats cache_stats;
+
+BUILD_ASSERT(ARRAY_SIZE(cache_entries) <= ATOMIC_BITS);
+
+static void cache_invalidate(bool network_only)
+{
+	atomic_val_t mask = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache_entries); i++) {
+		if (!network_only || cache_entries[i].network) {
+			mask |= BIT(i);
+		}
+	}
+
+	atomic_inc(&cache_generation);
+	atomic_and(&cache_valid, ~mask);
+}
+
+static void network_notif_handler(const char *notif)
+{
+	ARG_UNUSED(notif);
+
+	cache_invalidate(true);
+}
+
+/* Notifications that indicate a change in the network registration. */
+AT_MONITOR(modem_info_cereg_mon, "+CEREG", network_notif_handler);
+AT_MONITOR(modem_info_xmodemsleep_mon, "%XMODEMSLEEP", network_notif_handler);
+AT_MONITOR(modem_info_cgev_mon, "+CGEV", network_notif_handler);
+
+static int cache_index_get(enum modem_info type)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache_entries); i++) {
+		if (cache_entries[i].type == type) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static bool cache_get(struct lte_param *param, atomic_val_t *generation)
+{
+	int i = cache_index_get(param->type);
+
+	*generation = atomic_get(&cache_generation);
+
+	if ((i < 0) || !atomic_test_bit(&cache_valid, i)) {
+		cache_stats.misses++;
+		return false;
+	}
+
+	param->value = cache[i].value;
+	memcpy(param->value_string, cache[i].value_string, sizeof(param->value_string));
+	cache_stats.hits++;
+
+	return true;
+}
+
+static void cache_put(const struct lte_param *param, atomic_val_t generation)
+{
+	int i = cache_index_get(param->type);
+
+	if (i < 0) {
+		return;
+	}
+
+	cache[i].value = param->value;
+	memcpy(cache[i].value_string, param->value_string, sizeof(cache[i].value_string));
+
+	/* Discard the value if the cache was invalidated since it was read. */
+	if (atomic_get(&cache_generation) == generation) {
+		atomic_set_bit(&cache_valid, i);
+	}
+}
+
+static void cache_misses_add(uint32_t count)
+{
+	cache_stats.misses += count;
+}
+
+void modem_info_params_cache_invalidate(void)
+{
+	cache_invalidate(false);
+}
+
+void modem_info_params_cache_stats_get(struct modem_info_cache_stats *stats)
+{
+	if (stats == NULL) {
+		return;
+	}
+
+	k_mutex_lock(&params_mutex, K_FOREVER);
+	*stats = cache_stats;
+	k_mutex_unlock(&params_mutex);
+}
+
+#else
+
+static bool cache_get(struct lte_param *param, atomic_val_t *generation)
+{
+	return false;
+}
+
+static void cache_put(const struct lte_param *param, atomic_val_t generation)
+{
+}
+
+static void cache_misses_add(uint32_t count)
+{
+}
+
+#endif /* CONFIG_MODEM_INFO_CACHE */
+
 int modem_info_params_init(struct modem_param_info *modem)
 {
 	if (modem == NULL) {
@@ -107,8 +281,13 @@ static int cellid_to_dec(struct lte_param *cellID, double *cellID_dec)
 static int modem_data_get(struct lte_param *param)
 {
 	enum at_param_type data_type;
+	atomic_val_t generation;
 	int ret;
 
+	if (cache_get(param, &generation)) {
+		return 0;
+	}
+
 	data_type = modem_info_type_get(param->type);
 
 	if (data_type < 0) {
@@ -131,34 +310,90 @@ static int modem_data_get(struct lte_param *param)
 		}
 	}
 
+	cache_put(param, generation);
+
 	return 0;
 }
 
-int modem_info_params_get(struct modem_param_info *modem)
+static int view_string_get(const struct at_param_view_list *list, size_t index,
+			   struct lte_param *param)
+{
+	size_t len = sizeof(param->value_string) - 1;
+	int err;
+
+	err = at_param_views_string_get(list, index, param->value_string, &len);
+	if (err) {
+		return err;
+	}
+
+	param->value_string[len] = '\0';
+
+	return 0;
+}
+
+/* Read the registration dependent network parameters with a single %XMONITOR
+ * command, instead of one command per parameter.
+ */
+static int network_data_get(struct network_param *network)
 {
+	AT_PARAM_VIEW_LIST_DEFINE(list, XMONITOR_PARAMS_COUNT);
 	int ret;
 
-	if (modem == NULL) {
-		return -EINVAL;
+	ret = nrf_modem_at_cmd(xmonitor_response, sizeof(xmonitor_response), AT_CMD_XMONITOR);
+	if (ret) {
+		LOG_ERR("Link data not obtained: %d", ret);
+		return -EIO;
 	}
 
+	cache_misses_add(XMONITOR_PARAMS_READ);
+
+	/* Parameters added by newer modem firmware versions are not needed. */
+	ret = at_parser_param_views_from_str(xmonitor_response, NULL, &list);
+	if (ret && (ret != -E2BIG)) {
+		LOG_ERR("Unable to parse data: %d", ret);
+		return ret;
+	}
+
+	/* The optional parameters are only present when registered. */
+	ret = view_string_get(&list, XMONITOR_PLMN_INDEX, &network->current_operator);
+	if (!ret) {
+		ret = view_string_get(&list, XMONITOR_TAC_INDEX, &network->area_code);
+	}
+	if (!ret) {
+		ret = view_string_get(&list, XMONITOR_CELL_ID_INDEX, &network->cellid_hex);
+	}
+	if (!ret) {
+		ret = at_param_views_unsigned_short_get(&list, XMONITOR_BAND_INDEX,
+							&network->current_band.value);
+	}
+	if (!ret) {
+		ret = at_param_views_unsigned_short_get(&list, XMONITOR_RSRP_INDEX,
+							&network->rsrp.value);
+	}
+	if (ret) {
+		LOG_ERR("Link data not obtained: %d", ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+static int params_get(struct modem_param_info *modem)
+{
+	int ret;
+
 	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK) ||
 	    IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM) ||
 	    IS_ENABLED(CONFIG_MODEM_INFO_ADD_DEVICE)) {
 		struct lte_param *params[] = {
 #if IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK)
-			&modem->network.current_band,
 			&modem->network.sup_band,
 			&modem->network.ip_address,
 			&modem->network.ue_mode,
-			&modem->network.current_operator,
-			&modem->network.cellid_hex,
-			&modem->network.area_code,
 			&modem->network.lte_mode,
 			&modem->network.nbiot_mode,
 			&modem->network.gps_mode,
 			&modem->network.apn,
-			&modem->network.rsrp,
 #endif
 #if IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM_ICCID)
 			&modem->sim.iccid,
@@ -182,6 +417,11 @@ int modem_info_params_get(struct modem_param_info *modem)
 	}
 
 	if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK)) {
+		ret = network_data_get(&modem->network);
+		if (ret) {
+			return ret;
+		}
+
 		if (IS_ENABLED(CONFIG_MODEM_INFO_ADD_DATE_TIME)) {
 			ret = modem_data_get(&modem->network.date_time);
 			if (ret) {
@@ -208,3 +448,18 @@ int modem_info_params_get(struct modem_param_info *modem)
 	}
 	return 0;
 }
+
+int modem_info_params_get(struct modem_param_info *modem)
+{
+	int ret;
+
+	if (modem == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&params_mutex, K_FOREVER);
+	ret = params_get(modem);
+	k_mutex_unlock(&params_mutex);
+
+	return ret;
+}
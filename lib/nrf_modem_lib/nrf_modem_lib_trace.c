@@ -16,6 +16,8 @@
 #include <nrf_modem_trace.h>
 #include <nrf_errno.h>
 
+#include "nrf_modem_lib_trace_compress.h"
+
 LOG_MODULE_REGISTER(nrf_modem_lib_trace, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
 
 NRF_MODEM_LIB_ON_INIT(trace_init, trace_init_callback, NULL);
@@ -40,6 +42,37 @@ static uint32_t backend_bps_tot;
 static uint32_t backend_bps_samples;
 static int64_t backend_measurement_start;
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+static uint32_t compression_ratio;
+static uint32_t compression_bytes_in;
+static uint32_t compression_bytes_out;
+
+static void compression_ratio_update(void)
+{
+	uint32_t in;
+	uint32_t out;
+
+	trace_compress_bytes_get(&in, &out);
+
+	/* The counters wrap around, only their difference is meaningful. */
+	if (in != compression_bytes_in) {
+		compression_ratio = (uint64_t)(out - compression_bytes_out) * 100 /
+				    (in - compression_bytes_in);
+	} else {
+		/* Without input there is nothing to compare with */
+		compression_ratio = 0;
+	}
+
+	compression_bytes_in = in;
+	compression_bytes_out = out;
+}
+
+uint32_t nrf_modem_lib_trace_compression_ratio_get(void)
+{
+	return compression_ratio;
+}
+#endif
+
 #define BACKEND_BPS_AVG_UPDATE_PERIOD K_MSEC(CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_BITRATE_PERIOD_MS)
 
 static void backend_bps_reset(void)
@@ -69,6 +102,10 @@ static void backend_bps_avg_update(struct k_work *item)
 
 	backend_bps_reset();
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+	compression_ratio_update();
+#endif
+
 	k_work_schedule(&backend_bps_avg_update_work, BACKEND_BPS_AVG_UPDATE_PERIOD);
 }
 
@@ -118,6 +155,14 @@ static void backend_bps_log(struct k_work *item)
 {
 	LOG_INF("Trace backend bitrate (bps): %u", backend_bps_avg);
 
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+	if (compression_ratio) {
+		LOG_INF("Trace compression ratio: %u%%, trace bitrate (bps): %u",
+			compression_ratio, (uint32_t)((uint64_t)backend_bps_avg * 100 /
+						      compression_ratio));
+	}
+#endif
+
 	k_work_schedule(&backend_bps_log_work, BACKEND_BPS_LOG_PERIOD);
 }
 #endif
@@ -189,19 +234,56 @@ int nrf_modem_lib_trace_processing_done_wait(k_timeout_t timeout)
 	return 0;
 }
 
-static int trace_fragment_write(struct nrf_modem_trace_data *frag)
+static int backend_write(const void *data, size_t len)
 {
 	int ret;
-	size_t remaining = frag->len;
 
-	while (remaining) {
-		PERF_START();
+	PERF_START();
+
+	ret = trace_backend.write(data, len);
+
+	PERF_END(ret);
+
+	return ret;
+}
+
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+#define TRACE_WRITE trace_compress_write
+#define TRACE_PROCESSED_CB trace_compress_processed
+/* Write a partially filled block when the modem stops sending traces for a while. */
+#define TRACE_GET_TIMEOUT                                                                          \
+	(trace_compress_pending() ? CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_FLUSH_TIMEOUT_MS       \
+				  : NRF_MODEM_OS_FOREVER)
+
+static int trace_compress_processed(size_t len)
+{
+	/* Trace data is reported as processed once it is copied by the compression stage. */
+	ARG_UNUSED(len);
+
+	return 0;
+}
+#else
+#define TRACE_WRITE backend_write
+#define TRACE_PROCESSED_CB nrf_modem_trace_processed
+#define TRACE_GET_TIMEOUT NRF_MODEM_OS_FOREVER
+#endif
 
-		ret = trace_backend.write((void *)((uint8_t *)frag->data + frag->len - remaining),
-					  remaining);
+static int trace_flush(void)
+{
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+	return trace_compress_flush();
+#else
+	return 0;
+#endif
+}
 
-		PERF_END(ret);
+/* Write a trace fragment, starting at @p offset. On failure, @p offset is where to resume. */
+static int trace_fragment_write(struct nrf_modem_trace_data *frag, size_t *offset)
+{
+	int ret;
 
+	while (*offset < frag->len) {
+		ret = TRACE_WRITE((const uint8_t *)frag->data + *offset, frag->len - *offset);
 		if (ret < 0) {
 			LOG_ERR("trace_backend.write failed with err: %d", ret);
 
@@ -212,9 +294,24 @@ static int trace_fragment_write(struct nrf_modem_trace_data *frag)
 			LOG_WRN("trace_backend wrote 0 bytes.");
 		}
 
-		remaining -= ret;
+		*offset += ret;
+	}
+
+	return 0;
+}
+
+static int trace_backend_full(void)
+{
+	nrf_modem_lib_trace_callback(NRF_MODEM_LIB_TRACE_EVT_FULL);
+
+	if (!trace_backend.clear) {
+		return -ENOSPC;
 	}
 
+	has_space = false;
+	k_sem_give(&trace_done_sem);
+	k_sem_take(&trace_clear_sem, K_FOREVER);
+
 	return 0;
 }
 
@@ -223,17 +320,30 @@ void trace_thread_handler(void)
 	int err;
 	struct nrf_modem_trace_data *frags;
 	size_t n_frags;
+	size_t offset;
 
 trace_reset:
 	k_sem_take(&trace_sem, K_FOREVER);
 
 	while (true) {
-		err = nrf_modem_trace_get(&frags, &n_frags, NRF_MODEM_OS_FOREVER);
+		err = nrf_modem_trace_get(&frags, &n_frags, TRACE_GET_TIMEOUT);
 		switch (err) {
 		case 0:
 			/* Success */
 			UPDATE_TRACE_BYTES_RECEIVED(frags, n_frags);
 			break;
+		case -NRF_EAGAIN:
+			/* No trace data within the flush timeout */
+			err = trace_flush();
+			if (err == -ENOSPC) {
+				/* The block is written again on the next timeout */
+				err = trace_backend_full();
+			}
+
+			if (err) {
+				goto deinit;
+			}
+			continue;
 		case -NRF_ESHUTDOWN:
 			LOG_INF("Modem was turned off, no more traces");
 			goto deinit;
@@ -248,22 +358,20 @@ trace_reset:
 			goto deinit;
 		}
 
+		offset = 0;
+
 		for (int i = 0; i < n_frags; i++) {
-			err = trace_fragment_write(&frags[i]);
+			err = trace_fragment_write(&frags[i], &offset);
 			switch (err) {
 			case 0:
+				offset = 0;
 				break;
 			case -ENOSPC:
-				nrf_modem_lib_trace_callback(NRF_MODEM_LIB_TRACE_EVT_FULL);
-
-				if (!trace_backend.clear) {
+				if (trace_backend_full()) {
 					goto deinit;
 				}
 
-				has_space = false;
-				k_sem_give(&trace_done_sem);
-				k_sem_take(&trace_clear_sem, K_FOREVER);
-				/* Try the same fragment again */
+				/* Try the rest of the same fragment again */
 				i--;
 				continue;
 			default:
@@ -274,6 +382,11 @@ trace_reset:
 	}
 
 deinit:
+	err = trace_flush();
+	if (err) {
+		LOG_ERR("Failed to write buffered traces, err: %d", err);
+	}
+
 	err = trace_deinit();
 	if (err) {
 		LOG_ERR("trace_deinit failed with err: %d", err);
@@ -293,7 +406,11 @@ static int trace_init(void)
 
 	k_sem_take(&trace_done_sem, K_FOREVER);
 
-	err = trace_backend.init(nrf_modem_trace_processed);
+#if CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION
+	trace_compress_init(backend_write);
+#endif
+
+	err = trace_backend.init(TRACE_PROCESSED_CB);
 	if (err) {
 		LOG_ERR("trace_backend: init failed with err: %d", err);
 		return err;
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <nrf_modem_trace.h>
+
+#include "nrf_modem_lib_trace_compress.h"
+
+LOG_MODULE_DECLARE(nrf_modem_lib_trace, CONFIG_NRF_MODEM_LIB_LOG_LEVEL);
+
+#define BLOCK_SIZE CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_BLOCK_SIZE
+#define WRITE_ALIGN CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_WRITE_ALIGN
+#define HASH_BITS CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_HASH_BITS
+
+BUILD_ASSERT(IS_POWER_OF_TWO(WRITE_ALIGN), "Write alignment must be a power of two");
+BUILD_ASSERT(BLOCK_SIZE <= UINT16_MAX, "Block length must fit the block header");
+
+/* LZ4 block format constraints. */
+#define MIN_MATCH 4
+#define LAST_LITERALS 5
+#define MF_LIMIT 12
+#define RUN_MASK 15
+#define SKIP_TRIGGER 6
+
+/* Block header:
+ * [0..1] magic
+ * [2]    flags, TRACE_COMPRESS_FLAG_*
+ * [3]    reserved, zero
+ * [4..5] trace data length, little-endian
+ * [6..7] block data length, little-endian
+ */
+#define HDR_FLAGS_POS 2
+#define HDR_RAW_LEN_POS 4
+#define HDR_DATA_LEN_POS 6
+
+static uint8_t raw_buf[BLOCK_SIZE];
+static size_t raw_len;
+
+/* Compressed block, sent to the backend. Data which does not compress is stored as is. */
+static uint8_t out_buf[ROUND_UP(TRACE_COMPRESS_HDR_SIZE + BLOCK_SIZE, WRITE_ALIGN)] __aligned(4);
+static size_t out_len;
+static size_t out_written;
+
+/* Positions in raw_buf, indexed by the hash of the four bytes at that position. */
+static uint16_t hash_table[1 << HASH_BITS];
+
+static trace_compress_write_t backend_write;
+static uint32_t bytes_in;
+static uint32_t bytes_out;
+
+static inline uint32_t hash(uint32_t seq)
+{
+	return (seq * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static uint8_t *length_put(uint8_t *op, size_t len)
+{
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = len;
+
+	return op;
+}
+
+/* Encode a sequence of literals followed by a match, or only literals when match_len is 0. */
+static uint8_t *sequence_put(uint8_t *op, const uint8_t *oend, const uint8_t *lit, size_t lit_len,
+			     uint16_t offset, size_t match_len)
+{
+	size_t ml = match_len ? match_len - MIN_MATCH : 0;
+
+	/* Token, literal length, literals, offset and match length. */
+	if (op + 1 + lit_len / 255 + 1 + lit_len + 2 + ml / 255 + 1 > oend) {
+		return NULL;
+	}
+
+	*op++ = (MIN(lit_len, RUN_MASK) << 4) | MIN(ml, RUN_MASK);
+
+	if (lit_len >= RUN_MASK) {
+		op = length_put(op, lit_len - RUN_MASK);
+	}
+
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+
+	if (!match_len) {
+		return op;
+	}
+
+	sys_put_le16(offset, op);
+	op += 2;
+
+	if (ml >= RUN_MASK) {
+		op = length_put(op, ml - RUN_MASK);
+	}
+
+	return op;
+}
+
+/* Compress src into dst in LZ4 block format.
+ * Returns the compressed length, or 0 if it would not fit in dst.
+ */
+static size_t lz_compress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap)
+{
+	const uint8_t *const iend = src + src_len;
+	const uint8_t *const match_limit = iend - LAST_LITERALS;
+	const uint8_t *ip = src;
+	const uint8_t *anchor = src;
+	const uint8_t *oend = dst + dst_cap;
+	uint8_t *op = dst;
+	uint32_t attempts = 1 << SKIP_TRIGGER;
+
+	memset(hash_table, 0, sizeof(hash_table));
+
+	while (src_len > MF_LIMIT && ip < iend - MF_LIMIT) {
+		uint32_t seq = sys_get_le32(ip);
+		uint32_t h = hash(seq);
+		const uint8_t *ref = src + hash_table[h];
+		const uint8_t *mp;
+		const uint8_t *rp;
+
+		hash_table[h] = ip - src;
+
+		if (ref >= ip || sys_get_le32(ref) != seq) {
+			/* Skip faster through data that does not compress. */
+			ip += attempts++ >> SKIP_TRIGGER;
+			continue;
+		}
+
+		attempts = 1 << SKIP_TRIGGER;
+
+		while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+			ip--;
+			ref--;
+		}
+
+		mp = ip + MIN_MATCH;
+		rp = ref + MIN_MATCH;
+
+		while (mp < match_limit && *mp == *rp) {
+			mp++;
+			rp++;
+		}
+
+		op = sequence_put(op, oend, anchor, ip - anchor, ip - ref, mp - ip);
+		if (!op) {
+			return 0;
+		}
+
+		ip = mp;
+		anchor = ip;
+	}
+
+	op = sequence_put(op, oend, anchor, iend - anchor, 0, 0);
+	if (!op) {
+		return 0;
+	}
+
+	return op - dst;
+}
+
+static void block_encode(void)
+{
+	uint8_t *data = &out_buf[TRACE_COMPRESS_HDR_SIZE];
+	uint8_t flags = LOG2(WRITE_ALIGN) << TRACE_COMPRESS_FLAG_ALIGN_POS;
+	size_t data_len;
+
+	/* Only keep the compressed data if it is smaller than the trace data. */
+	data_len = lz_compress(raw_buf, raw_len, data, raw_len - 1);
+	if (!data_len) {
+		memcpy(data, raw_buf, raw_len);
+		data_len = raw_len;
+		flags |= TRACE_COMPRESS_FLAG_STORED;
+	}
+
+	out_buf[0] = TRACE_COMPRESS_MAGIC_0;
+	out_buf[1] = TRACE_COMPRESS_MAGIC_1;
+	out_buf[HDR_FLAGS_POS] = flags;
+	out_buf[HDR_FLAGS_POS + 1] = 0;
+	sys_put_le16(raw_len, &out_buf[HDR_RAW_LEN_POS]);
+	sys_put_le16(data_len, &out_buf[HDR_DATA_LEN_POS]);
+
+	out_len = TRACE_COMPRESS_HDR_SIZE + data_len;
+	memset(&out_buf[out_len], 0, ROUND_UP(out_len, WRITE_ALIGN) - out_len);
+	out_len = ROUND_UP(out_len, WRITE_ALIGN);
+	out_written = 0;
+
+	raw_len = 0;
+}
+
+static int block_write(void)
+{
+	int ret;
+
+	while (out_written < out_len) {
+		ret = backend_write(&out_buf[out_written], out_len - out_written);
+		if (ret < 0) {
+			return ret;
+		}
+
+		out_written += ret;
+		bytes_out += ret;
+	}
+
+	out_len = 0;
+	out_written = 0;
+
+	return 0;
+}
+
+void trace_compress_init(trace_compress_write_t write)
+{
+	backend_write = write;
+	raw_len = 0;
+	out_len = 0;
+	out_written = 0;
+}
+
+int trace_compress_write(const void *data, size_t len)
+{
+	int err;
+
+	/* Finish writing the previous block first. */
+	if (out_len) {
+		err = block_write();
+		if (err) {
+			return err;
+		}
+	}
+
+	if (raw_len == sizeof(raw_buf)) {
+		block_encode();
+
+		err = block_write();
+		if (err) {
+			return err;
+		}
+	}
+
+	len = MIN(len, sizeof(raw_buf) - raw_len);
+	memcpy(&raw_buf[raw_len], data, len);
+	raw_len += len;
+	bytes_in += len;
+
+	/* The data is copied, so the modem can reuse the trace memory. */
+	err = nrf_modem_trace_processed(len);
+	if (err) {
+		LOG_ERR("nrf_modem_trace_processed failed with err: %d", err);
+	}
+
+	return len;
+}
+
+int trace_compress_flush(void)
+{
+	if (!out_len && raw_len) {
+		block_encode();
+	}
+
+	if (!out_len) {
+		return 0;
+	}
+
+	return block_write();
+}
+
+bool trace_compress_pending(void)
+{
+	return raw_len || out_len;
+}
+
+void trace_compress_bytes_get(uint32_t *in, uint32_t *out)
+{
+	*in = bytes_in;
+	*out = bytes_out;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_MODEM_LIB_TRACE_COMPRESS_H__
+#define NRF_MODEM_LIB_TRACE_COMPRESS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Trace blocks are written to the backend as a header followed by the block data.
+ * The block data is LZ4 block format, or the trace data itself when it does not compress.
+ * Blocks are padded to a multiple of the write alignment. See
+ * scripts/modem_trace_decompress.py for a decoder.
+ */
+#define TRACE_COMPRESS_MAGIC_0 0x4D
+#define TRACE_COMPRESS_MAGIC_1 0x54
+#define TRACE_COMPRESS_HDR_SIZE 8
+
+/* Block data is stored without compression. */
+#define TRACE_COMPRESS_FLAG_STORED BIT(0)
+/* Position of the log2 of the write alignment in the flags. */
+#define TRACE_COMPRESS_FLAG_ALIGN_POS 4
+
+/** @brief Write function of the trace backend. */
+typedef int (*trace_compress_write_t)(const void *data, size_t len);
+
+/**
+ * @brief Initialize the compression stage and drop any buffered trace data.
+ *
+ * @param write Function writing compressed blocks to the trace backend.
+ */
+void trace_compress_init(trace_compress_write_t write);
+
+/**
+ * @brief Buffer trace data for compression.
+ *
+ * The data is copied into the current block and reported as processed to the Modem library.
+ * A block is compressed and written to the backend once it is full.
+ *
+ * @param data Trace data.
+ * @param len Length of the trace data.
+ *
+ * @return Number of bytes buffered, or a negative error code returned by the backend.
+ *         The same data must be passed again after an error.
+ */
+int trace_compress_write(const void *data, size_t len);
+
+/**
+ * @brief Compress and write the current block, even if it is not full.
+ *
+ * @return 0 on success, or a negative error code returned by the backend.
+ */
+int trace_compress_flush(void);
+
+/** @brief Check whether trace data is waiting in the compression stage. */
+bool trace_compress_pending(void);
+
+/**
+ * @brief Get the number of bytes that entered and left the compression stage.
+ *
+ * The counters wrap around, use the difference between two readings.
+ *
+ * @param in Number of trace data bytes buffered.
+ * @param out Number of bytes written to the backend, including block headers.
+ */
+void trace_compress_bytes_get(uint32_t *in, uint32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_MODEM_LIB_TRACE_COMPRESS_H__ */
@@ -123,6 +123,7 @@ static bool data_cb(struct bt_data *data, void *user_data)
 				sys_le32_to_cpu(recv_mfg_data->rng_seed) + scanner_random_share;
 			req.start_delay_us = 0;
 			req.extra_window_time_us = 0;
+			req.priority = 0;
 
 			dm_request_add(&req);
 		}
@@ -187,6 +188,7 @@ static void adv_scanned_cb(struct bt_le_ext_adv *adv,
 		req.rng_seed = peer_rng_seed_get() + scanner_addr_to_random_share(&info->addr->a);
 		req.start_delay_us = 0;
 		req.extra_window_time_us = 0;
+		req.priority = 0;
 
 		dm_request_add(&req);
 		adv_update_data();
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+"""
+Decompress modem traces captured with CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION.
+
+The trace backend receives a sequence of blocks, each made of an 8-byte header
+followed by the block data and padding up to the write alignment:
+
+  [0..1] magic, 0x4D 0x54
+  [2]    flags: bit 0 set if the data is not compressed,
+                bits 4-7 log2 of the write alignment
+  [3]    reserved, zero
+  [4..5] trace data length, little-endian
+  [6..7] block data length, little-endian
+
+Compressed block data uses the LZ4 block format. Bytes which do not form a
+valid block, for example when a UART capture starts in the middle of a block,
+are skipped.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'\x4d\x54'
+HDR = struct.Struct('<2sBBHH')
+FLAG_STORED = 0x01
+FLAG_ALIGN_POS = 4
+
+
+class DecodeError(Exception):
+    pass
+
+
+def lz4_block_decompress(src, raw_len):
+    dst = bytearray()
+    pos = 0
+
+    while pos < len(src):
+        token = src[pos]
+        pos += 1
+
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                if pos >= len(src):
+                    raise DecodeError('truncated literal length')
+                b = src[pos]
+                pos += 1
+                lit_len += b
+                if b != 255:
+                    break
+
+        if pos + lit_len > len(src):
+            raise DecodeError('truncated literals')
+        dst += src[pos:pos + lit_len]
+        pos += lit_len
+
+        # The last sequence has literals only.
+        if pos == len(src):
+            break
+
+        if pos + 2 > len(src):
+            raise DecodeError('truncated offset')
+        offset = src[pos] | (src[pos + 1] << 8)
+        pos += 2
+        if offset == 0 or offset > len(dst):
+            raise DecodeError('invalid offset {}'.format(offset))
+
+        match_len = token & 0x0f
+        if match_len == 15:
+            while True:
+                if pos >= len(src):
+                    raise DecodeError('truncated match length')
+                b = src[pos]
+                pos += 1
+                match_len += b
+                if b != 255:
+                    break
+        match_len += 4
+
+        # Matches may overlap the data they produce.
+        start = len(dst) - offset
+        for i in range(match_len):
+            dst.append(dst[start + i])
+
+    if len(dst) != raw_len:
+        raise DecodeError('length {} does not match header {}'.format(len(dst), raw_len))
+
+    return bytes(dst)
+
+
+def decompress(data, stats):
+    out = bytearray()
+    pos = 0
+
+    while pos + HDR.size <= len(data):
+        magic, flags, reserved, raw_len, data_len = HDR.unpack_from(data, pos)
+        end = pos + HDR.size + data_len
+
+        if magic != MAGIC or reserved != 0 or end > len(data):
+            stats['skipped'] += 1
+            pos += 1
+            continue
+
+        block = data[pos + HDR.size:end]
+
+        try:
+            if flags & FLAG_STORED:
+                if data_len != raw_len:
+                    raise DecodeError('stored block length mismatch')
+                out += block
+            else:
+                out += lz4_block_decompress(block, raw_len)
+        except DecodeError as e:
+            print('Invalid block at offset {}: {}'.format(pos, e), file=sys.stderr)
+            stats['skipped'] += 1
+            pos += 1
+            continue
+
+        align = 1 << (flags >> FLAG_ALIGN_POS)
+        stats['blocks'] += 1
+        stats['in'] += raw_len
+        stats['out'] += HDR.size + data_len
+        pos = end + (-(HDR.size + data_len) % align)
+
+    stats['skipped'] += len(data) - min(pos, len(data))
+
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='Compressed trace file, - for stdin')
+    parser.add_argument('output', help='Decompressed trace file, - for stdout')
+    parser.add_argument('-s', '--stats', action='store_true',
+                        help='Print compression statistics to stderr')
+    args = parser.parse_args()
+
+    if args.input == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+
+    stats = {'blocks': 0, 'in': 0, 'out': 0, 'skipped': 0}
+    out = decompress(data, stats)
+
+    if args.output == '-':
+        sys.stdout.buffer.write(out)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(out)
+
+    if args.stats:
+        ratio = 100 * stats['out'] / stats['in'] if stats['in'] else 0
+        print('Blocks: {}, trace data: {} bytes, compressed: {} bytes ({:.1f}%), '
+              'skipped: {} bytes'.format(stats['blocks'], stats['in'], stats['out'], ratio,
+                                         stats['skipped']), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -5,8 +5,12 @@
  */
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/net/buf.h>
+#include <zephyr/settings/settings.h>
 
 #include <bluetooth/gatt_dm.h>
 
@@ -22,6 +26,22 @@ LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 BUILD_ASSERT(sizeof(struct bt_gatt_service_val) % DATA_ALIGN == 0);
 BUILD_ASSERT(sizeof(struct bt_gatt_chrc) % DATA_ALIGN == 0);
 
+#define DB_HASH_LEN 16
+
+#define CACHE_KEY_PREFIX "bt_dm"
+/* Prefix, peer address, service UUID and start handle, all in hex. */
+#define CACHE_KEY_LEN (sizeof(CACHE_KEY_PREFIX "/") + 2 * sizeof(bt_addr_le_t) + \
+		       1 + 2 * BT_UUID_SIZE_128 + 4)
+
+/* Largest cache record: attribute handle, permissions and UUID, followed by
+ * the service or characteristic value.
+ */
+#define CACHE_UUID_MAX_LEN (1 + BT_UUID_SIZE_128)
+#define CACHE_RECORD_MAX_LEN (2 * (sizeof(uint16_t) + sizeof(uint16_t) + CACHE_UUID_MAX_LEN))
+
+/* Number of cache entries of a peer deleted in one settings load. */
+#define CACHE_DELETE_KEYS_MAX 8
+
 /* Flags for parsed attribute array state */
 enum {
 	STATE_ATTRS_LOCKED,
@@ -54,7 +74,7 @@ struct bt_gatt_dm {
 	ATOMIC_DEFINE(state_flags, STATE_NUM);
 
 	/* The UUID of the service to discover. */
-	union {
+	union uuid_storage {
 		struct bt_uuid uuid;
 		struct bt_uuid_16 u16;
 		struct bt_uuid_32 u32;
@@ -71,10 +91,32 @@ struct bt_gatt_dm {
 
 	/* Indicates that services should be searched by the UUID. */
 	bool search_svc_by_uuid;
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	/* Parameters used to read the Database Hash of the peer */
+	struct bt_gatt_read_params read_params;
+	/* Database Hash of the peer */
+	uint8_t db_hash[DB_HASH_LEN];
+	/* Indicates that db_hash was read from the peer. */
+	bool db_hash_valid;
+	/* Indicates that the current service was restored from the cache. */
+	bool cache_hit;
+	/* Start handle of the current service search, part of the cache key. */
+	uint16_t search_start_handle;
+	/* Restores the service from the cache outside of the API calls. */
+	struct k_work cache_work;
+#endif
 };
 
-/* Currently only one instance is supported */
-static struct bt_gatt_dm bt_gatt_dm_inst;
+/* One instance per simultaneous discovery procedure */
+static struct bt_gatt_dm bt_gatt_dm_inst[CONFIG_BT_GATT_DM_MAX_INSTANCES];
+/* Protects the allocation of instances to connections */
+static struct k_spinlock dm_lock;
+
+static int discovery_start(struct bt_gatt_dm *dm);
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+static void cache_work_handler(struct k_work *work);
+#endif
 
 /* Returns pointer to newly allocated space in a dm->data_chunk */
 static void *user_data_alloc(struct bt_gatt_dm *dm,
@@ -247,9 +289,463 @@ static struct bt_gatt_dm_attr *attr_find_by_handle(
 	return NULL;
 }
 
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+
+/* Shared by all instances. The cache is stored from the Bluetooth RX thread
+ * and restored from the thread that calls bt_gatt_dm_start() or
+ * bt_gatt_dm_continue(), so the buffer is protected by cache_lock.
+ */
+static uint8_t cache_buf[CONFIG_BT_GATT_DM_CACHE_SIZE];
+static K_MUTEX_DEFINE(cache_lock);
+
+static bool peer_bonded(struct bt_conn *conn)
+{
+	struct bt_conn_info info;
+
+	if (bt_conn_get_info(conn, &info) || info.type != BT_CONN_TYPE_LE) {
+		return false;
+	}
+
+	return bt_addr_le_is_bonded(info.id, info.le.dst);
+}
+
+static int cache_peer_key_get(const bt_addr_le_t *addr, char *key, size_t len)
+{
+	char addr_str[2 * sizeof(*addr) + 1];
+	int ret;
+
+	bin2hex((const uint8_t *)addr, sizeof(*addr), addr_str, sizeof(addr_str));
+
+	ret = snprintf(key, len, CACHE_KEY_PREFIX "/%s", addr_str);
+	if (ret < 0 || ret >= len) {
+		return -ENOMEM;
+	}
+
+	return ret;
+}
+
+static int cache_key_get(const struct bt_gatt_dm *dm, char *key, size_t len)
+{
+	char uuid_str[2 * BT_UUID_SIZE_128 + 1] = "0";
+	int pos;
+	int ret;
+
+	pos = cache_peer_key_get(bt_conn_get_dst(dm->conn), key, len);
+	if (pos < 0) {
+		return pos;
+	}
+
+	if (dm->search_svc_by_uuid) {
+		switch (dm->svc_uuid.uuid.type) {
+		case BT_UUID_TYPE_16:
+			bin2hex((const uint8_t *)&dm->svc_uuid.u16.val, sizeof(dm->svc_uuid.u16.val),
+				uuid_str, sizeof(uuid_str));
+			break;
+		case BT_UUID_TYPE_32:
+			bin2hex((const uint8_t *)&dm->svc_uuid.u32.val, sizeof(dm->svc_uuid.u32.val),
+				uuid_str, sizeof(uuid_str));
+			break;
+		case BT_UUID_TYPE_128:
+			bin2hex(dm->svc_uuid.u128.val, sizeof(dm->svc_uuid.u128.val),
+				uuid_str, sizeof(uuid_str));
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	ret = snprintf(&key[pos], len - pos, "/%s%04x", uuid_str, dm->search_start_handle);
+	if (ret < 0 || ret >= len - pos) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void cache_uuid_encode(struct net_buf_simple *buf, const struct bt_uuid *uuid)
+{
+	net_buf_simple_add_u8(buf, uuid->type);
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		net_buf_simple_add_le16(buf, BT_UUID_16(uuid)->val);
+		break;
+	case BT_UUID_TYPE_32:
+		net_buf_simple_add_le32(buf, BT_UUID_32(uuid)->val);
+		break;
+	case BT_UUID_TYPE_128:
+		net_buf_simple_add_mem(buf, BT_UUID_128(uuid)->val, BT_UUID_SIZE_128);
+		break;
+	}
+}
+
+static int cache_uuid_decode(struct net_buf_simple *buf, union uuid_storage *uuid)
+{
+	if (buf->len < 1) {
+		return -EINVAL;
+	}
+
+	uuid->uuid.type = net_buf_simple_pull_u8(buf);
+
+	switch (uuid->uuid.type) {
+	case BT_UUID_TYPE_16:
+		if (buf->len < BT_UUID_SIZE_16) {
+			return -EINVAL;
+		}
+		uuid->u16.val = net_buf_simple_pull_le16(buf);
+		return 0;
+	case BT_UUID_TYPE_32:
+		if (buf->len < BT_UUID_SIZE_32) {
+			return -EINVAL;
+		}
+		uuid->u32.val = net_buf_simple_pull_le32(buf);
+		return 0;
+	case BT_UUID_TYPE_128:
+		if (buf->len < BT_UUID_SIZE_128) {
+			return -EINVAL;
+		}
+		memcpy(uuid->u128.val, net_buf_simple_pull_mem(buf, BT_UUID_SIZE_128),
+		       BT_UUID_SIZE_128);
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+/** @brief Store the discovered service in the cache.
+ *
+ * The record starts with the Database Hash of the peer, followed by
+ * one entry per attribute: handle, permissions and UUID, and for service
+ * and characteristic declarations also their value.
+ */
+static void cache_store(struct bt_gatt_dm *dm)
+{
+	struct net_buf_simple buf;
+	char key[CACHE_KEY_LEN];
+	int err;
+
+	err = cache_key_get(dm, key, sizeof(key));
+	if (err) {
+		LOG_WRN("Unable to create cache key (err %d)", err);
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	net_buf_simple_init_with_data(&buf, cache_buf, sizeof(cache_buf));
+	net_buf_simple_reset(&buf);
+	net_buf_simple_add_mem(&buf, dm->db_hash, DB_HASH_LEN);
+
+	for (size_t i = 0; i < dm->cur_attr_id; i++) {
+		const struct bt_gatt_dm_attr *attr = &dm->attrs[i];
+		const struct bt_gatt_service_val *service_val;
+		const struct bt_gatt_chrc *chrc;
+
+		if (net_buf_simple_tailroom(&buf) < CACHE_RECORD_MAX_LEN) {
+			LOG_DBG("Service too large for the cache");
+			k_mutex_unlock(&cache_lock);
+			return;
+		}
+
+		net_buf_simple_add_le16(&buf, attr->handle);
+		net_buf_simple_add_le16(&buf, attr->perm);
+		cache_uuid_encode(&buf, attr->uuid);
+
+		service_val = bt_gatt_dm_attr_service_val(attr);
+		if (service_val) {
+			net_buf_simple_add_le16(&buf, service_val->end_handle);
+			cache_uuid_encode(&buf, service_val->uuid);
+			continue;
+		}
+
+		chrc = bt_gatt_dm_attr_chrc_val(attr);
+		if (chrc) {
+			net_buf_simple_add_le16(&buf, chrc->value_handle);
+			net_buf_simple_add_le16(&buf, chrc->properties);
+			cache_uuid_encode(&buf, chrc->uuid);
+		}
+	}
+
+	err = settings_save_one(key, buf.data, buf.len);
+	if (err) {
+		LOG_WRN("Unable to store discovery cache (err %d)", err);
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+static int cache_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			 void *cb_arg, void *param)
+{
+	ssize_t *loaded = param;
+
+	/* Only the exact key is of interest. */
+	if (key && *key != '\0') {
+		return 0;
+	}
+
+	*loaded = read_cb(cb_arg, cache_buf, sizeof(cache_buf));
+
+	return 0;
+}
+
+static int cache_attr_restore(struct bt_gatt_dm *dm, struct net_buf_simple *buf)
+{
+	union uuid_storage uuid;
+	union uuid_storage val_uuid;
+	struct bt_gatt_attr attr = {
+		.uuid = &uuid.uuid,
+	};
+	struct bt_gatt_dm_attr *cur_attr;
+	struct bt_gatt_service_val *service_val;
+	struct bt_gatt_chrc *chrc;
+
+	if (buf->len < 2 * sizeof(uint16_t)) {
+		return -EINVAL;
+	}
+
+	attr.handle = net_buf_simple_pull_le16(buf);
+	attr.perm = net_buf_simple_pull_le16(buf);
+
+	if (cache_uuid_decode(buf, &uuid)) {
+		return -EINVAL;
+	}
+
+	if (!bt_uuid_cmp(attr.uuid, BT_UUID_GATT_PRIMARY) ||
+	    !bt_uuid_cmp(attr.uuid, BT_UUID_GATT_SECONDARY)) {
+		if (buf->len < sizeof(uint16_t)) {
+			return -EINVAL;
+		}
+
+		cur_attr = attr_store(dm, &attr, sizeof(*service_val));
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+
+		service_val = bt_gatt_dm_attr_service_val(cur_attr);
+		service_val->end_handle = net_buf_simple_pull_le16(buf);
+
+		if (cache_uuid_decode(buf, &val_uuid)) {
+			return -EINVAL;
+		}
+
+		service_val->uuid = uuid_store(dm, &val_uuid.uuid);
+		if (!service_val->uuid) {
+			return -ENOMEM;
+		}
+
+		dm->discover_params.end_handle = service_val->end_handle;
+	} else if (!bt_uuid_cmp(attr.uuid, BT_UUID_GATT_CHRC)) {
+		if (buf->len < 2 * sizeof(uint16_t)) {
+			return -EINVAL;
+		}
+
+		cur_attr = attr_store(dm, &attr, sizeof(*chrc));
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+
+		chrc = bt_gatt_dm_attr_chrc_val(cur_attr);
+		chrc->value_handle = net_buf_simple_pull_le16(buf);
+		chrc->properties = net_buf_simple_pull_le16(buf);
+
+		if (cache_uuid_decode(buf, &val_uuid)) {
+			return -EINVAL;
+		}
+
+		chrc->uuid = uuid_store(dm, &val_uuid.uuid);
+		if (!chrc->uuid) {
+			return -ENOMEM;
+		}
+	} else {
+		cur_attr = attr_store(dm, &attr, 0);
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+
+/** @brief Restore the service from the cache.
+ *
+ * @retval 0 If the service was restored.
+ * @retval -ENOENT If there is no valid cache entry for the service.
+ *         Otherwise, a (negative) error code is returned.
+ */
+static int cache_restore(struct bt_gatt_dm *dm)
+{
+	struct net_buf_simple buf;
+	char key[CACHE_KEY_LEN];
+	ssize_t len = 0;
+	int err;
+
+	if (!dm->db_hash_valid) {
+		return -ENOENT;
+	}
+
+	err = cache_key_get(dm, key, sizeof(key));
+	if (err) {
+		return err;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	err = settings_load_subtree_direct(key, cache_load_cb, &len);
+	if (err) {
+		goto unlock;
+	}
+
+	if (len < DB_HASH_LEN || memcmp(cache_buf, dm->db_hash, DB_HASH_LEN)) {
+		err = -ENOENT;
+		goto unlock;
+	}
+
+	net_buf_simple_init_with_data(&buf, &cache_buf[DB_HASH_LEN], len - DB_HASH_LEN);
+
+	while (buf.len) {
+		err = cache_attr_restore(dm, &buf);
+		if (err) {
+			LOG_WRN("Invalid discovery cache entry (err %d)", err);
+			svc_attr_memory_release(dm);
+			goto unlock;
+		}
+	}
+
+	dm->discover_params.uuid = NULL;
+	dm->cache_hit = true;
+
+unlock:
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+static uint8_t db_hash_read_cb(struct bt_conn *conn, uint8_t err,
+			       struct bt_gatt_read_params *params,
+			       const void *data, uint16_t length)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm, read_params);
+	int ret;
+
+	if (!err && data && length == DB_HASH_LEN) {
+		memcpy(dm->db_hash, data, DB_HASH_LEN);
+		dm->db_hash_valid = true;
+	} else {
+		/* Without the Database Hash the cache can not be validated,
+		 * proceed with a regular discovery.
+		 */
+		LOG_DBG("Database Hash not available (err %u)", err);
+	}
+
+	ret = discovery_start(dm);
+	if (ret) {
+		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
+		if (dm->callback->error_found) {
+			dm->callback->error_found(dm->conn, ret, dm->context);
+		}
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+static int db_hash_read(struct bt_gatt_dm *dm)
+{
+	dm->read_params.func = db_hash_read_cb;
+	dm->read_params.handle_count = 0;
+	dm->read_params.by_uuid.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+	dm->read_params.by_uuid.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+	dm->read_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+
+	return bt_gatt_read(dm->conn, &dm->read_params);
+}
+
+/* Keys of the peer cache entries, collected while the settings are loaded.
+ * The entries are deleted after the load returns, as the settings must not
+ * be modified from the load callback.
+ */
+struct cache_peer_keys {
+	const char *peer_key;
+	size_t cnt;
+	char key[CACHE_DELETE_KEYS_MAX][CACHE_KEY_LEN];
+};
+
+static int cache_peer_collect_cb(const char *key, size_t len, settings_read_cb read_cb,
+				 void *cb_arg, void *param)
+{
+	struct cache_peer_keys *keys = param;
+	int ret;
+
+	if (!key || keys->cnt >= ARRAY_SIZE(keys->key)) {
+		/* The remaining entries are collected in the next load. */
+		return 0;
+	}
+
+	ret = snprintf(keys->key[keys->cnt], sizeof(keys->key[0]), "%s/%s",
+		       keys->peer_key, key);
+	if (ret > 0 && ret < sizeof(keys->key[0])) {
+		keys->cnt++;
+	}
+
+	return 0;
+}
+
+static void bond_deleted(uint8_t id, const bt_addr_le_t *peer)
+{
+	/* Too large for the stack of the calling thread, protected by cache_lock. */
+	static struct cache_peer_keys keys;
+	char peer_key[CACHE_KEY_LEN];
+	int err;
+
+	if (cache_peer_key_get(peer, peer_key, sizeof(peer_key)) < 0) {
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	keys.peer_key = peer_key;
+
+	do {
+		keys.cnt = 0;
+
+		err = settings_load_subtree_direct(peer_key, cache_peer_collect_cb, &keys);
+		for (size_t i = 0; !err && i < keys.cnt; i++) {
+			err = settings_delete(keys.key[i]);
+		}
+	} while (!err && keys.cnt == ARRAY_SIZE(keys.key));
+
+	k_mutex_unlock(&cache_lock);
+
+	if (err) {
+		LOG_WRN("Unable to delete discovery cache (err %d)", err);
+	}
+}
+
+static struct bt_conn_auth_info_cb cache_auth_info_cb = {
+	.bond_deleted = bond_deleted,
+};
+
+static int cache_init(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		k_work_init(&bt_gatt_dm_inst[i].cache_work, cache_work_handler);
+	}
+
+	return bt_conn_auth_info_cb_register(&cache_auth_info_cb);
+}
+
+SYS_INIT(cache_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
 static void discovery_complete(struct bt_gatt_dm *dm)
 {
 	LOG_DBG("Discovery complete.");
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	if (dm->db_hash_valid && !dm->cache_hit) {
+		cache_store(dm);
+	}
+#endif
 	atomic_set_bit(dm->state_flags, STATE_ATTRS_RELEASE_PENDING);
 	if (dm->callback->completed) {
 		dm->callback->completed(dm, dm->context);
@@ -443,28 +939,27 @@ static uint8_t discovery_callback(struct bt_conn *conn,
 		LOG_DBG("Attr: handle %u", attr->handle);
 	}
 
-	if (conn != bt_gatt_dm_inst.conn) {
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm,
+					     discover_params);
+
+	if (conn != dm->conn) {
 		LOG_ERR("Unexpected conn object. Aborting.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EFAULT);
+		discovery_complete_error(dm, -EFAULT);
 		return BT_GATT_ITER_STOP;
 	}
 
 	switch (params->type) {
 	case BT_GATT_DISCOVER_PRIMARY:
 	case BT_GATT_DISCOVER_SECONDARY:
-		return discovery_process_service(&bt_gatt_dm_inst,
-						 attr, params);
+		return discovery_process_service(dm, attr, params);
 	case BT_GATT_DISCOVER_ATTRIBUTE:
-		return discovery_process_attribute(&bt_gatt_dm_inst,
-						   attr, params);
+		return discovery_process_attribute(dm, attr, params);
 	case BT_GATT_DISCOVER_CHARACTERISTIC:
-		return discovery_process_characteristic(&bt_gatt_dm_inst,
-							attr,
-							params);
+		return discovery_process_characteristic(dm, attr, params);
 	default:
 		/* This should not be possible */
 		__ASSERT(false, "Unknown param type.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EINVAL);
+		discovery_complete_error(dm, -EINVAL);
 
 		break;
 	}
@@ -601,6 +1096,93 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
 	return curr;
 }
 
+/** @brief Allocate a free instance for the connection.
+ *
+ * @return Locked instance, or NULL if the connection already runs a
+ *         discovery or no instance is available.
+ */
+static struct bt_gatt_dm *dm_alloc(struct bt_conn *conn)
+{
+	struct bt_gatt_dm *dm = NULL;
+	k_spinlock_key_t key = k_spin_lock(&dm_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		if (atomic_test_bit(bt_gatt_dm_inst[i].state_flags, STATE_ATTRS_LOCKED) &&
+		    bt_gatt_dm_inst[i].conn == conn) {
+			goto unlock;
+		}
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		if (!atomic_test_and_set_bit(bt_gatt_dm_inst[i].state_flags,
+					     STATE_ATTRS_LOCKED)) {
+			dm = &bt_gatt_dm_inst[i];
+			/* Set while locked, so that a concurrent call for the
+			 * same connection sees it.
+			 */
+			dm->conn = conn;
+			break;
+		}
+	}
+
+unlock:
+	k_spin_unlock(&dm_lock, key);
+
+	return dm;
+}
+
+static int discovery_gatt_start(struct bt_gatt_dm *dm)
+{
+	int err;
+
+	err = bt_gatt_discover(dm->conn, &dm->discover_params);
+	if (err) {
+		LOG_ERR("Discover failed, error: %d.", err);
+	}
+
+	return err;
+}
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+static void cache_work_handler(struct k_work *work)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(work, struct bt_gatt_dm, cache_work);
+	int err;
+
+	if (!cache_restore(dm)) {
+		LOG_DBG("Service restored from cache");
+		discovery_complete(dm);
+		return;
+	}
+
+	err = discovery_gatt_start(dm);
+	if (err) {
+		discovery_complete_error(dm, err);
+	}
+}
+#endif
+
+/* Restores the service from the cache if possible, otherwise starts
+ * discovery of the service over the air.
+ */
+static int discovery_start(struct bt_gatt_dm *dm)
+{
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->cache_hit = false;
+	dm->search_start_handle = dm->discover_params.start_handle;
+
+	if (dm->db_hash_valid) {
+		/* The cache is read from the work, so that the callbacks are
+		 * never called from bt_gatt_dm_start() or bt_gatt_dm_continue().
+		 */
+		k_work_submit(&dm->cache_work);
+		return 0;
+	}
+#endif
+
+	return discovery_gatt_start(dm);
+}
+
 int bt_gatt_dm_start(struct bt_conn *conn,
 		     const struct bt_uuid *svc_uuid,
 		     const struct bt_gatt_dm_cb *cb,
@@ -619,9 +1201,8 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 		return -EINVAL;
 	}
 
-	dm = &bt_gatt_dm_inst;
-
-	if (atomic_test_and_set_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
+	dm = dm_alloc(conn);
+	if (!dm) {
 		return -EALREADY;
 	}
 
@@ -646,9 +1227,23 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->discover_params.end_handle = 0xffff;
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 
-	err = bt_gatt_discover(conn, &dm->discover_params);
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->db_hash_valid = false;
+
+	if (peer_bonded(conn)) {
+		/* Discovery continues once the Database Hash is read. */
+		err = db_hash_read(dm);
+		if (err) {
+			LOG_ERR("Database Hash read failed, error: %d.", err);
+			atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
+		}
+
+		return err;
+	}
+#endif
+
+	err = discovery_start(dm);
 	if (err) {
-		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
 	}
 
@@ -689,9 +1284,8 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context)
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 	dm->discover_params.uuid = dm->search_svc_by_uuid ? &dm->svc_uuid.uuid : NULL;
 
-	err = bt_gatt_discover(dm->conn, &dm->discover_params);
+	err = discovery_start(dm);
 	if (err) {
-		LOG_ERR("Discover failed, error: %d.", err);
 		atomic_clear_bit(dm->state_flags, STATE_ATTRS_LOCKED);
 		discovery_complete_error(dm, err);
 	}
@@ -18,10 +18,70 @@ LOG_MODULE_REGISTER(bt_mesh_rpl);
 #include <mesh/rpl.h>
 #include <emds/emds.h>
 
+/* The hash index is kept at twice the RPL size to keep probe sequences
+ * short even when the RPL is full.
+ */
+#define RPL_INDEX_SIZE (2 * CONFIG_BT_MESH_CRPL)
+
+BUILD_ASSERT(CONFIG_BT_MESH_CRPL < UINT16_MAX, "RPL too large for the hash index");
+
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
 EMDS_STATIC_ENTRY_DEFINE(rpl_store, CONFIG_BT_MESH_RPL_INDEX, replay_list, sizeof(replay_list));
 
+/* Open-addressed hash index over replay_list, keyed on source address.
+ * Each bucket holds the replay_list slot number + 1, or 0 when empty. The
+ * index lives in RAM only and is rebuilt from replay_list whenever needed,
+ * so the EMDS snapshot format is unaffected. The replay_list is kept
+ * compact, so replay_list[rpl_count] is always the next free slot.
+ */
+static uint16_t rpl_index[RPL_INDEX_SIZE];
+static size_t rpl_count;
+static bool rpl_index_valid;
+
+static size_t rpl_hash(uint16_t src)
+{
+	/* Fibonacci hashing to spread sequential unicast addresses. */
+	return ((uint32_t)src * 2654435769U >> 16) % RPL_INDEX_SIZE;
+}
+
+static void rpl_index_insert(uint16_t src, size_t slot)
+{
+	size_t i = rpl_hash(src);
+
+	while (rpl_index[i]) {
+		i = (i + 1) % RPL_INDEX_SIZE;
+	}
+
+	rpl_index[i] = slot + 1;
+}
+
+static struct bt_mesh_rpl *rpl_index_find(uint16_t src)
+{
+	for (size_t i = rpl_hash(src); rpl_index[i]; i = (i + 1) % RPL_INDEX_SIZE) {
+		struct bt_mesh_rpl *rpl = &replay_list[rpl_index[i] - 1];
+
+		if (rpl->src == src) {
+			return rpl;
+		}
+	}
+
+	return NULL;
+}
+
+static void rpl_index_rebuild(void)
+{
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+	rpl_count = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(replay_list) && replay_list[i].src; i++) {
+		rpl_index_insert(replay_list[i].src, i);
+		rpl_count++;
+	}
+
+	rpl_index_valid = true;
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
@@ -32,6 +92,20 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		rpl->seg = 0;
 	}
 
+	if (rpl->src != rx->ctx.addr) {
+		size_t slot = rpl - replay_list;
+
+		if (!rpl->src && rpl_index_valid && slot == rpl_count) {
+			rpl_index_insert(rx->ctx.addr, slot);
+			rpl_count++;
+		} else {
+			/* Slot was handed out to several sources before being
+			 * updated, fall back to rebuilding the index.
+			 */
+			rpl_index_valid = false;
+		}
+	}
+
 	rpl->src = rx->ctx.addr;
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
@@ -45,7 +119,7 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -57,11 +131,20 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	if (!rpl_index_valid) {
+		rpl_index_rebuild();
+	}
+
+	rpl = rpl_index_find(rx->ctx.addr);
 
-		/* Empty slot */
-		if (!rpl->src) {
+	/* Existing slot for given address */
+	if (rpl) {
+		if (rx->old_iv && !rpl->old_iv) {
+			return true;
+		}
+
+		if ((!rx->old_iv && rpl->old_iv) ||
+		    rpl->seq < rx->seq) {
 			if (match) {
 				*match = rpl;
 			} else {
@@ -69,27 +152,22 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 			}
 
 			return false;
+		} else {
+			return true;
 		}
+	}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
-
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+	/* Empty slot */
+	if (rpl_count < ARRAY_SIZE(replay_list)) {
+		rpl = &replay_list[rpl_count];
 
-				return false;
-			} else {
-				return true;
-			}
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
+
+		return false;
 	}
 
 	LOG_ERR("RPL is full!");
@@ -99,6 +177,7 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 void bt_mesh_rpl_clear(void)
 {
 	(void)memset(replay_list, 0, sizeof(replay_list));
+	rpl_index_valid = false;
 }
 
 void bt_mesh_rpl_reset(void)
@@ -130,6 +209,8 @@ void bt_mesh_rpl_reset(void)
 	}
 
 	(void) memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+
+	rpl_index_valid = false;
 }
 
 void bt_mesh_rpl_pending_store(uint16_t addr)
@@ -6,6 +6,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/math_extras.h>
 #include <string.h>
 #include <bluetooth/scan.h>
 
@@ -18,6 +19,12 @@ LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
+/* Filters that are matched against the advertising data. */
+#define AD_FILTERS (MODE_CHECK & ~BT_SCAN_ADDR_FILTER)
+
+/* Matched UUID filters are tracked in a bitmask. */
+BUILD_ASSERT(CONFIG_BT_SCAN_UUID_CNT <= 32, "Too many UUID filters");
+
 /* Scan filter mutex. */
 K_MUTEX_DEFINE(scan_mutex);
 
@@ -31,6 +38,9 @@ struct bt_scan_control {
 	/* Number of matched filters. */
 	uint8_t filter_match_cnt;
 
+	/* Mask of the matched filters. */
+	uint8_t filter_match_mask;
+
 	/* Indicates whether at least one filter has been fitted. */
 	bool filter_match;
 
@@ -89,6 +99,9 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+	/* Bloom filter of the target addresses. */
+	uint64_t bloom;
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +133,9 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+	/* Bloom filter of the UUIDs. */
+	uint64_t bloom;
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -194,6 +210,14 @@ struct bt_scan_filters {
 	 * matched to generate an event.
 	 */
 	bool all_mode;
+
+	/* Mask of the enabled filters, updated when the filters are
+	 * enabled or disabled.
+	 */
+	uint8_t enabled_mask;
+
+	/* Number of enabled filters. */
+	uint8_t enabled_cnt;
 };
 
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
@@ -211,6 +235,11 @@ struct conn_attempts_filter {
 	/* Array of the filtered devices. */
 	struct conn_attempts_device device[CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER_LEN];
 
+	/* Bloom filter of the filtered devices. Overwritten devices are not
+	 * removed from it, which only costs an extra array walk.
+	 */
+	uint64_t bloom;
+
 	/* The oldest device index. */
 	uint32_t oldest_idx;
 
@@ -225,6 +254,9 @@ struct conn_blocklist {
 	/* Array of the blocklist devices. */
 	bt_addr_le_t addr[CONFIG_BT_SCAN_BLOCKLIST_LEN];
 
+	/* Bloom filter of the blocklist devices. */
+	uint64_t bloom;
+
 	/* Blocklist device count. */
 	uint32_t count;
 };
@@ -270,6 +302,55 @@ static struct bt_scan {
 
 static sys_slist_t callback_list;
 
+/* Base UUID in little endian, without the 32-bit value part. */
+static const uint8_t uuid_base[] = {
+	0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00
+};
+
+/* Returns the bit of a 64-bit Bloom filter for the given key.
+ *
+ * The Bloom filters hold one bit per entry of a filter list, so that
+ * advertising reports that can not match any entry are rejected without
+ * walking and comparing the list.
+ */
+static uint64_t bloom_bit(uint32_t key)
+{
+	return BIT64((key * 2654435769U) >> 26);
+}
+
+static uint32_t addr_key(const bt_addr_le_t *addr)
+{
+	return sys_get_le32(addr->a.val) ^
+	       ((uint32_t)sys_get_le16(&addr->a.val[4]) << 8) ^ addr->type;
+}
+
+/* UUIDs that are equal according to bt_uuid_cmp() have the same key. */
+static uint32_t uuid_key(const struct bt_uuid *uuid)
+{
+	const uint8_t *val;
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return BT_UUID_16(uuid)->val;
+
+	case BT_UUID_TYPE_32:
+		return BT_UUID_32(uuid)->val;
+
+	case BT_UUID_TYPE_128:
+		val = BT_UUID_128(uuid)->val;
+
+		if (memcmp(val, uuid_base, sizeof(uuid_base)) == 0) {
+			return sys_get_le32(&val[sizeof(uuid_base)]);
+		}
+
+		return sys_get_le32(&val[0]) ^ sys_get_le32(&val[4]) ^
+		       sys_get_le32(&val[8]) ^ sys_get_le32(&val[12]);
+
+	default:
+		return 0;
+	}
+}
+
 void bt_scan_cb_register(struct bt_scan_cb *cb)
 {
 	if (!cb) {
@@ -337,6 +418,10 @@ static bool blocklist_device_check(const bt_addr_le_t *addr)
 
 	k_mutex_lock(&scan_mutex, K_FOREVER);
 
+	if (!(bt_scan.blocklist.bloom & bloom_bit(addr_key(addr)))) {
+		goto out;
+	}
+
 	for (size_t i = 0; i < bt_scan.blocklist.count; i++) {
 		if (bt_addr_le_cmp(&bt_scan.blocklist.addr[i], addr) == 0) {
 			blocklist_device = true;
@@ -345,6 +430,7 @@ static bool blocklist_device_check(const bt_addr_le_t *addr)
 		}
 	}
 
+out:
 	k_mutex_unlock(&scan_mutex);
 
 	return blocklist_device;
@@ -358,6 +444,7 @@ static void attempts_filter_force_add(struct conn_attempts_filter *filter,
 	/* Overwrite the oldest device */
 	filter->device[filter->oldest_idx].attempts = 0;
 	bt_addr_le_copy(&filter->device[filter->oldest_idx].addr, addr);
+	filter->bloom |= bloom_bit(addr_key(addr));
 
 	if (filter->oldest_idx == (ARRAY_SIZE(filter->device) - 1)) {
 		filter->oldest_idx = 0;
@@ -393,6 +480,7 @@ static void scan_attempts_filter_device_add(const bt_addr_le_t *addr)
 		attempts_filter_force_add(filter, addr);
 	} else {
 		bt_addr_le_copy(&filter->device[filter->count].addr, addr);
+		filter->bloom |= bloom_bit(addr_key(addr));
 		filter->count++;
 	}
 
@@ -428,10 +516,14 @@ static bool conn_attempts_exceeded(const bt_addr_le_t *addr)
 	char addr_str[BT_ADDR_LE_STR_LEN];
 	bool attempts_exceeded = false;
 
-	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
-
 	k_mutex_lock(&scan_mutex, K_FOREVER);
 
+	if (!(filter->bloom & bloom_bit(addr_key(addr)))) {
+		goto out;
+	}
+
+	bt_addr_le_to_str(addr, addr_str, sizeof(addr_str));
+
 	/* Check if the device is in the filter array. */
 	for (size_t i = 0; i < filter->count; i++) {
 		struct conn_attempts_device *device = &filter->device[i];
@@ -447,6 +539,7 @@ static bool conn_attempts_exceeded(const bt_addr_le_t *addr)
 		}
 	}
 
+out:
 	k_mutex_unlock(&scan_mutex);
 
 	return attempts_exceeded;
@@ -513,6 +606,10 @@ static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			bt_scan.scan_filters.addr.target_addr;
 	uint8_t counter = bt_scan.scan_filters.addr.cnt;
 
+	if (!(bt_scan.scan_filters.addr.bloom & bloom_bit(addr_key(target_addr)))) {
+		return false;
+	}
+
 	for (size_t i = 0; i < counter; i++) {
 		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
 			control->filter_status.addr.addr = &addr[i];
@@ -538,6 +635,7 @@ static void check_addr(struct bt_scan_control *control,
 
 			/* Information about the filters matched. */
 			control->filter_status.addr.match = true;
+			control->filter_match_mask |= BT_SCAN_ADDR_FILTER;
 			control->filter_match = true;
 		}
 	}
@@ -564,6 +662,7 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	bt_scan.scan_filters.addr.bloom |= bloom_bit(addr_key(target_addr));
 
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
@@ -624,6 +723,7 @@ static void name_check(struct bt_scan_control *control,
 
 			/* Information about the filters matched. */
 			control->filter_status.name.match = true;
+			control->filter_match_mask |= BT_SCAN_NAME_FILTER;
 			control->filter_match = true;
 		}
 	}
@@ -717,6 +817,7 @@ static void short_name_check(struct bt_scan_control *control,
 
 			/* Information about the filters matched. */
 			control->filter_status.short_name.match = true;
+			control->filter_match_mask |= BT_SCAN_SHORT_NAME_FILTER;
 			control->filter_match = true;
 		}
 	}
@@ -764,11 +865,16 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
+			     struct bt_scan_control *control)
 {
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
+	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
+	uint8_t data_len = data->data_len;
+	uint8_t uuid_match_cnt = 0;
+	uint32_t found = 0;
 	uint8_t uuid_len;
 
 	switch (uuid_type) {
@@ -788,50 +894,42 @@ static bool find_uuid(const uint8_t *data,
 		return false;
 	}
 
-	for (size_t i = 0; i < data_len; i += uuid_len) {
+	/* Decode each advertised UUID once, and only compare it with the
+	 * filters if it is in the Bloom filter.
+	 */
+	for (size_t i = 0; i + uuid_len <= data_len; i += uuid_len) {
 		struct bt_uuid_128 uuid;
 
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
-			return false;
+		if (!bt_uuid_create(&uuid.uuid, &data->data[i], uuid_len)) {
+			break;
 		}
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
+		if (!(uuid_filter->bloom & bloom_bit(uuid_key(&uuid.uuid)))) {
+			continue;
 		}
-	}
-
-	return false;
-}
-
-static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
-			     struct bt_scan_control *control)
-{
-	const struct bt_scan_uuid_filter *uuid_filter =
-			&bt_scan.scan_filters.uuid;
-	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
-	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
 
-	for (size_t i = 0; i < counter; i++) {
+		for (size_t j = 0; j < counter; j++) {
+			if (!(found & BIT(j)) &&
+			    (bt_uuid_cmp(&uuid.uuid, uuid_filter->uuid[j].uuid) == 0)) {
+				found |= BIT(j);
+			}
+		}
+	}
 
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
+	if (all_filters_mode) {
+		/* Report the matching UUIDs up to the first missing one. */
+		while ((uuid_match_cnt < counter) && (found & BIT(uuid_match_cnt))) {
 			control->filter_status.uuid.uuid[uuid_match_cnt] =
-				uuid_filter->uuid[i].uuid;
-
+				uuid_filter->uuid[uuid_match_cnt].uuid;
 			uuid_match_cnt++;
-
-			/* In the normal filter mode,
-			 * only one UUID is needed to match.
-			 */
-			if (!all_filters_mode) {
-				break;
-			}
-
-		} else if (all_filters_mode) {
-			break;
 		}
+	} else if (found) {
+		/* In the normal filter mode,
+		 * only one UUID is needed to match.
+		 */
+		control->filter_status.uuid.uuid[0] =
+			uuid_filter->uuid[u32_count_trailing_zeros(found)].uuid;
+		uuid_match_cnt = 1;
 	}
 
 	control->filter_status.uuid.count = uuid_match_cnt;
@@ -862,6 +960,7 @@ static void uuid_check(struct bt_scan_control *control,
 
 			/* Information about the filters matched. */
 			control->filter_status.uuid.match = true;
+			control->filter_match_mask |= BT_SCAN_UUID_FILTER;
 			control->filter_match = true;
 		}
 	}
@@ -917,6 +1016,7 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		return -EINVAL;
 	}
 
+	bt_scan.scan_filters.uuid.bloom |= bloom_bit(uuid_key(uuid));
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -982,6 +1082,7 @@ static void appearance_check(struct bt_scan_control *control,
 
 			/* Information about the filters matched. */
 			control->filter_status.appearance.match = true;
+			control->filter_match_mask |= BT_SCAN_APPEARANCE_FILTER;
 			control->filter_match = true;
 		}
 	}
@@ -1069,6 +1170,7 @@ static void manufacturer_data_check(struct bt_scan_control *control,
 
 			/* Information about the filters matched. */
 			control->filter_status.manufacturer_data.match = true;
+			control->filter_match_mask |= BT_SCAN_MANUFACTURER_DATA_FILTER;
 			control->filter_match = true;
 		}
 	}
@@ -1229,10 +1331,12 @@ void bt_scan_filter_remove_all(void)
 	struct bt_scan_addr_filter *addr_filter =
 			&bt_scan.scan_filters.addr;
 	addr_filter->cnt = 0;
+	addr_filter->bloom = 0;
 
 	struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
 	uuid_filter->cnt = 0;
+	uuid_filter->bloom = 0;
 
 	struct bt_scan_appearance_filter *appearance_filter =
 			&bt_scan.scan_filters.appearance;
@@ -1245,6 +1349,42 @@ void bt_scan_filter_remove_all(void)
 	k_mutex_unlock(&scan_mutex);
 }
 
+/* Precompute the mask and number of enabled filters, so that it does not
+ * have to be done for every advertising report.
+ */
+static void enabled_filters_update(void)
+{
+	struct bt_scan_filters *filters = &bt_scan.scan_filters;
+
+	filters->enabled_mask = 0;
+
+	if (is_addr_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_ADDR_FILTER;
+	}
+
+	if (is_name_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_NAME_FILTER;
+	}
+
+	if (is_short_name_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_SHORT_NAME_FILTER;
+	}
+
+	if (is_uuid_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_UUID_FILTER;
+	}
+
+	if (is_appearance_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_APPEARANCE_FILTER;
+	}
+
+	if (is_manufacturer_data_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_MANUFACTURER_DATA_FILTER;
+	}
+
+	filters->enabled_cnt = popcount(filters->enabled_mask);
+}
+
 void bt_scan_filter_disable(void)
 {
 	/* Disable all filters. */
@@ -1254,6 +1394,9 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.uuid.enabled = false;
 	bt_scan.scan_filters.appearance.enabled = false;
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
+
+	bt_scan.scan_filters.enabled_mask = 0;
+	bt_scan.scan_filters.enabled_cnt = 0;
 }
 
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
@@ -1296,6 +1439,8 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	enabled_filters_update();
+
 	return 0;
 }
 
@@ -1379,39 +1524,11 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 	bt_scan.conn_param = *new_conn_param;
 }
 
-static void check_enabled_filters(struct bt_scan_control *control)
-{
-	control->filter_cnt = 0;
-
-	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
-	}
-}
-
 static bool adv_data_found(struct bt_data *data, void *user_data)
 {
 	struct bt_scan_control *scan_control =
 			(struct bt_scan_control *)user_data;
+	const uint8_t ad_filters = bt_scan.scan_filters.enabled_mask & AD_FILTERS;
 
 	switch (data->type) {
 	case BT_DATA_NAME_COMPLETE:
@@ -1455,7 +1572,8 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 		break;
 	}
 
-	return true;
+	/* Stop parsing once all enabled filters have matched. */
+	return (scan_control->filter_match_mask & ad_filters) != ad_filters;
 }
 
 static void filter_state_check(struct bt_scan_control *control,
@@ -1500,8 +1618,7 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	memset(&scan_control, 0, sizeof(scan_control));
 
 	scan_control.all_mode = bt_scan.scan_filters.all_mode;
-
-	check_enabled_filters(&scan_control);
+	scan_control.filter_cnt = bt_scan.scan_filters.enabled_cnt;
 
 	/* Check id device is connectable. */
 	scan_control.connectable =
@@ -1513,9 +1630,11 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	/* Save advertising buffer state to transfer it
 	 * data to application if futher processing is needed.
 	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	if (bt_scan.scan_filters.enabled_mask & AD_FILTERS) {
+		net_buf_simple_save(ad, &state);
+		bt_data_parse(ad, adv_data_found, (void *)&scan_control);
+		net_buf_simple_restore(ad, &state);
+	}
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
@@ -1604,6 +1723,7 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr)
 	} else {
 		bt_addr_le_copy(&bt_scan.blocklist.addr[bt_scan.blocklist.count],
 				addr);
+		bt_scan.blocklist.bloom |= bloom_bit(addr_key(addr));
 		bt_scan.blocklist.count++;
 		LOG_INF("Device %s added to the scanning blocklist", addr_str);
 	}
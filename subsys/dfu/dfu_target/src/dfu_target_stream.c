@@ -13,6 +13,7 @@
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 #define MODULE "dfu"
 #define DFU_STREAM_OFFSET "stream/offset"
+#include <zephyr/drivers/flash.h>
 #include <zephyr/settings/settings.h>
 #endif /* CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS */
 
@@ -25,6 +26,10 @@ static const char *current_id;
 
 static char current_name_key[32];
 
+/* Offset and uptime of the last stored checkpoint. */
+static size_t checkpoint_offset;
+static int64_t checkpoint_time;
+
 /**
  * @brief Store the information stored in the stream_flash instance so that it
  *        can be restored from flash in case of a power failure, reboot etc.
@@ -42,9 +47,80 @@ static int store_progress(void)
 		return err;
 	}
 
+	checkpoint_offset = bytes_written;
+	checkpoint_time = k_uptime_get();
+
 	return 0;
 }
 
+/**
+ * @brief Check whether a new checkpoint should be stored.
+ *
+ * The stored offset only changes when stream_flash commits its buffer to
+ * flash, so there is nothing to store unless that has happened since the
+ * last checkpoint. Beyond that, checkpoints are rate limited by the
+ * configured byte and time intervals to spare the settings partition.
+ */
+static bool checkpoint_due(void)
+{
+	size_t bytes_written = stream_flash_bytes_written(&stream);
+
+	if (bytes_written == checkpoint_offset) {
+		return false;
+	}
+
+	if (bytes_written < checkpoint_offset ||
+	    bytes_written - checkpoint_offset >=
+	    CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_INTERVAL_BYTES) {
+		return true;
+	}
+
+	return CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_INTERVAL_MS > 0 &&
+	       (k_uptime_get() - checkpoint_time) >=
+	       CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_INTERVAL_MS;
+}
+
+/**
+ * @brief Verify that the flash after the restored offset is still erased.
+ *
+ * If the device was reset after stream_flash committed data but before the
+ * checkpoint was stored, the flash following the stored offset may already
+ * be programmed. That data can not be written again without an erase, so
+ * in that case progress is rolled back to the start of the page and the
+ * page is erased again by the next buffered write.
+ *
+ * @param page Page containing the last byte covered by the checkpoint.
+ *
+ * @return true if the tail of the page is erased, false otherwise.
+ */
+static bool tail_is_erased(const struct flash_pages_info *page)
+{
+	const struct flash_parameters *params = flash_get_parameters(stream.fdev);
+	off_t pos = stream.offset + stream.bytes_written;
+	off_t end = page->start_offset + page->size;
+	uint8_t chunk[32];
+
+	while (pos < end) {
+		size_t len = MIN(sizeof(chunk), end - pos);
+		int err = flash_read(stream.fdev, pos, chunk, len);
+
+		if (err) {
+			LOG_ERR("Error %d while verifying checkpoint tail", err);
+			return false;
+		}
+
+		for (size_t i = 0; i < len; i++) {
+			if (chunk[i] != params->erase_value) {
+				return false;
+			}
+		}
+
+		pos += len;
+	}
+
+	return true;
+}
+
 /**
  * @brief Function used by settings_load() to restore the stream_flash ctx.
  *	  See the Zephyr documentation of the settings subsystem for more
@@ -81,10 +157,21 @@ static int settings_set(const char *key, size_t len_rd,
 			return err;
 		}
 
+		if (!tail_is_erased(&page)) {
+			LOG_WRN("Flash after offset %zu is not erased, resuming from page start",
+				stream.bytes_written);
+
+			stream.bytes_written = MAX(page.start_offset - (off_t)stream.offset, 0);
+			stream.last_erased_page_start_offset = -1;
+			checkpoint_offset = stream.bytes_written;
+			return 0;
+		}
+
 		/* Update the last erased page to avoid deleting already
 		 * written data.
 		 */
 		stream.last_erased_page_start_offset = page.start_offset;
+		checkpoint_offset = stream.bytes_written;
 	}
 
 	return 0;
@@ -138,6 +225,9 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		return err;
 	}
 
+	checkpoint_offset = 0;
+	checkpoint_time = k_uptime_get();
+
 	err = settings_register(&sh);
 	if (err && err != -EEXIST) {
 		LOG_ERR("setting_register failed: (err %d)", err);
@@ -171,12 +261,14 @@ int dfu_target_stream_write(const uint8_t *buf, size_t len)
 	}
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
-	err = store_progress();
-	if (err != 0) {
-		/* Failing to store progress is not a critical error you'll just
-		 * be left to download a bit more if you fail and resume.
-		 */
-		LOG_WRN("Unable to store write progress: %d", err);
+	if (checkpoint_due()) {
+		err = store_progress();
+		if (err != 0) {
+			/* Failing to store progress is not a critical error you'll just
+			 * be left to download a bit more if you fail and resume.
+			 */
+			LOG_WRN("Unable to store write progress: %d", err);
+		}
 	}
 #endif
 
@@ -223,6 +315,9 @@ int dfu_target_stream_reset(void)
 
 	stream.buf_bytes = 0;
 	stream.bytes_written = 0;
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+	checkpoint_offset = 0;
+#endif
 
 	/* Erase just the first page. Stream write will take care of erasing remaining pages
 	 * on a next buffered_write round
@@ -21,3 +21,10 @@ uint32_t time_distance_get(uint32_t t1, uint32_t t2)
 
 	return t2 - t1;
 }
+
+bool time_is_before(uint32_t t1, uint32_t t2)
+{
+	uint32_t distance = time_distance_get(t1, t2);
+
+	return (distance != 0) && (distance <= RTC_COUNTER_MAX / 2);
+}
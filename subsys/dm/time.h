@@ -36,6 +36,17 @@ uint32_t time_now(void);
  */
 uint32_t time_distance_get(uint32_t t1, uint32_t t2);
 
+/** @brief Check if t1 is before t2.
+ *
+ *  The times must be less than half of the counter range apart.
+ *
+ *  @param t1 First time tick.
+ *  @param t2 Second time tick.
+ *
+ *  @retval true if t1 is before t2.
+ */
+bool time_is_before(uint32_t t1, uint32_t t2);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,19 +10,21 @@
 
 #define TIMESLOT_QUEUE_LENGTH            CONFIG_DM_TIMESLOT_QUEUE_LENGTH
 #define TIMESLOT_QUEUE_COUNT_SAME_PEER   CONFIG_DM_TIMESLOT_QUEUE_COUNT_SAME_PEER
+#define TIMESLOT_PEER_MIN_INTERVAL_US    CONFIG_DM_TIMESLOT_PEER_MIN_INTERVAL_US
 
 #define MIN_TIME_BETWEEN_TIMESLOTS_US    CONFIG_DM_MIN_TIME_BETWEEN_TIMESLOTS_US
 #define RANGING_OFFSET_US                CONFIG_DM_RANGING_OFFSET_US
 
 static K_MUTEX_DEFINE(list_mtx);
 static sys_slist_t timeslot_list = SYS_SLIST_STATIC_INIT(&timeslot_list);
+static size_t timeslot_cnt;
 
 struct timeslot_entry {
 	struct timeslot_request timeslot_req;
 	sys_snode_t node;
 };
 
-static K_HEAP_DEFINE(heap, TIMESLOT_QUEUE_LENGTH * sizeof(struct timeslot_entry));
+K_MEM_SLAB_DEFINE(timeslot_slab, sizeof(struct timeslot_entry), TIMESLOT_QUEUE_LENGTH, 4);
 
 static void list_lock(void)
 {
@@ -34,84 +36,199 @@ static void list_unlock(void)
 	k_mutex_unlock(&list_mtx);
 }
 
-static size_t get_list_size(void)
+/* Check if the timeslot ends before the given start time, including the processing time. */
+static bool timeslot_fits_before(const struct timeslot_request *ts, uint32_t start_time)
 {
-	size_t ret = 0;
-	sys_snode_t *node, *tmp;
+	uint32_t distance = time_distance_get(ts->start_time, start_time);
 
-	SYS_SLIST_FOR_EACH_NODE_SAFE(&timeslot_list, node, tmp) {
-		ret++;
+	return time_is_before(ts->start_time, start_time) &&
+	       distance >= US_TO_RTC_TICKS(ts->timeslot_length_us +
+					   MIN_TIME_BETWEEN_TIMESLOTS_US);
+}
+
+static bool timeslots_overlap(const struct timeslot_request *a,
+			      const struct timeslot_request *b)
+{
+	return !timeslot_fits_before(a, b->start_time) && !timeslot_fits_before(b, a->start_time);
+}
+
+static bool same_peer(const struct timeslot_request *ts, const struct dm_request *req)
+{
+	return bt_addr_le_cmp(&ts->dm_req.bt_addr, &req->bt_addr) == 0;
+}
+
+static bool peer_too_close(const struct timeslot_request *ts, uint32_t start_time)
+{
+	uint32_t distance;
+
+	if (TIMESLOT_PEER_MIN_INTERVAL_US == 0) {
+		return false;
 	}
 
-	return ret;
+	distance = time_is_before(ts->start_time, start_time) ?
+		   time_distance_get(ts->start_time, start_time) :
+		   time_distance_get(start_time, ts->start_time);
+
+	return distance < US_TO_RTC_TICKS(TIMESLOT_PEER_MIN_INTERVAL_US);
 }
 
-static bool is_request_exist(struct dm_request *req)
+/* Find the last timeslot starting before the given time. Must be called with the list lock
+ * taken.
+ */
+static sys_snode_t *insertion_point_find(uint32_t start_time)
 {
-	uint8_t cnt = 0;
-	sys_snode_t *node, *tmp;
-	struct timeslot_entry *item;
+	sys_snode_t *node, *prev = NULL;
+
+	SYS_SLIST_FOR_EACH_NODE(&timeslot_list, node) {
+		struct timeslot_entry *item = CONTAINER_OF(node, struct timeslot_entry, node);
+
+		if (!time_is_before(item->timeslot_req.start_time, start_time)) {
+			break;
+		}
+		prev = node;
+	}
+
+	return prev;
+}
+
+static void entry_remove(sys_snode_t *prev, struct timeslot_entry *item)
+{
+	sys_slist_remove(&timeslot_list, prev, &item->node);
+	timeslot_cnt--;
+	k_mem_slab_free(&timeslot_slab, (void **)&item);
+}
+
+/* Remove the conflicting timeslots of lower priority. Must be called with the list lock taken. */
+static void conflicts_evict(const struct timeslot_request *new_ts)
+{
+	sys_snode_t *node, *tmp, *prev = NULL;
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&timeslot_list, node, tmp) {
-		item = CONTAINER_OF(node, struct timeslot_entry, node);
-		if (bt_addr_le_cmp(&item->timeslot_req.dm_req.bt_addr, &req->bt_addr) == 0) {
-			cnt++;
+		struct timeslot_entry *item = CONTAINER_OF(node, struct timeslot_entry, node);
+
+		if (timeslots_overlap(&item->timeslot_req, new_ts)) {
+			__ASSERT_NO_MSG(item->timeslot_req.dm_req.priority <
+					new_ts->dm_req.priority);
+			entry_remove(prev, item);
+		} else {
+			prev = node;
 		}
 	}
+}
 
-	return cnt >= TIMESLOT_QUEUE_COUNT_SAME_PEER;
+/* Remove the latest timeslot of the lowest priority lower than the given one.
+ * Must be called with the list lock taken.
+ */
+static bool lowest_priority_evict(uint8_t priority)
+{
+	sys_snode_t *node, *prev = NULL;
+	sys_snode_t *victim = NULL, *victim_prev = NULL;
+	uint8_t victim_priority = priority;
+
+	SYS_SLIST_FOR_EACH_NODE(&timeslot_list, node) {
+		struct timeslot_entry *item = CONTAINER_OF(node, struct timeslot_entry, node);
+
+		if ((item->timeslot_req.dm_req.priority < priority) &&
+		    (item->timeslot_req.dm_req.priority <= victim_priority)) {
+			victim = node;
+			victim_prev = prev;
+			victim_priority = item->timeslot_req.dm_req.priority;
+		}
+		prev = node;
+	}
+
+	if (!victim) {
+		return false;
+	}
+
+	entry_remove(victim_prev, CONTAINER_OF(victim, struct timeslot_entry, node));
+
+	return true;
 }
 
 int timeslot_queue_append(struct dm_request *req, uint32_t start_ref_tick,
 			  uint32_t window_len_us, uint32_t timeslot_len_us)
 {
-	uint32_t distance;
-	uint32_t start_time;
 	uint32_t delay;
-	size_t list_size;
-	struct timeslot_entry *last, *item;
+	uint8_t peer_cnt = 0;
+	bool evict = false;
+	int err = 0;
+	sys_snode_t *node, *prev = NULL;
+	struct timeslot_entry *item;
+	struct timeslot_request new_ts = {
+		.timeslot_length_us = timeslot_len_us,
+		.window_length_us = window_len_us,
+	};
 
 	delay = req->start_delay_us + RANGING_OFFSET_US;
-	start_time = (start_ref_tick + US_TO_RTC_TICKS(delay)) % RTC_COUNTER_MAX;
+	new_ts.start_time = (start_ref_tick + US_TO_RTC_TICKS(delay)) % RTC_COUNTER_MAX;
+	new_ts.dm_req.priority = req->priority;
 
-	list_size = get_list_size();
-	if (list_size >= TIMESLOT_QUEUE_LENGTH) {
-		return -ENOMEM;
-	}
+	list_lock();
 
-	if (list_size != 0) {
-		if (is_request_exist(req)) {
-			return -EAGAIN;
+	/* Single pass over the list ordered by the start time: count the timeslots of the peer,
+	 * find the insertion point and check the neighbours for the conflicts.
+	 */
+	SYS_SLIST_FOR_EACH_NODE(&timeslot_list, node) {
+		struct timeslot_entry *entry = CONTAINER_OF(node, struct timeslot_entry, node);
+		const struct timeslot_request *ts = &entry->timeslot_req;
+
+		if (same_peer(ts, req)) {
+			if ((++peer_cnt >= TIMESLOT_QUEUE_COUNT_SAME_PEER) ||
+			    peer_too_close(ts, new_ts.start_time)) {
+				err = -EAGAIN;
+				goto out;
+			}
 		}
 
-		list_lock();
-		last = SYS_SLIST_PEEK_TAIL_CONTAINER(&timeslot_list, last, node);
-		list_unlock();
+		if (timeslots_overlap(ts, &new_ts)) {
+			if (ts->dm_req.priority >= req->priority) {
+				err = -EBUSY;
+				goto out;
+			}
+			evict = true;
+		}
 
-		distance = time_distance_get(last->timeslot_req.start_time, start_time);
-		if (distance < US_TO_RTC_TICKS(last->timeslot_req.timeslot_length_us +
-					       MIN_TIME_BETWEEN_TIMESLOTS_US)) {
-			return -EBUSY;
+		if (time_is_before(ts->start_time, new_ts.start_time)) {
+			prev = node;
 		}
 	}
 
-	item = k_heap_alloc(&heap, sizeof(struct timeslot_entry), K_NO_WAIT);
-	if (!item) {
-		return -ENOMEM;
+	if (evict) {
+		conflicts_evict(&new_ts);
+
+		/* The insertion point might have been removed. */
+		prev = insertion_point_find(new_ts.start_time);
+	}
+
+	if (k_mem_slab_alloc(&timeslot_slab, (void **)&item, K_NO_WAIT)) {
+		/* Make room by dropping a timeslot of lower priority. */
+		if (!lowest_priority_evict(req->priority) ||
+		    k_mem_slab_alloc(&timeslot_slab, (void **)&item, K_NO_WAIT)) {
+			err = -ENOMEM;
+			goto out;
+		}
+
+		/* The insertion point might have been removed. */
+		prev = insertion_point_find(new_ts.start_time);
 	}
 
-	item->timeslot_req.start_time = start_time;
-	item->timeslot_req.timeslot_length_us = timeslot_len_us;
-	item->timeslot_req.window_length_us = window_len_us;
 	req->rng_seed++;
 
+	item->timeslot_req = new_ts;
 	memcpy(&item->timeslot_req.dm_req, req, sizeof(item->timeslot_req.dm_req));
 
-	list_lock();
-	sys_slist_append(&timeslot_list, &item->node);
+	if (prev) {
+		sys_slist_insert(&timeslot_list, prev, &item->node);
+	} else {
+		sys_slist_prepend(&timeslot_list, &item->node);
+	}
+	timeslot_cnt++;
+
+out:
 	list_unlock();
 
-	return 0;
+	return err;
 }
 
 struct timeslot_request *timeslot_queue_peek(void)
@@ -136,6 +253,9 @@ void timeslot_queue_remove_first(void)
 
 	list_lock();
 	node = sys_slist_get(&timeslot_list);
+	if (node) {
+		timeslot_cnt--;
+	}
 	list_unlock();
 
 	if (!node) {
@@ -143,5 +263,10 @@ void timeslot_queue_remove_first(void)
 	}
 
 	item = CONTAINER_OF(node, struct timeslot_entry, node);
-	k_heap_free(&heap, item);
+	k_mem_slab_free(&timeslot_slab, (void **)&item);
+}
+
+size_t timeslot_queue_count(void)
+{
+	return timeslot_cnt;
 }
@@ -29,16 +29,21 @@ struct timeslot_request {
 	uint32_t window_length_us;
 };
 
-/** @brief Append an element to the end of a queue.
+/** @brief Insert an element into the queue ordered by the start time.
+ *
+ *  The timeslot is placed in any gap between the scheduled timeslots that is long enough.
+ *  Scheduled timeslots of lower priority that overlap the new one are removed.
  *
  *  @param req Address of the structure with request parameters.
  *  @param start_ref_tick Reference start time tick.
  *  @param window_len Ranging window length.
  *  @param timeslot_len Timeslot length.
  *
- *  @retval -ENOMEM when the tiemslot queue is full or a memory allocation error.
- *  @retval -EAGAIN when a single peer has a maximum number of timeslots scheduled.
- *  @retval -EBUSY when the timeslot cannot be scheduled due to time restrictions.
+ *  @retval -ENOMEM when the timeslot queue is full of timeslots with the same
+ *                  or higher priority.
+ *  @retval -EAGAIN when a single peer has a maximum number of timeslots scheduled
+ *                  or the peer has another timeslot scheduled too close.
+ *  @retval -EBUSY when the timeslot overlaps a timeslot with the same or higher priority.
  */
 int timeslot_queue_append(struct dm_request *req, uint32_t start_ref_tick,
 			  uint32_t window_len, uint32_t timeslot_len);
@@ -57,6 +62,12 @@ struct timeslot_request *timeslot_queue_peek(void);
  */
 void timeslot_queue_remove_first(void);
 
+/** @brief Get the number of timeslots in the queue.
+ *
+ *  @retval Number of the scheduled timeslots.
+ */
+size_t timeslot_queue_count(void);
+
 #ifdef __cplusplus
 }
 #endif
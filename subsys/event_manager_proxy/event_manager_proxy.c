@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <stdlib.h>
 #include <zephyr/kernel.h>
 #include <zephyr/spinlock.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/linker/section_tags.h>
 #include <app_event_manager.h>
 #include <event_manager_proxy.h>
 #include <zephyr/logging/log.h>
@@ -16,25 +19,86 @@ LOG_MODULE_REGISTER(event_manager_proxy, CONFIG_APP_EVENT_MANAGER_LOG_LEVEL);
 
 #define EMP_BIND_TIMEOUT K_MSEC(CONFIG_EVENT_MANAGER_PROXY_BIND_TIMEOUT_MS)
 
+/* Bits of the emp_ipc_data.bound event. */
+#define EMP_EVENT_BOUND    BIT(0)
+#define EMP_EVENT_FEATURES BIT(1)
+
+#define EMP_CACHE_MAGIC 0x454d5043 /* "EMPC" */
+#define EMP_HELLO_MAGIC 0x454d5048 /* "EMPH" */
+
+#define FNV1A_INIT  0x811c9dc5
+#define FNV1A_PRIME 0x01000193
+
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+#define EMP_BATCH_FRAME_WORDS (CONFIG_EVENT_MANAGER_PROXY_BATCH_FRAME_SIZE / sizeof(uint32_t))
+#define EMP_BATCH_TIMEOUT     K_MSEC(CONFIG_EVENT_MANAGER_PROXY_BATCH_TIMEOUT_MS)
+#define EMP_BATCH_RETRY_DELAY K_MSEC(1)
+#endif
+
+/** @brief Entry of the event type index sorted by the name hash. */
+struct emp_hash_entry {
+	uint32_t hash;
+	uint32_t idx;
+};
+
 /* Helpers - allow linker to get information about these structure sizes. */
 static struct event_type _emp_event_type_size_check
 	__used __attribute__((__section__("event_manager_proxy_event_type_size")));
 static struct event_type *_emp_event_type_pointer_size_check
 	__used __attribute__((__section__("event_manager_proxy_event_type_pointer_size")));
+static struct emp_hash_entry _emp_hash_entry_size_check
+	__used __attribute__((__section__("event_manager_proxy_hash_entry_size")));
+static bool _emp_subscribed_size_check
+	__used __attribute__((__section__("event_manager_proxy_subscribed_size")));
 
 /* Array used for inter-core event type mapping. */
 extern struct event_type *event_manager_proxy_array[];
 extern struct event_type *_event_manager_proxy_array_list_end[];
 
+/* Array used for event type lookup by the name hash. */
+extern struct emp_hash_entry event_manager_proxy_hash_index[];
+
+/* Array of the local events subscribed on the remotes. */
+extern bool event_manager_proxy_subscribed[];
+
 
 /** @brief Command codes used by the proxy. */
 enum emp_cmd_code {
 	EMP_CMD_SUBSCRIBE,
 	EMP_CMD_START,
+	EMP_CMD_SUBSCRIBE_HASH,
+	EMP_CMD_FEATURES,
 	EMP_CMD_COUNT,
 	EMP_CMD_FORCE_INT_SIZE = INT_MAX
 };
 
+/** @brief Flags passed by the start command. */
+enum emp_start_flags {
+	/** The events are sent to the remote packed in batch frames. */
+	EMP_START_FLAG_BATCH = BIT(0),
+};
+
+/** @brief Features of the proxy advertised to the remote. */
+enum emp_features {
+	/** The subscriptions are accepted by the event name hash. */
+	EMP_FEATURE_SUBSCRIBE_HASH = BIT(0),
+	/** The subscriptions are kept over the reset. */
+	EMP_FEATURE_CACHE = BIT(1),
+};
+
+#define EMP_FEATURES (EMP_FEATURE_SUBSCRIBE_HASH | \
+		      (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_CACHE) ? EMP_FEATURE_CACHE : 0))
+
+/** @brief State of the features exchange with the remote. */
+enum emp_hello_state {
+	/** The first subscription was not sent yet. */
+	EMP_HELLO_NONE,
+	/** Waiting for the remote features. */
+	EMP_HELLO_PENDING,
+	/** The remote features are known, zero for the remotes without the extensions. */
+	EMP_HELLO_DONE,
+};
+
 /**
  * @brief The command base structure.
  */
@@ -42,6 +106,47 @@ struct emp_cmd {
 	enum emp_cmd_code code;
 };
 
+/**
+ * @brief The command structure used to subscribe by the event name hash.
+ */
+struct emp_cmd_subscribe_hash {
+	enum emp_cmd_code code;
+	const struct event_type *id;
+	uint32_t hash;
+};
+
+/**
+ * @brief Extension of the first subscribe command sent to the remote.
+ *
+ * It follows the event name, aligned to the word size.
+ * Remotes that do not know the extension ignore it and do not reply.
+ * The signature identifies the event types of the core sending the command.
+ */
+struct emp_subscribe_hello {
+	uint32_t magic;
+	uint32_t features;
+	uint32_t signature;
+};
+
+/**
+ * @brief The command structure used to reply to the subscribe command extension.
+ */
+struct emp_cmd_features {
+	enum emp_cmd_code code;
+	uint32_t features;
+	uint32_t cache_hit;
+};
+
+/**
+ * @brief The command structure used to start.
+ *
+ * The flags are optional, a start command without them is accepted.
+ */
+struct emp_cmd_start {
+	enum emp_cmd_code code;
+	uint32_t flags;
+};
+
 /**
  * @brief The command structure used to subscribe.
  */
@@ -51,15 +156,83 @@ struct emp_cmd_subscribe {
 	char name[];
 };
 
+/**
+ * @brief The header of a single event in the batch frame.
+ *
+ * The event data follows the header and is padded to the word size.
+ */
+struct emp_batch_record {
+	uint32_t len;
+	uint32_t data[];
+};
+
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+/** @brief Frame with multiple events to be sent in one IPC message. */
+struct emp_batch_frame {
+	size_t len;
+	uint32_t buffer[EMP_BATCH_FRAME_WORDS];
+};
+
+/**
+ * @brief Queue of the frames waiting for transmission.
+ *
+ * The last queued frame is open and new events are appended to it.
+ */
+struct emp_batch {
+	struct emp_batch_frame frame[CONFIG_EVENT_MANAGER_PROXY_BATCH_FRAME_COUNT];
+	size_t head;
+	size_t cnt;
+	unsigned int dropped;
+	struct k_mutex lock;
+	struct k_work_delayable flush_work;
+};
+#endif /* CONFIG_EVENT_MANAGER_PROXY_BATCH */
+
 /** @brief Inter-core communication data. */
 struct emp_ipc_data {
 	struct ipc_ept ept;
 	struct ipc_ept_cfg ept_cfg;
 	bool used;
 	bool started;
+	bool remote_batch;
+	bool remote_cache_hit;
+	bool map_unconfirmed;
+	enum emp_hello_state hello;
+	uint32_t remote_features;
+	uint32_t remote_signature;
 	struct k_event bound;
 	const struct event_type **event_type_map;
+	bool *subscribed;
+	struct k_work_delayable resubscribe_work;
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+	struct emp_batch batch;
+#endif
+};
+
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+/** @brief Subscription of the remote kept in the cache. */
+struct emp_cache_entry {
+	/** The name hash of the local event type. */
+	uint32_t hash;
+	/** The event ID requested by the remote. */
+	const struct event_type *id;
+};
+
+/**
+ * @brief Subscriptions of the remote kept over the warm reset.
+ *
+ * The structure is placed in the memory that is not initialized on boot.
+ * The CRC covers all the fields after it up to the last used entry.
+ */
+struct emp_cache {
+	uint32_t magic;
+	uint32_t crc;
+	uint32_t signature;
+	uint32_t remote_signature;
+	uint32_t count;
+	struct emp_cache_entry entry[CONFIG_EVENT_MANAGER_PROXY_CACHE_SIZE];
 };
+#endif /* CONFIG_EVENT_MANAGER_PROXY_CACHE */
 
 
 /** @brief True if proxy was started. */
@@ -71,6 +244,17 @@ static K_EVENT_DEFINE(emp_all_remotes_started);
 /** @brief IPC communication data. One entry per connected core. */
 static struct emp_ipc_data emp_ipc_data[CONFIG_EVENT_MANAGER_PROXY_CH_COUNT];
 
+/** @brief True if the event type hash index is ready. */
+static bool emp_hash_index_ready;
+
+/** @brief The signature of the local event types. */
+static uint32_t emp_signature;
+
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+/** @brief Cached subscriptions. One entry per connected core. */
+static __noinit struct emp_cache emp_cache[CONFIG_EVENT_MANAGER_PROXY_CH_COUNT];
+#endif
+
 
 /**
  * @brief Find IPC structure by the given instance.
@@ -111,6 +295,129 @@ static struct event_type *find_event_by_name(const char *name)
 	return NULL;
 }
 
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ p[i]) * FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Get the hash of the event name.
+ *
+ * The hash identifies the event type between the cores.
+ *
+ * @param name The name of the event.
+ *
+ * @return The name hash.
+ */
+static uint32_t event_name_hash(const char *name)
+{
+	return fnv1a(FNV1A_INIT, name, strlen(name));
+}
+
+/**
+ * @brief Get the number of event types.
+ *
+ * @return The number of event types.
+ */
+static size_t event_type_count(void)
+{
+	return _event_type_list_end - _event_type_list_start;
+}
+
+static int hash_entry_cmp(const void *a, const void *b)
+{
+	const struct emp_hash_entry *ea = a;
+	const struct emp_hash_entry *eb = b;
+
+	if (ea->hash != eb->hash) {
+		return (ea->hash < eb->hash) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Prepare the event type index sorted by the name hash.
+ *
+ * The names are hashed once, so the subscribe commands are resolved
+ * without comparing the strings.
+ * The signature of the local event types is calculated at the same time.
+ */
+static void hash_index_prepare(void)
+{
+	size_t count = event_type_count();
+	uint32_t signature = FNV1A_INIT;
+
+	if (emp_hash_index_ready) {
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const struct event_type *et = &_event_type_list_start[i];
+		uint32_t hash = event_name_hash(et->name);
+
+		event_manager_proxy_hash_index[i].hash = hash;
+		event_manager_proxy_hash_index[i].idx = i;
+
+		/* The identifiers used by the remote are the event type addresses. */
+		signature = fnv1a(signature, &hash, sizeof(hash));
+		signature = fnv1a(signature, &et, sizeof(et));
+	}
+
+	qsort(event_manager_proxy_hash_index, count, sizeof(event_manager_proxy_hash_index[0]),
+	      hash_entry_cmp);
+
+	for (size_t i = 1; i < count; i++) {
+		if (event_manager_proxy_hash_index[i].hash ==
+		    event_manager_proxy_hash_index[i - 1].hash) {
+			LOG_ERR("Event name hash collision: %s, %s",
+				_event_type_list_start[event_manager_proxy_hash_index[i].idx].name,
+				_event_type_list_start[event_manager_proxy_hash_index[i - 1].idx].name);
+			__ASSERT_NO_MSG(false);
+		}
+	}
+
+	emp_signature = signature;
+	emp_hash_index_ready = true;
+}
+
+/**
+ * @brief Find event type by the name hash.
+ *
+ * @param hash The hash of the event name.
+ *
+ * @retval NULL    Cannot find event.
+ * @retval pointer Pointer to the event type structure.
+ */
+static struct event_type *find_event_by_hash(uint32_t hash)
+{
+	size_t lo = 0;
+	size_t hi = event_type_count();
+
+	__ASSERT_NO_MSG(emp_hash_index_ready);
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const struct emp_hash_entry *entry = &event_manager_proxy_hash_index[mid];
+
+		if (entry->hash == hash) {
+			return &_event_type_list_start[entry->idx];
+		} else if (entry->hash < hash) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * @brief Get event type position index on the event type array.
  *
@@ -139,16 +446,203 @@ static size_t ipc2idx(const struct emp_ipc_data *ipc)
 	return ipc - emp_ipc_data;
 }
 
+/**
+ * @brief Remove the subscriptions of the remote.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ */
+static void map_reset(struct emp_ipc_data *ipc)
+{
+	memset(ipc->event_type_map, 0, event_type_count() * sizeof(ipc->event_type_map[0]));
+	ipc->map_unconfirmed = false;
+
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+	emp_cache[ipc2idx(ipc)].magic = 0;
+#endif
+}
+
+/**
+ * @brief Prepare the event type map for the subscriptions of the remote.
+ *
+ * The subscriptions restored from the cache or kept over the remote restart
+ * are removed if the remote did not confirm they are still valid.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ */
+static void map_subscribe_prepare(struct emp_ipc_data *ipc)
+{
+	if (ipc->map_unconfirmed) {
+		map_reset(ipc);
+	}
+}
+
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+static uint32_t cache_crc(const struct emp_cache *cache)
+{
+	const uint8_t *start = (const uint8_t *)&cache->signature;
+	const uint8_t *end = (const uint8_t *)&cache->entry[cache->count];
+
+	return crc32_ieee(start, end - start);
+}
+
+/**
+ * @brief Check if the cache holds valid subscriptions of the remote.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ *
+ * @return True if the cached subscriptions match the local event types.
+ */
+static bool cache_valid(const struct emp_ipc_data *ipc)
+{
+	const struct emp_cache *cache = &emp_cache[ipc2idx(ipc)];
+
+	return (cache->magic == EMP_CACHE_MAGIC) &&
+	       (cache->count <= ARRAY_SIZE(cache->entry)) &&
+	       (cache->crc == cache_crc(cache)) &&
+	       (cache->signature == emp_signature);
+}
+#endif /* CONFIG_EVENT_MANAGER_PROXY_CACHE */
+
+/**
+ * @brief Check if the remote can skip sending the subscriptions.
+ *
+ * @param ipc       The related element of the @ref emp_ipc_data array.
+ * @param signature The signature of the remote event types.
+ *
+ * @return True if the cache holds valid subscriptions sent by the remote with the same signature.
+ */
+static bool cache_hit(const struct emp_ipc_data *ipc, uint32_t signature)
+{
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+	return cache_valid(ipc) && (emp_cache[ipc2idx(ipc)].remote_signature == signature);
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Restore the event type map from the cache.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ *
+ * @return True if the subscriptions were restored.
+ */
+static bool cache_restore(struct emp_ipc_data *ipc)
+{
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+	const struct emp_cache *cache = &emp_cache[ipc2idx(ipc)];
+
+	if (!cache_valid(ipc)) {
+		return false;
+	}
+
+	for (size_t i = 0; i < cache->count; i++) {
+		struct event_type *et = find_event_by_hash(cache->entry[i].hash);
+
+		if (!et) {
+			map_reset(ipc);
+			return false;
+		}
+
+		ipc->event_type_map[et2idx(et)] = cache->entry[i].id;
+	}
+
+	ipc->remote_signature = cache->remote_signature;
+	LOG_DBG("%u subscriptions of remote %zu restored", cache->count, ipc2idx(ipc));
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+static void cache_store(const struct emp_ipc_data *ipc)
+{
+#if CONFIG_EVENT_MANAGER_PROXY_CACHE
+	struct emp_cache *cache = &emp_cache[ipc2idx(ipc)];
+	uint32_t count = 0;
+
+	cache->magic = 0;
+
+	for (size_t i = 0; i < event_type_count(); i++) {
+		const struct emp_hash_entry *entry = &event_manager_proxy_hash_index[i];
+		const struct event_type *id = ipc->event_type_map[entry->idx];
+
+		if (!id) {
+			continue;
+		}
+
+		if (count == ARRAY_SIZE(cache->entry)) {
+			LOG_WRN("Subscriptions of remote %zu not cached, "
+				"increase CONFIG_EVENT_MANAGER_PROXY_CACHE_SIZE", ipc2idx(ipc));
+			return;
+		}
+
+		cache->entry[count].hash = entry->hash;
+		cache->entry[count].id = id;
+		count++;
+	}
+
+	cache->count = count;
+	cache->signature = emp_signature;
+	cache->remote_signature = ipc->remote_signature;
+	cache->crc = cache_crc(cache);
+	cache->magic = EMP_CACHE_MAGIC;
+#endif
+}
+
+/**
+ * @brief Prepare for the new handshake with the restarted remote.
+ *
+ * The remote sends the subscriptions and the start command again.
+ * If the proxy is already started, the local subscriptions are sent again
+ * to the remote from the resubscribe work.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ */
+static void remote_restart(struct emp_ipc_data *ipc)
+{
+	LOG_INF("Remote on ipc %zu restarted", ipc2idx(ipc));
+
+	ipc->started = false;
+	ipc->remote_batch = false;
+	ipc->remote_cache_hit = false;
+	ipc->hello = EMP_HELLO_NONE;
+	ipc->remote_features = 0;
+	/* The remote confirms with its first subscription if the map is still valid. */
+	ipc->map_unconfirmed = true;
+	k_event_set(&ipc->bound, 0);
+
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+	/* The events queued for the previous remote instance are dropped. */
+	k_work_cancel_delayable(&ipc->batch.flush_work);
+	k_mutex_lock(&ipc->batch.lock, K_FOREVER);
+	ipc->batch.cnt = 0;
+	ipc->batch.dropped = 0;
+	k_mutex_unlock(&ipc->batch.lock);
+#endif
+
+	if (emp_started) {
+		k_work_reschedule(&ipc->resubscribe_work, K_NO_WAIT);
+	}
+}
+
 /**
  * @brief The IPC endpoint bound by remote.
  *
+ * The endpoint bound again after the transmission started means that the remote restarted.
+ *
  * @param priv The pointer of the related element of the @ref emp_ipc_data array.
  */
 static void handle_ipc_endpoint_bound(void *priv)
 {
 	struct emp_ipc_data *ipc = priv;
 
-	k_event_set(&ipc->bound, 0x1);
+	if (ipc->started) {
+		remote_restart(ipc);
+	}
+
+	k_event_post(&ipc->bound, EMP_EVENT_BOUND);
 }
 
 static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size_t len)
@@ -159,6 +653,62 @@ static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size
 	_event_submit(event);
 }
 
+static void handle_remote_batch(struct emp_ipc_data *ipc, const void *data, size_t len)
+{
+	const uint8_t *pos = data;
+	const uint8_t *end = pos + len;
+
+	while (pos < end) {
+		const struct emp_batch_record *record = (const struct emp_batch_record *)pos;
+		size_t left = end - pos;
+
+		if ((left < sizeof(*record)) ||
+		    ((left - sizeof(*record)) < record->len) ||
+		    (record->len < sizeof(struct app_event_header))) {
+			LOG_ERR("Malformed batch frame from ipc %zu", ipc2idx(ipc));
+			__ASSERT_NO_MSG(false);
+			return;
+		}
+
+		handle_remote_event(ipc, record->data, record->len);
+		pos += sizeof(*record) + ROUND_UP(record->len, sizeof(uint32_t));
+	}
+}
+
+/**
+ * @brief Handle the extension of the first subscribe command sent by the remote.
+ *
+ * The remote learns the local features and if the cached subscriptions are kept.
+ *
+ * @param ipc   The related element of the @ref emp_ipc_data array.
+ * @param hello The subscribe command extension.
+ */
+static void handle_remote_hello(struct emp_ipc_data *ipc, const struct emp_subscribe_hello *hello)
+{
+	struct emp_cmd_features reply = {
+		.code = EMP_CMD_FEATURES,
+		.features = EMP_FEATURES,
+	};
+
+	if (ipc->map_unconfirmed && cache_hit(ipc, hello->signature)) {
+		reply.cache_hit = true;
+		ipc->map_unconfirmed = false;
+	} else {
+		/* The remote sends the subscriptions again. */
+		map_reset(ipc);
+	}
+
+	ipc->remote_signature = hello->signature;
+
+	LOG_DBG("Cache %s on ipc %zu", reply.cache_hit ? "hit" : "miss", ipc2idx(ipc));
+
+	int ret = ipc_service_send(&ipc->ept, &reply, sizeof(reply));
+
+	if (ret < 0) {
+		LOG_ERR("Cannot send features to remote: %d", ret);
+	}
+}
+
 static void handle_remote_command_subscribe(struct emp_ipc_data *ipc, const void *data, size_t len)
 {
 	if (ipc->started) {
@@ -176,6 +726,24 @@ static void handle_remote_command_subscribe(struct emp_ipc_data *ipc, const void
 		return;
 	}
 
+	size_t name_len = strnlen(cmd->name, len - sizeof(*cmd));
+
+	if (name_len == (len - sizeof(*cmd))) {
+		LOG_ERR("Event name not terminated");
+		__ASSERT_NO_MSG(false);
+		return;
+	}
+
+	size_t hello_offset = ROUND_UP(sizeof(*cmd) + name_len + 1, sizeof(uint32_t));
+	const struct emp_subscribe_hello *hello =
+		(const struct emp_subscribe_hello *)((const uint8_t *)data + hello_offset);
+
+	if ((len >= (hello_offset + sizeof(*hello))) && (hello->magic == EMP_HELLO_MAGIC)) {
+		handle_remote_hello(ipc, hello);
+	}
+
+	map_subscribe_prepare(ipc);
+
 	struct event_type *et = find_event_by_name(cmd->name);
 
 	if (!et) {
@@ -189,15 +757,77 @@ static void handle_remote_command_subscribe(struct emp_ipc_data *ipc, const void
 	}
 }
 
+static void handle_remote_command_subscribe_hash(struct emp_ipc_data *ipc, const void *data,
+						 size_t len)
+{
+	const struct emp_cmd_subscribe_hash *cmd = data;
+
+	if (ipc->started) {
+		/* Reject if started. */
+		__ASSERT_NO_MSG(false);
+		return;
+	}
+
+	if (len < sizeof(*cmd)) {
+		LOG_ERR("Unexpected command size: %zu", len);
+		__ASSERT_NO_MSG(false);
+		return;
+	}
+
+	map_subscribe_prepare(ipc);
+
+	struct event_type *et = find_event_by_hash(cmd->hash);
+
+	if (!et) {
+		LOG_ERR("Cannot register event with hash: 0x%08x", cmd->hash);
+	} else {
+		ipc->event_type_map[et2idx(et)] = cmd->id;
+		LOG_DBG("Remote event %s registered on ipc %zu", et->name, ipc2idx(ipc));
+	}
+}
+
+static void handle_remote_command_features(struct emp_ipc_data *ipc, const void *data,
+					   size_t len)
+{
+	const struct emp_cmd_features *cmd = data;
+
+	if (len < sizeof(*cmd)) {
+		LOG_ERR("Unexpected command size: %zu", len);
+		__ASSERT_NO_MSG(false);
+		return;
+	}
+
+	if (ipc->hello != EMP_HELLO_PENDING) {
+		LOG_WRN("Unexpected features from remote %zu", ipc2idx(ipc));
+		return;
+	}
+
+	ipc->remote_features = cmd->features;
+	ipc->remote_cache_hit = cmd->cache_hit;
+	ipc->hello = EMP_HELLO_DONE;
+	k_event_post(&ipc->bound, EMP_EVENT_FEATURES);
+
+	if (k_work_delayable_is_pending(&ipc->resubscribe_work)) {
+		/* Do not wait for the timeout. */
+		k_work_reschedule(&ipc->resubscribe_work, K_NO_WAIT);
+	}
+}
+
 static void handle_remote_command_start(struct emp_ipc_data *ipc, const void *data, size_t len)
 {
+	const struct emp_cmd_start *cmd = data;
+
 	if (ipc->started) {
 		/* Reject if started. */
 		__ASSERT_NO_MSG(false);
 		return;
 	}
 
+	/* Remotes that do not send the flags transmit single events. */
+	ipc->remote_batch = (len >= sizeof(*cmd)) && (cmd->flags & EMP_START_FLAG_BATCH);
+	map_subscribe_prepare(ipc);
 	ipc->started = true;
+	cache_store(ipc);
 
 	LOG_DBG("Event transmission on ipc %d started", ipc2idx(ipc));
 
@@ -232,6 +862,14 @@ static void handle_remote_command(struct emp_ipc_data *ipc, const void *data, si
 		handle_remote_command_start(ipc, data, len);
 		break;
 
+	case EMP_CMD_SUBSCRIBE_HASH:
+		handle_remote_command_subscribe_hash(ipc, data, len);
+		break;
+
+	case EMP_CMD_FEATURES:
+		handle_remote_command_features(ipc, data, len);
+		break;
+
 	default:
 		LOG_ERR("Unsupported command %u", cmd->code);
 		__ASSERT_NO_MSG(false);
@@ -256,7 +894,11 @@ static void handle_ipc_data_receive(const void *data, size_t len, void *priv)
 	__ASSERT_NO_MSG(!k_is_in_isr());
 
 	if (ipc->started && emp_started) {
-		handle_remote_event(ipc, data, len);
+		if (ipc->remote_batch) {
+			handle_remote_batch(ipc, data, len);
+		} else {
+			handle_remote_event(ipc, data, len);
+		}
 	} else {
 		handle_remote_command(ipc, data, len);
 	}
@@ -274,7 +916,158 @@ static void handle_ipc_endpoint_error(const char *message, void *priv)
 	__ASSERT_NO_MSG(false);
 }
 
-static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh)
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+/**
+ * @brief Send the queued batch frames.
+ *
+ * The frames that cannot be sent because the IPC is busy are kept in the queue
+ * and the transmission is retried later from the flush work.
+ * Must be called with the batch lock taken.
+ *
+ * @param ipc The related element of the @ref emp_ipc_data array.
+ * @param all If false, the open frame is not sent.
+ *
+ * @retval 0     All requested frames were sent.
+ * @retval other The error returned by the IPC service.
+ */
+static int batch_send(struct emp_ipc_data *ipc, bool all)
+{
+	struct emp_batch *batch = &ipc->batch;
+
+	while (batch->cnt > (all ? 0 : 1)) {
+		struct emp_batch_frame *frame = &batch->frame[batch->head];
+		int ret = ipc_service_send(&ipc->ept, frame->buffer, frame->len);
+
+		if (ret < 0) {
+			k_work_reschedule(&batch->flush_work, EMP_BATCH_RETRY_DELAY);
+			return ret;
+		}
+
+		batch->head = (batch->head + 1) % ARRAY_SIZE(batch->frame);
+		batch->cnt--;
+	}
+
+	if (batch->dropped) {
+		LOG_WRN("%u events to remote %zu dropped", batch->dropped, ipc2idx(ipc));
+		batch->dropped = 0;
+	}
+
+	return 0;
+}
+
+static void batch_flush_work_fn(struct k_work *work)
+{
+	struct emp_batch *batch = CONTAINER_OF(k_work_delayable_from_work(work),
+					       struct emp_batch, flush_work);
+	struct emp_ipc_data *ipc = CONTAINER_OF(batch, struct emp_ipc_data, batch);
+
+	k_mutex_lock(&batch->lock, K_FOREVER);
+	(void)batch_send(ipc, true);
+	k_mutex_unlock(&batch->lock);
+}
+
+/**
+ * @brief Send the event that does not fit into the batch frame as a frame on its own.
+ *
+ * Must be called with the batch lock taken.
+ */
+static int batch_send_oversized(struct emp_ipc_data *ipc, const struct app_event_header *eh,
+				const struct event_type *remote_ev, size_t size)
+{
+	uint32_t buffer[DIV_ROUND_UP(sizeof(struct emp_batch_record) + size, sizeof(uint32_t))];
+	struct emp_batch_record *record = (struct emp_batch_record *)buffer;
+	struct app_event_header *remote_eh = (struct app_event_header *)record->data;
+	int ret;
+
+	/* Keep the events order. */
+	ret = batch_send(ipc, true);
+	if (!ret) {
+		record->len = size;
+		memcpy(record->data, eh, size);
+		remote_eh->type_id = remote_ev;
+
+		ret = ipc_service_send(&ipc->ept, buffer, sizeof(buffer));
+	}
+
+	return ret;
+}
+
+/**
+ * @brief Append the event to the open batch frame.
+ *
+ * Used only for the remotes that announced batching in the START command.
+ */
+static int send_event_batched(struct emp_ipc_data *ipc, const struct app_event_header *eh)
+{
+	const struct event_type *remote_ev = ipc->event_type_map[et2idx(eh->type_id)];
+	struct emp_batch *batch = &ipc->batch;
+	struct emp_batch_frame *frame;
+	struct emp_batch_record *record;
+	struct app_event_header *remote_eh;
+	size_t size;
+	size_t record_size;
+	int ret = 0;
+
+	if (remote_ev == NULL) {
+		return 0;
+	}
+
+	size = app_event_manager_event_size(eh);
+	record_size = sizeof(*record) + ROUND_UP(size, sizeof(uint32_t));
+
+	k_mutex_lock(&batch->lock, K_FOREVER);
+
+	if (record_size > sizeof(batch->frame[0].buffer)) {
+		ret = batch_send_oversized(ipc, eh, remote_ev, size);
+		goto out;
+	}
+
+	frame = (batch->cnt == 0) ? NULL :
+		&batch->frame[(batch->head + batch->cnt - 1) % ARRAY_SIZE(batch->frame)];
+
+	if (!frame || (frame->len + record_size > sizeof(frame->buffer))) {
+		if (batch->cnt == ARRAY_SIZE(batch->frame)) {
+			/* All frames are waiting for the IPC, try to release one. */
+			(void)batch_send(ipc, true);
+			if (batch->cnt == ARRAY_SIZE(batch->frame)) {
+				ret = -ENOBUFS;
+				goto out;
+			}
+		}
+
+		frame = &batch->frame[(batch->head + batch->cnt) % ARRAY_SIZE(batch->frame)];
+		frame->len = 0;
+		batch->cnt++;
+	}
+
+	record = (struct emp_batch_record *)((uint8_t *)frame->buffer + frame->len);
+	record->len = size;
+	memcpy(record->data, eh, size);
+	remote_eh = (struct app_event_header *)record->data;
+	remote_eh->type_id = remote_ev;
+	frame->len += record_size;
+
+	if (batch->cnt > 1) {
+		/* Send the full frames right away. */
+		(void)batch_send(ipc, false);
+	}
+
+	/* The deadline is counted from the first event waiting in the queue. */
+	k_work_schedule(&batch->flush_work, EMP_BATCH_TIMEOUT);
+
+out:
+	if (ret < 0) {
+		batch->dropped++;
+		ret = 0;
+	}
+
+	k_mutex_unlock(&batch->lock);
+
+	return ret;
+}
+#endif /* CONFIG_EVENT_MANAGER_PROXY_BATCH */
+
+static int send_event_single(struct emp_ipc_data *ipc, const struct app_event_header *eh)
 {
 	const struct event_type *remote_ev = ipc->event_type_map[et2idx(eh->type_id)];
 	int ret;
@@ -306,6 +1099,18 @@ static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event
 	return ret;
 }
 
+static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh)
+{
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+	/* Remotes that did not announce batching cannot unpack the frames. */
+	if (ipc->remote_batch) {
+		return send_event_batched(ipc, eh);
+	}
+#endif
+
+	return send_event_single(ipc, eh);
+}
+
 static void event_manager_proxy_on_event_process(const struct app_event_header *eh)
 {
 	int ret = 0;
@@ -326,6 +1131,162 @@ static void event_manager_proxy_on_event_process(const struct app_event_header *
 }
 APP_EVENT_HOOK_POSTPROCESS_REGISTER(event_manager_proxy_on_event_process);
 
+/**
+ * @brief Send the subscribe command to the remote.
+ *
+ * The command carrying the event name hash is used only if the remote advertised it supports it.
+ *
+ * @param ipc            The related element of the @ref emp_ipc_data array.
+ * @param local_event_id The local event type, its name identifies the remote event.
+ * @param hello          Append the extension with the local features and signature.
+ *
+ * @retval 0     The command was sent.
+ * @retval other The error returned by the IPC service.
+ */
+static int send_subscribe_command(struct emp_ipc_data *ipc,
+				  const struct event_type *local_event_id,
+				  bool hello)
+{
+	int ret;
+
+	if (!hello && (ipc->remote_features & EMP_FEATURE_SUBSCRIBE_HASH)) {
+		const struct emp_cmd_subscribe_hash cmd = {
+			.code = EMP_CMD_SUBSCRIBE_HASH,
+			.id = local_event_id,
+			.hash = event_name_hash(local_event_id->name),
+		};
+
+		ret = ipc_service_send(&ipc->ept, &cmd, sizeof(cmd));
+		return (ret < 0) ? ret : 0;
+	}
+
+	/* The name based command is understood by every remote. */
+	struct emp_cmd_subscribe *cmd;
+	size_t size = ROUND_UP(sizeof(*cmd) + strlen(local_event_id->name) + 1, sizeof(uint32_t));
+	size_t hello_size = hello ? sizeof(struct emp_subscribe_hello) : 0;
+	uint32_t buffer[(size + hello_size) / sizeof(uint32_t)];
+
+	memset(buffer, 0, sizeof(buffer));
+	cmd = (struct emp_cmd_subscribe *)buffer;
+	cmd->code = EMP_CMD_SUBSCRIBE;
+	cmd->id = local_event_id;
+	strcpy(cmd->name, local_event_id->name);
+
+	if (hello) {
+		struct emp_subscribe_hello *ext =
+			(struct emp_subscribe_hello *)((uint8_t *)buffer + size);
+
+		ext->magic = EMP_HELLO_MAGIC;
+		ext->features = EMP_FEATURES;
+		ext->signature = emp_signature;
+	}
+
+	ret = ipc_service_send(&ipc->ept, buffer, sizeof(buffer));
+
+	return (ret < 0) ? ret : 0;
+}
+
+/**
+ * @brief Send the first subscription with the local features and signature.
+ *
+ * The remote replies with its features and tells if it still holds
+ * the subscriptions sent before the reset.
+ * Remotes that do not know the extension do not reply.
+ */
+static int send_hello(struct emp_ipc_data *ipc, const struct event_type *local_event_id)
+{
+	ipc->remote_features = 0;
+	ipc->remote_cache_hit = false;
+	ipc->hello = EMP_HELLO_PENDING;
+
+	return send_subscribe_command(ipc, local_event_id, true);
+}
+
+/**
+ * @brief Stop waiting for the remote features.
+ *
+ * If the remote did not reply, it supports only the name based subscribe command.
+ */
+static void hello_done(struct emp_ipc_data *ipc)
+{
+	if (ipc->hello == EMP_HELLO_PENDING) {
+		LOG_DBG("No features from remote %zu", ipc2idx(ipc));
+		ipc->hello = EMP_HELLO_DONE;
+	}
+}
+
+static int send_start_command(struct emp_ipc_data *ipc)
+{
+	const struct emp_cmd_start cmd = {
+		.code = EMP_CMD_START,
+		.flags = IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH) ? EMP_START_FLAG_BATCH : 0,
+	};
+	int ret = ipc_service_send(&ipc->ept, &cmd, sizeof(cmd));
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Send the local subscriptions and the start command to the restarted remote.
+ *
+ * The work runs first to send the subscription with the extension and then again
+ * when the remote replies with its features or when the reply timeout expires.
+ */
+static void resubscribe_work_fn(struct k_work *work)
+{
+	struct emp_ipc_data *ipc = CONTAINER_OF(k_work_delayable_from_work(work),
+						struct emp_ipc_data, resubscribe_work);
+	size_t count = event_type_count();
+	size_t first = count;
+	int ret = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		if (ipc->subscribed[i]) {
+			first = i;
+			break;
+		}
+	}
+
+	if ((ipc->hello == EMP_HELLO_NONE) && (first < count)) {
+		/* The reply or the timeout runs the work again. */
+		k_work_schedule(&ipc->resubscribe_work, EMP_BIND_TIMEOUT);
+
+		ret = send_hello(ipc, &_event_type_list_start[first]);
+		if (ret) {
+			k_work_cancel_delayable(&ipc->resubscribe_work);
+			goto error;
+		}
+
+		return;
+	}
+
+	hello_done(ipc);
+
+	for (size_t i = first + 1; (i < count) && !ipc->remote_cache_hit; i++) {
+		if (!ipc->subscribed[i]) {
+			continue;
+		}
+
+		ret = send_subscribe_command(ipc, &_event_type_list_start[i], false);
+		if (ret) {
+			goto error;
+		}
+	}
+
+	ret = send_start_command(ipc);
+	if (!ret) {
+		LOG_DBG("Subscriptions sent again to remote %zu", ipc2idx(ipc));
+		return;
+	}
+
+error:
+	LOG_ERR("Cannot subscribe to restarted remote %zu: %d", ipc2idx(ipc), ret);
+}
+
 static int add_ipc_instace(struct emp_ipc_data *ipc, const struct device *instance)
 {
 	int ret = ipc_service_open_instance(instance);
@@ -346,15 +1307,36 @@ static int add_ipc_instace(struct emp_ipc_data *ipc, const struct device *instan
 		.priv = ipc
 	};
 
-	size_t event_type_count = _event_type_list_end - _event_type_list_start;
+	size_t count = event_type_count();
 
-	ipc->event_type_map = (void *)&event_manager_proxy_array[ipc2idx(ipc) * event_type_count];
+	hash_index_prepare();
+
+	ipc->hello = EMP_HELLO_NONE;
+	ipc->remote_features = 0;
+	ipc->remote_signature = 0;
+	ipc->remote_cache_hit = false;
+	ipc->event_type_map = (void *)&event_manager_proxy_array[ipc2idx(ipc) * count];
 	__ASSERT_NO_MSG((char *)ipc->event_type_map < (char *)_event_manager_proxy_array_list_end);
-	__ASSERT_NO_MSG((char *)(ipc->event_type_map + event_type_count) <=
+	__ASSERT_NO_MSG((char *)(ipc->event_type_map + count) <=
 			(char *)_event_manager_proxy_array_list_end);
-	memset(ipc->event_type_map, 0, event_type_count * sizeof(ipc->event_type_map[0]));
+	memset(ipc->event_type_map, 0, count * sizeof(ipc->event_type_map[0]));
+
+	ipc->subscribed = &event_manager_proxy_subscribed[ipc2idx(ipc) * count];
+	memset(ipc->subscribed, 0, count * sizeof(ipc->subscribed[0]));
+
+	/* The restored subscriptions are used only if the remote confirms them. */
+	ipc->map_unconfirmed = cache_restore(ipc);
 
 	k_event_init(&ipc->bound);
+	k_work_init_delayable(&ipc->resubscribe_work, resubscribe_work_fn);
+
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+	ipc->batch.head = 0;
+	ipc->batch.cnt = 0;
+	ipc->batch.dropped = 0;
+	k_mutex_init(&ipc->batch.lock);
+	k_work_init_delayable(&ipc->batch.flush_work, batch_flush_work_fn);
+#endif
 
 	ret = ipc_service_register_endpoint(instance, &ipc->ept, &ipc->ept_cfg);
 	if (ret) {
@@ -387,33 +1369,41 @@ int event_manager_proxy_add_remote(const struct device *instance)
 }
 
 static int send_subscribe_command_to_remote(struct emp_ipc_data *ipc,
-					   const struct event_type *local_event_id,
-					   const char *remote_event_name)
+					   const struct event_type *local_event_id)
 {
 	__ASSERT_NO_MSG(ipc);
 
-	if (!k_event_wait(&ipc->bound, 0x1, false, EMP_BIND_TIMEOUT)) {
+	if (!k_event_wait(&ipc->bound, EMP_EVENT_BOUND, false, EMP_BIND_TIMEOUT)) {
 		LOG_ERR("IPC bind timeout");
 		return -EPIPE;
 	}
 
-	/* Preparing and sending the command */
-	struct emp_cmd_subscribe *cmd;
-	size_t size = sizeof(*cmd) + strlen(remote_event_name) + 1;
-	uint32_t buffer[DIV_ROUND_UP(size, sizeof(uint32_t))];
+	/* Kept to subscribe again if the remote restarts. */
+	ipc->subscribed[et2idx(local_event_id)] = true;
 
-	cmd = (struct emp_cmd_subscribe *)buffer;
-	cmd->code = EMP_CMD_SUBSCRIBE;
-	cmd->id  = local_event_id;
-	strcpy(cmd->name, remote_event_name);
+	if (ipc->hello == EMP_HELLO_NONE) {
+		int ret = send_hello(ipc, local_event_id);
 
-	int ret = ipc_service_send(&ipc->ept, buffer, sizeof(buffer));
+		if (ret) {
+			return ret;
+		}
 
-	if (ret < 0) {
-		return ret;
+		if (!k_event_wait(&ipc->bound, EMP_EVENT_FEATURES, false, EMP_BIND_TIMEOUT)) {
+			hello_done(ipc);
+		}
+
+		LOG_DBG("Remote on ipc %zu %s the subscriptions", ipc2idx(ipc),
+			ipc->remote_cache_hit ? "keeps" : "does not keep");
+
+		return 0;
 	}
 
-	return 0;
+	if (ipc->remote_cache_hit) {
+		/* The remote holds the subscription from before the reset. */
+		return 0;
+	}
+
+	return send_subscribe_command(ipc, local_event_id, false);
 }
 
 int event_manager_proxy_subscribe(const struct device *instance,
@@ -423,27 +1413,19 @@ int event_manager_proxy_subscribe(const struct device *instance,
 
 	struct emp_ipc_data *ipc = find_ipc_by_instance(instance);
 
-	return send_subscribe_command_to_remote(ipc, local_event_id, local_event_id->name);
+	return send_subscribe_command_to_remote(ipc, local_event_id);
 }
 
 static int send_start_command_to_remote(struct emp_ipc_data *ipc)
 {
-	const struct emp_cmd cmd = {.code = EMP_CMD_START};
-
 	__ASSERT_NO_MSG(ipc);
 
-	if (!k_event_wait(&ipc->bound, 0x1, false, EMP_BIND_TIMEOUT)) {
+	if (!k_event_wait(&ipc->bound, EMP_EVENT_BOUND, false, EMP_BIND_TIMEOUT)) {
 		LOG_ERR("IPC bind timeout");
 		return -EPIPE;
 	}
 
-	int ret = ipc_service_send(&ipc->ept, &cmd, sizeof(cmd));
-
-	if (ret < 0) {
-		return ret;
-	}
-
-	return 0;
+	return send_start_command(ipc);
 }
 
 int event_manager_proxy_start(void)
@@ -479,3 +1461,31 @@ int event_manager_proxy_wait_for_remotes(k_timeout_t timeout)
 
 	return 0;
 }
+
+int event_manager_proxy_flush(void)
+{
+	int ret = 0;
+
+	__ASSERT_NO_MSG(emp_started);
+
+#if CONFIG_EVENT_MANAGER_PROXY_BATCH
+	for (size_t i = 0; i < ARRAY_SIZE(emp_ipc_data); ++i) {
+		struct emp_ipc_data *ipc = &emp_ipc_data[i];
+		int err;
+
+		if (!ipc->used || !ipc->started) {
+			continue;
+		}
+
+		k_mutex_lock(&ipc->batch.lock, K_FOREVER);
+		err = batch_send(ipc, true);
+		k_mutex_unlock(&ipc->batch.lock);
+
+		if (err && !ret) {
+			ret = err;
+		}
+	}
+#endif
+
+	return ret;
+}
@@ -8,6 +8,7 @@
 #include <zephyr/net/coap.h>
 #include <net/download_client.h>
 #include <zephyr/logging/log.h>
+#include <limits.h>
 #include <string.h>
 #include <zephyr/sys/__assert.h>
 
@@ -25,34 +26,59 @@ extern char *strtok_r(char *str, const char *sep, char **state);
 int url_parse_file(const char *url, char *file, size_t len);
 int socket_send(const struct download_client *client, size_t len, int timeout);
 
-static int coap_get_current_from_response_pkt(const struct coap_packet *cpkt)
-{
-	int block = 0;
+/* Smallest block size used when adapting to packet loss */
+#define BLOCK_SIZE_MIN COAP_BLOCK_64
+/* Number of blocks received without retransmission before the block size is doubled */
+#define BLOCK_SIZE_GROW_AFTER 16
 
-	block = coap_get_option_int(cpkt, COAP_OPTION_BLOCK2);
-	if (block < 0) {
-		return block;
-	}
+static struct download_client_coap_block *block_get(struct download_client *client, size_t idx)
+{
+	return &client->coap.blocks[(client->coap.head + idx) % ARRAY_SIZE(client->coap.blocks)];
+}
 
-	return GET_BLOCK_NUM(block) << (GET_BLOCK_SIZE(block) + 4);
+static size_t block_end(const struct download_client_coap_block *block)
+{
+	return block->offset + coap_block_size_to_bytes(block->block_size);
 }
 
 static bool has_pending(struct download_client *client)
 {
-	return client->coap.pending.timeout > 0;
+	for (size_t i = 0; i < client->coap.count; i++) {
+		if (block_get(client, i)->pending.timeout > 0) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 int coap_block_init(struct download_client *client, size_t from)
 {
+	const size_t block_max = coap_block_size_to_bytes(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE);
+
 	coap_block_transfer_init(&client->coap.block_ctx,
 				 CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE, 0);
 	client->coap.block_ctx.current = from;
+
+	client->coap.head = 0;
+	client->coap.count = 0;
+	client->coap.block_size = CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE;
+	client->coap.blocks_without_loss = 0;
+
+	/* Blocks that follow each other are reported in one fragment,
+	 * so the buffer must hold the blocks of the whole window.
+	 */
+	client->coap.window = CLAMP(CONFIG_DOWNLOAD_CLIENT_BUF_SIZE / block_max,
+				    1, CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE);
+
 	return 0;
 }
 
 int coap_get_recv_timeout(struct download_client *dl)
 {
 	int timeout;
+	int min_timeout = INT_MAX;
+	struct download_client_coap_block *block;
 
 	__ASSERT(has_pending(dl), "Must have coap pending");
 
@@ -60,8 +86,17 @@ int coap_get_recv_timeout(struct download_client *dl)
 	 * blocks, the time that is used for sending request must be substracted next time
 	 * recv() is called.
 	 */
-	timeout = dl->coap.pending.t0 + dl->coap.pending.timeout - k_uptime_get_32();
-	if (timeout < 0) {
+	for (size_t i = 0; i < dl->coap.count; i++) {
+		block = block_get(dl, i);
+		if (block->pending.timeout == 0) {
+			continue;
+		}
+
+		timeout = block->pending.t0 + block->pending.timeout - k_uptime_get_32();
+		min_timeout = MIN(min_timeout, timeout);
+	}
+
+	if (min_timeout < 0) {
 		/* All time is spent when sending request and time this
 		 * method is called, there is no time left for receiving;
 		 * skip over recv() and initiate retransmission on next
@@ -70,77 +105,230 @@ int coap_get_recv_timeout(struct download_client *dl)
 		return 0;
 	}
 
-	return timeout;
+	return min_timeout;
 }
 
 int coap_initiate_retransmission(struct download_client *dl)
 {
-	if (dl->coap.pending.timeout == 0) {
+	bool retransmit = false;
+	struct download_client_coap_block *block;
+
+	if (!has_pending(dl)) {
 		return -EINVAL;
 	}
 
-	if (!coap_pending_cycle(&dl->coap.pending)) {
-		LOG_ERR("CoAP max-retransmissions exceeded");
-		return -1;
+	for (size_t i = 0; i < dl->coap.count; i++) {
+		block = block_get(dl, i);
+		if (block->pending.timeout == 0 ||
+		    (int32_t)(block->pending.t0 + block->pending.timeout - k_uptime_get_32()) > 0) {
+			continue;
+		}
+
+		if (!coap_pending_cycle(&block->pending)) {
+			LOG_ERR("CoAP max-retransmissions exceeded");
+			return -1;
+		}
+
+		LOG_DBG("Retransmitting request for block at %d", block->offset);
+		block->send = true;
+		retransmit = true;
+	}
+
+	if (!retransmit) {
+		/* recv() returned before the first request timed out */
+		return 0;
+	}
+
+	dl->coap.blocks_without_loss = 0;
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_ADAPTIVE_BLOCK_SIZE) &&
+	    dl->coap.block_size > BLOCK_SIZE_MIN) {
+		dl->coap.block_size--;
+		LOG_DBG("Block size decreased to %d bytes",
+			coap_block_size_to_bytes(dl->coap.block_size));
 	}
 
 	return 0;
 }
 
-static int coap_block_update(struct download_client *client, struct coap_packet *pkt,
-			     size_t *blk_off, bool *more)
+static void block_size_update(struct download_client *client)
 {
-	int err, new_current;
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_ADAPTIVE_BLOCK_SIZE)) {
+		return;
+	}
 
-	*blk_off = client->coap.block_ctx.current %
-		   coap_block_size_to_bytes(client->coap.block_ctx.block_size);
-	if (*blk_off) {
-		LOG_DBG("%d bytes of current block already downloaded",
-			*blk_off);
+	client->coap.blocks_without_loss++;
+
+	if (client->coap.blocks_without_loss >= BLOCK_SIZE_GROW_AFTER &&
+	    client->coap.block_size < client->coap.block_ctx.block_size) {
+		client->coap.blocks_without_loss = 0;
+		client->coap.block_size++;
+		LOG_DBG("Block size increased to %d bytes",
+			coap_block_size_to_bytes(client->coap.block_size));
 	}
+}
 
-	new_current = coap_get_current_from_response_pkt(pkt);
-	if (new_current < 0) {
-		LOG_ERR("Failed to get current from CoAP packet, err %d", new_current);
-		return new_current;
+/* Returns the block request that the response belongs to, or NULL if the
+ * response is a duplicate or belongs to a request that is no longer in flight.
+ */
+static struct download_client_coap_block *block_find(struct download_client *client,
+						     const struct coap_packet *response,
+						     size_t *idx)
+{
+	struct download_client_coap_block *block;
+	const uint16_t id = coap_header_get_id(response);
+
+	for (size_t i = 0; i < client->coap.count; i++) {
+		block = block_get(client, i);
+		if (!block->received && block->pending.timeout > 0 && block->pending.id == id) {
+			*idx = i;
+			return block;
+		}
 	}
 
-	if (new_current < client->coap.block_ctx.current) {
-		LOG_WRN("Block out of order %d, expected %d", new_current,
-			client->coap.block_ctx.current);
-		return -1;
-	} else if (new_current > client->coap.block_ctx.current) {
-		LOG_WRN("Block out of order %d, expected %d", new_current,
-			client->coap.block_ctx.current);
-		return -1;
+	return NULL;
+}
+
+static int block_request_send(struct download_client *client,
+			      struct download_client_coap_block *block)
+{
+	int err;
+	uint16_t id;
+	char file[FILENAME_SIZE];
+	char *path_elem;
+	char *path_elem_saveptr;
+	struct coap_packet request;
+	struct coap_block_context block_ctx = client->coap.block_ctx;
+
+	if (block->pending.timeout > 0) {
+		id = block->pending.id;
+	} else {
+		id = coap_next_id();
 	}
 
-	err = coap_update_from_block(pkt, &client->coap.block_ctx);
+	err = coap_packet_init(&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, COAP_VER,
+			       COAP_TYPE_CON, 8, coap_next_token(), COAP_METHOD_GET, id);
 	if (err) {
+		LOG_ERR("Failed to init CoAP message, err %d", err);
 		return err;
 	}
 
-	if (client->file_size == 0 && client->coap.block_ctx.total_size > 0) {
-		LOG_DBG("Total size: %d", client->coap.block_ctx.total_size);
-		client->file_size = client->coap.block_ctx.total_size;
+	err = url_parse_file(client->file, file, sizeof(file));
+	if (err) {
+		LOG_ERR("Unable to parse url");
+		return err;
 	}
 
-	*more = coap_next_block(pkt, &client->coap.block_ctx);
-	if (!*more) {
-		LOG_DBG("Last block received");
+	path_elem = strtok_r(file, COAP_PATH_ELEM_DELIM, &path_elem_saveptr);
+	do {
+		err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
+			path_elem, strlen(path_elem));
+		if (err) {
+			LOG_ERR("Unable add option to request");
+			return err;
+		}
+	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
+
+	block_ctx.current = block->offset;
+	block_ctx.block_size = block->block_size;
+
+	err = coap_append_block2_option(&request, &block_ctx);
+	if (err) {
+		LOG_ERR("Unable to add block2 option");
+		return err;
+	}
+
+	err = coap_append_size2_option(&request, &block_ctx);
+	if (err) {
+		LOG_ERR("Unable to add size2 option");
+		return err;
+	}
+
+	if (block->pending.timeout == 0) {
+		err = coap_pending_init(&block->pending, &request, &client->remote_addr,
+					CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT);
+		if (err < 0) {
+			return -EINVAL;
+		}
+
+		coap_pending_cycle(&block->pending);
+	}
+
+	LOG_DBG("CoAP next block: %d", block->offset);
+
+	err = socket_send(client, request.offset, block->pending.timeout);
+	if (err) {
+		LOG_ERR("Failed to send CoAP request, errno %d", errno);
+		return err;
+	}
+
+	block->send = false;
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
 	}
 
 	return 0;
 }
 
+/* Move the payload of the oldest block, and of the blocks following it
+ * that have already been received, to the beginning of the buffer.
+ */
+static void blocks_deliver(struct download_client *client, const uint8_t *payload,
+			   uint16_t payload_len)
+{
+	struct download_client_coap_block *block = block_get(client, 0);
+	/* Bytes of the first block that were downloaded before the download was resumed */
+	const size_t blk_off = client->progress - block->offset;
+	size_t len = payload_len - blk_off;
+
+	if (blk_off) {
+		LOG_DBG("%d bytes of current block already downloaded", blk_off);
+	}
+
+	LOG_DBG("CoAP response: copying %d bytes", len);
+	memmove(client->buf, payload + blk_off, len);
+	client->offset = 0;
+
+	while (true) {
+		client->offset += len;
+		client->progress += len;
+		client->coap.head = (client->coap.head + 1) % ARRAY_SIZE(client->coap.blocks);
+		client->coap.count--;
+
+		if (client->coap.count == 0) {
+			break;
+		}
+
+		block = block_get(client, 0);
+		if (!block->received) {
+			break;
+		}
+
+#if CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE > 1
+		/* The window is limited so that its blocks fit in the buffer */
+		__ASSERT(client->offset + block->len <= sizeof(client->buf), "Buffer overflow");
+
+		LOG_DBG("Copying %d bytes received ahead", block->len);
+		memcpy(client->buf + client->offset, block->data, block->len);
+		len = block->len;
+#endif
+	}
+
+	client->coap.block_ctx.current = client->progress;
+}
+
 int coap_parse(struct download_client *client, size_t len)
 {
 	int err;
-	size_t blk_off;
+	int block2;
+	int size2;
+	size_t idx;
 	uint8_t response_code;
 	uint16_t payload_len;
 	const uint8_t *payload;
 	struct coap_packet response;
+	struct download_client_coap_block *block;
 	bool more;
 
 	/* TODO: currently we stop download on every error, but this is mostly not necessary
@@ -153,17 +341,29 @@ int coap_parse(struct download_client *client, size_t len)
 		return -EBADMSG;
 	}
 
-	err = coap_block_update(client, &response, &blk_off, &more);
-	if (err) {
+	block = block_find(client, &response, &idx);
+	if (!block) {
+		/* Response to a retransmitted request, whose first
+		 * response has been received already.
+		 */
+		LOG_DBG("Response is not pending, ignoring");
+		return 1;
+	}
+
+	block2 = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		LOG_ERR("Failed to get block from CoAP packet, err %d", block2);
 		return -EBADMSG;
 	}
 
-	if (coap_header_get_id(&response) != client->coap.pending.id) {
-		LOG_ERR("Response is not pending");
+	if ((GET_BLOCK_NUM(block2) << (GET_BLOCK_SIZE(block2) + 4)) != block->offset ||
+	    GET_BLOCK_SIZE(block2) > block->block_size) {
+		LOG_WRN("Block out of order %d, expected %d",
+			GET_BLOCK_NUM(block2) << (GET_BLOCK_SIZE(block2) + 4), block->offset);
 		return -EBADMSG;
 	}
 
-	coap_pending_clear(&client->coap.pending);
+	coap_pending_clear(&block->pending);
 
 	if (coap_header_get_type(&response) != COAP_TYPE_ACK) {
 		LOG_ERR("Response must be of coap type ACK");
@@ -183,97 +383,126 @@ int coap_parse(struct download_client *client, size_t len)
 		return -EBADMSG;
 	}
 
-	/* TODO: because our buffer is large enough for the whole datagram,
-	 * we don't scrictly need to copy the bytes at the beginning
-	 * of the buffer, we could simply send a fragment pointing to the
-	 * payload directly.
-	 */
-	LOG_DBG("CoAP response: %d, copying %d bytes",
-		coap_header_get_code(&response), payload_len - blk_off);
-	memcpy(client->buf + client->offset, payload + blk_off,
-	       payload_len - blk_off);
+	more = GET_MORE(block2);
+	if (payload_len > coap_block_size_to_bytes(GET_BLOCK_SIZE(block2)) ||
+	    (more && payload_len != coap_block_size_to_bytes(GET_BLOCK_SIZE(block2)))) {
+		LOG_ERR("Invalid block length %d", payload_len);
+		return -EBADMSG;
+	}
 
-	client->offset += payload_len - blk_off;
-	client->progress += payload_len - blk_off;
+	if (GET_BLOCK_SIZE(block2) < block->block_size) {
+		/* The server uses smaller blocks than requested. The requests that
+		 * follow this one ask for the wrong blocks, forget them.
+		 */
+		LOG_DBG("Server block size is %d bytes",
+			coap_block_size_to_bytes(GET_BLOCK_SIZE(block2)));
+		block->block_size = GET_BLOCK_SIZE(block2);
+		client->coap.block_ctx.block_size = block->block_size;
+		client->coap.block_size = MIN(client->coap.block_size, block->block_size);
+		client->coap.count = idx + 1;
+
+		if (block_end(block) <= client->progress) {
+			/* The smaller block ends before the point where the download
+			 * was resumed, request the block that holds the next byte.
+			 */
+			block->offset = ROUND_DOWN(client->progress,
+						   coap_block_size_to_bytes(block->block_size));
+			err = block_request_send(client, block);
+			return err ? err : 1;
+		}
+	}
+
+	size2 = coap_get_option_int(&response, COAP_OPTION_SIZE2);
+	if (client->file_size == 0 && size2 > 0) {
+		LOG_DBG("Total size: %d", size2);
+		client->file_size = size2;
+		client->coap.block_ctx.total_size = size2;
+	}
 
 	if (!more) {
+		LOG_DBG("Last block received");
 		/* Mark the end, in case we did not know the total size */
-		client->file_size = client->progress;
+		client->file_size = block->offset + payload_len;
+		client->coap.count = idx + 1;
 	}
 
+	block->received = true;
+	block_size_update(client);
+
+	if (idx != 0) {
+#if CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE > 1
+		/* Keep the block until the blocks before it have been received */
+		LOG_DBG("Block at %d received ahead", block->offset);
+		memcpy(block->data, payload, payload_len);
+		block->len = payload_len;
+#endif
+		return 1;
+	}
+
+	blocks_deliver(client, payload, payload_len);
+
 	return 0;
 }
 
-int coap_request_send(struct download_client *client)
+/* Returns the next block to request, or NULL if the window is full. */
+static struct download_client_coap_block *block_next(struct download_client *client)
 {
-	int err;
-	uint16_t id;
-	char file[FILENAME_SIZE];
-	char *path_elem;
-	char *path_elem_saveptr;
-	struct coap_packet request;
+	size_t offset;
+	enum coap_block_size block_size = client->coap.block_size;
+	struct download_client_coap_block *block;
+
+	if (client->coap.count == 0) {
+		/* Request the block that holds the next byte */
+		offset = ROUND_DOWN(client->progress, coap_block_size_to_bytes(block_size));
+	} else if (client->coap.count < client->coap.window && client->file_size != 0) {
+		/* Only request blocks ahead when the end of the file is known */
+		offset = block_end(block_get(client, client->coap.count - 1));
+		if (offset >= client->file_size) {
+			return NULL;
+		}
 
-	if (has_pending(client)) {
-		id = client->coap.pending.id;
+		/* Block numbers count blocks of the requested size */
+		while (offset % coap_block_size_to_bytes(block_size)) {
+			block_size--;
+		}
 	} else {
-		id = coap_next_id();
+		return NULL;
 	}
 
-	err = coap_packet_init(&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, COAP_VER,
-			       COAP_TYPE_CON, 8, coap_next_token(), COAP_METHOD_GET, id);
-	if (err) {
-		LOG_ERR("Failed to init CoAP message, err %d", err);
-		return err;
-	}
+	block = block_get(client, client->coap.count);
+	memset(&block->pending, 0, sizeof(block->pending));
+	block->offset = offset;
+	block->block_size = block_size;
+	block->send = true;
+	block->received = false;
 
-	err = url_parse_file(client->file, file, sizeof(file));
-	if (err) {
-		LOG_ERR("Unable to parse url");
-		return err;
-	}
+	client->coap.count++;
 
-	path_elem = strtok_r(file, COAP_PATH_ELEM_DELIM, &path_elem_saveptr);
-	do {
-		err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
-			path_elem, strlen(path_elem));
-		if (err) {
-			LOG_ERR("Unable add option to request");
-			return err;
-		}
-	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
-
-	err = coap_append_block2_option(&request, &client->coap.block_ctx);
-	if (err) {
-		LOG_ERR("Unable to add block2 option");
-		return err;
-	}
-
-	err = coap_append_size2_option(&request, &client->coap.block_ctx);
-	if (err) {
-		LOG_ERR("Unable to add size2 option");
-		return err;
-	}
+	return block;
+}
 
-	if (!has_pending(client)) {
-		err = coap_pending_init(&client->coap.pending, &request, &client->remote_addr,
-					CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT);
-		if (err < 0) {
-			return -EINVAL;
+int coap_request_send(struct download_client *client)
+{
+	int err;
+	struct download_client_coap_block *block;
+
+	/* Retransmit the requests that have timed out */
+	for (size_t i = 0; i < client->coap.count; i++) {
+		block = block_get(client, i);
+		if (block->send) {
+			err = block_request_send(client, block);
+			if (err) {
+				return err;
+			}
 		}
-
-		coap_pending_cycle(&client->coap.pending);
 	}
 
-	LOG_DBG("CoAP next block: %d", client->coap.block_ctx.current);
-
-	err = socket_send(client, request.offset, client->coap.pending.timeout);
-	if (err) {
-		LOG_ERR("Failed to send CoAP request, errno %d", errno);
-		return err;
-	}
-
-	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
+	/* Fill the window */
+	while ((block = block_next(client)) != NULL) {
+		err = block_request_send(client, block);
+		if (err) {
+			return err;
+		}
 	}
 
 	return 0;
@@ -34,6 +34,7 @@ int url_parse_host(const char *url, char *host, size_t len);
 
 int http_parse(struct download_client *client, size_t len);
 int http_get_request_send(struct download_client *client);
+size_t http_recv_max(const struct download_client *client);
 
 int coap_block_init(struct download_client *client, size_t from);
 int coap_get_recv_timeout(struct download_client *dl);
@@ -399,6 +400,9 @@ static int client_connect(struct download_client *dl)
 	if (err) {
 		err = -errno;
 		LOG_ERR("Unable to connect, errno %d", -err);
+	} else {
+		/* Nothing is in flight on a new connection */
+		dl->http.requested = 0;
 	}
 
 cleanup:
@@ -497,18 +501,30 @@ static int reconnect(struct download_client *dl)
 		dl->fd = -1;
 	}
 	err = client_connect(dl);
+	if (err) {
+		return err;
+	}
 
-	return err;
+	/* Requests in flight on the old socket are lost */
+	if (IS_ENABLED(CONFIG_COAP) &&
+	    (dl->proto == IPPROTO_UDP || dl->proto == IPPROTO_DTLS_1_2)) {
+		coap_block_init(dl, dl->progress);
+	}
+
+	return 0;
 }
 
 static ssize_t socket_recv(struct download_client *dl)
 {
 	int err, timeout = 0;
+	size_t len = sizeof(dl->buf) - dl->offset;
 
 	switch (dl->proto) {
 	case IPPROTO_TCP:
 	case IPPROTO_TLS_1_2:
 		timeout = CONFIG_DOWNLOAD_CLIENT_TCP_SOCK_TIMEO_MS;
+		/* Don't read into the responses to pipelined requests */
+		len = MIN(len, http_recv_max(dl));
 		break;
 	case IPPROTO_UDP:
 	case IPPROTO_DTLS_1_2:
@@ -530,7 +546,7 @@ static ssize_t socket_recv(struct download_client *dl)
 		return -1;
 	}
 
-	return recv(dl->fd, dl->buf + dl->offset, sizeof(dl->buf) - dl->offset, 0);
+	return recv(dl->fd, dl->buf + dl->offset, len, 0);
 }
 
 static int request_resend(struct download_client *dl)
@@ -650,7 +666,9 @@ static int handle_received(struct download_client *dl, ssize_t len)
 	} else if (IS_ENABLED(CONFIG_COAP)) {
 		rc = coap_parse(dl, (size_t)len);
 		if (rc == 1) {
-			/* Duplicate packet received */
+			/* Duplicate packet, or block received ahead of the
+			 * blocks preceding it.
+			 */
 			return 1;
 		}
 	} else {
@@ -835,6 +853,17 @@ void download_thread(void *client, void *a, void *b)
 			}
 		}
 
+		if (dl->fd != -1 && dl->http.requested > dl->progress) {
+			/* Responses to pipelined requests are still on their way,
+			 * they would be taken for the response to the next request.
+			 */
+			k_mutex_lock(&dl->mutex, K_FOREVER);
+			LOG_DBG("Closing connection with requests in flight");
+			close(dl->fd);
+			dl->fd = -1;
+			k_mutex_unlock(&dl->mutex);
+		}
+
 		if (is_downloading(dl)) {
 			if (dl->close_when_done) {
 				set_state(dl, DOWNLOAD_CLIENT_CLOSING);
@@ -952,9 +981,14 @@ int download_client_start(struct download_client *client, const char *file,
 	client->progress = from;
 	client->offset = 0;
 	client->http.has_header = false;
-	if (is_idle(client)) {
+	client->http.requested = 0;
+	if (is_idle(client) || client->fd == -1) {
 		set_state(client, DOWNLOAD_CLIENT_CONNECTING);
 	} else {
+		if (IS_ENABLED(CONFIG_COAP) &&
+		    (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2)) {
+			coap_block_init(client, from);
+		}
 		set_state(client, DOWNLOAD_CLIENT_DOWNLOADING);
 	}
 
@@ -46,11 +46,91 @@ int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
 int socket_send(const struct download_client *client, size_t len, int timeout);
 
-int http_get_request_send(struct download_client *client)
+static size_t frag_size_get(const struct download_client *client)
+{
+	if (client->config.frag_size_override) {
+		return client->config.frag_size_override;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static size_t pipeline_depth_get(const struct download_client *client)
+{
+	if (client->config.http_pipeline_depth) {
+		return client->config.http_pipeline_depth;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH;
+}
+
+static int http_request_send(struct download_client *client, int len)
+{
+	int err;
+
+	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+		return -ENOMEM;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+	}
+
+	err = socket_send(client, len, 0);
+	if (err) {
+		LOG_ERR("Failed to send HTTP request, errno %d", errno);
+		return err;
+	}
+
+	return 0;
+}
+
+/* Send Range requests until the configured number of fragments
+ * is in flight. Until the file size is known, that is, until the
+ * first response has been received, only one fragment is requested.
+ */
+static int http_range_requests_send(struct download_client *client,
+				    const char *file, const char *host)
 {
 	int err;
 	int len;
 	size_t off;
+	const size_t frag_size = frag_size_get(client);
+	const size_t window = pipeline_depth_get(client) * frag_size;
+	size_t from = MAX(client->progress, client->http.requested);
+
+	while (from == client->progress ||
+	       (client->file_size != 0 && from < client->file_size &&
+		from - client->progress < window)) {
+		/* Offset of last byte in range (Content-Range) */
+		off = from + frag_size - 1;
+
+		if (client->file_size != 0) {
+			/* Don't request bytes past the end of file */
+			off = MIN(off, client->file_size - 1);
+		}
+
+		len = snprintf(client->buf,
+			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
+			HTTP_GET_RANGE, file, host, from, off);
+
+		err = http_request_send(client, len);
+		if (err) {
+			return err;
+		}
+
+		from = off + 1;
+		client->http.requested = from;
+	}
+
+	return 0;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	int err;
+	int len;
 	char host[HOSTNAME_SIZE];
 	char file[FILENAME_SIZE];
 
@@ -69,53 +149,56 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
-	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
-
-	if (client->file_size != 0) {
-		/* Don't request bytes past the end of file */
-		off = MIN(off, client->file_size - 1);
-	}
-
 	if (client->proto == IPPROTO_TLS_1_2
 	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET_RANGE, file, host, client->progress, off);
 		client->http.ranged = true;
-	} else if (client->progress) {
+		return http_range_requests_send(client, file, host);
+	}
+
+	if (client->progress) {
 		len = snprintf(client->buf,
 			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 			HTTP_GET_OFFSET, file, host, client->progress);
-		client->http.ranged = false;
 	} else {
 		len = snprintf(client->buf,
 			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 			HTTP_GET, file, host);
-		client->http.ranged = false;
 	}
 
-	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
-		LOG_ERR("Cannot create GET request, buffer too small");
-		return -ENOMEM;
+	client->http.ranged = false;
+
+	return http_request_send(client, len);
+}
+
+/* Returns the number of bytes that can be received without reading
+ * into the response to the next pipelined request.
+ */
+size_t http_recv_max(const struct download_client *client)
+{
+	size_t end;
+
+	if (client->http.has_header) {
+		end = client->http.range_end;
+	} else {
+		end = client->progress + frag_size_get(client);
+		if (client->file_size != 0) {
+			end = MIN(end, client->file_size);
+		}
 	}
 
-	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+	if (!client->http.ranged || client->http.requested <= end) {
+		/* No other response follows the current one */
+		return SIZE_MAX;
 	}
 
-	err = socket_send(client, len, 0);
-	if (err) {
-		LOG_ERR("Failed to send HTTP request, errno %d", errno);
-		return err;
+	if (!client->http.has_header) {
+		/* The end of the header has not been received yet,
+		 * so at least one more header byte precedes the payload.
+		 */
+		return end - client->progress + 1;
 	}
 
-	return 0;
+	return end - client->progress;
 }
 
 /* Returns:
@@ -258,6 +341,12 @@ int http_parse(struct download_client *client, size_t len)
 			return rc;
 		}
 
+		/* Offset of the byte following the range of this response */
+		client->http.range_end = client->progress + frag_size_get(client);
+		if (client->file_size != 0) {
+			client->http.range_end = MIN(client->http.range_end, client->file_size);
+		}
+
 		if (client->offset != hdr_len) {
 			/* The buffer contains some payload bytes,
 			 * copy them at the beginning of the buffer
@@ -289,9 +378,7 @@ int http_parse(struct download_client *client, size_t len)
 	/* Have we received a whole fragment or the whole file? */
 	if (client->progress != client->file_size) {
 		if (client->http.ranged) {
-			if (client->offset < (client->config.frag_size_override != 0 ?
-						      client->config.frag_size_override :
-						      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+			if (client->progress < client->http.range_end) {
 				/* Ranged query: read until a full fragment */
 				return 1;
 			}
@@ -5,6 +5,8 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
+#include <string.h>
 #include <strings.h>
 #include <zephyr/kernel.h>
 #include <zephyr/types.h>
@@ -14,385 +16,299 @@
 
 LOG_MODULE_REGISTER(icalendar_parser, CONFIG_ICAL_PARSER_LOG_LEVEL);
 
-static size_t unfold_contentline(const char *buf, char *prop_buf)
+/* Usable length of the line buffer, one byte is kept for the null terminator. */
+#define LINE_SIZE_MAX (sizeof(((struct icalendar_parser *)0)->line) - 1)
+
+struct ical_com {
+	const char *name;
+	enum ical_parser_evt_id id;
+};
+
+struct ical_prop {
+	const char *name;
+	/* Offset of the value buffer in struct ical_component */
+	size_t offset;
+	size_t max_value_len;
+	enum ical_parser_error_id error;
+	/* The property can have parameters, such as TZID, before the value. */
+	bool params;
+};
+
+/* Calendar components.
+ * Reference: RFC 5545 3.6 Calendar Components
+ */
+static const struct ical_com ical_coms[] = {
+	{ "VEVENT", ICAL_EVT_VEVENT },
+	{ "VTODO", ICAL_EVT_VTODO },
+	{ "VJOURNAL", ICAL_EVT_VJOURNAL },
+	{ "VFREEBUSY", ICAL_EVT_VFREEBUSY },
+	{ "VTIMEZONE", ICAL_EVT_VTIMEZONE },
+};
+
+/* Supported properties of the VEVENT component. */
+static const struct ical_prop ical_event_props[] = {
+	{ "SUMMARY", offsetof(struct ical_component, summary),
+	  CONFIG_ICAL_PARSER_SUMMARY_SIZE, ICAL_ERROR_SUMMARY, false },
+	{ "LOCATION", offsetof(struct ical_component, location),
+	  CONFIG_ICAL_PARSER_LOCATION_SIZE, ICAL_ERROR_LOCATION, false },
+	{ "DESCRIPTION", offsetof(struct ical_component, description),
+	  CONFIG_ICAL_PARSER_DESCRIPTION_SIZE, ICAL_ERROR_DESCRIPTION, false },
+	{ "DTSTART", offsetof(struct ical_component, dtstart),
+	  CONFIG_ICAL_PARSER_DTSTART_SIZE, ICAL_ERROR_DTSTART, true },
+	{ "DTEND", offsetof(struct ical_component, dtend),
+	  CONFIG_ICAL_PARSER_DTEND_SIZE, ICAL_ERROR_DTEND, true },
+};
+
+static void line_append(struct icalendar_parser *ical, const char *data, size_t len)
 {
-	const char *sol = buf;
-	char *eol;
-	uint16_t total_line_len = 0, single_line_len = 0;
+	size_t copy_len = MIN(len, LINE_SIZE_MAX - ical->line_len);
 
-	while (1) {
-		eol = strstr(sol, "\r\n");
-		if (!eol) {
-			return 0;
-		}
-		single_line_len = eol - sol;
-		if ((total_line_len + single_line_len) <= CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE) {
-			memcpy(prop_buf + total_line_len, sol, single_line_len);
-			total_line_len += single_line_len;
-		} else {
-			LOG_WRN("Property value overflow."
-				"Increase CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE.");
-			return 0;
-		}
-		if (!strncmp(eol, "\r\n ", strlen("\r\n "))) {
-			/* Long content line is split into multiple lines.
-			 * Copy the folded part to unfolded buffer.
-			 */
-			sol = eol + strlen("\r\n ");
-		} else {
-			/* Content line is delimited. */
-			break;
-		}
-	}
-	prop_buf[total_line_len] = '\0';
+	memcpy(ical->line + ical->line_len, data, copy_len);
+	ical->line_len += copy_len;
 
-	return total_line_len;
+	if (copy_len < len) {
+		ical->line_overflow = true;
+	}
 }
 
-static bool parse_desc_props(const char *buf,
-			     const char *name,
-			     size_t name_size,
-			     char *value,
-			     size_t max_value_len)
+static void line_reset(struct icalendar_parser *ical)
 {
-	bool ret;
-	size_t unfold_size;
-	char ical_prop_buf[CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE + 1];
+	ical->line_len = 0;
+	ical->line_overflow = false;
+	ical->line_break = false;
+}
 
-	unfold_size = unfold_contentline(buf, ical_prop_buf);
-	if (unfold_size <= 0) {
-		/* Property wrong format - no parameter or value. */
-		LOG_ERR("%s no value/param.", name);
-		return false;
-	}
+/* Find the value of a property with parameters, skipping quoted parameter values. */
+static const char *prop_value_find(const char *params)
+{
+	bool quoted = false;
 
-	if (ical_prop_buf[name_size] == ':') {
-		size_t value_len = unfold_size - name_size - 1;
-
-		if (value_len <= max_value_len) {
-			memcpy(value, ical_prop_buf + name_size + 1, value_len);
-			value[value_len] = '\0';
-			ret = true;
-		} else {
-			/* Property value overflow. */
-			LOG_ERR("%s value overflow.", name);
-			ret = false;
+	for (; *params != '\0'; params++) {
+		if (*params == '"') {
+			quoted = !quoted;
+		} else if (*params == ':' && !quoted) {
+			return params + 1;
 		}
-	} else if (ical_prop_buf[name_size] == ';') {
-		/* Does not support property parameter. */
-		LOG_ERR("%s param not supported.", name);
-		ret = false;
-	} else {
-		/* Property wrong format - no parameter or value. */
-		LOG_ERR("%s wrong format.", name);
-		ret = false;
 	}
 
-	return ret;
+	return NULL;
 }
 
-static bool parse_datetime_props(const char *buf,
-				 const char *name,
-				 size_t name_size,
-				 char *value,
-				 size_t max_value_len)
+static bool prop_value_get(const struct icalendar_parser *ical,
+			   const struct ical_prop *prop,
+			   size_t name_len,
+			   char *value)
 {
-	bool ret;
-	size_t unfold_size;
-	char ical_prop_buf[CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE + 1];
-
-	unfold_size = unfold_contentline(buf, ical_prop_buf);
-	if (unfold_size <= 0) {
-		/* Property wrong format - fail to unfold property. */
-		LOG_ERR("%s wrong format. Fail to unfold property", name);
+	const char *line = ical->line;
+	const char *prop_value;
+	size_t value_len;
+
+	if (ical->line_overflow) {
+		LOG_WRN("%s overflow. Increase CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE.",
+			prop->name);
 		return false;
 	}
 
-	if (ical_prop_buf[name_size] == ':') {
-		size_t value_len = unfold_size - name_size - 1;
-
-		if (value_len <= max_value_len) {
-			memcpy(value, ical_prop_buf + name_size + 1, value_len);
-			value[value_len] = '\0';
-			ret = true;
-		} else {
-			/* Property value overflow. */
-			LOG_ERR("%s value overflow.", name);
-			ret = false;
+	if (line[name_len] == ':') {
+		prop_value = line + name_len + 1;
+	} else if (line[name_len] == ';') {
+		if (!prop->params) {
+			/* Does not support property parameter. */
+			LOG_ERR("%s param not supported.", prop->name);
+			return false;
 		}
-	} else if (ical_prop_buf[name_size] == ';') {
-		char *dtvalue;
-
-		dtvalue = strchr(ical_prop_buf, ':');
-		if (dtvalue) {
-			dtvalue = dtvalue + 1;
-			size_t value_len;
-
-			value_len = unfold_size - (dtvalue - ical_prop_buf);
-			if (value_len <= max_value_len) {
-				memcpy(value, dtvalue, value_len);
-				value[value_len] = '\0';
-				ret = true;
-			} else {
-				/* Property value overflow. */
-				LOG_ERR("%s value overflow.", name);
-				ret = false;
-			}
-		} else {
+
+		prop_value = prop_value_find(line + name_len);
+		if (!prop_value) {
 			/* Property wrong format - no value. */
-			LOG_ERR("%s wrong format - no value.", name);
-			ret = false;
+			LOG_ERR("%s wrong format - no value.", prop->name);
+			return false;
 		}
 	} else {
 		/* Property wrong format - no parameter or value. */
-		LOG_ERR("%s wrong format.", name);
-		ret = false;
+		LOG_ERR("%s wrong format.", prop->name);
+		return false;
 	}
 
-	return ret;
-}
-
-static size_t parse_calprops(const char *buf)
-{
-	const char *parsed = buf;
-	char *end = NULL;
-	char prop_value[CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE + 1];
-
-	parsed = strstr(parsed, "BEGIN:VCALENDAR\r\n");
-	if (parsed == NULL) {
-		return 0;
+	value_len = ical->line_len - (prop_value - line);
+	if (value_len > prop->max_value_len) {
+		/* Property value overflow. */
+		LOG_ERR("%s value overflow.", prop->name);
+		return false;
 	}
-	parsed += strlen("BEGIN:VCALENDAR\r\n");
 
-	end = strstr(parsed, "\r\nBEGIN:");
-	if (end == NULL) {
-		return 0;
-	}
-	end += strlen("\r\n");
-
-	while (parsed < end) {
-		memset(prop_value, 0, sizeof(prop_value));
-		if (!strncmp(parsed, "PRODID", 6)) {
-			if (!parse_desc_props(parsed, "PRODID", 6,
-					prop_value, sizeof(prop_value))) {
-				LOG_ERR("Wrong PRODID");
-			}
-		} else if (!strncmp(parsed, "VERSION", 7)) {
-			if (!parse_desc_props(parsed, "VERSION", 7,
-					prop_value, sizeof(prop_value))) {
-				LOG_ERR("Wrong VERSION");
-			}
-		}
-		parsed = strstr(parsed, "\r\n");
-		parsed += strlen("\r\n");
-	}
+	memcpy(value, prop_value, value_len);
+	value[value_len] = '\0';
 
-	return (parsed - buf);
+	return true;
 }
 
-static size_t parse_eventprop(const char *buf, struct ical_parser_evt *evt)
+static void parse_eventprop(struct icalendar_parser *ical)
 {
-	const char *parsed = buf;
-	char *com_end;
+	size_t name_len = strcspn(ical->line, ":;");
 
-	if (strncmp(buf, "BEGIN:VEVENT\r\n", strlen("BEGIN:VEVENT\r\n"))) {
-		return 0;
+	/* Properties after an erroneous one are not parsed. */
+	if (ical->evt.error != ICAL_ERROR_NONE) {
+		return;
 	}
 
-	com_end = strstr(buf, "END:VEVENT\r\n");
-	if (com_end == NULL) {
-		return 0;
-	}
+	for (size_t i = 0; i < ARRAY_SIZE(ical_event_props); i++) {
+		const struct ical_prop *prop = &ical_event_props[i];
 
-	evt->id = ICAL_EVT_VEVENT;
-	evt->error = ICAL_ERROR_NONE;
-	com_end += strlen("END:VEVENT\r\n");
-	while (parsed < com_end) {
-		if (!strncasecmp(parsed, "SUMMARY", 7)) {
-			if (!parse_desc_props(
-				parsed, "SUMMARY", 7,
-				evt->ical_com.summary,
-				CONFIG_ICAL_PARSER_SUMMARY_SIZE)) {
-				evt->error = ICAL_ERROR_SUMMARY;
-				parsed = com_end;
-			}
-		} else if (!strncasecmp(parsed, "LOCATION", 8)) {
-			if (!parse_desc_props(
-				parsed, "LOCATION", 8,
-				evt->ical_com.location,
-				CONFIG_ICAL_PARSER_LOCATION_SIZE)) {
-				evt->error = ICAL_ERROR_LOCATION;
-				parsed = com_end;
-			}
-		} else if (!strncasecmp(parsed, "DESCRIPTION", 11)) {
-			if (!parse_desc_props(
-				parsed, "DESCRIPTION", 11,
-				evt->ical_com.description,
-				CONFIG_ICAL_PARSER_DESCRIPTION_SIZE)) {
-				evt->error = ICAL_ERROR_DESCRIPTION;
-				parsed = com_end;
-			}
-		} else if (!strncasecmp(parsed, "DTSTART", 7)) {
-			if (!parse_datetime_props(
-				parsed, "DTSTART", 7,
-				evt->ical_com.dtstart,
-				CONFIG_ICAL_PARSER_DTSTART_SIZE)) {
-				evt->error = ICAL_ERROR_DTSTART;
-				parsed = com_end;
-			}
-		} else if (!strncasecmp(parsed,
-					"DTEND", 5)) {
-			if (!parse_datetime_props(
-				parsed, "DTEND", 5,
-				evt->ical_com.dtend,
-				CONFIG_ICAL_PARSER_DTEND_SIZE)) {
-				evt->error = ICAL_ERROR_DTEND;
-				parsed = com_end;
-			}
+		if (name_len != strlen(prop->name) ||
+		    strncasecmp(ical->line, prop->name, name_len)) {
+			continue;
 		}
 
-		/* Move parsed pointer to end of line break */
-		parsed = strstr(parsed, "\r\n") + 2;
+		if (!prop_value_get(ical, prop, name_len,
+				    (char *)&ical->evt.ical_com + prop->offset)) {
+			ical->evt.error = prop->error;
+		}
+		break;
 	}
-
-	return parsed - buf;
 }
 
-static size_t parse_todoprop(const char *buf, struct ical_parser_evt *evt)
+static void parse_com_begin(struct icalendar_parser *ical, const char *name)
 {
-	const char *parsed = buf;
-	char *com_end;
-
-	com_end = strstr(buf, "END:VTODO\r\n");
-	if (com_end) {
-		parsed = com_end + strlen("END:VTODO\r\n");
+	ical->com_depth++;
+	if (ical->com_depth > 1) {
+		/* Subcomponents, such as VALARM, are skipped. */
+		return;
 	}
-	evt->id = ICAL_EVT_VTODO;
-	evt->error = ICAL_ERROR_COM_NOT_SUPPORTED;
 
-	return parsed - buf;
-}
-
-static size_t parse_jourprop(const char *buf,
-				struct ical_parser_evt *evt)
-{
-	const char *parsed = buf;
-	char *com_end;
-
-	com_end = strstr(buf, "END:VJOURNAL\r\n");
-	if (com_end) {
-		parsed = com_end + strlen("END:VJOURNAL\r\n");
+	ical->com_reported = false;
+	for (size_t i = 0; i < ARRAY_SIZE(ical_coms); i++) {
+		if (!strcmp(name, ical_coms[i].name)) {
+			memset(&ical->evt, 0, sizeof(ical->evt));
+			ical->evt.id = ical_coms[i].id;
+			ical->evt.error = (ical_coms[i].id == ICAL_EVT_VEVENT) ?
+					  ICAL_ERROR_NONE : ICAL_ERROR_COM_NOT_SUPPORTED;
+			ical->com_reported = true;
+			break;
+		}
 	}
-	evt->id = ICAL_EVT_VJOURNAL;
-	evt->error = ICAL_ERROR_COM_NOT_SUPPORTED;
-
-	return parsed - buf;
 }
 
-static size_t parse_fbprop(const char *buf, struct ical_parser_evt *evt)
+static int parse_com_end(struct icalendar_parser *ical)
 {
-	const char *parsed = buf;
-	char *com_end;
+	if (ical->com_depth == 0) {
+		LOG_WRN("END without BEGIN");
+		return 0;
+	}
 
-	com_end = strstr(buf, "END:VFREEBUSY\r\n");
-	if (com_end) {
-		parsed = com_end + strlen("END:VFREEBUSY\r\n");
+	ical->com_depth--;
+	if (ical->com_depth > 0 || !ical->com_reported) {
+		return 0;
 	}
-	evt->id = ICAL_EVT_VFREEBUSY;
-	evt->error = ICAL_ERROR_COM_NOT_SUPPORTED;
 
-	return parsed - buf;
+	return ical->callback(&ical->evt);
 }
 
-static size_t parse_tzprop(const char *buf, struct ical_parser_evt *evt)
+/* Parse an unfolded content line. Return non-zero if the application stopped parsing. */
+static int parse_contentline(struct icalendar_parser *ical)
 {
-	const char *parsed = buf;
-	char *com_end;
+	const char *line = ical->line;
 
-	com_end = strstr(buf, "END:VTIMEZONE\r\n");
-	if (com_end) {
-		parsed = com_end + strlen("END:VTIMEZONE\r\n");
-	}
-	evt->id = ICAL_EVT_VTIMEZONE;
-	evt->error = ICAL_ERROR_COM_NOT_SUPPORTED;
+	ical->line[ical->line_len] = '\0';
 
-	return parsed - buf;
-}
+	/* Check begin of iCalendar object delimiter
+	 * Reference: RFC 5545 3.4 iCalendar Object
+	 */
+	if (!ical->icalobject_begin) {
+		if (!strcmp(line, "BEGIN:VCALENDAR")) {
+			LOG_DBG("Found a calendar stream");
+			ical->icalobject_begin = true;
+			ical->com_depth = 0;
+		}
+		return 0;
+	}
 
-static size_t parse_component(char *buf, struct ical_parser_evt *evt)
-{
-	char *com_begin = buf;
-	size_t ret = 0;
-
-	/* Search begin of component */
-	if (!strncmp(com_begin, "BEGIN:VEVENT\r\n", 14)) {
-		ret += parse_eventprop(com_begin, evt);
-	} else if (!strncmp(com_begin, "BEGIN:VTODO\r\n", 13)) {
-		ret += parse_todoprop(com_begin, evt);
-	} else if (!strncmp(com_begin, "BEGIN:VJOURNAL\r\n", 16)) {
-		ret += parse_jourprop(com_begin, evt);
-	} else if (!strncmp(com_begin, "BEGIN:VFREEBUSY\r\n", 17)) {
-		ret += parse_fbprop(com_begin, evt);
-	} else if (!strncmp(com_begin, "BEGIN:VTIMEZONE\r\n", 17)) {
-		ret += parse_tzprop(com_begin, evt);
+	if (!strncmp(line, "BEGIN:", strlen("BEGIN:"))) {
+		parse_com_begin(ical, line + strlen("BEGIN:"));
+	} else if (!strncmp(line, "END:", strlen("END:"))) {
+		if (ical->com_depth == 0 && !strcmp(line, "END:VCALENDAR")) {
+			ical->icalobject_begin = false;
+			return 0;
+		}
+		return parse_com_end(ical);
+	} else if (ical->com_depth == 1 && ical->com_reported &&
+		   ical->evt.id == ICAL_EVT_VEVENT) {
+		parse_eventprop(ical);
+	} else if (ical->com_depth == 0) {
+		/* Calendar properties, such as PRODID and VERSION, are not used. */
+		LOG_DBG("Calendar property %.*s", (int)strcspn(line, ":;"), line);
 	}
 
-	return ret;
+	return 0;
 }
 
-static size_t parse_icalbody(char *buf,	icalendar_parser_callback_t callback)
+/* Handle the end of a line. Return non-zero if the application stopped parsing. */
+static int parse_line_break(struct icalendar_parser *ical)
 {
-	size_t parsed_bytes = 0, parsed_offset = 0;
+	int err;
+
+	/* Content lines are delimited by CRLF, a bare LF is accepted as well. */
+	if (ical->line_len > 0 && ical->line[ical->line_len - 1] == '\r') {
+		ical->line_len--;
+	} else if (ical->line_len == LINE_SIZE_MAX) {
+		/* The last byte is content, not a CR, so it does not fit. */
+		ical->line_overflow = true;
+	}
 
-	do {
-		struct ical_parser_evt evt;
+	/* A delimiter line ends a component, so it is parsed right away instead of
+	 * waiting for the next line to know whether it is folded.
+	 */
+	if (ical->line_len > strlen("END:") &&
+	    !strncmp(ical->line, "END:", strlen("END:"))) {
+		err = parse_contentline(ical);
+		line_reset(ical);
+		return err;
+	}
 
-		parsed_bytes = parse_component(buf + parsed_offset, &evt);
-		parsed_offset += parsed_bytes;
-		if (parsed_bytes > 0) {
-			callback(&evt);
-		}
-	} while (parsed_bytes > 0);
+	ical->line_break = true;
 
-	return parsed_offset;
+	return 0;
 }
 
 size_t ical_parser_parse(struct icalendar_parser *ical, const char *data, size_t len)
 {
 	size_t parsed_offset = 0;
 
-	if (CONFIG_ICAL_PARSER_BUFFER_SIZE < (ical->offset + len)) {
-		return -ENOBUFS;
-	}
+	while (parsed_offset < len) {
+		const char *eol;
+		size_t run_len;
 
-	memcpy(ical->buf + ical->offset, data, len);
-	ical->buf[ical->offset + len] = '\0';
+		if (ical->line_break) {
+			ical->line_break = false;
 
-	/* Check begin of iCalendar object delimiter
-	 * Reference: RFC 5545 3.4 iCalendar Object
-	 */
-	if (!ical->icalobject_begin) {
-		/* The body of the iCalendar object consists of
-		 * a sequence of calendar properties and
-		 * one or more calendar components.
-		 *
-		 * Reference: RFC 5545 3.6 Calendar Components
-		 */
-		parsed_offset += parse_calprops(ical->buf);
-		if (parsed_offset > 0) {
-			LOG_DBG("Found a calendar stream");
-			ical->icalobject_begin = true;
+			if (data[parsed_offset] == ' ' || data[parsed_offset] == '\t') {
+				/* Long content line is split into multiple lines.
+				 * Unfold it by removing the line break and the whitespace.
+				 * Reference: RFC 5545 3.1 Content Lines
+				 */
+				parsed_offset++;
+				continue;
+			}
+
+			/* Content line is delimited. */
+			(void)parse_contentline(ical);
+			line_reset(ical);
 		}
-	}
 
-	/* If we got a calendar property, start parsing calendar body. */
-	if (ical->icalobject_begin) {
-		parsed_offset += parse_icalbody(ical->buf + parsed_offset, ical->callback);
-	}
+		eol = memchr(data + parsed_offset, '\n', len - parsed_offset);
+		run_len = eol ? (size_t)(eol - (data + parsed_offset)) : len - parsed_offset;
+
+		line_append(ical, data + parsed_offset, run_len);
+		parsed_offset += run_len;
 
-	if (parsed_offset) {
-		ical->offset = ical->offset + len - parsed_offset;
-		memcpy(ical->buf, ical->buf + parsed_offset, ical->offset);
+		if (!eol) {
+			break;
+		}
+
+		parsed_offset++;
+		if (parse_line_break(ical)) {
+			break;
+		}
 	}
 
 	return parsed_offset;
@@ -404,9 +320,8 @@ int ical_parser_init(struct icalendar_parser *ical, icalendar_parser_callback_t
 		return -EINVAL;
 	}
 
+	memset(ical, 0, sizeof(*ical));
 	ical->callback = callback;
-	ical->icalobject_begin = false;
-	ical->offset = 0;
 
 	return 0;
 }
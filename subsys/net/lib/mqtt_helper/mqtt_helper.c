@@ -17,6 +17,7 @@
 
 #include <net/mqtt_helper.h>
 #include <zephyr/net/mqtt.h>
+#include <zephyr/sys/slist.h>
 
 #if defined(CONFIG_MQTT_HELPER_PROVISION_CERTIFICATES)
 #include CONFIG_MQTT_HELPER_CERTIFICATES_FILE
@@ -45,6 +46,24 @@ MQTT_HELPER_STATIC K_SEM_DEFINE(connection_poll_sem, 0, 1);
 static struct mqtt_helper_cfg current_cfg;
 MQTT_HELPER_STATIC enum mqtt_state mqtt_state = MQTT_STATE_UNINIT;
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+/* Message that is held back while the client is not connected. The topic and the payload are
+ * stored after the entry.
+ */
+struct queued_publish {
+	sys_snode_t node;
+	struct mqtt_publish_param param;
+	uint8_t data[];
+};
+
+static K_HEAP_DEFINE(publish_queue_heap, CONFIG_MQTT_HELPER_PUBLISH_QUEUE_SIZE);
+MQTT_HELPER_STATIC sys_slist_t publish_queue = SYS_SLIST_STATIC_INIT(&publish_queue);
+MQTT_HELPER_STATIC size_t publish_queue_count;
+
+/* Serializes queueing with the state change to connected, so that no message is left behind. */
+static K_MUTEX_DEFINE(publish_queue_lock);
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 static const char *state_name_get(enum mqtt_state state)
 {
 	switch (state) {
@@ -241,6 +260,183 @@ static int publish_get_payload(struct mqtt_client *const mqtt_client, size_t len
 	return mqtt_readall_publish_payload(mqtt_client, payload_buf, length);
 }
 
+/* Read the payload in chunks of the payload buffer size and pass them on to the application.
+ * If the application stops consuming, the rest of the payload is read and discarded to keep the
+ * MQTT stream in sync.
+ */
+static int publish_payload_stream(struct mqtt_client *const mqtt_client,
+				  struct mqtt_helper_buf topic, size_t length)
+{
+	int err;
+	bool discard = false;
+	struct mqtt_helper_payload_chunk chunk = {
+		.buf.ptr = payload_buf,
+		.total_len = length,
+	};
+
+	do {
+		chunk.buf.size = MIN(length - chunk.offset, sizeof(payload_buf));
+
+		err = mqtt_readall_publish_payload(mqtt_client, payload_buf, chunk.buf.size);
+		if (err) {
+			return err;
+		}
+
+		if (!discard) {
+			err = current_cfg.cb.on_publish_chunk(topic, &chunk);
+			if (err) {
+				LOG_WRN("Payload discarded at offset %zu, error: %d", chunk.offset, err);
+				discard = true;
+			}
+		}
+
+		chunk.offset += chunk.buf.size;
+	} while (chunk.offset < length);
+
+	return 0;
+}
+
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+static bool topic_equal(const struct mqtt_topic *a, const struct mqtt_topic *b)
+{
+	return (a->topic.size == b->topic.size) &&
+	       (memcmp(a->topic.utf8, b->topic.utf8, a->topic.size) == 0);
+}
+
+static bool topic_coalesces(const struct mqtt_topic *topic)
+{
+	for (size_t i = 0; i < current_cfg.coalesce_topic_count; i++) {
+		const struct mqtt_helper_buf *coalesce_topic = &current_cfg.coalesce_topics[i];
+
+		if ((topic->topic.size == coalesce_topic->size) &&
+		    (memcmp(topic->topic.utf8, coalesce_topic->ptr, coalesce_topic->size) == 0)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void publish_queue_remove(struct queued_publish *entry)
+{
+	sys_slist_find_and_remove(&publish_queue, &entry->node);
+	k_heap_free(&publish_queue_heap, entry);
+	publish_queue_count--;
+}
+
+/* Drop the oldest queued message with QoS 0 to make room for a new message.
+ * Returns false if there is no such message.
+ */
+static bool publish_queue_qos0_drop(void)
+{
+	struct queued_publish *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&publish_queue, entry, node) {
+		if (entry->param.message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+			LOG_WRN("Publish queue full, dropping message on topic: %.*s",
+				entry->param.message.topic.topic.size,
+				(char *)entry->param.message.topic.topic.utf8);
+
+			publish_queue_remove(entry);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Must be called with the publish queue lock held. */
+static int publish_queue_add(const struct mqtt_publish_param *param)
+{
+	struct queued_publish *entry;
+	struct mqtt_publish_param queued_param = *param;
+	size_t topic_len = param->message.topic.topic.size;
+	size_t payload_len = param->message.payload.len;
+
+	/* A message on a state topic supersedes a queued message on the same topic. The delivery
+	 * guarantee of the superseded message is kept. If the superseded message is acknowledged,
+	 * its message ID is also kept, so that the PUBACK that is expected for it is still
+	 * received. The message ID of the superseding message is then never acknowledged.
+	 */
+	if (topic_coalesces(&param->message.topic)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&publish_queue, entry, node) {
+			if (!topic_equal(&entry->param.message.topic, &param->message.topic)) {
+				continue;
+			}
+
+			if (entry->param.message.topic.qos > queued_param.message.topic.qos) {
+				queued_param.message.topic.qos = entry->param.message.topic.qos;
+			}
+
+			if (entry->param.message.topic.qos >= MQTT_QOS_1_AT_LEAST_ONCE) {
+				queued_param.message_id = entry->param.message_id;
+			}
+
+			LOG_DBG("Replacing queued message, ID: %d", entry->param.message_id);
+
+			publish_queue_remove(entry);
+			break;
+		}
+	}
+
+	do {
+		entry = k_heap_alloc(&publish_queue_heap, sizeof(*entry) + topic_len + payload_len,
+				     K_NO_WAIT);
+	} while ((entry == NULL) && publish_queue_qos0_drop());
+
+	if (entry == NULL) {
+		LOG_ERR("Publish queue full");
+		return -ENOMEM;
+	}
+
+	memcpy(entry->data, param->message.topic.topic.utf8, topic_len);
+	memcpy(entry->data + topic_len, param->message.payload.data, payload_len);
+
+	entry->param = queued_param;
+	entry->param.message.topic.topic.utf8 = entry->data;
+	entry->param.message.payload.data = entry->data + topic_len;
+
+	sys_slist_append(&publish_queue, &entry->node);
+	publish_queue_count++;
+
+	LOG_DBG("Message queued, %zu messages in queue", publish_queue_count);
+
+	return 0;
+}
+
+/* Publish the queued messages in the order they were queued. If publishing fails, the remaining
+ * messages stay in the queue until the next connection. Must be called with the publish queue
+ * lock held.
+ */
+static void publish_queue_flush(void)
+{
+	int err;
+	sys_snode_t *node;
+	struct queued_publish *entry;
+
+	while ((node = sys_slist_peek_head(&publish_queue)) != NULL) {
+		entry = CONTAINER_OF(node, struct queued_publish, node);
+
+		err = mqtt_publish(&mqtt_client, &entry->param);
+		if (err) {
+			LOG_ERR("Failed to publish queued message, error: %d", err);
+			return;
+		}
+
+		publish_queue_remove(entry);
+	}
+}
+
+static void publish_queue_clear(void)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_peek_head(&publish_queue)) != NULL) {
+		publish_queue_remove(CONTAINER_OF(node, struct queued_publish, node));
+	}
+}
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 static void send_ack(struct mqtt_client *const mqtt_client, uint16_t message_id)
 {
 	int err;
@@ -269,6 +465,20 @@ MQTT_HELPER_STATIC void on_publish(const struct mqtt_evt *mqtt_evt)
 		.ptr = payload_buf,
 	};
 
+	if (current_cfg.cb.on_publish_chunk) {
+		err = publish_payload_stream(&mqtt_client, topic, p->message.payload.len);
+		if (err) {
+			LOG_ERR("publish_payload_stream, error: %d", err);
+			return;
+		}
+
+		if (p->message.topic.qos == MQTT_QOS_1_AT_LEAST_ONCE) {
+			send_ack(&mqtt_client, p->message_id);
+		}
+
+		return;
+	}
+
 	err = publish_get_payload(&mqtt_client, p->message.payload.len);
 	if (err) {
 		LOG_ERR("publish_get_payload, error: %d", err);
@@ -299,7 +509,14 @@ MQTT_HELPER_STATIC void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 		LOG_DBG("MQTT mqtt_client connected");
 
 		if (mqtt_evt->param.connack.return_code == MQTT_CONNECTION_ACCEPTED) {
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+			k_mutex_lock(&publish_queue_lock, K_FOREVER);
 			mqtt_state_set(MQTT_STATE_CONNECTED);
+			publish_queue_flush();
+			k_mutex_unlock(&publish_queue_lock);
+#else
+			mqtt_state_set(MQTT_STATE_CONNECTED);
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
 		} else {
 			mqtt_state_set(MQTT_STATE_DISCONNECTED);
 		}
@@ -627,6 +844,25 @@ int mqtt_helper_publish(const struct mqtt_publish_param *param)
 		param->message.topic.topic.size,
 		(char *)param->message.topic.topic.utf8);
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	if (!mqtt_state_verify(MQTT_STATE_UNINIT) && !mqtt_state_verify(MQTT_STATE_CONNECTED)) {
+		int err = -EOPNOTSUPP;
+
+		k_mutex_lock(&publish_queue_lock, K_FOREVER);
+
+		/* Check the state again, it may have changed while waiting for the lock. */
+		if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
+			err = publish_queue_add(param);
+		}
+
+		k_mutex_unlock(&publish_queue_lock);
+
+		if (err != -EOPNOTSUPP) {
+			return err;
+		}
+	}
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 	if (!mqtt_state_verify(MQTT_STATE_CONNECTED)) {
 		LOG_ERR("Library is in the wrong state (%s), %s required",
 			state_name_get(mqtt_state_get()),
@@ -648,6 +884,12 @@ int mqtt_helper_deinit(void)
 		return -EOPNOTSUPP;
 	}
 
+#if defined(CONFIG_MQTT_HELPER_PUBLISH_QUEUE)
+	k_mutex_lock(&publish_queue_lock, K_FOREVER);
+	publish_queue_clear();
+	k_mutex_unlock(&publish_queue_lock);
+#endif /* CONFIG_MQTT_HELPER_PUBLISH_QUEUE */
+
 	memset(&current_cfg, 0, sizeof(current_cfg));
 	memset(&mqtt_client, 0, sizeof(mqtt_client));
 
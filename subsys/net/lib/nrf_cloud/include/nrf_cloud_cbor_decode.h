@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+/*
+ * Generated using zcbor version 0.6.0
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 3
+ */
+
+#ifndef NRF_CLOUD_CBOR_DECODE_H__
+#define NRF_CLOUD_CBOR_DECODE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_decode.h"
+#include "nrf_cloud_cbor_decode_types.h"
+
+#if DEFAULT_MAX_QTY != 3
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+int cbor_decode_fota_job(const uint8_t *payload, size_t payload_len, struct fota_job *result,
+			 size_t *payload_len_out);
+
+int cbor_decode_fota_ble_job(const uint8_t *payload, size_t payload_len,
+			     struct fota_ble_job *result, size_t *payload_len_out);
+
+#endif /* NRF_CLOUD_CBOR_DECODE_H__ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+/*
+ * Generated using zcbor version 0.6.0
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 3
+ */
+
+#ifndef NRF_CLOUD_CBOR_DECODE_TYPES_H__
+#define NRF_CLOUD_CBOR_DECODE_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_decode.h"
+
+/** Which value for --default-max-qty this file was created with.
+ *
+ *  The define is used in the other generated file to do a build-time
+ *  compatibility check.
+ *
+ *  See `zcbor --help` for more information about --default-max-qty
+ */
+#define DEFAULT_MAX_QTY 3
+
+struct fota_job_info {
+	struct zcbor_string _fota_job_info_job_id;
+	int32_t _fota_job_info_type;
+	int32_t _fota_job_info_size;
+	struct zcbor_string _fota_job_info_host;
+	struct zcbor_string _fota_job_info_path;
+};
+
+struct fota_job {
+	struct fota_job_info _fota_job__fota_job_info;
+};
+
+struct fota_ble_job {
+	struct zcbor_string _fota_ble_job_ble_id;
+	struct fota_job_info _fota_ble_job__fota_job_info;
+};
+
+#endif /* NRF_CLOUD_CBOR_DECODE_TYPES_H__ */
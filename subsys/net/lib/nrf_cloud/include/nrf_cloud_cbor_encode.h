@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+/*
+ * Generated using zcbor version 0.6.0
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 3
+ */
+
+#ifndef NRF_CLOUD_CBOR_ENCODE_H__
+#define NRF_CLOUD_CBOR_ENCODE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_encode.h"
+#include "nrf_cloud_cbor_encode_types.h"
+
+#if DEFAULT_MAX_QTY != 3
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+int cbor_encode_sensor_msg(uint8_t *payload, size_t payload_len, const struct sensor_msg *input,
+			   size_t *payload_len_out);
+
+int cbor_encode_alert_msg(uint8_t *payload, size_t payload_len, const struct alert_msg *input,
+			  size_t *payload_len_out);
+
+int cbor_encode_log_msg(uint8_t *payload, size_t payload_len, const struct log_msg *input,
+			size_t *payload_len_out);
+
+int cbor_encode_device_msg(uint8_t *payload, size_t payload_len, const struct device_msg *input,
+			   size_t *payload_len_out);
+
+#endif /* NRF_CLOUD_CBOR_ENCODE_H__ */
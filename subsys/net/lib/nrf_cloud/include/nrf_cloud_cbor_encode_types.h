@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+/*
+ * Generated using zcbor version 0.6.0
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 3
+ */
+
+#ifndef NRF_CLOUD_CBOR_ENCODE_TYPES_H__
+#define NRF_CLOUD_CBOR_ENCODE_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_encode.h"
+
+/** Which value for --default-max-qty this file was created with.
+ *
+ *  The define is used in the other generated file to do a build-time
+ *  compatibility check.
+ *
+ *  See `zcbor --help` for more information about --default-max-qty
+ */
+#define DEFAULT_MAX_QTY 3
+
+struct sensor_msg_ts {
+	int64_t _sensor_msg_ts;
+};
+
+struct sensor_msg {
+	struct zcbor_string _sensor_msg_appId;
+	struct sensor_msg_ts _sensor_msg_ts;
+	uint_fast32_t _sensor_msg_ts_present;
+	struct zcbor_string _sensor_msg_data;
+};
+
+struct alert_msg_value {
+	float _alert_msg_value;
+};
+
+struct alert_msg_ts {
+	int64_t _alert_msg_ts;
+};
+
+struct alert_msg_seq {
+	uint32_t _alert_msg_seq;
+};
+
+struct alert_msg_desc {
+	struct zcbor_string _alert_msg_desc;
+};
+
+struct alert_msg {
+	int32_t _alert_msg_type;
+	struct alert_msg_value _alert_msg_value;
+	uint_fast32_t _alert_msg_value_present;
+	struct alert_msg_ts _alert_msg_ts;
+	uint_fast32_t _alert_msg_ts_present;
+	struct alert_msg_seq _alert_msg_seq;
+	uint_fast32_t _alert_msg_seq_present;
+	struct alert_msg_desc _alert_msg_desc;
+	uint_fast32_t _alert_msg_desc_present;
+};
+
+struct log_msg_src {
+	struct zcbor_string _log_msg_src;
+};
+
+struct log_msg_ts {
+	int64_t _log_msg_ts;
+};
+
+struct log_msg_seq {
+	uint32_t _log_msg_seq;
+};
+
+struct log_msg {
+	int32_t _log_msg_dom;
+	int32_t _log_msg_lvl;
+	struct log_msg_src _log_msg_src;
+	uint_fast32_t _log_msg_src_present;
+	struct log_msg_ts _log_msg_ts;
+	uint_fast32_t _log_msg_ts_present;
+	struct log_msg_seq _log_msg_seq;
+	uint_fast32_t _log_msg_seq_present;
+	struct zcbor_string _log_msg_msg;
+};
+
+struct device_info_appVersion {
+	struct zcbor_string _device_info_appVersion;
+};
+
+struct device_info_batteryVoltage {
+	uint32_t _device_info_batteryVoltage;
+};
+
+struct device_info {
+	struct device_info_appVersion _device_info_appVersion;
+	uint_fast32_t _device_info_appVersion_present;
+	struct zcbor_string _device_info_modemFirmware;
+	struct device_info_batteryVoltage _device_info_batteryVoltage;
+	uint_fast32_t _device_info_batteryVoltage_present;
+	struct zcbor_string _device_info_imei;
+	struct zcbor_string _device_info_board;
+	struct zcbor_string _device_info_sdkVer;
+	struct zcbor_string _device_info_appName;
+	struct zcbor_string _device_info_zephyrVer;
+	struct zcbor_string _device_info_hwVer;
+};
+
+struct device_data_deviceInfo {
+	struct device_info _device_data_deviceInfo;
+};
+
+struct network_info {
+	uint32_t _network_info_currentBand;
+	struct zcbor_string _network_info_supportedBands;
+	uint32_t _network_info_areaCode;
+	struct zcbor_string _network_info_mccmnc;
+	struct zcbor_string _network_info_ipAddress;
+	uint32_t _network_info_ueMode;
+	uint32_t _network_info_cellID;
+	struct zcbor_string _network_info_networkMode;
+};
+
+struct device_data_networkInfo {
+	struct network_info _device_data_networkInfo;
+};
+
+struct sim_info_iccid {
+	struct zcbor_string _sim_info_iccid;
+};
+
+struct sim_info_imsi {
+	struct zcbor_string _sim_info_imsi;
+};
+
+struct sim_info {
+	uint32_t _sim_info_uiccMode;
+	struct sim_info_iccid _sim_info_iccid;
+	uint_fast32_t _sim_info_iccid_present;
+	struct sim_info_imsi _sim_info_imsi;
+	uint_fast32_t _sim_info_imsi_present;
+};
+
+struct device_data_simInfo {
+	struct sim_info _device_data_simInfo;
+};
+
+struct device_data {
+	struct device_data_deviceInfo _device_data_deviceInfo;
+	uint_fast32_t _device_data_deviceInfo_present;
+	struct device_data_networkInfo _device_data_networkInfo;
+	uint_fast32_t _device_data_networkInfo_present;
+	struct device_data_simInfo _device_data_simInfo;
+	uint_fast32_t _device_data_simInfo_present;
+};
+
+struct device_msg_ts {
+	int64_t _device_msg_ts;
+};
+
+struct device_msg {
+	struct device_msg_ts _device_msg_ts;
+	uint_fast32_t _device_msg_ts_present;
+	struct device_data _device_msg_data;
+};
+
+#endif /* NRF_CLOUD_CBOR_ENCODE_TYPES_H__ */
@@ -50,6 +50,12 @@ enum nrf_cloud_rcv_topic {
 /** Format identifier for remainder of this binary blob */
 #define NRF_CLOUD_DICT_LOG_FMT 0x0001
 
+/** Size of the keys and numbers of a JSON device message, excluding its strings */
+#define NRF_CLOUD_JSON_MSG_OVERHEAD 128
+
+/** Size of the buffer for nrf_cloud_shadow_control_response_encode() */
+#define NRF_CLOUD_SHADOW_CONTROL_RESPONSE_SIZE 96
+
 /** @brief Header preceding binary blobs so nRF Cloud can
  *  process them in correct order using ts_ms and sequence fields.
  */
@@ -111,8 +117,9 @@ int nrf_cloud_shadow_control_decode(struct nrf_cloud_data const *const input,
 				    enum nrf_cloud_ctrl_status *status,
 				    struct nrf_cloud_ctrl_data *data);
 
-/** @brief Encode response that we have accepted a shadow delta. */
+/** @brief Encode response that we have accepted a shadow delta into the provided buffer. */
 int nrf_cloud_shadow_control_response_encode(struct nrf_cloud_ctrl_data const *const data,
+					     char *buf, size_t size,
 					     struct nrf_cloud_data *const output);
 
 /** @brief Encode the device status data into a JSON formatted buffer to be saved to
@@ -198,7 +205,7 @@ int nrf_cloud_cell_pos_req_json_encode(struct lte_lc_cells_info const *const inf
 
 /** @brief Build a location request string using the provided info.
  * If successful, memory will be allocated for the output string and the user is
- * responsible for freeing it using @ref cJSON_free.
+ * responsible for freeing it using @ref cJSON_free or nrf_cloud_free().
  */
 int nrf_cloud_location_req_json_encode(struct lte_lc_cells_info const *const cell_info,
 				       struct wifi_scan_info const *const wifi_info,
@@ -213,6 +220,14 @@ int nrf_cloud_wifi_req_json_encode(struct wifi_scan_info const *const wifi,
 /** @brief Get the required information from the modem for a single-cell location request. */
 int nrf_cloud_get_single_cell_modem_info(struct lte_lc_cell *const cell_inf);
 
+#if defined(CONFIG_MODEM_INFO)
+/** @brief Read the modem parameters into the structure used by the modem info encoders.
+ *
+ * @return Pointer to the modem parameters, or NULL if they could not be read.
+ */
+const struct modem_param_info *nrf_cloud_modem_param_info_get(void);
+#endif
+
 /** @brief Parse the location response (REST and MQTT) from nRF Cloud. */
 int nrf_cloud_location_response_decode(const char *const buf,
 				      struct nrf_cloud_location_result *result);
@@ -327,9 +342,59 @@ typedef int (*gateway_state_handler_t)(void *root_obj);
 void nrf_cloud_register_gateway_state_handler(gateway_state_handler_t handler);
 #endif
 
-/** @brief Encode a log output buffer for transport to the cloud */
+/** @brief Encode a log output buffer for transport to the cloud.
+ * The message is encoded into json_buf if provided, otherwise it is allocated with
+ * nrf_cloud_malloc() and the caller must free it with nrf_cloud_free().
+ */
 int nrf_cloud_log_json_encode(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
-			 struct nrf_cloud_data *output);
+			      char *json_buf, size_t json_size, struct nrf_cloud_data *output);
+
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+/** @brief Encode the sensor data as a CBOR device message.
+ * The output is allocated with nrf_cloud_malloc(); the caller must free it
+ * with nrf_cloud_free().
+ */
+int nrf_cloud_sensor_data_cbor_encode(const struct nrf_cloud_sensor_data *sensor,
+				      struct nrf_cloud_data *output);
+
+#if defined(CONFIG_NRF_CLOUD_ALERT)
+/** @brief Encode an alert as a CBOR device message.
+ * The caller must free the output with nrf_cloud_free().
+ */
+int nrf_cloud_alert_cbor_encode(const struct nrf_cloud_alert_info *alert,
+				struct nrf_cloud_data *output);
+#endif
+
+/** @brief Encode a log output buffer as a CBOR device message.
+ * The caller must free the output with nrf_cloud_free().
+ */
+int nrf_cloud_log_cbor_encode(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
+			      struct nrf_cloud_data *output);
+
+#if defined(CONFIG_MODEM_INFO)
+/** @brief Encode the modem info sections that are set as a CBOR device message.
+ * The caller must free the output with nrf_cloud_free().
+ */
+int nrf_cloud_modem_info_cbor_encode(const struct nrf_cloud_modem_info *const mod_inf,
+				     const int64_t ts_ms, struct nrf_cloud_data *output);
+#endif
+
+/** @brief Check if the input starts with a CBOR map. */
+bool nrf_cloud_cbor_map_check(const struct nrf_cloud_data *const input);
+
+/** @brief Check if the input starts with a CBOR array. */
+bool nrf_cloud_cbor_list_check(const struct nrf_cloud_data *const input);
+
+/** @brief CBOR equivalent of @ref nrf_cloud_shadow_control_decode. */
+int nrf_cloud_shadow_control_cbor_decode(struct nrf_cloud_data const *const input,
+					 enum nrf_cloud_ctrl_status *status,
+					 struct nrf_cloud_ctrl_data *data);
+
+/** @brief CBOR equivalent of @ref nrf_cloud_fota_job_decode. */
+int nrf_cloud_fota_job_cbor_decode(struct nrf_cloud_fota_job_info *const job_info,
+				   bt_addr_t *const ble_id,
+				   const struct nrf_cloud_data *const input);
+#endif /* CONFIG_NRF_CLOUD_CBOR */
 
 #ifdef __cplusplus
 }
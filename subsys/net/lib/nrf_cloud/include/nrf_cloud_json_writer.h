@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_JSON_WRITER_H__
+#define NRF_CLOUD_JSON_WRITER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <net/nrf_cloud.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Forward-only JSON writer.
+ *
+ * Items are serialized directly into a buffer, in the order they are added, with the
+ * same unformatted output as cJSON_PrintUnformatted(). No tree is built, so encoding a
+ * message takes no heap memory besides the output buffer.
+ *
+ * Errors are kept in the writer and nrf_cloud_json_writer_finish() returns the first
+ * error. Items are still counted after the buffer is full, so that the length of the
+ * output is known even then.
+ *
+ * The key is NULL for items in an array and for the top level item.
+ */
+struct nrf_cloud_json_writer {
+	/* Output buffer, or NULL to only compute the length of the output */
+	char *buf;
+	size_t size;
+	/* Length of the output, also counted past the end of a too small buffer */
+	size_t len;
+	int err;
+	uint8_t depth;
+	/* An item was written at the current depth, the next one needs a separator */
+	bool separator;
+};
+
+/**
+ * @brief Initialize a JSON writer.
+ *
+ * @param w Writer.
+ * @param buf Output buffer, or NULL to only compute the length of the output.
+ * @param size Size of the output buffer, including the NUL terminator.
+ */
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *w, char *buf, size_t size);
+
+/**
+ * @brief Check that all objects and arrays are closed and NUL terminate the output.
+ *
+ * @retval Length of the output, excluding the NUL terminator.
+ * @retval -E2BIG The output buffer is too small.
+ * @retval -EINVAL Objects or arrays are not balanced.
+ */
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *w);
+
+void nrf_cloud_json_obj_start(struct nrf_cloud_json_writer *w, const char *key);
+void nrf_cloud_json_obj_end(struct nrf_cloud_json_writer *w);
+void nrf_cloud_json_arr_start(struct nrf_cloud_json_writer *w, const char *key);
+void nrf_cloud_json_arr_end(struct nrf_cloud_json_writer *w);
+
+/** @brief Add a string. A NULL string is written as an empty string, like cJSON does. */
+void nrf_cloud_json_str_add(struct nrf_cloud_json_writer *w, const char *key, const char *str);
+
+/** @brief Add a number, formatted the way cJSON formats numbers. */
+void nrf_cloud_json_num_add(struct nrf_cloud_json_writer *w, const char *key, double num);
+
+void nrf_cloud_json_bool_add(struct nrf_cloud_json_writer *w, const char *key, bool val);
+void nrf_cloud_json_null_add(struct nrf_cloud_json_writer *w, const char *key);
+
+/** @brief Function adding the items of a message to a writer. */
+typedef void (*nrf_cloud_json_write_fn)(struct nrf_cloud_json_writer *w, const void *ctx);
+
+/**
+ * @brief Encode a message in a single pass.
+ *
+ * If a buffer is given, the message is written into it and nothing is allocated.
+ * Otherwise, a buffer of the given size is allocated with nrf_cloud_malloc() and is freed
+ * with nrf_cloud_free() or cJSON_free(). The size is then only an estimate: if the
+ * message does not fit, the buffer is allocated again with the exact size and the
+ * message is written a second time.
+ *
+ * @param write Function adding the items of the message.
+ * @param ctx Context passed to the write function.
+ * @param buf Output buffer, or NULL to allocate it.
+ * @param size Size of the output buffer, including the NUL terminator.
+ * @param output Encoded message.
+ *
+ * @retval 0 Success.
+ * @retval -E2BIG The given output buffer is too small.
+ * @retval -ENOMEM Out of memory.
+ * @retval -EINVAL Objects or arrays are not balanced.
+ */
+int nrf_cloud_json_encode(nrf_cloud_json_write_fn write, const void *ctx, char *buf,
+			  size_t size, struct nrf_cloud_data *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_JSON_WRITER_H__ */
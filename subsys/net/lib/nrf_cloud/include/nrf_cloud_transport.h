@@ -22,6 +22,7 @@ enum nct_evt_type {
 	NCT_EVT_CC_TX_DATA_ACK,
 	NCT_EVT_PINGRESP,
 	NCT_EVT_DC_RX_DATA,
+	NCT_EVT_DC_RX_DATA_CHUNK,
 	NCT_EVT_DC_TX_DATA_ACK,
 	NCT_EVT_CC_DISCONNECTED,
 	NCT_EVT_DC_DISCONNECTED,
@@ -42,6 +43,15 @@ struct nct_dc_data {
 	uint16_t message_id;
 };
 
+/* Part of a message received on the data channel that does not fit in the payload buffer. */
+struct nct_dc_chunk {
+	struct nct_dc_data dc;
+	/* Offset of the chunk in the message payload. */
+	size_t offset;
+	/* Length of the message payload. */
+	size_t total_len;
+};
+
 struct nct_cc_data {
 	struct nrf_cloud_data data;
 	struct nrf_cloud_topic topic;
@@ -54,6 +64,7 @@ struct nct_evt {
 	union {
 		struct nct_cc_data *cc;
 		struct nct_dc_data *dc;
+		struct nct_dc_chunk *dc_chunk;
 		uint16_t message_id;
 		uint8_t flag;
 	} param;
@@ -0,0 +1,42 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+zcbor code -c nrf_cloud_cbor.cddl \
+	-t sensor_msg alert_msg log_msg device_msg -e \
+	--oc  src/nrf_cloud_cbor_encode.c \
+	--oh  include/nrf_cloud_cbor_encode.h \
+	--oht include/nrf_cloud_cbor_encode_types.h
+
+if [ $? -ne 0 ]; then
+	echo "Encoder generation failed!"
+	exit
+fi
+
+zcbor code -c nrf_cloud_cbor.cddl \
+	-t fota_job fota_ble_job -d \
+	--oc  src/nrf_cloud_cbor_decode.c \
+	--oh  include/nrf_cloud_cbor_decode.h \
+	--oht include/nrf_cloud_cbor_decode_types.h
+
+if [ $? -ne 0 ]; then
+	echo "Decoder generation failed!"
+	exit
+fi
+
+# Format the generated files
+clang-format -i src/nrf_cloud_cbor*.c
+clang-format -i include/nrf_cloud_cbor*.h
+
+# Commit the generated files and the matching CDDL file
+git add src/nrf_cloud_cbor*.c include/nrf_cloud_cbor*.h
+git add nrf_cloud_cbor.cddl
+
+# Append license information
+git apply -3 --apply nrf_cloud_cbor_license.patch
+
+if [ $? -ne 0 ]; then
+	echo "Appending license information failed!"
+	exit
+fi
@@ -292,6 +292,56 @@ int nrf_cloud_shadow_device_status_update(const struct nrf_cloud_device_status *
 	return err;
 }
 
+#if defined(CONFIG_NRF_CLOUD_CBOR_MODEM_INFO)
+int nrf_cloud_modem_info_send(const struct nrf_cloud_modem_info *const modem_info,
+			      const int64_t ts_ms)
+{
+	int err;
+	struct nct_dc_data dc_data = {
+		.message_id = NCT_MSG_ID_USE_NEXT_INCREMENT
+	};
+
+	if (current_state != STATE_DC_CONNECTED) {
+		return -EACCES;
+	}
+
+	if (modem_info == NULL) {
+		return -EINVAL;
+	}
+
+	err = nrf_cloud_modem_info_cbor_encode(modem_info, ts_ms, &dc_data.data);
+	if (err) {
+		return err;
+	}
+
+	err = nct_dc_bin_send(&dc_data, MQTT_QOS_1_AT_LEAST_ONCE);
+	nrf_cloud_free((void *)dc_data.data.ptr);
+
+	return err;
+}
+#endif
+
+static int sensor_data_encode(const struct nrf_cloud_sensor_data *param,
+			      struct nrf_cloud_data *output)
+{
+#if defined(CONFIG_NRF_CLOUD_CBOR_SENSOR)
+	return nrf_cloud_sensor_data_cbor_encode(param, output);
+#else
+	return nrf_cloud_sensor_data_encode(param, output);
+#endif
+}
+
+/* CBOR messages are sent on the binary topic */
+static int sensor_data_publish(const struct nct_dc_data *sensor_data, enum mqtt_qos qos)
+{
+#if defined(CONFIG_NRF_CLOUD_CBOR_SENSOR)
+	return nct_dc_bin_send(sensor_data, qos);
+#else
+	return (qos == MQTT_QOS_0_AT_MOST_ONCE) ? nct_dc_stream(sensor_data) :
+						  nct_dc_send(sensor_data);
+#endif
+}
+
 int nrf_cloud_sensor_data_send(const struct nrf_cloud_sensor_data *param)
 {
 	int err;
@@ -305,7 +355,7 @@ int nrf_cloud_sensor_data_send(const struct nrf_cloud_sensor_data *param)
 		return -EINVAL;
 	}
 
-	err = nrf_cloud_sensor_data_encode(param, &sensor_data.data);
+	err = sensor_data_encode(param, &sensor_data.data);
 	if (err) {
 		return err;
 	}
@@ -316,7 +366,7 @@ int nrf_cloud_sensor_data_send(const struct nrf_cloud_sensor_data *param)
 		sensor_data.message_id = NCT_MSG_ID_USE_NEXT_INCREMENT;
 	}
 
-	err = nct_dc_send(&sensor_data);
+	err = sensor_data_publish(&sensor_data, MQTT_QOS_1_AT_LEAST_ONCE);
 	nrf_cloud_free((void *)sensor_data.data.ptr);
 
 	return err;
@@ -335,12 +385,12 @@ int nrf_cloud_sensor_data_stream(const struct nrf_cloud_sensor_data *param)
 		return -EINVAL;
 	}
 
-	err = nrf_cloud_sensor_data_encode(param, &sensor_data.data);
+	err = sensor_data_encode(param, &sensor_data.data);
 	if (err) {
 		return err;
 	}
 
-	err = nct_dc_stream(&sensor_data);
+	err = sensor_data_publish(&sensor_data, MQTT_QOS_0_AT_MOST_ONCE);
 	nrf_cloud_free((void *)sensor_data.data.ptr);
 
 	return err;
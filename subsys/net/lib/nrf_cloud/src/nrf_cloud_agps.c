@@ -44,6 +44,46 @@ static atomic_t request_in_progress;
 static int64_t last_request_timestamp;
 #endif
 
+#define AGPS_BIN_HEADER_SIZE (NRF_CLOUD_AGPS_BIN_TYPE_SIZE + NRF_CLOUD_AGPS_BIN_COUNT_SIZE)
+
+/* State of parsing A-GPS data in the binary schema. */
+struct agps_parser {
+	uint16_t elements_left_to_process;
+	enum nrf_cloud_agps_type element_type;
+	struct nrf_cloud_agps_system_time sys_time;
+	uint32_t sv_mask;
+#if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED)
+	bool ephemerides_processed;
+#endif
+};
+
+/* Elements of the binary schema, to size the stream buffer. */
+union agps_bin_element {
+	struct nrf_cloud_agps_utc utc;
+	struct nrf_cloud_agps_ephemeris ephemeris;
+	struct nrf_cloud_agps_almanac almanac;
+	struct nrf_cloud_agps_klobuchar klobuchar;
+	struct nrf_cloud_agps_nequick nequick;
+	struct nrf_cloud_agps_system_time time_and_tow;
+	struct nrf_cloud_agps_tow_element tow;
+	struct nrf_cloud_agps_location location;
+	struct nrf_cloud_agps_integrity integrity;
+};
+
+/* A-GPS data received in chunks by nrf_cloud_agps_process_chunk(). */
+static struct {
+	struct agps_parser parser;
+	/* Offset of the next chunk and length of the data. */
+	size_t offset;
+	size_t total_len;
+	/* Element being reassembled, with the type and count header of its array. */
+	char element[AGPS_BIN_HEADER_SIZE + sizeof(union agps_bin_element)];
+	size_t element_len;
+	bool active;
+	/* An unknown element type was found, the rest of the data is skipped. */
+	bool done;
+} agps_stream;
+
 void agps_print_enable(bool enable)
 {
 	agps_print_enabled = enable;
@@ -403,107 +443,203 @@ static int agps_send_to_modem(struct nrf_cloud_apgs_element *agps_data)
 	return 0;
 }
 
-static size_t get_next_agps_element(struct nrf_cloud_apgs_element *element,
+/* Size of an element of the given type in the binary schema, 0 if the type is unknown. */
+static size_t agps_element_size(enum nrf_cloud_agps_type type)
+{
+	switch (type) {
+	case NRF_CLOUD_AGPS_UTC_PARAMETERS:
+		return sizeof(struct nrf_cloud_agps_utc);
+	case NRF_CLOUD_AGPS_EPHEMERIDES:
+		return sizeof(struct nrf_cloud_agps_ephemeris);
+	case NRF_CLOUD_AGPS_ALMANAC:
+		return sizeof(struct nrf_cloud_agps_almanac);
+	case NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION:
+		return sizeof(struct nrf_cloud_agps_klobuchar);
+	case NRF_CLOUD_AGPS_NEQUICK_CORRECTION:
+		return sizeof(struct nrf_cloud_agps_nequick);
+	case NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK:
+		return sizeof(struct nrf_cloud_agps_system_time) -
+		       sizeof(((struct nrf_cloud_agps_system_time *)0)->sv_tow) + 4;
+	case NRF_CLOUD_AGPS_GPS_TOWS:
+		return sizeof(struct nrf_cloud_agps_tow_element);
+	case NRF_CLOUD_AGPS_LOCATION:
+		return sizeof(struct nrf_cloud_agps_location);
+	case NRF_CLOUD_AGPS_INTEGRITY:
+		return sizeof(struct nrf_cloud_agps_integrity);
+	default:
+		return 0;
+	}
+}
+
+static size_t get_next_agps_element(struct agps_parser *parser,
+				    struct nrf_cloud_apgs_element *element,
 				    const char *buf,
 				    size_t buf_len)
 {
-	static uint16_t elements_left_to_process;
-	static enum nrf_cloud_agps_type element_type;
 	size_t len = 0;
 
 	/* Check if there are more elements left in the array to process.
 	 * The element type is only given once before the array, and not for
 	 * each element.
 	 */
-	if (elements_left_to_process == 0) {
+	if (parser->elements_left_to_process == 0) {
 		/* Check that there's enough data for type and count. */
-		if (buf_len < NRF_CLOUD_AGPS_BIN_TYPE_SIZE + NRF_CLOUD_AGPS_BIN_COUNT_SIZE) {
+		if (buf_len < AGPS_BIN_HEADER_SIZE) {
 			LOG_ERR("Unexpected end of data");
 			return 0;
 		}
 
 		element->type =
 			(enum nrf_cloud_agps_type)buf[NRF_CLOUD_AGPS_BIN_TYPE_OFFSET];
-		element_type = element->type;
-		elements_left_to_process =
+		parser->element_type = element->type;
+		parser->elements_left_to_process =
 			*(uint16_t *)&buf[NRF_CLOUD_AGPS_BIN_COUNT_OFFSET] - 1;
-		len += NRF_CLOUD_AGPS_BIN_TYPE_SIZE +
-			NRF_CLOUD_AGPS_BIN_COUNT_SIZE;
+		len += AGPS_BIN_HEADER_SIZE;
 	} else {
-		element->type = element_type;
-		elements_left_to_process -= 1;
+		element->type = parser->element_type;
+		parser->elements_left_to_process -= 1;
 	}
 
 	switch (element->type) {
 	case NRF_CLOUD_AGPS_UTC_PARAMETERS:
 		element->utc = (struct nrf_cloud_agps_utc *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_utc);
 		break;
 	case NRF_CLOUD_AGPS_EPHEMERIDES:
 		element->ephemeris = (struct nrf_cloud_agps_ephemeris *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_ephemeris);
 		break;
 	case NRF_CLOUD_AGPS_ALMANAC:
 		element->almanac = (struct nrf_cloud_agps_almanac *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_almanac);
 		break;
 	case NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION:
 		element->ion_correction.klobuchar =
 			(struct nrf_cloud_agps_klobuchar *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_klobuchar);
 		break;
 	case NRF_CLOUD_AGPS_NEQUICK_CORRECTION:
 		element->ion_correction.nequick =
 			(struct nrf_cloud_agps_nequick *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_nequick);
 		break;
 	case NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK:
 		element->time_and_tow =
 			(struct nrf_cloud_agps_system_time *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_system_time) -
-			sizeof(element->time_and_tow->sv_tow) + 4;
 		break;
 	case NRF_CLOUD_AGPS_GPS_TOWS:
 		element->tow =
 			(struct nrf_cloud_agps_tow_element *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_tow_element);
 		break;
 	case NRF_CLOUD_AGPS_LOCATION:
 		element->location = (struct nrf_cloud_agps_location *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_location);
 		break;
 	case NRF_CLOUD_AGPS_INTEGRITY:
 		element->integrity =
 			(struct nrf_cloud_agps_integrity *)(buf + len);
-		len += sizeof(struct nrf_cloud_agps_integrity);
 		break;
 	default:
 		LOG_DBG("Unhandled A-GPS data type: %d", element->type);
-		elements_left_to_process = 0;
+		parser->elements_left_to_process = 0;
 		return 0;
 	}
 
+	len += agps_element_size(element->type);
+
 	/* Check that there's enough data for the element. */
 	if (buf_len < len) {
 		LOG_ERR("Unexpected end of data");
-		elements_left_to_process = 0;
+		parser->elements_left_to_process = 0;
 		return 0;
 	}
 
 	return len;
 }
 
+/* Length of the next element, including the type and count header before the first element of
+ * an array. Only the header needs to be in buf. 0 if the element type is unknown.
+ */
+static size_t agps_next_element_len(const struct agps_parser *parser,
+				    const char *buf,
+				    size_t buf_len)
+{
+	size_t element_size;
+
+	if (parser->elements_left_to_process > 0) {
+		return agps_element_size(parser->element_type);
+	}
+
+	if (buf_len < AGPS_BIN_HEADER_SIZE) {
+		return AGPS_BIN_HEADER_SIZE;
+	}
+
+	element_size = agps_element_size(
+		(enum nrf_cloud_agps_type)buf[NRF_CLOUD_AGPS_BIN_TYPE_OFFSET]);
+
+	return element_size ? AGPS_BIN_HEADER_SIZE + element_size : 0;
+}
+
+static int agps_element_process(struct agps_parser *parser,
+				struct nrf_cloud_apgs_element *element)
+{
+	int err;
+
+	if (element->type == NRF_CLOUD_AGPS_GPS_TOWS) {
+		memcpy(&parser->sys_time.sv_tow[element->tow->sv_id - 1],
+			element->tow,
+			sizeof(parser->sys_time.sv_tow[0]));
+		if (element->tow->flags || element->tow->tlm) {
+			parser->sv_mask |= 1 << (element->tow->sv_id - 1);
+		}
+
+		LOG_DBG("TOW %d copied", element->tow->sv_id - 1);
+
+		return 0;
+	} else if (element->type == NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK) {
+		memcpy(&parser->sys_time, element->time_and_tow,
+			sizeof(parser->sys_time) - sizeof(parser->sys_time.sv_tow));
+		parser->sys_time.sv_mask = parser->sv_mask | element->time_and_tow->sv_mask;
+		LOG_DBG("TOWs copied, bitmask: 0x%08x",
+			parser->sys_time.sv_mask);
+		element->time_and_tow = &parser->sys_time;
+#if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED)
+	} else if (element->type == NRF_CLOUD_AGPS_EPHEMERIDES) {
+		parser->ephemerides_processed = true;
+#endif
+	}
+
+	/* The processed variable is read/written by agps_send_to_modem() and
+	 * nrf_cloud_agps_processed() which can be called from different contexts.
+	 */
+	k_mutex_lock(&processed_lock, K_FOREVER);
+	err = agps_send_to_modem(element);
+	k_mutex_unlock(&processed_lock);
+	if (err) {
+		LOG_ERR("Failed to send data to modem, error: %d", err);
+	}
+
+	return err;
+}
+
+static void agps_parse_finish(const struct agps_parser *parser, int err)
+{
+#if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED)
+	/**
+	 * In filtered mode, because fewer than the full set of ephemerides is sent to
+	 * the modem, determine here if we correctly received them from the cloud and
+	 * sent them to the modem.
+	 */
+	if (!err && parser->ephemerides_processed) {
+		last_request_timestamp = k_uptime_get();
+	}
+#else
+	ARG_UNUSED(parser);
+	ARG_UNUSED(err);
+#endif
+}
+
 int nrf_cloud_agps_process(const char *buf, size_t buf_len)
 {
 	int err;
 	struct nrf_cloud_apgs_element element = {0};
-	struct nrf_cloud_agps_system_time sys_time = {0};
-	uint32_t sv_mask = 0;
+	struct agps_parser parser = {0};
 	size_t parsed_len = 0;
 	uint8_t version;
-#if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED)
-	bool ephemerides_processed = false;
-#endif
 
 	if (!buf || (buf_len == 0)) {
 		return -EINVAL;
@@ -544,7 +680,8 @@ int nrf_cloud_agps_process(const char *buf, size_t buf_len)
 
 	while (parsed_len < buf_len) {
 		size_t element_size =
-			get_next_agps_element(&element, &buf[parsed_len], buf_len - parsed_len);
+			get_next_agps_element(&parser, &element, &buf[parsed_len],
+					      buf_len - parsed_len);
 
 		if (element_size == 0) {
 			LOG_DBG("Parsing finished\n");
@@ -555,54 +692,117 @@ int nrf_cloud_agps_process(const char *buf, size_t buf_len)
 
 		LOG_DBG("Parsed_len: %d", parsed_len);
 
-		if (element.type == NRF_CLOUD_AGPS_GPS_TOWS) {
-			memcpy(&sys_time.sv_tow[element.tow->sv_id - 1],
-				element.tow,
-				sizeof(sys_time.sv_tow[0]));
-			if (element.tow->flags || element.tow->tlm) {
-				sv_mask |= 1 << (element.tow->sv_id - 1);
-			}
+		err = agps_element_process(&parser, &element);
+		if (err) {
+			break;
+		}
+	}
+
+	agps_parse_finish(&parser, err);
+
+	LOG_DBG("A-GPS_inject_active UNLOCKED");
+	k_sem_give(&agps_injection_active);
+
+	return err;
+}
 
-			LOG_DBG("TOW %d copied", element.tow->sv_id - 1);
+int nrf_cloud_agps_process_chunk(const char *buf, size_t buf_len, size_t offset,
+				 size_t total_len)
+{
+	int err;
+	struct nrf_cloud_apgs_element element = {0};
+	size_t parsed_len = 0;
+	size_t element_len;
+	size_t copy_len;
+	uint8_t version;
+
+	if (!buf || (buf_len == 0) || (offset + buf_len > total_len)) {
+		return -EINVAL;
+	}
+
+	if (offset == 0) {
+		if (buf_len == total_len) {
+			/* Not split, the data may also be a JSON error message. */
+			return nrf_cloud_agps_process(buf, buf_len);
+		}
+
+		version = buf[NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_INDEX];
+		if (version != NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION) {
+			LOG_ERR("Cannot parse schema version: %d", version);
+			agps_stream.active = false;
+			return -EBADMSG;
+		}
+
+		LOG_DBG("Receiving AGPS data. Schema version: %d, length: %zu",
+			version, total_len);
+
+		memset(&agps_stream, 0, sizeof(agps_stream));
+		agps_stream.active = true;
+		agps_stream.total_len = total_len;
+		parsed_len += NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE;
+	} else if (!agps_stream.active || (offset != agps_stream.offset) ||
+		   (total_len != agps_stream.total_len)) {
+		LOG_ERR("Unexpected A-GPS data chunk at offset %zu", offset);
+		agps_stream.active = false;
+		return -EINVAL;
+	}
 
+	agps_stream.offset = offset + buf_len;
+
+	err = k_sem_take(&agps_injection_active, K_FOREVER);
+	if (err) {
+		LOG_ERR("A-GPS injection already active.");
+		agps_stream.active = false;
+		return err;
+	}
+
+	/* Elements are copied to the stream buffer, so that those split between chunks
+	 * can be reassembled.
+	 */
+	while (!agps_stream.done) {
+		element_len = agps_next_element_len(&agps_stream.parser, agps_stream.element,
+						    agps_stream.element_len);
+		if (element_len == 0) {
+			LOG_DBG("Unhandled A-GPS data type: %d",
+				agps_stream.element[NRF_CLOUD_AGPS_BIN_TYPE_OFFSET]);
+			agps_stream.done = true;
+			break;
+		}
+
+		if (agps_stream.element_len < element_len) {
+			if (parsed_len == buf_len) {
+				break;
+			}
+
+			copy_len = MIN(element_len - agps_stream.element_len,
+				       buf_len - parsed_len);
+			memcpy(&agps_stream.element[agps_stream.element_len], &buf[parsed_len],
+			       copy_len);
+			agps_stream.element_len += copy_len;
+			parsed_len += copy_len;
 			continue;
-		} else if (element.type == NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK) {
-			memcpy(&sys_time, element.time_and_tow,
-				sizeof(sys_time) - sizeof(sys_time.sv_tow));
-			sys_time.sv_mask = sv_mask | element.time_and_tow->sv_mask;
-			LOG_DBG("TOWs copied, bitmask: 0x%08x",
-				sys_time.sv_mask);
-			element.time_and_tow = &sys_time;
-#if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED)
-		} else if (element.type == NRF_CLOUD_AGPS_EPHEMERIDES) {
-			ephemerides_processed = true;
-#endif
 		}
 
-		/* The processed variable is read/written by agps_send_to_modem() and
-		 * nrf_cloud_agps_processed() which can be called from different contexts.
-		 */
-		k_mutex_lock(&processed_lock, K_FOREVER);
-		err = agps_send_to_modem(&element);
-		k_mutex_unlock(&processed_lock);
+		(void)get_next_agps_element(&agps_stream.parser, &element, agps_stream.element,
+					    agps_stream.element_len);
+		agps_stream.element_len = 0;
+
+		err = agps_element_process(&agps_stream.parser, &element);
 		if (err) {
-			LOG_ERR("Failed to send data to modem, error: %d", err);
+			agps_stream.active = false;
 			break;
 		}
 	}
 
-#if defined(CONFIG_NRF_CLOUD_AGPS_FILTERED)
-	/**
-	 * In filtered mode, because fewer than the full set of ephemerides is sent to
-	 * the modem, determine here if we correctly received them from the cloud and
-	 * sent them to the modem.
-	 */
-	if (!err && ephemerides_processed) {
-		last_request_timestamp = k_uptime_get();
+	if (!err && (agps_stream.offset == total_len)) {
+		if (!agps_stream.done && (agps_stream.element_len > 0)) {
+			LOG_ERR("Unexpected end of data");
+		}
+
+		agps_parse_finish(&agps_stream.parser, err);
+		agps_stream.active = false;
 	}
-#endif
 
-	LOG_DBG("A-GPS_inject_active UNLOCKED");
 	k_sem_give(&agps_injection_active);
 
 	return err;
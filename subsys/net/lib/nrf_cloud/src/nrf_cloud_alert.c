@@ -25,7 +25,8 @@ static atomic_t alert_sequence;
 static int alert_prepare(struct nrf_cloud_data *output,
 			 enum nrf_cloud_alert_type type,
 			 float value,
-			 const char *description)
+			 const char *description,
+			 bool cbor)
 {
 	struct nrf_cloud_alert_info alert = {.ts_ms = 0, .type = type, .value = value,
 					     .description = description};
@@ -43,6 +44,14 @@ static int alert_prepare(struct nrf_cloud_data *output,
 		alert.type, alert.value, alert.description ? alert.description : "",
 		alert.ts_ms, alert.sequence);
 
+#if defined(CONFIG_NRF_CLOUD_CBOR_ALERT)
+	if (cbor) {
+		return nrf_cloud_alert_cbor_encode(&alert, output);
+	}
+#else
+	ARG_UNUSED(cbor);
+#endif
+
 	return nrf_cloud_alert_encode(&alert, output);
 }
 #endif /* CONFIG_NRF_CLOUD_ALERT */
@@ -53,9 +62,11 @@ int nrf_cloud_alert_send(enum nrf_cloud_alert_type type,
 			 const char *description)
 {
 #if defined(CONFIG_NRF_CLOUD_ALERT)
+	/* CBOR alerts are sent on the binary topic */
 	struct nrf_cloud_tx_data output = {
 		.qos = MQTT_QOS_1_AT_LEAST_ONCE,
-		.topic_type = NRF_CLOUD_TOPIC_MESSAGE
+		.topic_type = IS_ENABLED(CONFIG_NRF_CLOUD_CBOR_ALERT) ?
+			      NRF_CLOUD_TOPIC_BIN : NRF_CLOUD_TOPIC_MESSAGE
 	};
 	int err;
 
@@ -68,9 +79,14 @@ int nrf_cloud_alert_send(enum nrf_cloud_alert_type type,
 		return -EACCES;
 	}
 
-	err = alert_prepare(&output.data, type, value, description);
+	err = alert_prepare(&output.data, type, value, description,
+			    IS_ENABLED(CONFIG_NRF_CLOUD_CBOR_ALERT));
 	if (!err) {
-		LOG_DBG("Encoded alert: %s", (const char *)output.data.ptr);
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_CBOR_ALERT)) {
+			LOG_DBG("Encoded alert: %u bytes", output.data.len);
+		} else {
+			LOG_DBG("Encoded alert: %s", (const char *)output.data.ptr);
+		}
 	} else {
 		LOG_ERR("Error encoding alert: %d", err);
 		return err;
@@ -112,7 +128,7 @@ int nrf_cloud_rest_alert_send(struct nrf_cloud_rest_context *const rest_ctx,
 		return 0;
 	}
 	(void)nrf_cloud_codec_init(NULL);
-	err = alert_prepare(&data, type, value, description);
+	err = alert_prepare(&data, type, value, description, false);
 	if (!err) {
 		LOG_DBG("Encoded alert: %s", (const char *)data.ptr);
 	} else {
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+/*
+ * Generated using zcbor version 0.6.0
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 3
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_decode.h"
+#include "nrf_cloud_cbor_decode.h"
+
+#if DEFAULT_MAX_QTY != 3
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+static bool decode_fota_job_info(zcbor_state_t *state, struct fota_job_info *result);
+static bool decode_fota_job(zcbor_state_t *state, struct fota_job *result);
+static bool decode_fota_ble_job(zcbor_state_t *state, struct fota_ble_job *result);
+
+static bool decode_fota_job_info(zcbor_state_t *state, struct fota_job_info *result)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_tstr_decode(state, (&(*result)._fota_job_info_job_id)))) &&
+		   ((zcbor_int32_decode(state, (&(*result)._fota_job_info_type)))) &&
+		   ((zcbor_int32_decode(state, (&(*result)._fota_job_info_size)))) &&
+		   ((zcbor_tstr_decode(state, (&(*result)._fota_job_info_host)))) &&
+		   ((zcbor_tstr_decode(state, (&(*result)._fota_job_info_path))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool decode_fota_job(zcbor_state_t *state, struct fota_job *result)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = (((zcbor_list_start_decode(state) &&
+		   ((((decode_fota_job_info(state, (&(*result)._fota_job__fota_job_info))))) ||
+		    (zcbor_list_map_end_force_decode(state), false)) &&
+		   zcbor_list_end_decode(state))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool decode_fota_ble_job(zcbor_state_t *state, struct fota_ble_job *result)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = (((zcbor_list_start_decode(state) &&
+		   ((((zcbor_tstr_decode(state, (&(*result)._fota_ble_job_ble_id)))) &&
+		     ((decode_fota_job_info(state,
+					     (&(*result)._fota_ble_job__fota_job_info))))) ||
+		    (zcbor_list_map_end_force_decode(state), false)) &&
+		   zcbor_list_end_decode(state))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+int cbor_decode_fota_job(const uint8_t *payload, size_t payload_len, struct fota_job *result,
+			 size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = decode_fota_job(states, result);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_decode_fota_ble_job(const uint8_t *payload, size_t payload_len,
+			     struct fota_ble_job *result, size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = decode_fota_ble_job(states, result);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
@@ -0,0 +1,738 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+/*
+ * Generated using zcbor version 0.6.0
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 3
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_encode.h"
+#include "nrf_cloud_cbor_encode.h"
+
+#if DEFAULT_MAX_QTY != 3
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+static bool encode_repeated_sensor_msg_ts(zcbor_state_t *state, const struct sensor_msg_ts *input);
+static bool encode_sensor_msg(zcbor_state_t *state, const struct sensor_msg *input);
+static bool encode_repeated_alert_msg_value(zcbor_state_t *state,
+					    const struct alert_msg_value *input);
+static bool encode_repeated_alert_msg_ts(zcbor_state_t *state, const struct alert_msg_ts *input);
+static bool encode_repeated_alert_msg_seq(zcbor_state_t *state, const struct alert_msg_seq *input);
+static bool encode_repeated_alert_msg_desc(zcbor_state_t *state,
+					   const struct alert_msg_desc *input);
+static bool encode_alert_msg(zcbor_state_t *state, const struct alert_msg *input);
+static bool encode_repeated_log_msg_src(zcbor_state_t *state, const struct log_msg_src *input);
+static bool encode_repeated_log_msg_ts(zcbor_state_t *state, const struct log_msg_ts *input);
+static bool encode_repeated_log_msg_seq(zcbor_state_t *state, const struct log_msg_seq *input);
+static bool encode_log_msg(zcbor_state_t *state, const struct log_msg *input);
+static bool encode_network_info(zcbor_state_t *state, const struct network_info *input);
+static bool encode_repeated_sim_info_iccid(zcbor_state_t *state,
+					   const struct sim_info_iccid *input);
+static bool encode_repeated_sim_info_imsi(zcbor_state_t *state, const struct sim_info_imsi *input);
+static bool encode_sim_info(zcbor_state_t *state, const struct sim_info *input);
+static bool encode_repeated_device_info_appVersion(zcbor_state_t *state,
+						   const struct device_info_appVersion *input);
+static bool encode_repeated_device_info_batteryVoltage(
+	zcbor_state_t *state, const struct device_info_batteryVoltage *input);
+static bool encode_device_info(zcbor_state_t *state, const struct device_info *input);
+static bool encode_repeated_device_data_deviceInfo(zcbor_state_t *state,
+						   const struct device_data_deviceInfo *input);
+static bool encode_repeated_device_data_networkInfo(zcbor_state_t *state,
+						    const struct device_data_networkInfo *input);
+static bool encode_repeated_device_data_simInfo(zcbor_state_t *state,
+						const struct device_data_simInfo *input);
+static bool encode_device_data(zcbor_state_t *state, const struct device_data *input);
+static bool encode_repeated_device_msg_ts(zcbor_state_t *state, const struct device_msg_ts *input);
+static bool encode_device_msg(zcbor_state_t *state, const struct device_msg *input);
+
+static bool encode_repeated_sensor_msg_ts(zcbor_state_t *state, const struct sensor_msg_ts *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"ts",
+					tmp_str.len = sizeof("ts") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_int64_encode(state, (&(*input)._sensor_msg_ts))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_sensor_msg(zcbor_state_t *state, const struct sensor_msg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 4) &&
+		   ((((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"appId",
+				     tmp_str.len = sizeof("appId") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._sensor_msg_appId)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"messageType",
+				     tmp_str.len = sizeof("messageType") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"DATA",
+						 tmp_str.len = sizeof("DATA") - 1,
+						 &tmp_str))))) &&
+		    (zcbor_present_encode(&((*input)._sensor_msg_ts_present),
+					  (zcbor_encoder_t *)encode_repeated_sensor_msg_ts,
+					  state, (&(*input)._sensor_msg_ts))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"data",
+				     tmp_str.len = sizeof("data") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._sensor_msg_data))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 4))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_alert_msg_value(zcbor_state_t *state,
+					    const struct alert_msg_value *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"value",
+					tmp_str.len = sizeof("value") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_float32_encode(state, (&(*input)._alert_msg_value))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_alert_msg_ts(zcbor_state_t *state, const struct alert_msg_ts *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"ts",
+					tmp_str.len = sizeof("ts") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_int64_encode(state, (&(*input)._alert_msg_ts))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_alert_msg_seq(zcbor_state_t *state, const struct alert_msg_seq *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"seq",
+					tmp_str.len = sizeof("seq") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_uint32_encode(state, (&(*input)._alert_msg_seq))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_alert_msg_desc(zcbor_state_t *state, const struct alert_msg_desc *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"desc",
+					tmp_str.len = sizeof("desc") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_tstr_encode(state, (&(*input)._alert_msg_desc))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_alert_msg(zcbor_state_t *state, const struct alert_msg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 6) &&
+		   ((((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"appId",
+				     tmp_str.len = sizeof("appId") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"ALERT",
+						 tmp_str.len = sizeof("ALERT") - 1,
+						 &tmp_str))))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"type",
+				     tmp_str.len = sizeof("type") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_int32_encode(state, (&(*input)._alert_msg_type)))) &&
+		    (zcbor_present_encode(&((*input)._alert_msg_value_present),
+					  (zcbor_encoder_t *)encode_repeated_alert_msg_value,
+					  state, (&(*input)._alert_msg_value))) &&
+		    (zcbor_present_encode(&((*input)._alert_msg_ts_present),
+					  (zcbor_encoder_t *)encode_repeated_alert_msg_ts,
+					  state, (&(*input)._alert_msg_ts))) &&
+		    (zcbor_present_encode(&((*input)._alert_msg_seq_present),
+					  (zcbor_encoder_t *)encode_repeated_alert_msg_seq,
+					  state, (&(*input)._alert_msg_seq))) &&
+		    (zcbor_present_encode(&((*input)._alert_msg_desc_present),
+					  (zcbor_encoder_t *)encode_repeated_alert_msg_desc,
+					  state, (&(*input)._alert_msg_desc)))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 6))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_log_msg_src(zcbor_state_t *state, const struct log_msg_src *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"src",
+					tmp_str.len = sizeof("src") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_tstr_encode(state, (&(*input)._log_msg_src))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_log_msg_ts(zcbor_state_t *state, const struct log_msg_ts *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"ts",
+					tmp_str.len = sizeof("ts") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_int64_encode(state, (&(*input)._log_msg_ts))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_log_msg_seq(zcbor_state_t *state, const struct log_msg_seq *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"seq",
+					tmp_str.len = sizeof("seq") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_uint32_encode(state, (&(*input)._log_msg_seq))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_log_msg(zcbor_state_t *state, const struct log_msg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 7) &&
+		   ((((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"appId",
+				     tmp_str.len = sizeof("appId") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"LOG",
+						 tmp_str.len = sizeof("LOG") - 1,
+						 &tmp_str))))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"dom",
+				     tmp_str.len = sizeof("dom") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_int32_encode(state, (&(*input)._log_msg_dom)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"lvl",
+				     tmp_str.len = sizeof("lvl") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_int32_encode(state, (&(*input)._log_msg_lvl)))) &&
+		    (zcbor_present_encode(&((*input)._log_msg_src_present),
+					  (zcbor_encoder_t *)encode_repeated_log_msg_src,
+					  state, (&(*input)._log_msg_src))) &&
+		    (zcbor_present_encode(&((*input)._log_msg_ts_present),
+					  (zcbor_encoder_t *)encode_repeated_log_msg_ts,
+					  state, (&(*input)._log_msg_ts))) &&
+		    (zcbor_present_encode(&((*input)._log_msg_seq_present),
+					  (zcbor_encoder_t *)encode_repeated_log_msg_seq,
+					  state, (&(*input)._log_msg_seq))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"msg",
+				     tmp_str.len = sizeof("msg") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._log_msg_msg))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 7))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_network_info(zcbor_state_t *state, const struct network_info *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 8) &&
+		   ((((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"currentBand",
+				     tmp_str.len = sizeof("currentBand") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_uint32_encode(state, (&(*input)._network_info_currentBand)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"supportedBands",
+				     tmp_str.len = sizeof("supportedBands") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._network_info_supportedBands)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"areaCode",
+				     tmp_str.len = sizeof("areaCode") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_uint32_encode(state, (&(*input)._network_info_areaCode)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"mccmnc",
+				     tmp_str.len = sizeof("mccmnc") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._network_info_mccmnc)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"ipAddress",
+				     tmp_str.len = sizeof("ipAddress") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._network_info_ipAddress)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"ueMode",
+				     tmp_str.len = sizeof("ueMode") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_uint32_encode(state, (&(*input)._network_info_ueMode)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"cellID",
+				     tmp_str.len = sizeof("cellID") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_uint32_encode(state, (&(*input)._network_info_cellID)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"networkMode",
+				     tmp_str.len = sizeof("networkMode") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._network_info_networkMode))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 8))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_sim_info_iccid(zcbor_state_t *state, const struct sim_info_iccid *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"iccid",
+					tmp_str.len = sizeof("iccid") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_tstr_encode(state, (&(*input)._sim_info_iccid))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_sim_info_imsi(zcbor_state_t *state, const struct sim_info_imsi *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"imsi",
+					tmp_str.len = sizeof("imsi") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_tstr_encode(state, (&(*input)._sim_info_imsi))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_sim_info(zcbor_state_t *state, const struct sim_info *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 3) &&
+		   ((((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"uiccMode",
+				     tmp_str.len = sizeof("uiccMode") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_uint32_encode(state, (&(*input)._sim_info_uiccMode)))) &&
+		    (zcbor_present_encode(&((*input)._sim_info_iccid_present),
+					  (zcbor_encoder_t *)encode_repeated_sim_info_iccid,
+					  state, (&(*input)._sim_info_iccid))) &&
+		    (zcbor_present_encode(&((*input)._sim_info_imsi_present),
+					  (zcbor_encoder_t *)encode_repeated_sim_info_imsi,
+					  state, (&(*input)._sim_info_imsi)))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 3))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_device_info_appVersion(zcbor_state_t *state,
+						   const struct device_info_appVersion *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"appVersion",
+					tmp_str.len = sizeof("appVersion") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_tstr_encode(state, (&(*input)._device_info_appVersion))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_device_info_batteryVoltage(
+	zcbor_state_t *state, const struct device_info_batteryVoltage *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"batteryVoltage",
+					tmp_str.len = sizeof("batteryVoltage") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_uint32_encode(
+				     state, (&(*input)._device_info_batteryVoltage))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_device_info(zcbor_state_t *state, const struct device_info *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 9) &&
+		   (((zcbor_present_encode(&((*input)._device_info_appVersion_present),
+					  (zcbor_encoder_t *)encode_repeated_device_info_appVersion,
+					  state, (&(*input)._device_info_appVersion))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"modemFirmware",
+				     tmp_str.len = sizeof("modemFirmware") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_modemFirmware)))) &&
+		    (zcbor_present_encode(&((*input)._device_info_batteryVoltage_present),
+				      (zcbor_encoder_t *)encode_repeated_device_info_batteryVoltage,
+				      state, (&(*input)._device_info_batteryVoltage))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"imei",
+				     tmp_str.len = sizeof("imei") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_imei)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"board",
+				     tmp_str.len = sizeof("board") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_board)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"sdkVer",
+				     tmp_str.len = sizeof("sdkVer") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_sdkVer)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"appName",
+				     tmp_str.len = sizeof("appName") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_appName)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"zephyrVer",
+				     tmp_str.len = sizeof("zephyrVer") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_zephyrVer)))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"hwVer",
+				     tmp_str.len = sizeof("hwVer") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, (&(*input)._device_info_hwVer))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 9))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_device_data_deviceInfo(zcbor_state_t *state,
+						   const struct device_data_deviceInfo *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"deviceInfo",
+					tmp_str.len = sizeof("deviceInfo") - 1,
+					&tmp_str)))))) &&
+			    (encode_device_info(state, (&(*input)._device_data_deviceInfo))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_device_data_networkInfo(zcbor_state_t *state,
+						    const struct device_data_networkInfo *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"networkInfo",
+					tmp_str.len = sizeof("networkInfo") - 1,
+					&tmp_str)))))) &&
+			    (encode_network_info(state, (&(*input)._device_data_networkInfo))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_device_data_simInfo(zcbor_state_t *state,
+						const struct device_data_simInfo *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"simInfo",
+					tmp_str.len = sizeof("simInfo") - 1,
+					&tmp_str)))))) &&
+			    (encode_sim_info(state, (&(*input)._device_data_simInfo))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_device_data(zcbor_state_t *state, const struct device_data *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 3) &&
+		   (((zcbor_present_encode(&((*input)._device_data_deviceInfo_present),
+					  (zcbor_encoder_t *)encode_repeated_device_data_deviceInfo,
+					  state, (&(*input)._device_data_deviceInfo))) &&
+		    (zcbor_present_encode(&((*input)._device_data_networkInfo_present),
+					 (zcbor_encoder_t *)encode_repeated_device_data_networkInfo,
+					 state, (&(*input)._device_data_networkInfo))) &&
+		    (zcbor_present_encode(&((*input)._device_data_simInfo_present),
+					  (zcbor_encoder_t *)encode_repeated_device_data_simInfo,
+					  state, (&(*input)._device_data_simInfo)))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 3))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_device_msg_ts(zcbor_state_t *state, const struct device_msg_ts *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = ((((((zcbor_tstr_encode(
+			       state, ((tmp_str.value = (uint8_t *)"ts",
+					tmp_str.len = sizeof("ts") - 1,
+					&tmp_str)))))) &&
+			    (zcbor_int64_encode(state, (&(*input)._device_msg_ts))))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_device_msg(zcbor_state_t *state, const struct device_msg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result = (((zcbor_map_start_encode(state, 4) &&
+		   ((((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"appId",
+				     tmp_str.len = sizeof("appId") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"DEVICE",
+						 tmp_str.len = sizeof("DEVICE") - 1,
+						 &tmp_str))))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"messageType",
+				     tmp_str.len = sizeof("messageType") - 1,
+				     &tmp_str)))))) &&
+		     (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"DATA",
+						 tmp_str.len = sizeof("DATA") - 1,
+						 &tmp_str))))) &&
+		    (zcbor_present_encode(&((*input)._device_msg_ts_present),
+					  (zcbor_encoder_t *)encode_repeated_device_msg_ts,
+					  state, (&(*input)._device_msg_ts))) &&
+		    ((((zcbor_tstr_encode(
+			    state, ((tmp_str.value = (uint8_t *)"data",
+				     tmp_str.len = sizeof("data") - 1,
+				     &tmp_str)))))) &&
+		     (encode_device_data(state, (&(*input)._device_msg_data))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 4))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+int cbor_encode_sensor_msg(uint8_t *payload, size_t payload_len, const struct sensor_msg *input,
+			   size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_sensor_msg(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_encode_alert_msg(uint8_t *payload, size_t payload_len, const struct alert_msg *input,
+			  size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_alert_msg(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_encode_log_msg(uint8_t *payload, size_t payload_len, const struct log_msg *input,
+			size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_log_msg(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_encode_device_msg(uint8_t *payload, size_t payload_len, const struct device_msg *input,
+			   size_t *payload_len_out)
+{
+	zcbor_state_t states[6];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_device_msg(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
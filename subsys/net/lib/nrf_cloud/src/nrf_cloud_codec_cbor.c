@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zcbor_common.h>
+#include <zcbor_decode.h>
+#include <net/nrf_cloud_codec.h>
+
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_cbor_encode.h"
+#include "nrf_cloud_cbor_decode.h"
+#include "nrf_cloud_mem.h"
+
+LOG_MODULE_REGISTER(nrf_cloud_codec_cbor, CONFIG_NRF_CLOUD_LOG_LEVEL);
+
+/* The device messages and FOTA jobs are encoded and decoded with the zcbor
+ * generated code in nrf_cloud_cbor_encode.c and nrf_cloud_cbor_decode.c, see
+ * nrf_cloud_cbor.cddl. CBOR messages use the same keys and structure as the
+ * JSON messages, only the values are encoded in binary.
+ */
+
+/* Shadow deltas have three levels of maps */
+#define DECODE_STATES 4
+
+/* Upper bound of the encoded size of the keys, map headers and number values
+ * of a message, excluding the variable length strings.
+ */
+#define MSG_OVERHEAD 128
+/* Upper bound of the encoded size of a text string header */
+#define STR_OVERHEAD 9
+
+/* Point a zcbor string to a C string, return its upper bound encoded size */
+static size_t str_set(struct zcbor_string *dst, const char *src)
+{
+	dst->value = (const uint8_t *)(src ? src : "");
+	dst->len = strlen((const char *)dst->value);
+
+	return dst->len + STR_OVERHEAD;
+}
+
+/* Hand over the encoded message, or free the buffer if encoding failed */
+static int encoded_output_set(int err, uint8_t *buf, size_t len, struct nrf_cloud_data *output)
+{
+	if (err != ZCBOR_SUCCESS) {
+		LOG_ERR("Failed to encode CBOR message: %d", err);
+		nrf_cloud_free(buf);
+		return -EIO;
+	}
+
+	output->ptr = buf;
+	output->len = len;
+
+	return 0;
+}
+
+static const char *const sensor_app_id[] = {
+	[NRF_CLOUD_SENSOR_GNSS] = NRF_CLOUD_JSON_APPID_VAL_GNSS,
+	[NRF_CLOUD_SENSOR_FLIP] = NRF_CLOUD_JSON_APPID_VAL_FLIP,
+	[NRF_CLOUD_SENSOR_BUTTON] = NRF_CLOUD_JSON_APPID_VAL_BTN,
+	[NRF_CLOUD_SENSOR_TEMP] = NRF_CLOUD_JSON_APPID_VAL_TEMP,
+	[NRF_CLOUD_SENSOR_HUMID] = NRF_CLOUD_JSON_APPID_VAL_HUMID,
+	[NRF_CLOUD_SENSOR_AIR_PRESS] = NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS,
+	[NRF_CLOUD_SENSOR_AIR_QUAL] = NRF_CLOUD_JSON_APPID_VAL_AIR_QUAL,
+	[NRF_CLOUD_LTE_LINK_RSRP] = NRF_CLOUD_JSON_APPID_VAL_RSRP,
+	[NRF_CLOUD_LOG] = NRF_CLOUD_JSON_APPID_VAL_LOG,
+	[NRF_CLOUD_DICTIONARY_LOG] = NRF_CLOUD_JSON_APPID_VAL_DICTIONARY_LOG,
+	[NRF_CLOUD_DEVICE_INFO] = NRF_CLOUD_JSON_APPID_VAL_DEVICE,
+	[NRF_CLOUD_SENSOR_LIGHT] = NRF_CLOUD_JSON_APPID_VAL_LIGHT,
+};
+
+int nrf_cloud_sensor_data_cbor_encode(const struct nrf_cloud_sensor_data *sensor,
+				      struct nrf_cloud_data *output)
+{
+	__ASSERT_NO_MSG(sensor != NULL);
+	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
+	__ASSERT_NO_MSG(output != NULL);
+
+	struct sensor_msg msg = {
+		._sensor_msg_ts._sensor_msg_ts = sensor->ts_ms,
+		._sensor_msg_ts_present = (sensor->ts_ms > NRF_CLOUD_NO_TIMESTAMP),
+		._sensor_msg_data = {
+			.value = sensor->data.ptr,
+			.len = strnlen(sensor->data.ptr, sensor->data.len)
+		}
+	};
+	size_t size = MSG_OVERHEAD + msg._sensor_msg_data.len + STR_OVERHEAD;
+	uint8_t *buf;
+	size_t len;
+	int err;
+
+	if (sensor->type >= ARRAY_SIZE(sensor_app_id) || !sensor_app_id[sensor->type]) {
+		return -EINVAL;
+	}
+
+	size += str_set(&msg._sensor_msg_appId, sensor_app_id[sensor->type]);
+
+	buf = nrf_cloud_malloc(size);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	err = cbor_encode_sensor_msg(buf, size, &msg, &len);
+
+	return encoded_output_set(err, buf, len, output);
+}
+
+#if defined(CONFIG_NRF_CLOUD_ALERT)
+int nrf_cloud_alert_cbor_encode(const struct nrf_cloud_alert_info *alert,
+				struct nrf_cloud_data *output)
+{
+	__ASSERT_NO_MSG(alert != NULL);
+	__ASSERT_NO_MSG(output != NULL);
+
+	struct alert_msg msg = {
+		._alert_msg_type = alert->type,
+		._alert_msg_value._alert_msg_value = alert->value,
+		._alert_msg_value_present = (alert->value != NRF_CLOUD_ALERT_UNUSED_VALUE),
+		._alert_msg_ts._alert_msg_ts = alert->ts_ms,
+		._alert_msg_ts_present = (alert->ts_ms > NRF_CLOUD_NO_TIMESTAMP),
+		._alert_msg_seq._alert_msg_seq = alert->sequence,
+		._alert_msg_seq_present = ((alert->ts_ms <= NRF_CLOUD_NO_TIMESTAMP) ||
+					   IS_ENABLED(CONFIG_NRF_CLOUD_ALERT_SEQ_ALWAYS)),
+		._alert_msg_desc_present = (alert->description != NULL)
+	};
+	size_t size = MSG_OVERHEAD;
+	uint8_t *buf;
+	size_t len;
+	int err;
+
+	if (msg._alert_msg_desc_present) {
+		size += str_set(&msg._alert_msg_desc._alert_msg_desc, alert->description);
+	}
+
+	buf = nrf_cloud_malloc(size);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	err = cbor_encode_alert_msg(buf, size, &msg, &len);
+
+	return encoded_output_set(err, buf, len, output);
+}
+#endif /* CONFIG_NRF_CLOUD_ALERT */
+
+int nrf_cloud_log_cbor_encode(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
+			      struct nrf_cloud_data *output)
+{
+	__ASSERT_NO_MSG(ctx != NULL);
+	__ASSERT_NO_MSG(buf != NULL);
+	__ASSERT_NO_MSG(output != NULL);
+
+	struct log_msg msg = {
+		._log_msg_dom = ctx->dom_id,
+		._log_msg_lvl = ctx->level,
+		._log_msg_src_present = (ctx->src_name != NULL),
+		._log_msg_ts._log_msg_ts = ctx->ts,
+		._log_msg_ts_present = (ctx->ts > 0),
+		._log_msg_seq._log_msg_seq = ctx->sequence,
+		._log_msg_seq_present = (!ctx->ts || IS_ENABLED(CONFIG_NRF_CLOUD_LOG_SEQ_ALWAYS)),
+		._log_msg_msg = {
+			.value = buf,
+			.len = size
+		}
+	};
+	size_t msg_size = MSG_OVERHEAD + size + STR_OVERHEAD;
+	uint8_t *msg_buf;
+	size_t len;
+	int err;
+
+	if (msg._log_msg_src_present) {
+		msg_size += str_set(&msg._log_msg_src._log_msg_src, ctx->src_name);
+	}
+
+	msg_buf = nrf_cloud_malloc(msg_size);
+	if (!msg_buf) {
+		return -ENOMEM;
+	}
+
+	err = cbor_encode_log_msg(msg_buf, msg_size, &msg, &len);
+
+	return encoded_output_set(err, msg_buf, len, output);
+}
+
+#if defined(CONFIG_MODEM_INFO)
+/* Buffers for the strings of a device message that are not in the modem info */
+struct device_msg_strs {
+	char network_mode[12];
+	char hw_ver[40];
+};
+
+static size_t network_info_set(struct network_info *info, const struct network_param *network,
+			       char *network_mode)
+{
+	size_t size = 0;
+
+	info->_network_info_currentBand = network->current_band.value;
+	size += str_set(&info->_network_info_supportedBands, network->sup_band.value_string);
+	info->_network_info_areaCode = network->area_code.value;
+	size += str_set(&info->_network_info_mccmnc, network->current_operator.value_string);
+	size += str_set(&info->_network_info_ipAddress, network->ip_address.value_string);
+	info->_network_info_ueMode = network->ue_mode.value;
+	info->_network_info_cellID = (uint32_t)network->cellid_dec;
+
+	if (network->lte_mode.value == 1) {
+		strcat(network_mode, "LTE-M");
+	} else if (network->nbiot_mode.value == 1) {
+		strcat(network_mode, "NB-IoT");
+	}
+	if (network->gps_mode.value == 1) {
+		strcat(network_mode, " GPS");
+	}
+
+	return size + str_set(&info->_network_info_networkMode, network_mode);
+}
+
+static size_t sim_info_set(struct sim_info *info, const struct sim_param *sim)
+{
+	size_t size = 0;
+
+	info->_sim_info_uiccMode = sim->uicc.value;
+
+	info->_sim_info_iccid_present = (sim->iccid.value_string[0] != '\0');
+	if (info->_sim_info_iccid_present) {
+		size += str_set(&info->_sim_info_iccid._sim_info_iccid, sim->iccid.value_string);
+	} else {
+		LOG_DBG("sim_param object does not contain an ICCID");
+	}
+
+	info->_sim_info_imsi_present = (sim->imsi.value_string[0] != '\0');
+	if (info->_sim_info_imsi_present) {
+		size += str_set(&info->_sim_info_imsi._sim_info_imsi, sim->imsi.value_string);
+	} else {
+		LOG_DBG("sim_param object does not contain an IMSI");
+	}
+
+	return size;
+}
+
+static size_t device_info_set(struct device_info *info, const struct device_param *device,
+			      const char *app_ver, char *hw_ver, size_t hw_ver_size)
+{
+#ifdef BUILD_VERSION
+	const char * const zver = STRINGIFY(BUILD_VERSION);
+#else
+	const char * const zver = "N/A";
+#endif
+	size_t size = 0;
+
+	info->_device_info_appVersion_present = (app_ver != NULL);
+	if (app_ver) {
+		size += str_set(&info->_device_info_appVersion._device_info_appVersion, app_ver);
+	}
+
+	size += str_set(&info->_device_info_modemFirmware, device->modem_fw.value_string);
+
+	info->_device_info_batteryVoltage_present =
+		IS_ENABLED(CONFIG_NRF_CLOUD_DEVICE_STATUS_ENCODE_VOLTAGE);
+	info->_device_info_batteryVoltage._device_info_batteryVoltage = device->battery.value;
+
+	size += str_set(&info->_device_info_imei, device->imei.value_string);
+	size += str_set(&info->_device_info_board, device->board);
+	size += str_set(&info->_device_info_sdkVer, device->app_version);
+	size += str_set(&info->_device_info_appName, device->app_name);
+	size += str_set(&info->_device_info_zephyrVer, zver);
+
+	if (modem_info_get_hw_version(hw_ver, hw_ver_size - 1)) {
+		strcpy(hw_ver, "N/A");
+	}
+
+	return size + str_set(&info->_device_info_hwVer, hw_ver);
+}
+
+int nrf_cloud_modem_info_cbor_encode(const struct nrf_cloud_modem_info *const mod_inf,
+				     const int64_t ts_ms, struct nrf_cloud_data *output)
+{
+	if (!mod_inf || !output) {
+		return -EINVAL;
+	}
+
+	if ((!IS_ENABLED(CONFIG_MODEM_INFO_ADD_DEVICE)) &&
+	    (mod_inf->device == NRF_CLOUD_INFO_SET)) {
+		LOG_ERR("CONFIG_MODEM_INFO_ADD_DEVICE is not enabled, unable to add device info");
+		return -EACCES;
+	} else if ((!IS_ENABLED(CONFIG_MODEM_INFO_ADD_NETWORK)) &&
+		   (mod_inf->network == NRF_CLOUD_INFO_SET)) {
+		LOG_ERR("CONFIG_MODEM_INFO_ADD_NETWORK is not enabled, unable to add network info");
+		return -EACCES;
+	} else if ((!IS_ENABLED(CONFIG_MODEM_INFO_ADD_SIM)) &&
+		   (mod_inf->sim == NRF_CLOUD_INFO_SET)) {
+		LOG_ERR("CONFIG_MODEM_INFO_ADD_SIM is not enabled, unable to add SIM info");
+		return -EACCES;
+	}
+
+	const struct modem_param_info *mpi = mod_inf->mpi;
+	struct device_msg_strs strs = {0};
+	struct device_msg msg = {
+		._device_msg_ts._device_msg_ts = ts_ms,
+		._device_msg_ts_present = (ts_ms > NRF_CLOUD_NO_TIMESTAMP)
+	};
+	struct device_data *data = &msg._device_msg_data;
+	size_t size = MSG_OVERHEAD;
+	uint8_t *buf;
+	size_t len;
+	int err;
+
+	/* Only the sections that are set are sent, a device message does not clear anything */
+	data->_device_data_deviceInfo_present = (mod_inf->device == NRF_CLOUD_INFO_SET);
+	data->_device_data_networkInfo_present = (mod_inf->network == NRF_CLOUD_INFO_SET);
+	data->_device_data_simInfo_present = (mod_inf->sim == NRF_CLOUD_INFO_SET);
+
+	if (!data->_device_data_deviceInfo_present && !data->_device_data_networkInfo_present &&
+	    !data->_device_data_simInfo_present) {
+		return -ENODATA;
+	}
+
+	if (!mpi) {
+		/* No modem info provided, use local */
+		mpi = nrf_cloud_modem_param_info_get();
+		if (!mpi) {
+			return -EIO;
+		}
+	}
+
+	if (data->_device_data_deviceInfo_present) {
+		size += MSG_OVERHEAD +
+			device_info_set(&data->_device_data_deviceInfo._device_data_deviceInfo,
+					&mpi->device, mod_inf->application_version, strs.hw_ver,
+					sizeof(strs.hw_ver));
+	}
+
+	if (data->_device_data_networkInfo_present) {
+		size += MSG_OVERHEAD +
+			network_info_set(&data->_device_data_networkInfo._device_data_networkInfo,
+					 &mpi->network, strs.network_mode);
+	}
+
+	if (data->_device_data_simInfo_present) {
+		size += sim_info_set(&data->_device_data_simInfo._device_data_simInfo, &mpi->sim);
+	}
+
+	buf = nrf_cloud_malloc(size);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	err = cbor_encode_device_msg(buf, size, &msg, &len);
+
+	return encoded_output_set(err, buf, len, output);
+}
+#endif /* CONFIG_MODEM_INFO */
+
+bool nrf_cloud_cbor_map_check(const struct nrf_cloud_data *const input)
+{
+	return input && input->ptr && input->len &&
+	       (ZCBOR_MAJOR_TYPE(*(const uint8_t *)input->ptr) == ZCBOR_MAJOR_TYPE_MAP);
+}
+
+bool nrf_cloud_cbor_list_check(const struct nrf_cloud_data *const input)
+{
+	return input && input->ptr && input->len &&
+	       (ZCBOR_MAJOR_TYPE(*(const uint8_t *)input->ptr) == ZCBOR_MAJOR_TYPE_LIST);
+}
+
+static bool key_equal(const struct zcbor_string *key, const char *str)
+{
+	return (key->len == strlen(str)) && !memcmp(key->value, str, key->len);
+}
+
+/* Control section of one of the shadow sections */
+struct ctrl_section {
+	bool found;
+	bool has_alert;
+	bool alerts_enabled;
+	bool has_log;
+	int32_t log_level;
+};
+
+static bool control_decode(zcbor_state_t *zs, struct ctrl_section *ctrl)
+{
+	struct zcbor_string key;
+
+	if (!zcbor_map_start_decode(zs)) {
+		return false;
+	}
+
+	ctrl->found = true;
+
+	while (zcbor_tstr_decode(zs, &key)) {
+		if (key_equal(&key, NRF_CLOUD_JSON_KEY_ALERT)) {
+			if (zcbor_bool_decode(zs, &ctrl->alerts_enabled)) {
+				ctrl->has_alert = true;
+				continue;
+			}
+
+			LOG_WRN(NRF_CLOUD_JSON_KEY_ALERT " is not a bool");
+		} else if (key_equal(&key, NRF_CLOUD_JSON_KEY_LOG)) {
+			if (zcbor_int32_decode(zs, &ctrl->log_level)) {
+				ctrl->has_log = true;
+				continue;
+			}
+
+			LOG_WRN(NRF_CLOUD_JSON_KEY_LOG " is not a number");
+		}
+
+		if (!zcbor_any_skip(zs, NULL)) {
+			return false;
+		}
+	}
+
+	return zcbor_map_end_decode(zs);
+}
+
+/* Find the control section in a state, desired or reported section */
+static bool section_decode(zcbor_state_t *zs, struct ctrl_section *ctrl)
+{
+	struct zcbor_string key;
+
+	if (!zcbor_map_start_decode(zs)) {
+		/* Not a map, for example null */
+		return zcbor_any_skip(zs, NULL);
+	}
+
+	while (zcbor_tstr_decode(zs, &key)) {
+		if (key_equal(&key, NRF_CLOUD_JSON_KEY_CTRL)) {
+			if (!control_decode(zs, ctrl)) {
+				return false;
+			}
+		} else if (!zcbor_any_skip(zs, NULL)) {
+			return false;
+		}
+	}
+
+	return zcbor_map_end_decode(zs);
+}
+
+enum ctrl_section_idx {
+	CTRL_SECTION_STATE,
+	CTRL_SECTION_DESIRED,
+	CTRL_SECTION_REPORTED,
+	CTRL_SECTION__COUNT
+};
+
+int nrf_cloud_shadow_control_cbor_decode(struct nrf_cloud_data const *const input,
+					 enum nrf_cloud_ctrl_status *status,
+					 struct nrf_cloud_ctrl_data *data)
+{
+	struct ctrl_section sections[CTRL_SECTION__COUNT] = {0};
+	struct ctrl_section *ctrl = NULL;
+	struct zcbor_string key;
+	bool ok;
+
+	__ASSERT_NO_MSG(input != NULL);
+	__ASSERT_NO_MSG(status != NULL);
+	__ASSERT_NO_MSG(data != NULL);
+
+	ZCBOR_STATE_D(zs, DECODE_STATES, input->ptr, input->len, 1);
+
+	ok = zcbor_map_start_decode(zs);
+
+	while (ok && zcbor_tstr_decode(zs, &key)) {
+		if (key_equal(&key, NRF_CLOUD_JSON_KEY_STATE)) {
+			ok = section_decode(zs, &sections[CTRL_SECTION_STATE]);
+		} else if (key_equal(&key, NRF_CLOUD_JSON_KEY_DES)) {
+			ok = section_decode(zs, &sections[CTRL_SECTION_DESIRED]);
+		} else if (key_equal(&key, NRF_CLOUD_JSON_KEY_REP)) {
+			ok = section_decode(zs, &sections[CTRL_SECTION_REPORTED]);
+		} else {
+			ok = zcbor_any_skip(zs, NULL);
+		}
+	}
+
+	if (!ok || !zcbor_map_end_decode(zs)) {
+		LOG_ERR("Invalid CBOR shadow: %d", zcbor_peek_error(zs));
+		return -ESRCH;
+	}
+
+	/* Same precedence as for JSON: delta, then desired, then reported */
+	for (size_t i = 0; i < ARRAY_SIZE(sections); i++) {
+		if (sections[i].found) {
+			ctrl = &sections[i];
+			break;
+		}
+	}
+
+	if (!ctrl) {
+		LOG_DBG("Shadow delta does not have control section");
+		*status = NRF_CLOUD_CTRL_NOT_PRESENT;
+		return 0;
+	}
+
+	if (ctrl->has_alert && (data->alerts_enabled != ctrl->alerts_enabled)) {
+		data->alerts_enabled = ctrl->alerts_enabled;
+		LOG_INF("AlertsEn changed to %u", data->alerts_enabled);
+	}
+
+	if (ctrl->has_log && (data->log_level != ctrl->log_level)) {
+		data->log_level = ctrl->log_level;
+		LOG_INF("LogLvl changed to %u", data->log_level);
+	}
+
+	*status = NRF_CLOUD_CTRL_REPLY;
+
+	return 0;
+}
+
+static char *cbor_strdup(const struct zcbor_string *str)
+{
+	char *dest = nrf_cloud_calloc(str->len + 1, 1);
+
+	if (dest) {
+		memcpy(dest, str->value, str->len);
+	}
+
+	return dest;
+}
+
+/* FOTA job format, same as the JSON array:
+ * ["jobExecutionId",firmwareType,fileSize,"host","path"]
+ * ["BLE ID","jobExecutionId",firmwareType,fileSize,"host","path"]
+ */
+int nrf_cloud_fota_job_cbor_decode(struct nrf_cloud_fota_job_info *const job_info,
+				   bt_addr_t *const ble_id,
+				   const struct nrf_cloud_data *const input)
+{
+	struct fota_ble_job ble_job;
+	struct fota_job job;
+	const struct fota_job_info *info;
+	int err = -ENOMSG;
+
+	if (!job_info || !input || !input->ptr) {
+		return -EINVAL;
+	}
+
+	memset(job_info, 0, sizeof(*job_info));
+
+	if (ble_id) {
+		err = cbor_decode_fota_ble_job(input->ptr, input->len, &ble_job, NULL);
+		info = &ble_job._fota_ble_job__fota_job_info;
+	} else {
+		err = cbor_decode_fota_job(input->ptr, input->len, &job, NULL);
+		info = &job._fota_job__fota_job_info;
+	}
+
+	if (err != ZCBOR_SUCCESS) {
+		LOG_ERR("Invalid CBOR FOTA job: %d", err);
+		return -EINVAL;
+	}
+
+	err = -ENOMSG;
+
+	/* Get the job ID separately, it may be needed to reject an invalid job */
+	job_info->id = cbor_strdup(&info->_fota_job_info_job_id);
+	if (job_info->id == NULL) {
+		LOG_ERR("FOTA job ID not allocated");
+		goto cleanup;
+	}
+
+	/* Check that the job ID is a valid size */
+	if (info->_fota_job_info_job_id.len > (NRF_CLOUD_FOTA_JOB_ID_SIZE - 1)) {
+		LOG_ERR("Job ID length: %d, exceeds allowed length: %d",
+			(int)info->_fota_job_info_job_id.len, NRF_CLOUD_FOTA_JOB_ID_SIZE - 1);
+		goto cleanup;
+	}
+
+#if defined(CONFIG_NRF_CLOUD_FOTA_BLE_DEVICES)
+	if (ble_id) {
+		const struct zcbor_string *ble_str = &ble_job._fota_ble_job_ble_id;
+		char addr[BT_ADDR_STR_LEN];
+
+		if (ble_str->len >= sizeof(addr)) {
+			err = -EADDRNOTAVAIL;
+			LOG_ERR("Invalid BLE ID");
+			goto cleanup;
+		}
+
+		memcpy(addr, ble_str->value, ble_str->len);
+		addr[ble_str->len] = '\0';
+
+		if (bt_addr_from_str(addr, ble_id)) {
+			err = -EADDRNOTAVAIL;
+			LOG_ERR("Invalid BLE ID: %s", addr);
+			goto cleanup;
+		}
+	}
+#endif
+
+	job_info->type = info->_fota_job_info_type;
+	job_info->file_size = info->_fota_job_info_size;
+	job_info->host = cbor_strdup(&info->_fota_job_info_host);
+	job_info->path = cbor_strdup(&info->_fota_job_info_path);
+
+	if (!job_info->host || !job_info->path) {
+		LOG_ERR("Error allocating job info");
+		goto cleanup;
+	}
+
+	/* Check that the FOTA type is valid */
+	if (job_info->type < NRF_CLOUD_FOTA_TYPE__FIRST ||
+	    job_info->type >= NRF_CLOUD_FOTA_TYPE__INVALID) {
+		LOG_ERR("Invalid FOTA type: %d", job_info->type);
+		goto cleanup;
+	}
+
+	err = 0;
+
+cleanup:
+	if (err) {
+		/* On error, leave the job ID so that the job can be cancelled */
+		nrf_cloud_free(job_info->host);
+		job_info->host = NULL;
+		nrf_cloud_free(job_info->path);
+		job_info->path = NULL;
+
+		job_info->type = NRF_CLOUD_FOTA_TYPE__INVALID;
+	}
+
+	return err;
+}
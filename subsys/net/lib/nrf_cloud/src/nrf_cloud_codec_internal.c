@@ -5,6 +5,7 @@
  */
 
 #include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_json_writer.h"
 #include "nrf_cloud_mem.h"
 #include "nrf_cloud_fsm.h"
 #include <net/nrf_cloud_codec.h>
@@ -69,6 +70,9 @@ static const char *const sensor_type_str[] = {
 /* Max length of a NRF_CLOUD_JSON_MSG_TYPE_VAL_DISCONNECT message */
 #define NRF_CLOUD_JSON_MSG_MAX_LEN_DISCONNECT	200
 
+/* Estimated size of an encoded cell or access point in a location request */
+#define LOCATION_REQ_ITEM_SIZE	96
+
 int nrf_cloud_codec_init(struct nrf_cloud_os_mem_hooks *hooks)
 {
 	if (!initialized) {
@@ -269,49 +273,31 @@ static void nrf_cloud_decode_desired_obj(cJSON *root_obj,
 	}
 }
 
+static void sensor_data_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct nrf_cloud_sensor_data *sensor = ctx;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	if (sensor->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, sensor->ts_ms);
+	}
+	nrf_cloud_json_obj_end(w);
+}
+
 int nrf_cloud_sensor_data_encode(const struct nrf_cloud_sensor_data *sensor,
 				 struct nrf_cloud_data *output)
 {
-	int ret;
-
 	__ASSERT_NO_MSG(sensor != NULL);
 	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
 	__ASSERT_NO_MSG(sensor->data.len != 0);
 	__ASSERT_NO_MSG(output != NULL);
 	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
 
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
-
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_MSG_TYPE_KEY,
-			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
-	if (sensor->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, sensor->ts_ms);
-	}
-
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
-
-	char *buffer;
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
-
-	if (buffer == NULL) {
-		return -ENOMEM;
-	}
-
-	output->ptr = buffer;
-	output->len = strlen(buffer);
-
-	return 0;
+	return nrf_cloud_json_encode(sensor_data_write, sensor, NULL,
+				     sensor->data.len + NRF_CLOUD_JSON_MSG_OVERHEAD, output);
 }
 
 #ifdef CONFIG_NRF_CLOUD_GATEWAY
@@ -484,6 +470,12 @@ int nrf_cloud_shadow_control_decode(struct nrf_cloud_data const *const input,
 	__ASSERT_NO_MSG(status != NULL);
 	__ASSERT_NO_MSG(data != NULL);
 
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+	if (nrf_cloud_cbor_map_check(input)) {
+		return nrf_cloud_shadow_control_cbor_decode(input, status, data);
+	}
+#endif
+
 	cJSON *state_obj = NULL;
 	cJSON *control_obj = NULL;
 	cJSON *alert_obj = NULL;
@@ -572,43 +564,41 @@ end:
 	return 0;
 }
 
+static void shadow_control_response_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct nrf_cloud_ctrl_data *data = ctx;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_obj_start(w, NRF_CLOUD_JSON_KEY_STATE);
+	nrf_cloud_json_obj_start(w, NRF_CLOUD_JSON_KEY_REP);
+	nrf_cloud_json_obj_start(w, NRF_CLOUD_JSON_KEY_CTRL);
+	nrf_cloud_json_bool_add(w, NRF_CLOUD_JSON_KEY_ALERT, data->alerts_enabled);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_KEY_LOG, data->log_level);
+	nrf_cloud_json_obj_end(w);
+	nrf_cloud_json_obj_end(w);
+	nrf_cloud_json_obj_end(w);
+	nrf_cloud_json_obj_end(w);
+}
+
 int nrf_cloud_shadow_control_response_encode(struct nrf_cloud_ctrl_data const *const data,
+					     char *buf, size_t size,
 					     struct nrf_cloud_data *const output)
 {
 	__ASSERT_NO_MSG(data != NULL);
+	__ASSERT_NO_MSG(buf != NULL);
 	__ASSERT_NO_MSG(output != NULL);
 
-	char *buffer = NULL;
-	int err = 0;
+	int err;
 
 	/* Prepare JSON response for the delta */
-	cJSON *root_obj = cJSON_CreateObject();
-	cJSON *state_obj = cJSON_AddObjectToObjectCS(root_obj, NRF_CLOUD_JSON_KEY_STATE);
-	cJSON *reported_obj = cJSON_AddObjectToObjectCS(state_obj, NRF_CLOUD_JSON_KEY_REP);
-	cJSON *control_obj = cJSON_AddObjectToObjectCS(reported_obj, NRF_CLOUD_JSON_KEY_CTRL);
-	int alert_ret = json_add_bool_cs(control_obj, NRF_CLOUD_JSON_KEY_ALERT,
-					 data->alerts_enabled);
-	int log_ret = json_add_num_cs(control_obj, NRF_CLOUD_JSON_KEY_LOG, data->log_level);
-
-	/* If any object could not be created, we ran out of memory */
-	if (!(root_obj && state_obj && reported_obj && control_obj &&
-	      !alert_ret && !log_ret)) {
-		err = -ENOMEM;
-		goto end;
-	}
-	buffer = cJSON_PrintUnformatted(root_obj);
-	if (!buffer) {
-		err = -ENOMEM;
-		goto end;
+	err = nrf_cloud_json_encode(shadow_control_response_write, data, buf, size, output);
+	if (err) {
+		return err;
 	}
-	LOG_DBG("Sending shadow back: %s", buffer);
 
-	output->ptr = buffer;
-	output->len = strlen(buffer);
+	LOG_DBG("Sending shadow back: %s", (const char *)output->ptr);
 
-end:
-	cJSON_Delete(root_obj);
-	return err;
+	return 0;
 }
 
 static int add_device_status(cJSON * const reported_obj)
@@ -1180,6 +1170,11 @@ static int get_modem_info(void)
 	return 0;
 }
 
+const struct modem_param_info *nrf_cloud_modem_param_info_get(void)
+{
+	return get_modem_info() ? NULL : &modem_inf;
+}
+
 static int cell_info_json_encode(cJSON *const obj, const struct lte_lc_cell *const cell_inf)
 {
 	__ASSERT_NO_MSG(obj != NULL);
@@ -1755,6 +1750,12 @@ int nrf_cloud_fota_job_decode(struct nrf_cloud_fota_job_info *const job_info,
 		return -EINVAL;
 	}
 
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+	if (nrf_cloud_cbor_list_check(input)) {
+		return nrf_cloud_fota_job_cbor_decode(job_info, ble_id, input);
+	}
+#endif
+
 	int err = -ENOMSG;
 	size_t job_id_len;
 	int offset = !ble_id ? 1 : 0;
@@ -2448,6 +2449,147 @@ cleanup:
 	return -ENOMEM;
 }
 
+struct location_req {
+	struct lte_lc_cells_info const *cell_info;
+	struct wifi_scan_info const *wifi_info;
+};
+
+/* Cell and Wi-Fi parts of a location request, with the same items as
+ * nrf_cloud_cell_pos_req_json_encode() and nrf_cloud_wifi_req_json_encode()
+ */
+static void lte_inf_write(struct nrf_cloud_json_writer *w, struct lte_lc_cell const *const inf)
+{
+	nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_ECI, inf->id);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_MCC, inf->mcc);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_MNC, inf->mnc);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_TAC, inf->tac);
+
+	if (inf->earfcn != NRF_CLOUD_LOCATION_CELL_OMIT_EARFCN) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN, inf->earfcn);
+	}
+	if (inf->rsrp != NRF_CLOUD_LOCATION_CELL_OMIT_RSRP) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+				       RSRP_IDX_TO_DBM(inf->rsrp));
+	}
+	if (inf->rsrq != NRF_CLOUD_LOCATION_CELL_OMIT_RSRQ) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ,
+				       RSRQ_IDX_TO_DB(inf->rsrq));
+	}
+	if (inf->timing_advance != NRF_CLOUD_LOCATION_CELL_OMIT_TIME_ADV) {
+		nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_T_ADV,
+				       MIN(inf->timing_advance,
+					   NRF_CLOUD_LOCATION_CELL_TIME_ADV_MAX));
+	}
+}
+
+static void ncells_write(struct nrf_cloud_json_writer *w, const uint8_t ncells_count,
+			 const struct lte_lc_ncell *const neighbor_cells)
+{
+	if (!ncells_count || !neighbor_cells) {
+		return;
+	}
+
+	nrf_cloud_json_arr_start(w, NRF_CLOUD_CELL_POS_JSON_KEY_NBORS);
+
+	for (uint8_t i = 0; i < ncells_count; ++i) {
+		const struct lte_lc_ncell *ncell = neighbor_cells + i;
+
+		nrf_cloud_json_obj_start(w, NULL);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN, ncell->earfcn);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_PCI, ncell->phys_cell_id);
+		if (ncell->rsrp != NRF_CLOUD_LOCATION_CELL_OMIT_RSRP) {
+			nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+					       RSRP_IDX_TO_DBM(ncell->rsrp));
+		}
+		if (ncell->rsrq != NRF_CLOUD_LOCATION_CELL_OMIT_RSRQ) {
+			nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ,
+					       RSRQ_IDX_TO_DB(ncell->rsrq));
+		}
+		if (ncell->time_diff != LTE_LC_CELL_TIME_DIFF_INVALID) {
+			nrf_cloud_json_num_add(w, NRF_CLOUD_CELL_POS_JSON_KEY_TDIFF,
+					       ncell->time_diff);
+		}
+		nrf_cloud_json_obj_end(w);
+	}
+
+	nrf_cloud_json_arr_end(w);
+}
+
+static void cell_pos_req_write(struct nrf_cloud_json_writer *w,
+			       struct lte_lc_cells_info const *const inf)
+{
+	nrf_cloud_json_arr_start(w, NRF_CLOUD_CELL_POS_JSON_KEY_LTE);
+
+	/* If using a GCI search type, sometimes there is no current cell */
+	if (inf->current_cell.id != LTE_LC_CELL_EUTRAN_ID_INVALID) {
+		nrf_cloud_json_obj_start(w, NULL);
+		lte_inf_write(w, &inf->current_cell);
+		ncells_write(w, inf->ncells_count, inf->neighbor_cells);
+		nrf_cloud_json_obj_end(w);
+	}
+
+	for (uint8_t i = 0; inf->gci_cells && (i < inf->gci_cells_count); ++i) {
+		nrf_cloud_json_obj_start(w, NULL);
+		lte_inf_write(w, inf->gci_cells + i);
+		nrf_cloud_json_obj_end(w);
+	}
+
+	nrf_cloud_json_arr_end(w);
+}
+
+static void wifi_req_write(struct nrf_cloud_json_writer *w,
+			   struct wifi_scan_info const *const wifi)
+{
+	nrf_cloud_json_obj_start(w, NRF_CLOUD_LOCATION_JSON_KEY_WIFI);
+	nrf_cloud_json_arr_start(w, NRF_CLOUD_LOCATION_JSON_KEY_APS);
+
+	for (uint8_t cnt = 0; cnt < wifi->cnt; ++cnt) {
+		char str_buf[MAX(WIFI_MAC_ADDR_STR_LEN, WIFI_SSID_MAX_LEN) + 1];
+		struct wifi_scan_result const *const ap = (wifi->ap_info + cnt);
+
+		nrf_cloud_json_obj_start(w, NULL);
+
+		(void)snprintk(str_buf, sizeof(str_buf), WIFI_MAC_ADDR_TEMPLATE,
+			       ap->mac[0], ap->mac[1], ap->mac[2],
+			       ap->mac[3], ap->mac[4], ap->mac[5]);
+		nrf_cloud_json_str_add(w, NRF_CLOUD_LOCATION_JSON_KEY_WIFI_MAC, str_buf);
+
+		memset(str_buf, 0, sizeof(str_buf));
+		if ((ap->ssid_length > 0) && (ap->ssid_length <= WIFI_SSID_MAX_LEN)) {
+			memcpy(str_buf, ap->ssid, ap->ssid_length);
+		}
+		if (str_buf[0] != '\0') {
+			nrf_cloud_json_str_add(w, NRF_CLOUD_LOCATION_JSON_KEY_WIFI_SSID, str_buf);
+		}
+
+		if (ap->rssi != NRF_CLOUD_LOCATION_WIFI_OMIT_RSSI) {
+			nrf_cloud_json_num_add(w, NRF_CLOUD_LOCATION_JSON_KEY_WIFI_RSSI, ap->rssi);
+		}
+		if (ap->channel != NRF_CLOUD_LOCATION_WIFI_OMIT_CHAN) {
+			nrf_cloud_json_num_add(w, NRF_CLOUD_LOCATION_JSON_KEY_WIFI_CH, ap->channel);
+		}
+
+		nrf_cloud_json_obj_end(w);
+	}
+
+	nrf_cloud_json_arr_end(w);
+	nrf_cloud_json_obj_end(w);
+}
+
+static void location_req_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct location_req *req = ctx;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	if (req->cell_info) {
+		cell_pos_req_write(w, req->cell_info);
+	}
+	if (req->wifi_info) {
+		wifi_req_write(w, req->wifi_info);
+	}
+	nrf_cloud_json_obj_end(w);
+}
+
 int nrf_cloud_location_req_json_encode(struct lte_lc_cells_info const *const cell_info,
 	struct wifi_scan_info const *const wifi_info, char **string_out)
 {
@@ -2455,34 +2597,44 @@ int nrf_cloud_location_req_json_encode(struct lte_lc_cells_info const *const cel
 		return -EINVAL;
 	}
 
-	int err = 0;
-	cJSON *req_obj = cJSON_CreateObject();
+	const struct location_req req = {
+		.cell_info = cell_info,
+		.wifi_info = wifi_info,
+	};
+	size_t items = 0;
+	struct nrf_cloud_data output;
+	int err;
 
 	if (cell_info) {
-		err = nrf_cloud_cell_pos_req_json_encode(cell_info, req_obj);
-		if (err) {
-			goto cleanup;
+		if ((cell_info->current_cell.id == LTE_LC_CELL_EUTRAN_ID_INVALID) &&
+		    (!cell_info->gci_cells_count || !cell_info->gci_cells)) {
+			LOG_ERR("Failed to format location request: %d", -ENODATA);
+			return -ENODATA;
 		}
+
+		items += 1 + cell_info->ncells_count + cell_info->gci_cells_count;
 	}
 
 	if (wifi_info) {
-		err = nrf_cloud_wifi_req_json_encode(wifi_info, req_obj);
-		if (err) {
-			goto cleanup;
+		if (!wifi_info->ap_info || !wifi_info->cnt) {
+			return -EINVAL;
 		}
+
+		items += wifi_info->cnt;
 	}
 
-	*string_out = cJSON_PrintUnformatted(req_obj);
-	if (*string_out == NULL) {
-		err = -ENOMEM;
-	} else {
-		LOG_DBG("JSON: %s", *string_out);
+	err = nrf_cloud_json_encode(location_req_write, &req, NULL,
+				    NRF_CLOUD_JSON_MSG_OVERHEAD + items * LOCATION_REQ_ITEM_SIZE,
+				    &output);
+	if (err) {
+		LOG_ERR("Failed to format location request: %d", err);
+		return err;
 	}
 
-cleanup:
-	cJSON_Delete(req_obj);
+	*string_out = (char *)output.ptr;
+	LOG_DBG("JSON: %s", *string_out);
 
-	return err;
+	return 0;
 }
 
 static bool json_item_string_exists(const cJSON *const obj, const char *const key,
@@ -2852,59 +3004,50 @@ cleanup:
 	return ret;
 }
 
-int nrf_cloud_alert_encode(const struct nrf_cloud_alert_info *alert, struct nrf_cloud_data *output)
-{
 #if defined(CONFIG_NRF_CLOUD_ALERT)
-	int ret;
-
-	__ASSERT_NO_MSG(alert != NULL);
-	__ASSERT_NO_MSG(output != NULL);
-
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
+static void alert_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct nrf_cloud_alert_info *alert = ctx;
 
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_ALERT);
-	ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_ALERT_TYPE, alert->type);
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_ALERT);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_TYPE, alert->type);
 	if (alert->value != NRF_CLOUD_ALERT_UNUSED_VALUE) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_ALERT_VALUE, alert->value);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_VALUE, alert->value);
 	}
 	if (alert->ts_ms > NRF_CLOUD_NO_TIMESTAMP) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, alert->ts_ms);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, alert->ts_ms);
 	}
 	if ((alert->ts_ms <= NRF_CLOUD_NO_TIMESTAMP) ||
 	    IS_ENABLED(CONFIG_NRF_CLOUD_ALERT_SEQ_ALWAYS)) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_ALERT_SEQUENCE, alert->sequence);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_SEQUENCE, alert->sequence);
 	}
 	if (alert->description != NULL) {
-		ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_ALERT_DESCRIPTION,
-				       alert->description);
-	}
-
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
+		nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_ALERT_DESCRIPTION, alert->description);
 	}
+	nrf_cloud_json_obj_end(w);
+}
+#endif /* CONFIG_NRF_CLOUD_ALERT */
 
-	char *buffer;
+int nrf_cloud_alert_encode(const struct nrf_cloud_alert_info *alert, struct nrf_cloud_data *output)
+{
+#if defined(CONFIG_NRF_CLOUD_ALERT)
+	__ASSERT_NO_MSG(alert != NULL);
+	__ASSERT_NO_MSG(output != NULL);
 
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
+	size_t size = NRF_CLOUD_JSON_MSG_OVERHEAD;
 
-	if (buffer == NULL) {
-		return -ENOMEM;
+	if (alert->description != NULL) {
+		size += strlen(alert->description);
 	}
 
-	output->ptr = buffer;
-	output->len = strlen(buffer);
+	return nrf_cloud_json_encode(alert_write, alert, NULL, size, output);
 #else
 	ARG_UNUSED(alert);
 	output->ptr = NULL;
 	output->len = 0;
-#endif /* CONFIG_NRF_CLOUD_ALERT */
 	return 0;
+#endif /* CONFIG_NRF_CLOUD_ALERT */
 }
 
 static int agps_types_array_json_encode(cJSON * const obj,
@@ -3340,58 +3483,59 @@ int nrf_cloud_json_to_url_params_convert(char *const buf, const size_t buf_size,
 	return 0;
 }
 
-static int encode_json_log(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
-			   struct nrf_cloud_data *output)
-{
-	int ret;
-	cJSON *root_obj = cJSON_CreateObject();
+struct log_msg_ctx {
+	const struct nrf_cloud_log_context *ctx;
+	const char *msg;
+};
 
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
+static void log_write(struct nrf_cloud_json_writer *w, const void *data)
+{
+	const struct log_msg_ctx *log = data;
+	const struct nrf_cloud_log_context *ctx = log->ctx;
 
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_LOG);
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_LOG);
 	if (ctx != NULL) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_DOMAIN, ctx->dom_id);
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_LEVEL, ctx->level);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_LOG_KEY_DOMAIN, ctx->dom_id);
+		nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_LOG_KEY_LEVEL, ctx->level);
 		if (ctx->src_name != NULL) {
-			ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_SOURCE,
-					       ctx->src_name);
+			nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_LOG_KEY_SOURCE, ctx->src_name);
 		}
 		if (ctx->ts > 0) {
-			ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, ctx->ts);
+			nrf_cloud_json_num_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, ctx->ts);
 		}
 		if (!ctx->ts || IS_ENABLED(CONFIG_NRF_CLOUD_LOG_SEQ_ALWAYS)) {
-			ret += json_add_num_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_SEQUENCE,
-					       ctx->sequence);
+			nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_LOG_KEY_SEQUENCE, ctx->sequence);
 		}
 	}
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_LOG_KEY_MESSAGE, log->msg);
+	nrf_cloud_json_obj_end(w);
+}
 
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_LOG_KEY_MESSAGE, (const char *)buf);
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
-		return -ENOMEM;
-	}
-
-	char *buffer = cJSON_PrintUnformatted(root_obj);
-
-	cJSON_Delete(root_obj);
+static int encode_json_log(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
+			   char *json_buf, size_t json_size, struct nrf_cloud_data *output)
+{
+	struct log_msg_ctx log = {
+		.ctx = ctx,
+		.msg = (const char *)buf
+	};
 
-	if (buffer == NULL) {
-		return -ENOMEM;
+	if (!json_buf) {
+		json_size = size + NRF_CLOUD_JSON_MSG_OVERHEAD;
+		if ((ctx != NULL) && (ctx->src_name != NULL)) {
+			json_size += strlen(ctx->src_name);
+		}
 	}
 
-	output->ptr = buffer;
-	output->len = strlen(buffer);
-	return 0;
+	return nrf_cloud_json_encode(log_write, &log, json_buf, json_size, output);
 }
 
 int nrf_cloud_log_json_encode(struct nrf_cloud_log_context *ctx, uint8_t *buf, size_t size,
-			 struct nrf_cloud_data *output)
+			      char *json_buf, size_t json_size, struct nrf_cloud_data *output)
 {
 	__ASSERT_NO_MSG(ctx != NULL);
 	__ASSERT_NO_MSG(buf != NULL);
 	__ASSERT_NO_MSG(output != NULL);
 
-	return encode_json_log(ctx, buf, size, output);
+	return encode_json_log(ctx, buf, size, json_buf, json_size, output);
 }
@@ -31,6 +31,7 @@ static int cc_tx_ack_in_state_requested_handler(const struct nct_evt *nct_evt);
 static int cc_disconnection_handler(const struct nct_evt *nct_evt);
 static int dc_connection_handler(const struct nct_evt *nct_evt);
 static int dc_rx_data_handler(const struct nct_evt *nct_evt);
+static int dc_rx_data_chunk_handler(const struct nct_evt *nct_evt);
 static int dc_tx_ack_handler(const struct nct_evt *nct_evt);
 static int dc_disconnection_handler(const struct nct_evt *nct_evt);
 static int cc_rx_data_handler(const struct nct_evt *nct_evt);
@@ -90,6 +91,7 @@ static const fsm_transition dc_connected_fsm_transition[NCT_EVT_TOTAL] = {
 	[NCT_EVT_CC_TX_DATA_ACK] = cc_tx_ack_handler,
 	[NCT_EVT_PINGRESP] = cc_tx_ack_handler,
 	[NCT_EVT_DC_RX_DATA] = dc_rx_data_handler,
+	[NCT_EVT_DC_RX_DATA_CHUNK] = dc_rx_data_chunk_handler,
 	[NCT_EVT_DC_TX_DATA_ACK] = dc_tx_ack_handler,
 	[NCT_EVT_CC_DISCONNECTED] = cc_disconnection_handler,
 	[NCT_EVT_DC_DISCONNECTED] = dc_disconnection_handler,
@@ -279,24 +281,22 @@ static int handle_device_control_update(const struct nct_evt *const evt,
 
 	/* Acknowledge that shadow delta changes have been made. */
 	if (status == NRF_CLOUD_CTRL_REPLY) {
+		char buf[NRF_CLOUD_SHADOW_CONTROL_RESPONSE_SIZE];
 		struct nct_cc_data msg = {
 			.opcode = NCT_CC_OPCODE_UPDATE_REQ,
 			.message_id = NCT_MSG_ID_STATE_REPORT,
 		};
 		LOG_DBG("Confirming shadow delta");
-		err = nrf_cloud_shadow_control_response_encode(&ctrl_data, &msg.data);
+		err = nrf_cloud_shadow_control_response_encode(&ctrl_data, buf, sizeof(buf),
+							       &msg.data);
 		if (err) {
 			LOG_ERR("nrf_cloud_shadow_control_response_encode failed %d", err);
 			return err;
 		}
 
-		if (msg.data.ptr) {
-			err = nct_cc_send(&msg);
-			nrf_cloud_free((void *)msg.data.ptr);
-
-			if (err) {
-				LOG_ERR("nct_cc_send failed %d", err);
-			}
+		err = nct_cc_send(&msg);
+		if (err) {
+			LOG_ERR("nct_cc_send failed %d", err);
 		}
 	}
 
@@ -622,11 +622,9 @@ static int dc_connection_handler(const struct nct_evt *nct_evt)
 	return 0;
 }
 
-static void agps_process(const char * const buf, const size_t buf_len)
-{
 #if defined(CONFIG_NRF_CLOUD_AGPS)
-	int ret = nrf_cloud_agps_process(buf, buf_len);
-
+static void agps_process_result(int ret)
+{
 	if (ret) {
 		struct nrf_cloud_evt evt = {
 			.type = NRF_CLOUD_EVT_ERROR,
@@ -653,6 +651,35 @@ static void agps_process(const char * const buf, const size_t buf_len)
 		}
 	}
 #endif
+}
+#endif /* CONFIG_NRF_CLOUD_AGPS */
+
+static void agps_process(const char * const buf, const size_t buf_len)
+{
+#if defined(CONFIG_NRF_CLOUD_AGPS)
+	agps_process_result(nrf_cloud_agps_process(buf, buf_len));
+#endif
+}
+
+static void agps_process_chunk(const struct nct_dc_chunk *const chunk)
+{
+#if defined(CONFIG_NRF_CLOUD_AGPS)
+	/* Error processing an earlier chunk of the same message. */
+	static int chunk_err;
+	bool last = (chunk->offset + chunk->dc.data.len) == chunk->total_len;
+
+	if (chunk->offset == 0) {
+		chunk_err = 0;
+	} else if (chunk_err) {
+		/* The rest of the message is discarded. */
+		return;
+	}
+
+	chunk_err = nrf_cloud_agps_process_chunk(chunk->dc.data.ptr, chunk->dc.data.len,
+						 chunk->offset, chunk->total_len);
+	if (chunk_err || last) {
+		agps_process_result(chunk_err);
+	}
 #endif
 }
 
@@ -749,6 +776,29 @@ static int dc_rx_data_handler(const struct nct_evt *nct_evt)
 	return 0;
 }
 
+static int dc_rx_data_chunk_handler(const struct nct_evt *nct_evt)
+{
+	__ASSERT_NO_MSG(nct_evt != NULL);
+	__ASSERT_NO_MSG(nct_evt->param.dc_chunk != NULL);
+
+	const struct nct_dc_chunk *chunk = nct_evt->param.dc_chunk;
+
+	switch (nrf_cloud_dc_rx_topic_decode(chunk->dc.topic.ptr)) {
+	case NRF_CLOUD_RCV_TOPIC_AGPS:
+		agps_process_chunk(chunk);
+		break;
+	default:
+		/* Other messages are only processed as a whole. */
+		if (chunk->offset == 0) {
+			LOG_ERR("Message of %zu bytes does not fit in the payload buffer, dropped",
+				chunk->total_len);
+		}
+		break;
+	}
+
+	return 0;
+}
+
 static int dc_tx_ack_handler(const struct nct_evt *nct_evt)
 {
 	return 0; /* Nothing to do */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "nrf_cloud_json_writer.h"
+#include "nrf_cloud_mem.h"
+
+/* Large enough for "%1.17g" of any double */
+#define NUM_BUF_SIZE 26
+
+static void put(struct nrf_cloud_json_writer *w, const char *data, size_t len)
+{
+	if (w->buf) {
+		/* Keep room for the NUL terminator. When the buffer is too small, stop
+		 * writing but keep counting, so that the required size is known.
+		 */
+		if (len >= w->size - w->len) {
+			w->err = w->err ? w->err : -E2BIG;
+			w->buf = NULL;
+		} else {
+			memcpy(&w->buf[w->len], data, len);
+		}
+	}
+
+	w->len += len;
+}
+
+static void put_char(struct nrf_cloud_json_writer *w, char c)
+{
+	put(w, &c, 1);
+}
+
+/* Escape the string the same way cJSON does */
+static void put_string(struct nrf_cloud_json_writer *w, const char *str)
+{
+	const char *run = str;
+	char esc[7];
+
+	put_char(w, '"');
+
+	for (; str && *str; str++) {
+		unsigned char c = *str;
+
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+
+		/* Write the characters which need no escaping at once */
+		put(w, run, str - run);
+		run = str + 1;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			esc[1] = c;
+			break;
+		case '\b':
+			esc[1] = 'b';
+			break;
+		case '\f':
+			esc[1] = 'f';
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			snprintk(esc, sizeof(esc), "\\u%04x", c);
+			put(w, esc, 6);
+			continue;
+		}
+
+		esc[0] = '\\';
+		put(w, esc, 2);
+	}
+
+	if (str) {
+		put(w, run, str - run);
+	}
+
+	put_char(w, '"');
+}
+
+/* Write the separator and key of the next item */
+static void item_start(struct nrf_cloud_json_writer *w, const char *key)
+{
+	if (w->separator) {
+		put_char(w, ',');
+	}
+
+	if (key) {
+		put_string(w, key);
+		put_char(w, ':');
+	}
+
+	w->separator = true;
+}
+
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *w, char *buf, size_t size)
+{
+	__ASSERT_NO_MSG(w != NULL);
+	__ASSERT_NO_MSG(buf == NULL || size > 0);
+
+	*w = (struct nrf_cloud_json_writer) {
+		.buf = buf,
+		.size = size,
+	};
+}
+
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *w)
+{
+	if (!w->err && w->depth) {
+		w->err = -EINVAL;
+	}
+
+	if (w->err) {
+		return w->err;
+	}
+
+	if (w->buf) {
+		w->buf[w->len] = '\0';
+	}
+
+	return w->len;
+}
+
+static void container_start(struct nrf_cloud_json_writer *w, const char *key, char c)
+{
+	item_start(w, key);
+	put_char(w, c);
+
+	if (w->depth == UINT8_MAX) {
+		w->err = w->err ? w->err : -EINVAL;
+		return;
+	}
+
+	w->depth++;
+	w->separator = false;
+}
+
+static void container_end(struct nrf_cloud_json_writer *w, char c)
+{
+	if (!w->depth) {
+		w->err = w->err ? w->err : -EINVAL;
+		return;
+	}
+
+	put_char(w, c);
+	w->depth--;
+	w->separator = true;
+}
+
+void nrf_cloud_json_obj_start(struct nrf_cloud_json_writer *w, const char *key)
+{
+	container_start(w, key, '{');
+}
+
+void nrf_cloud_json_obj_end(struct nrf_cloud_json_writer *w)
+{
+	container_end(w, '}');
+}
+
+void nrf_cloud_json_arr_start(struct nrf_cloud_json_writer *w, const char *key)
+{
+	container_start(w, key, '[');
+}
+
+void nrf_cloud_json_arr_end(struct nrf_cloud_json_writer *w)
+{
+	container_end(w, ']');
+}
+
+void nrf_cloud_json_str_add(struct nrf_cloud_json_writer *w, const char *key, const char *str)
+{
+	item_start(w, key);
+	put_string(w, str);
+}
+
+static bool double_equal(double a, double b)
+{
+	double max = MAX(fabs(a), fabs(b));
+
+	return fabs(a - b) <= max * DBL_EPSILON;
+}
+
+void nrf_cloud_json_num_add(struct nrf_cloud_json_writer *w, const char *key, double num)
+{
+	char num_buf[NUM_BUF_SIZE];
+	int valueint;
+	int len;
+
+	/* cJSON saturates the integer value of a number */
+	if (num >= INT_MAX) {
+		valueint = INT_MAX;
+	} else if (num <= (double)INT_MIN) {
+		valueint = INT_MIN;
+	} else {
+		valueint = (int)num;
+	}
+
+	if (isnan(num) || isinf(num)) {
+		len = snprintf(num_buf, sizeof(num_buf), "null");
+	} else if (num == (double)valueint) {
+		len = snprintf(num_buf, sizeof(num_buf), "%d", valueint);
+	} else {
+		/* Use 15 digits if the number can be recovered from them, like cJSON */
+		len = snprintf(num_buf, sizeof(num_buf), "%1.15g", num);
+		if (!double_equal(strtod(num_buf, NULL), num)) {
+			len = snprintf(num_buf, sizeof(num_buf), "%1.17g", num);
+		}
+	}
+
+	item_start(w, key);
+
+	if (len <= 0 || len >= (int)sizeof(num_buf)) {
+		w->err = w->err ? w->err : -EINVAL;
+		return;
+	}
+
+	put(w, num_buf, len);
+}
+
+void nrf_cloud_json_bool_add(struct nrf_cloud_json_writer *w, const char *key, bool val)
+{
+	item_start(w, key);
+
+	if (val) {
+		put(w, "true", 4);
+	} else {
+		put(w, "false", 5);
+	}
+}
+
+void nrf_cloud_json_null_add(struct nrf_cloud_json_writer *w, const char *key)
+{
+	item_start(w, key);
+	put(w, "null", 4);
+}
+
+static int encode(nrf_cloud_json_write_fn write, const void *ctx, char *buf, size_t size,
+		  size_t *len)
+{
+	struct nrf_cloud_json_writer w;
+	int ret;
+
+	nrf_cloud_json_writer_init(&w, buf, size);
+	write(&w, ctx);
+
+	ret = nrf_cloud_json_writer_finish(&w);
+	*len = w.len;
+
+	return ret;
+}
+
+int nrf_cloud_json_encode(nrf_cloud_json_write_fn write, const void *ctx, char *buf,
+			  size_t size, struct nrf_cloud_data *output)
+{
+	bool alloc = (buf == NULL);
+	size_t len;
+	int ret;
+
+	__ASSERT_NO_MSG(write != NULL);
+	__ASSERT_NO_MSG(size > 0);
+	__ASSERT_NO_MSG(output != NULL);
+
+	if (alloc) {
+		buf = nrf_cloud_malloc(size);
+		if (!buf) {
+			return -ENOMEM;
+		}
+	}
+
+	ret = encode(write, ctx, buf, size, &len);
+
+	if (alloc && (ret == -E2BIG)) {
+		/* The estimate was too small, the length of the output is known now */
+		nrf_cloud_free(buf);
+
+		size = len + 1;
+		buf = nrf_cloud_malloc(size);
+		if (!buf) {
+			return -ENOMEM;
+		}
+
+		ret = encode(write, ctx, buf, size, &len);
+	}
+
+	if (ret < 0) {
+		if (alloc) {
+			nrf_cloud_free(buf);
+		}
+		return ret;
+	}
+
+	output->ptr = buf;
+	output->len = ret;
+
+	return 0;
+}
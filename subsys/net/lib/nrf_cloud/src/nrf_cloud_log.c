@@ -117,7 +117,16 @@ static int log_format(struct nrf_cloud_log_context *context,
 		LOG_WRN("Log msg is empty");
 		return -EINVAL;
 	}
-	err = nrf_cloud_log_json_encode(context, buf, strlen(buf), &output->data);
+#if defined(CONFIG_NRF_CLOUD_CBOR_LOG)
+	if (output->topic_type == NRF_CLOUD_TOPIC_BIN) {
+		err = nrf_cloud_log_cbor_encode(context, buf, strlen(buf), &output->data);
+	} else {
+		err = nrf_cloud_log_json_encode(context, buf, strlen(buf), NULL, 0,
+						&output->data);
+	}
+#else
+	err = nrf_cloud_log_json_encode(context, buf, strlen(buf), NULL, 0, &output->data);
+#endif
 	if (err) {
 		LOG_ERR("Error encoding log:%d", err);
 	}
@@ -149,9 +158,11 @@ int nrf_cloud_log_send(int log_level, const char *fmt, ...)
 #else
 	struct nrf_cloud_log_context context = {0};
 	char buf[CONFIG_NRF_CLOUD_LOG_BUF_SIZE];
+	/* CBOR logs are sent on the binary topic */
 	struct nrf_cloud_tx_data output = {
 		.qos = MQTT_QOS_0_AT_MOST_ONCE,
-		.topic_type = NRF_CLOUD_TOPIC_MESSAGE
+		.topic_type = IS_ENABLED(CONFIG_NRF_CLOUD_CBOR_LOG) ?
+			      NRF_CLOUD_TOPIC_BIN : NRF_CLOUD_TOPIC_MESSAGE
 	};
 
 	/* Send it directly to the cloud. */
@@ -165,6 +176,7 @@ int nrf_cloud_log_send(int log_level, const char *fmt, ...)
 	if (err) {
 		LOG_ERR("Error sending log:%d", err);
 	}
+	nrf_cloud_free((void *)output.data.ptr);
 #endif /* CONFIG_NRF_CLOUD_LOG_BACKEND */
 
 	return err;
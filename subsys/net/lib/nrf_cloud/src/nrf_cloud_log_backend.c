@@ -70,6 +70,8 @@ static struct nrf_cloud_log_stats {
 static struct nrf_cloud_log_context log_context;
 
 static uint8_t log_buf[CONFIG_NRF_CLOUD_LOG_BUF_SIZE + 1];
+/* JSON encoded log message, before it is stored in the ring buffer */
+static char log_json_buf[CONFIG_NRF_CLOUD_LOG_BUF_SIZE + NRF_CLOUD_JSON_MSG_OVERHEAD];
 static uint32_t log_format_current = CONFIG_LOG_BACKEND_NRF_CLOUD_OUTPUT_DEFAULT;
 static uint32_t log_output_flags = LOG_OUTPUT_FLAG_CRLF_NONE;
 static int num_msgs;
@@ -456,7 +458,12 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 				size -= len + 2;
 			}
 		}
-		err = nrf_cloud_log_json_encode(&log_context, buf, size, &data);
+		err = nrf_cloud_log_json_encode(&log_context, buf, size, log_json_buf,
+						sizeof(log_json_buf), &data);
+		if (err == -E2BIG) {
+			/* Escaping made the message larger than the buffer */
+			err = nrf_cloud_log_json_encode(&log_context, buf, size, NULL, 0, &data);
+		}
 		if (err) {
 			LOG_ERR("Error encoding log: %d", err);
 			goto end;
@@ -501,8 +508,9 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 				LOG_WRN("Stored:%u, put:%u", stored, data.len);
 			}
 			num_msgs++;
-			if (log_format_current == LOG_OUTPUT_TEXT) {
-				cJSON_free((void *)data.ptr);
+			if ((log_format_current == LOG_OUTPUT_TEXT) &&
+			    (data.ptr != log_json_buf)) {
+				nrf_cloud_free((void *)data.ptr);
 			}
 			/* Stored rendered output in ring buffer, so we can exit now */
 			break;
@@ -518,8 +526,9 @@ static int logger_out(uint8_t *buf, size_t size, void *ctx)
 			k_sleep(K_MSEC(LOG_OUTPUT_RETRY_DELAY_MS));
 			retry_count++;
 		} else {
-			if (log_format_current == LOG_OUTPUT_TEXT) {
-				cJSON_free((void *)data.ptr);
+			if ((log_format_current == LOG_OUTPUT_TEXT) &&
+			    (data.ptr != log_json_buf)) {
+				nrf_cloud_free((void *)data.ptr);
 			}
 			err = -ETIMEDOUT;
 		}
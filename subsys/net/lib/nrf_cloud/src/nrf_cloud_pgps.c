@@ -104,10 +104,34 @@ static pgps_event_handler_t evt_handler;
 static uint8_t *write_buf;
 
 #if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
-static off_t prediction_cache_flash_offset = UINT32_MAX;
-static uint8_t prediction_cache[PGPS_PREDICTION_STORAGE_SIZE];
+#define PREDICTION_CACHE_SIZE		CONFIG_NRF_CLOUD_PGPS_PREDICTION_CACHE_SIZE
+
+struct prediction_cache_entry {
+	/* Flash device offset of the cached prediction */
+	off_t off;
+	/* Value of prediction_cache_clock when last used; 0 if the entry is unused */
+	uint32_t last_used;
+	uint8_t data[PGPS_PREDICTION_STORAGE_SIZE] __aligned(4);
+};
+
+static struct prediction_cache_entry prediction_cache[PREDICTION_CACHE_SIZE];
+static uint32_t prediction_cache_clock;
+static uint32_t prediction_flash_reads;
 #endif
 
+/* Prediction fields needed for validation, which precede the ephemerides, and the sentinel. */
+struct prediction_summary {
+	uint8_t time_type;
+	uint16_t time_count;
+	struct nrf_cloud_pgps_system_time time;
+	uint8_t schema_version;
+	uint8_t ephemeris_type;
+	uint16_t ephemeris_count;
+	uint32_t sentinel;
+};
+
+#define PREDICTION_HEADER_SIZE		offsetof(struct nrf_cloud_pgps_prediction, ephemerii)
+
 static uint8_t prediction_buf[PGPS_PREDICTION_STORAGE_SIZE];
 static atomic_t accept_packets;
 static atomic_t pgps_need_assistance;
@@ -132,7 +156,9 @@ K_TIMER_DEFINE(prediction_timer, prediction_timer_handler, NULL);
 static void discard_prediction_buffer(void)
 {
 #if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
-	prediction_cache_flash_offset = UINT32_MAX;
+	for (int i = 0; i < PREDICTION_CACHE_SIZE; i++) {
+		prediction_cache[i].last_used = 0;
+	}
 #endif
 }
 
@@ -141,11 +167,26 @@ static int get_prediction_block(int pnum)
 	return npgps_pointer_to_block((uint8_t *)index.predictions[pnum]);
 }
 
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+static struct prediction_cache_entry *find_cached_prediction(off_t off)
+{
+	for (int i = 0; i < PREDICTION_CACHE_SIZE; i++) {
+		if (prediction_cache[i].last_used && (prediction_cache[i].off == off)) {
+			return &prediction_cache[i];
+		}
+	}
+
+	return NULL;
+}
+#endif
+
 /**
  * @brief When using external flash, ensure the prediction at the requested flash device offset
  * is available via the prediction cache.  When using internal flash, just the flash device offset
  * as a direct pointer to the location of the prediction in flash.
  *
+ * When the cache is full, the least recently used prediction is replaced.
+ *
  * @param off Offset from the start of the flash device, when using external flash, or offset from
  * the start of application processor memory space when using internal flash.
  *
@@ -155,32 +196,105 @@ static int get_prediction_block(int pnum)
 static struct nrf_cloud_pgps_prediction *get_cached_prediction(off_t off)
 {
 #if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
-	/* Check if the cached prediction is the one we want; if not, read it now */
-	if (prediction_cache_flash_offset != off) {
-		int err;
+	struct prediction_cache_entry *entry = find_cached_prediction(off);
+	int err;
 
-		/* Subtract fa_off from off to convert from flash device address space
-		 * to partition address space.
-		 */
-		err = flash_area_read(prediction_flash_area, off - prediction_flash_area->fa_off,
-				      prediction_cache, sizeof(prediction_cache));
+	if (entry) {
+		entry->last_used = ++prediction_cache_clock;
+		return (struct nrf_cloud_pgps_prediction *)entry->data;
+	}
 
-		if (err) {
-			LOG_ERR("Error %d reading prediction from flash offset 0x%lx",
-				err, off);
-			return NULL;
+	/* Not cached; replace the least recently used entry, unused entries first */
+	entry = &prediction_cache[0];
+	for (int i = 1; i < PREDICTION_CACHE_SIZE; i++) {
+		if (prediction_cache[i].last_used < entry->last_used) {
+			entry = &prediction_cache[i];
 		}
-		prediction_cache_flash_offset = off;
-		LOG_DBG("Caching offset 0x%X", (uint32_t)(off - prediction_flash_area->fa_off));
 	}
 
-	return (struct nrf_cloud_pgps_prediction *)prediction_cache;
+	/* Subtract fa_off from off to convert from flash device address space
+	 * to partition address space.
+	 */
+	prediction_flash_reads++;
+	err = flash_area_read(prediction_flash_area, off - prediction_flash_area->fa_off,
+			      entry->data, sizeof(entry->data));
+	if (err) {
+		LOG_ERR("Error %d reading prediction from flash offset 0x%lx",
+			err, off);
+		entry->last_used = 0;
+		return NULL;
+	}
+	entry->off = off;
+	entry->last_used = ++prediction_cache_clock;
+	LOG_DBG("Caching offset 0x%X", (uint32_t)(off - prediction_flash_area->fa_off));
+
+	return (struct nrf_cloud_pgps_prediction *)entry->data;
 #else
 	/* The parameter off is really the address in built-in flash for the prediction */
 	return (struct nrf_cloud_pgps_prediction *)off;
 #endif
 }
 
+static void prediction_summary_set(struct prediction_summary *s,
+				   const struct nrf_cloud_pgps_prediction *p)
+{
+	/* Only the fields preceding the ephemerides are accessed */
+	s->time_type = p->time_type;
+	s->time_count = p->time_count;
+	s->time.date_day = p->time.date_day;
+	s->time.time_full_s = p->time.time_full_s;
+	s->schema_version = p->schema_version;
+	s->ephemeris_type = p->ephemeris_type;
+	s->ephemeris_count = p->ephemeris_count;
+}
+
+/**
+ * @brief Get the fields of the prediction at the given offset needed to validate it.
+ * With external flash, only those fields are read, unless the prediction is already cached.
+ * The prediction cache is not modified.
+ */
+static int get_prediction_summary(off_t off, struct prediction_summary *s)
+{
+	const struct nrf_cloud_pgps_prediction *p;
+
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+	struct prediction_cache_entry *entry = find_cached_prediction(off);
+	uint8_t header[PREDICTION_HEADER_SIZE] __aligned(4);
+	off_t fa_off = off - prediction_flash_area->fa_off;
+	int err;
+
+	if (entry) {
+		p = (const struct nrf_cloud_pgps_prediction *)entry->data;
+		prediction_summary_set(s, p);
+		s->sentinel = p->sentinel;
+		return 0;
+	}
+
+	prediction_flash_reads += 2;
+	err = flash_area_read(prediction_flash_area, fa_off, header, sizeof(header));
+	if (!err) {
+		err = flash_area_read(prediction_flash_area,
+				      fa_off + offsetof(struct nrf_cloud_pgps_prediction, sentinel),
+				      &s->sentinel, sizeof(s->sentinel));
+	}
+	if (err) {
+		LOG_ERR("Error %d reading prediction header from flash offset 0x%lx",
+			err, off);
+		return err;
+	}
+
+	/* The buffer only holds the fields preceding the ephemerides */
+	p = (const struct nrf_cloud_pgps_prediction *)header;
+	prediction_summary_set(s, p);
+#else
+	p = (const struct nrf_cloud_pgps_prediction *)off;
+	prediction_summary_set(s, p);
+	s->sentinel = p->sentinel;
+#endif
+
+	return 0;
+}
+
 static struct nrf_cloud_pgps_prediction *get_prediction(int pnum)
 {
 	off_t off = (off_t)index.predictions[pnum];
@@ -200,7 +314,7 @@ static struct nrf_cloud_pgps_prediction *get_prediction_slot(int slot, off_t *fl
 }
 
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
-				    struct nrf_cloud_pgps_prediction *p)
+				    const struct prediction_summary *p)
 {
 	int64_t start_sec = npgps_gps_day_time_to_sec(header->gps_day,
 						      header->gps_time_of_day);
@@ -248,7 +362,7 @@ static bool validate_pgps_header(const struct nrf_cloud_pgps_header *header)
 	return true;
 }
 
-static int validate_prediction(const struct nrf_cloud_pgps_prediction *p,
+static int validate_prediction(const struct prediction_summary *p,
 			       uint16_t gps_day,
 			       uint32_t gps_time_of_day,
 			       uint16_t period_min,
@@ -305,8 +419,8 @@ static int validate_prediction(const struct nrf_cloud_pgps_prediction *p,
 							      gps_time_of_day);
 		stored_sentinel = p->sentinel;
 		if (expected_sentinel != stored_sentinel) {
-			LOG_ERR("prediction at:%p has stored_sentinel:0x%08X, "
-				"expected:0x%08X", p, stored_sentinel,
+			LOG_ERR("prediction has stored_sentinel:0x%08X, "
+				"expected:0x%08X", stored_sentinel,
 				expected_sentinel);
 			err = -EINVAL;
 		}
@@ -327,72 +441,82 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	uint16_t period_min = index.header.prediction_period_min;
 	uint16_t gps_day = index.header.gps_day;
 	uint32_t gps_time_of_day = index.header.gps_time_of_day;
-	struct nrf_cloud_pgps_prediction *pred;
+	struct prediction_summary summary;
 	int64_t start_gps_sec = index.start_sec;
+	int64_t start_ms = k_uptime_get();
 	off_t off;
 	int64_t gps_sec;
+	ATOMIC_DEFINE(valid, NUM_PREDICTIONS);
 
 	/* reset catalog of predictions */
 	discard_prediction_buffer();
 	for (pnum = 0; pnum < count; pnum++) {
 		index.predictions[pnum] = NULL;
 	}
+	memset(valid, 0, sizeof(valid));
 
 	npgps_reset_block_pool();
 
-	/* build catalog of predictions by block */
+	/* build catalog of predictions by block, and validate each prediction
+	 * against the time it is expected to have; only the fields needed
+	 * for this are read, not the ephemerides
+	 */
 	for (i = 0; i < count; i++) {
-		pred = (struct nrf_cloud_pgps_prediction *)get_prediction_slot(i, &off);
-		if (pred == NULL) {
+		off = storage_addr + i * PGPS_PREDICTION_STORAGE_SIZE;
+		err = get_prediction_summary(off, &summary);
+		if (err) {
 			LOG_ERR("Prediction at idx:%d not accessible", i);
 			continue;
 		}
 
-		pnum = determine_prediction_num(&index.header, pred);
+		pnum = determine_prediction_num(&index.header, &summary);
 		if (pnum < 0) {
-			LOG_ERR("prediction idx:%u, ofs:%p, out of expected time range;"
-				" day:%u, time:%u", i, (void *)pred, pred->time.date_day,
-				pred->time.time_full_s);
-		} else if (index.predictions[pnum] == NULL) {
-			index.predictions[pnum] = (struct nrf_cloud_pgps_prediction *)off;
-			LOG_DBG("Prediction num:%u stored at idx:%d, off:0x%lX",
-				pnum, i, (unsigned long) off);
-		} else {
+			LOG_ERR("prediction idx:%u, ofs:0x%lX, out of expected time range;"
+				" day:%u, time:%u", i, (unsigned long)off, summary.time.date_day,
+				summary.time.time_full_s);
+			continue;
+		} else if (index.predictions[pnum] != NULL) {
 			LOG_WRN("Prediction num:%u stored more than once!", pnum);
+			continue;
 		}
-	}
 
-	/* validate predictions in time order, independent of storage order */
-	i = -1;
-	for (pnum = 0; pnum < count; pnum++) {
+		index.predictions[pnum] = (struct nrf_cloud_pgps_prediction *)off;
+		LOG_DBG("Prediction num:%u stored at idx:%d, off:0x%lX",
+			pnum, i, (unsigned long) off);
+
 		/* calculate expected time signature */
 		gps_sec = start_gps_sec + pnum * period_min * SEC_PER_MIN;
 		npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
 
-		pred = get_prediction(pnum);
-		if (pred == NULL) {
-			LOG_WRN("Prediction num:%u missing", pnum);
-			/* request partial data; download interrupted? */
-			*first_bad_day = gps_day;
-			*first_bad_time = gps_time_of_day;
-			break;
-		}
-
-		err = validate_prediction(pred, gps_day, gps_time_of_day,
+		err = validate_prediction(&summary, gps_day, gps_time_of_day,
 					  period_min, true, false);
 		if (err) {
 			LOG_ERR("Prediction num:%u, gps_day:%u, "
-				"gps_time_of_day:%u is bad:%d; loc:%p",
-				pnum, gps_day, gps_time_of_day, err, pred);
+				"gps_time_of_day:%u is bad:%d; off:0x%lX",
+				pnum, gps_day, gps_time_of_day, err, (unsigned long)off);
+		} else {
+			atomic_set_bit(valid, pnum);
+		}
+	}
+
+	/* use predictions in time order, independent of storage order */
+	i = -1;
+	for (pnum = 0; pnum < count; pnum++) {
+		if (!atomic_test_bit(valid, pnum)) {
+			if (index.predictions[pnum] == NULL) {
+				LOG_WRN("Prediction num:%u missing", pnum);
+			}
 			/* request partial data; download interrupted? */
+			gps_sec = start_gps_sec + pnum * period_min * SEC_PER_MIN;
+			npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
 			*first_bad_day = gps_day;
 			*first_bad_time = gps_time_of_day;
 			break;
 		}
 
 		i = get_prediction_block(pnum);
-		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
-		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", pred);
+		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, index.predictions[pnum], i);
+		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", index.predictions[pnum]);
 		npgps_mark_block_used(i, true);
 	}
 
@@ -411,6 +535,14 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	}
 
 	npgps_print_blocks();
+
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+	LOG_INF("Validated %d of %u predictions in %u ms; total flash reads:%u",
+		pnum, count, (uint32_t)(k_uptime_get() - start_ms), prediction_flash_reads);
+#else
+	LOG_INF("Validated %d of %u predictions in %u ms",
+		pnum, count, (uint32_t)(k_uptime_get() - start_ms));
+#endif
 	return pnum;
 }
 
@@ -680,7 +812,11 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	index.cur_pnum = pnum;
 	*prediction = get_prediction(pnum);
 	if (*prediction) {
-		err = validate_prediction(*prediction,
+		struct prediction_summary summary;
+
+		prediction_summary_set(&summary, *prediction);
+		summary.sentinel = (*prediction)->sentinel;
+		err = validate_prediction(&summary,
 					  cur_gps_day, cur_gps_time_of_day,
 					  period_min, false, margin);
 		if (!err) {
@@ -805,6 +805,46 @@ static int publish_get_payload(struct mqtt_client *client, size_t length)
 	return ret;
 }
 
+/* Read a payload that does not fit in the payload buffer and pass it on in chunks. */
+static int publish_get_payload_chunked(struct mqtt_client *client,
+				       const struct mqtt_publish_param *p)
+{
+	int err;
+	size_t len;
+	struct nct_dc_chunk chunk = {
+		.dc.data.ptr = nct.payload_buf,
+		.dc.topic.len = p->message.topic.topic.size,
+		.dc.topic.ptr = p->message.topic.topic.utf8,
+		.dc.message_id = p->message_id,
+		.total_len = p->message.payload.len,
+	};
+	const struct nct_evt evt = {
+		.type = NCT_EVT_DC_RX_DATA_CHUNK,
+		.param.dc_chunk = &chunk,
+	};
+
+	while (chunk.offset < chunk.total_len) {
+		len = MIN(chunk.total_len - chunk.offset, sizeof(nct.payload_buf) - 1);
+
+		err = mqtt_readall_publish_payload(client, nct.payload_buf, len);
+		if (err) {
+			return err;
+		}
+
+		nct.payload_buf[len] = 0;
+		chunk.dc.data.len = len;
+
+		err = nct_input(&evt);
+		if (err) {
+			LOG_ERR("nct_input: failed %d", err);
+		}
+
+		chunk.offset += len;
+	}
+
+	return 0;
+}
+
 static int translate_mqtt_connack_result(const int mqtt_result)
 {
 	switch (mqtt_result) {
@@ -886,8 +926,19 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			p->message.topic.topic.size,
 			p->message.topic.topic.utf8);
 
-		int err = publish_get_payload(mqtt_client,
-					      p->message.payload.len);
+		bool cc_topic = control_channel_topic_match(NCT_RX_LIST, &p->message.topic,
+							    &cc.opcode);
+		/* Messages on the data channel that do not fit in the payload buffer,
+		 * such as A-GPS data, are passed on in chunks.
+		 */
+		bool chunked = !cc_topic &&
+			       (p->message.payload.len > (sizeof(nct.payload_buf) - 1));
+
+		if (chunked) {
+			err = publish_get_payload_chunked(mqtt_client, p);
+		} else {
+			err = publish_get_payload(mqtt_client, p->message.payload.len);
+		}
 
 		if (err < 0) {
 			LOG_ERR("publish_get_payload: failed %d", err);
@@ -899,8 +950,7 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 		/* If the data arrives on one of the subscribed control channel
 		 * topic. Then we notify the same.
 		 */
-		if (control_channel_topic_match(NCT_RX_LIST, &p->message.topic,
-						&cc.opcode)) {
+		if (cc_topic) {
 			cc.message_id = p->message_id;
 			cc.data.ptr = nct.payload_buf;
 			cc.data.len = p->message.payload.len;
@@ -910,7 +960,7 @@ static void nct_mqtt_evt_handler(struct mqtt_client *const mqtt_client,
 			evt.type = NCT_EVT_CC_RX_DATA;
 			evt.param.cc = &cc;
 			event_notify = true;
-		} else {
+		} else if (!chunked) {
 			/* Try to match it with one of the data topics. */
 			dc.message_id = p->message_id;
 			dc.data.ptr = nct.payload_buf;
@@ -30,6 +30,32 @@ LOG_MODULE_REGISTER(rest_client, CONFIG_REST_CLIENT_LOG_LEVEL);
 
 #define HTTP_PROTOCOL "HTTP/1.1"
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+/* Requests to hosts with longer names are not pooled. */
+#define CONN_POOL_HOST_LEN_MAX 128
+
+/* Connection that is kept open after a request, to be reused by the next request to the same
+ * server with the same security settings.
+ */
+struct rest_client_conn {
+	/* Socket, or -1 if the slot has no open connection. */
+	int fd;
+	/* True while the slot is used by a request. */
+	bool in_use;
+	/* Uptime when the connection was last released, in milliseconds. */
+	int64_t last_used;
+	uint16_t port;
+	int sec_tag;
+	int tls_peer_verify;
+	char host[CONN_POOL_HOST_LEN_MAX];
+};
+
+static struct rest_client_conn conn_pool[CONFIG_REST_CLIENT_CONN_POOL_SIZE] = {
+	[0 ... CONFIG_REST_CLIENT_CONN_POOL_SIZE - 1] = { .fd = -1 },
+};
+static K_MUTEX_DEFINE(conn_pool_lock);
+#endif /* CONFIG_REST_CLIENT_CONN_POOL */
+
 static void rest_client_http_response_cb(struct http_response *rsp,
 					  enum http_final_call final_data,
 					  void *user_data)
@@ -130,18 +156,26 @@ static int rest_client_sckt_timeouts_set(int fd, int32_t timeout_ms)
 		/* Send TO also affects TCP connect */
 		timeout.tv_sec = timeout_ms / MSEC_PER_SEC;
 		timeout.tv_usec = (timeout_ms % MSEC_PER_SEC) * USEC_PER_MSEC;
-		err = setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-		if (err) {
-			LOG_ERR("Failed to set socket send timeout, error: %d", errno);
-			return err;
-		}
+	} else if (!IS_ENABLED(CONFIG_REST_CLIENT_CONN_POOL)) {
+		return 0;
+	}
 
-		err = setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-		if (err) {
-			LOG_ERR("Failed to set socket recv timeout, error: %d", errno);
-			return err;
-		}
+	/* A zero timeout disables the timeout. It is set explicitly when connections are pooled,
+	 * as a reused socket still has the timeouts of the previous request.
+	 */
+
+	err = setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	if (err) {
+		LOG_ERR("Failed to set socket send timeout, error: %d", errno);
+		return err;
 	}
+
+	err = setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	if (err) {
+		LOG_ERR("Failed to set socket recv timeout, error: %d", errno);
+		return err;
+	}
+
 	return 0;
 }
 
@@ -323,6 +357,7 @@ static int rest_client_do_api_call(struct http_request *http_req,
 	resp_ctx->response_len = 0;
 	resp_ctx->total_response_len = 0;
 	resp_ctx->used_socket_id = req_ctx->connect_socket;
+	resp_ctx->http_status_code = 0;
 	resp_ctx->http_status_code_str[0] = '\0';
 
 	err = http_client_req(req_ctx->connect_socket, http_req, req_ctx->timeout_ms, resp_ctx);
@@ -340,6 +375,226 @@ static int rest_client_do_api_call(struct http_request *http_req,
 	return err;
 }
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+static bool conn_pool_match(const struct rest_client_conn *conn,
+			    const struct rest_client_req_context *const req_ctx)
+{
+	return (conn->port == req_ctx->port) &&
+	       (conn->sec_tag == req_ctx->sec_tag) &&
+	       (conn->tls_peer_verify == req_ctx->tls_peer_verify) &&
+	       (strcmp(conn->host, req_ctx->host) == 0);
+}
+
+static void conn_pool_conn_close(struct rest_client_conn *conn)
+{
+	if (conn->fd < 0) {
+		return;
+	}
+
+	if (close(conn->fd)) {
+		LOG_WRN("Failed to close pooled socket, error: %d", errno);
+	}
+
+	conn->fd = -1;
+}
+
+/* Get a pool slot for the request. The slot holds an open connection to the server if there is
+ * one that can be reused, otherwise its socket is -1. Returns NULL if the request cannot be pooled.
+ */
+static struct rest_client_conn *conn_pool_acquire(struct rest_client_req_context *const req_ctx)
+{
+	struct rest_client_conn *match = NULL;
+	struct rest_client_conn *free_slot = NULL;
+	struct rest_client_conn *lru = NULL;
+	struct rest_client_conn *conn;
+	int64_t now;
+
+	if (strlen(req_ctx->host) >= CONN_POOL_HOST_LEN_MAX) {
+		return NULL;
+	}
+
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	now = k_uptime_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		conn = &conn_pool[i];
+
+		if (conn->in_use) {
+			continue;
+		}
+
+		/* Close connections that have been idle for too long, the server has likely
+		 * closed them already.
+		 */
+		if ((conn->fd >= 0) &&
+		    ((now - conn->last_used) >=
+		     (CONFIG_REST_CLIENT_CONN_POOL_IDLE_TIMEOUT * MSEC_PER_SEC))) {
+			LOG_DBG("Closing idle connection to %s", conn->host);
+			conn_pool_conn_close(conn);
+		}
+
+		if (conn->fd < 0) {
+			if (!free_slot) {
+				free_slot = conn;
+			}
+		} else if (conn_pool_match(conn, req_ctx)) {
+			match = conn;
+			break;
+		} else if (!lru || (conn->last_used < lru->last_used)) {
+			lru = conn;
+		}
+	}
+
+	if (match) {
+		conn = match;
+		LOG_DBG("Reusing connection to %s, socket %d", conn->host, conn->fd);
+	} else if (free_slot) {
+		conn = free_slot;
+	} else if (lru) {
+		conn = lru;
+		LOG_DBG("Closing least recently used connection to %s", conn->host);
+		conn_pool_conn_close(conn);
+	} else {
+		/* All connections are in use by other requests. */
+		conn = NULL;
+	}
+
+	if (conn) {
+		conn->in_use = true;
+
+		if (conn != match) {
+			conn->port = req_ctx->port;
+			conn->sec_tag = req_ctx->sec_tag;
+			conn->tls_peer_verify = req_ctx->tls_peer_verify;
+			strcpy(conn->host, req_ctx->host);
+		}
+	}
+
+	k_mutex_unlock(&conn_pool_lock);
+
+	return conn;
+}
+
+/* A reused connection that the server has closed while it was idle fails before any byte of the
+ * response is received. The request has then not been processed, so it can be sent again whatever
+ * its method is. After other failures, such as a timeout, the server may have processed the
+ * request, so only idempotent requests are sent again.
+ */
+static bool conn_pool_retry_allowed(const struct http_request *http_req, int err,
+				    const struct rest_client_resp_context *const resp_ctx)
+{
+	if ((resp_ctx->http_status_code != 0) || (err == -ENOBUFS)) {
+		return false;
+	}
+
+	if ((resp_ctx->total_response_len == 0) &&
+	    ((err == -ECONNRESET) || (err == -EPIPE) || (err == -ENOTCONN) || (err == 0))) {
+		return true;
+	}
+
+	return (http_req->method == HTTP_GET) || (http_req->method == HTTP_HEAD);
+}
+
+static void conn_pool_release(struct rest_client_conn *conn, int fd, bool reusable)
+{
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	conn->fd = fd;
+
+	if (reusable) {
+		conn->last_used = k_uptime_get();
+	} else {
+		conn_pool_conn_close(conn);
+	}
+
+	conn->in_use = false;
+
+	k_mutex_unlock(&conn_pool_lock);
+}
+
+static int rest_client_do_pooled_api_call(struct http_request *http_req,
+					  struct rest_client_req_context *const req_ctx,
+					  struct rest_client_resp_context *const resp_ctx)
+{
+	int err;
+	bool reused;
+	bool retry;
+	bool reusable;
+	struct rest_client_conn *conn;
+
+	/* Used to tell whether a response was received. */
+	resp_ctx->http_status_code = 0;
+
+	conn = conn_pool_acquire(req_ctx);
+	if (!conn) {
+		/* Fall back to a connection that is closed after the request. */
+		return rest_client_do_api_call(http_req, req_ctx, resp_ctx);
+	}
+
+	req_ctx->connect_socket = conn->fd;
+	reused = (conn->fd >= 0);
+
+	if (reused) {
+		err = rest_client_sckt_timeouts_set(conn->fd, req_ctx->timeout_ms);
+		/* The request has not been sent if the socket cannot be configured. */
+		retry = (err != 0);
+	} else {
+		err = 0;
+		retry = false;
+	}
+
+	if (!err) {
+		err = rest_client_do_api_call(http_req, req_ctx, resp_ctx);
+		retry = reused && conn_pool_retry_allowed(http_req, err, resp_ctx);
+	}
+
+	/* The server may have closed a reused connection while it was idle. In that case, the
+	 * request is sent again on a new connection.
+	 */
+	if (retry) {
+		LOG_DBG("Pooled connection failed (%d), reconnecting", err);
+
+		(void)close(req_ctx->connect_socket);
+		req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+
+		err = rest_client_do_api_call(http_req, req_ctx, resp_ctx);
+	}
+
+	/* The connection can only be reused if the whole response was read, and the server
+	 * does not close it.
+	 */
+	reusable = (err == 0) && (resp_ctx->http_status_code != 0) &&
+		   http_should_keep_alive(&http_req->internal.parser);
+
+	conn_pool_release(conn, req_ctx->connect_socket, reusable);
+
+	/* The socket is owned by the pool, but it is still open if it was kept. */
+	resp_ctx->used_socket_is_alive = reusable;
+	req_ctx->connect_socket = REST_CLIENT_SCKT_CONNECT;
+
+	return err;
+}
+
+int rest_client_conn_pool_flush(void)
+{
+	int closed = 0;
+
+	k_mutex_lock(&conn_pool_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(conn_pool); i++) {
+		if (!conn_pool[i].in_use && (conn_pool[i].fd >= 0)) {
+			conn_pool_conn_close(&conn_pool[i]);
+			closed++;
+		}
+	}
+
+	k_mutex_unlock(&conn_pool_lock);
+
+	return closed;
+}
+#endif /* CONFIG_REST_CLIENT_CONN_POOL */
+
 void rest_client_request_defaults_set(struct rest_client_req_context *req_ctx)
 {
 	__ASSERT_NO_MSG(req_ctx != NULL);
@@ -388,7 +643,15 @@ int rest_client_request(struct rest_client_req_context *req_ctx,
 		}
 	}
 
+#if defined(CONFIG_REST_CLIENT_CONN_POOL)
+	if ((req_ctx->connect_socket == REST_CLIENT_SCKT_CONNECT) && !req_ctx->keep_alive) {
+		ret = rest_client_do_pooled_api_call(&http_req, req_ctx, resp_ctx);
+	} else {
+		ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+	}
+#else
 	ret = rest_client_do_api_call(&http_req, req_ctx, resp_ctx);
+#endif /* CONFIG_REST_CLIENT_CONN_POOL */
 	if (ret) {
 		LOG_ERR("rest_client_do_api_call() failed, err %d", ret);
 		goto clean_up;
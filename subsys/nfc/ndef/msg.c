@@ -8,6 +8,7 @@
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <errno.h>
+#include <string.h>
 
 /* Resolve the value of record location flags of the NFC NDEF record
  * within an NFC NDEF message.
@@ -96,3 +97,117 @@ int nfc_ndef_msg_record_add(struct nfc_ndef_msg_desc *msg,
 
 	return 0;
 }
+
+int nfc_ndef_msg_cache_encode(struct nfc_ndef_msg_cache *cache,
+			      struct nfc_ndef_msg_desc const *ndef_msg_desc,
+			      uint8_t *msg_buffer,
+			      uint32_t *msg_len)
+{
+	uint32_t sum_of_len = 0;
+
+	if (!cache || !ndef_msg_desc || !ndef_msg_desc->record ||
+	    !msg_buffer || !msg_len) {
+		return -EINVAL;
+	}
+
+	if (ndef_msg_desc->record_count > cache->max_record_count) {
+		return -ENOSR;
+	}
+
+	cache->msg = NULL;
+
+	for (uint32_t i = 0; i < ndef_msg_desc->record_count; i++) {
+		uint32_t temp_len = *msg_len - sum_of_len;
+		int err;
+
+		err = nfc_ndef_record_encode(ndef_msg_desc->record[i],
+					     record_location_get(i, ndef_msg_desc->record_count),
+					     &msg_buffer[sum_of_len],
+					     &temp_len);
+		if (err) {
+			return err;
+		}
+
+		cache->offset[i] = sum_of_len;
+		sum_of_len += temp_len;
+	}
+
+	cache->offset[ndef_msg_desc->record_count] = sum_of_len;
+	cache->msg = ndef_msg_desc;
+	cache->buffer = msg_buffer;
+	cache->size = *msg_len;
+
+	*msg_len = sum_of_len;
+
+	return 0;
+}
+
+int nfc_ndef_msg_cache_record_update(struct nfc_ndef_msg_cache *cache,
+				     uint32_t index,
+				     uint32_t *msg_len)
+{
+	struct nfc_ndef_record_desc const *record;
+	enum nfc_ndef_record_location record_location;
+	uint32_t record_count;
+	uint32_t old_len;
+	uint32_t new_len;
+	uint32_t tail_len;
+	uint32_t *offset;
+	int err;
+
+	if (!cache || !cache->msg || !msg_len) {
+		return -EINVAL;
+	}
+
+	record_count = cache->msg->record_count;
+	offset = cache->offset;
+
+	if (index >= record_count) {
+		return -EINVAL;
+	}
+
+	record = cache->msg->record[index];
+	record_location = record_location_get(index, record_count);
+
+	/* Records are always encoded with the long payload length field, so
+	 * a change of the record length only moves the records following it.
+	 */
+	err = nfc_ndef_record_encode(record, record_location, NULL, &new_len);
+	if (err) {
+		return err;
+	}
+
+	old_len = offset[index + 1] - offset[index];
+
+	if (new_len != old_len) {
+		tail_len = offset[record_count] - offset[index + 1];
+
+		if ((offset[record_count] - old_len + new_len) > cache->size) {
+			return -ENOSR;
+		}
+
+		memmove(&cache->buffer[offset[index] + new_len],
+			&cache->buffer[offset[index + 1]],
+			tail_len);
+
+		for (uint32_t i = index + 1; i <= record_count; i++) {
+			offset[i] = offset[i] - old_len + new_len;
+		}
+	}
+
+	err = nfc_ndef_record_encode(record, record_location,
+				     &cache->buffer[offset[index]], &new_len);
+	if (!err && (new_len != offset[index + 1] - offset[index])) {
+		err = -EIO;
+	}
+
+	if (err) {
+		/* The buffer no longer matches the cached layout. */
+		cache->msg = NULL;
+		return err;
+	}
+
+	*msg_len = offset[record_count];
+
+	return 0;
+}
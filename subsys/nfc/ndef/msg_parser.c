@@ -3,8 +3,10 @@
  *
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
+#include <errno.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <nfc/ndef/msg_parser.h>
 #include "msg_parser_local.h"
 
 LOG_MODULE_REGISTER(nfc_ndef_parser, CONFIG_NFC_NDEF_PARSER_LOG_LEVEL);
@@ -35,6 +37,67 @@ int nfc_ndef_msg_parse(uint8_t *result_buf,
 	return err;
 }
 
+void nfc_ndef_msg_iter_init(struct nfc_ndef_msg_iter *iter,
+			    const uint8_t *raw_data,
+			    uint32_t raw_data_len)
+{
+	__ASSERT_NO_MSG(iter);
+
+	iter->data = raw_data;
+	iter->data_len = raw_data_len;
+	iter->offset = 0;
+	iter->record_count = 0;
+	iter->end = false;
+}
+
+int nfc_ndef_msg_iter_next(struct nfc_ndef_msg_iter *iter,
+			   struct nfc_ndef_record_view *view)
+{
+	uint32_t record_len;
+	int err;
+
+	__ASSERT_NO_MSG(iter);
+	__ASSERT_NO_MSG(view);
+
+	if (iter->end) {
+		return -ENOENT;
+	}
+
+	if (iter->offset >= iter->data_len) {
+		return -EFAULT;
+	}
+
+	record_len = iter->data_len - iter->offset;
+
+	err = nfc_ndef_record_view_parse(view, &iter->data[iter->offset],
+					 &record_len);
+	if (err) {
+		return err;
+	}
+
+	/* Verify the records location flags. */
+	if (iter->record_count == 0) {
+		if ((view->location != NDEF_FIRST_RECORD) &&
+		    (view->location != NDEF_LONE_RECORD)) {
+			return -EFAULT;
+		}
+	} else {
+		if ((view->location != NDEF_MIDDLE_RECORD) &&
+		    (view->location != NDEF_LAST_RECORD)) {
+			return -EFAULT;
+		}
+	}
+
+	iter->offset += record_len;
+	iter->record_count++;
+
+	if ((view->location == NDEF_LAST_RECORD) ||
+	    (view->location == NDEF_LONE_RECORD)) {
+		iter->end = true;
+	}
+
+	return 0;
+}
 
 void nfc_ndef_msg_printout(const struct nfc_ndef_msg_desc *msg_desc)
 {
@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <string.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/byteorder.h>
@@ -19,11 +20,9 @@ LOG_MODULE_DECLARE(nfc_ndef_parser, CONFIG_NFC_NDEF_PARSER_LOG_LEVEL);
 #define NDEF_RECORD_BASE_SHORT_LEN (2 + NDEF_RECORD_PAYLOAD_LEN_SHORT_SIZE)
 
 
-int nfc_ndef_record_parse(struct nfc_ndef_bin_payload_desc *bin_pay_desc,
-			  struct nfc_ndef_record_desc *rec_desc,
-			  enum nfc_ndef_record_location *record_location,
-			  const uint8_t *nfc_data,
-			  uint32_t *nfc_data_len)
+int nfc_ndef_record_view_parse(struct nfc_ndef_record_view *view,
+			       const uint8_t *nfc_data,
+			       uint32_t *nfc_data_len)
 {
 	uint32_t expected_rec_size = NDEF_RECORD_BASE_SHORT_LEN;
 
@@ -31,26 +30,24 @@ int nfc_ndef_record_parse(struct nfc_ndef_bin_payload_desc *bin_pay_desc,
 		return -EINVAL;
 	}
 
-	rec_desc->tnf = (enum nfc_ndef_record_tnf) ((*nfc_data) & NDEF_RECORD_TNF_MASK);
+	view->tnf = (enum nfc_ndef_record_tnf) ((*nfc_data) & NDEF_RECORD_TNF_MASK);
 
 	/* An NDEF parser that receives an NDEF record with an unknown
 	 * or unsupported TNF field value
 	 * SHOULD treat it as Unknown. See NFCForum-TS-NDEF_1.0
 	 */
-	if (rec_desc->tnf == TNF_RESERVED) {
-		rec_desc->tnf = TNF_UNKNOWN_TYPE;
+	if (view->tnf == TNF_RESERVED) {
+		view->tnf = TNF_UNKNOWN_TYPE;
 	}
 
-	*record_location = (enum nfc_ndef_record_location) ((*nfc_data) & NDEF_RECORD_LOCATION_MASK);
+	view->location = (enum nfc_ndef_record_location) ((*nfc_data) & NDEF_RECORD_LOCATION_MASK);
 
 	uint8_t flags = *(nfc_data++);
 
-	rec_desc->type_length = *(nfc_data++);
-
-	uint32_t payload_length;
+	view->type_length = *(nfc_data++);
 
 	if (flags & NDEF_RECORD_SR_MASK) {
-		payload_length = *(nfc_data++);
+		view->payload_length = *(nfc_data++);
 	} else {
 		expected_rec_size +=
 			NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE - NDEF_RECORD_PAYLOAD_LEN_SHORT_SIZE;
@@ -59,7 +56,7 @@ int nfc_ndef_record_parse(struct nfc_ndef_bin_payload_desc *bin_pay_desc,
 			return -EINVAL;
 		}
 
-		payload_length = sys_get_be32(nfc_data);
+		view->payload_length = sys_get_be32(nfc_data);
 		nfc_data += NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE;
 	}
 
@@ -70,42 +67,81 @@ int nfc_ndef_record_parse(struct nfc_ndef_bin_payload_desc *bin_pay_desc,
 			return -EINVAL;
 		}
 
-		rec_desc->id_length = *(nfc_data++);
+		view->id_length = *(nfc_data++);
 	} else {
-		rec_desc->id_length = 0;
-		rec_desc->id        = NULL;
+		view->id_length = 0;
 	}
 
-	expected_rec_size += rec_desc->type_length + rec_desc->id_length + payload_length;
+	/* Compare the remaining lengths one by one, so that a corrupted
+	 * payload length cannot overflow the expected record size.
+	 */
+	expected_rec_size += view->type_length + view->id_length;
 
-	if (expected_rec_size > *nfc_data_len) {
+	if ((expected_rec_size > *nfc_data_len) ||
+	    (view->payload_length > (*nfc_data_len - expected_rec_size))) {
 		return -EINVAL;
 	}
 
-	if (rec_desc->type_length > 0) {
-		rec_desc->type = nfc_data;
-		nfc_data += rec_desc->type_length;
-	} else {
-		rec_desc->type = NULL;
-	}
+	expected_rec_size += view->payload_length;
 
-	if (rec_desc->id_length > 0) {
-		rec_desc->id = nfc_data;
-		nfc_data += rec_desc->id_length;
-	}
+	view->type = (view->type_length > 0) ? nfc_data : NULL;
+	nfc_data += view->type_length;
 
-	if (payload_length == 0) {
-		bin_pay_desc->payload = NULL;
-	} else {
-		bin_pay_desc->payload = nfc_data;
-	}
+	view->id = (view->id_length > 0) ? nfc_data : NULL;
+	nfc_data += view->id_length;
 
-	bin_pay_desc->payload_length = payload_length;
+	view->payload = (view->payload_length > 0) ? nfc_data : NULL;
+
+	*nfc_data_len = expected_rec_size;
+
+	return 0;
+}
+
+void nfc_ndef_record_view_desc_get(const struct nfc_ndef_record_view *view,
+				   struct nfc_ndef_bin_payload_desc *bin_pay_desc,
+				   struct nfc_ndef_record_desc *rec_desc)
+{
+	rec_desc->tnf = view->tnf;
+	rec_desc->type_length = view->type_length;
+	rec_desc->type = view->type;
+	rec_desc->id_length = view->id_length;
+	rec_desc->id = view->id;
+
+	bin_pay_desc->payload = view->payload;
+	bin_pay_desc->payload_length = view->payload_length;
 
 	rec_desc->payload_descriptor = bin_pay_desc;
 	rec_desc->payload_constructor  = (payload_constructor_t) nfc_ndef_bin_payload_memcopy;
+}
 
-	*nfc_data_len = expected_rec_size;
+bool nfc_ndef_record_view_type_match(const struct nfc_ndef_record_view *view,
+				     enum nfc_ndef_record_tnf tnf,
+				     const uint8_t *type,
+				     uint8_t type_length)
+{
+	if ((view->tnf != tnf) || (view->type_length != type_length)) {
+		return false;
+	}
+
+	return (type_length == 0) || (memcmp(view->type, type, type_length) == 0);
+}
+
+int nfc_ndef_record_parse(struct nfc_ndef_bin_payload_desc *bin_pay_desc,
+			  struct nfc_ndef_record_desc *rec_desc,
+			  enum nfc_ndef_record_location *record_location,
+			  const uint8_t *nfc_data,
+			  uint32_t *nfc_data_len)
+{
+	struct nfc_ndef_record_view view;
+	int err;
+
+	err = nfc_ndef_record_view_parse(&view, nfc_data, nfc_data_len);
+	if (err) {
+		return err;
+	}
+
+	nfc_ndef_record_view_desc_get(&view, bin_pay_desc, rec_desc);
+	*record_location = view.location;
 
 	return 0;
 }
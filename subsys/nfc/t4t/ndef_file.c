@@ -24,3 +24,39 @@ int nfc_t4t_ndef_file_encode(uint8_t *file_buf, uint32_t *size)
 
 	return 0;
 }
+
+#if defined(CONFIG_NFC_NDEF_MSG)
+int nfc_t4t_ndef_file_record_update(uint8_t *file_buf,
+				    struct nfc_ndef_msg_cache *cache,
+				    uint32_t index,
+				    uint32_t *size)
+{
+	uint16_t nlen;
+	int err;
+
+	if (!file_buf || !cache || !size) {
+		return -EINVAL;
+	}
+
+	if (cache->buffer != nfc_t4t_ndef_file_msg_get(file_buf)) {
+		return -EINVAL;
+	}
+
+	nlen = *(uint16_t *)file_buf;
+	*(uint16_t *)file_buf = 0;
+
+	err = nfc_ndef_msg_cache_record_update(cache, index, size);
+	if (err) {
+		/* Restore the previous message length if the message was not
+		 * modified.
+		 */
+		if (cache->msg) {
+			*(uint16_t *)file_buf = nlen;
+		}
+
+		return err;
+	}
+
+	return nfc_t4t_ndef_file_encode(file_buf, size);
+}
+#endif /* defined(CONFIG_NFC_NDEF_MSG) */
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+
+#define MAX_PARAMS        100
+#define NCELLMEAS_NEIGHBORS 17
+#define BENCH_ITERATIONS  200
+
+static const char *const responses[] = {
+	"+CEREG: 2,\"76C1\",\"0102DA04\", 7\r\n+CME ERROR: 10\r\n",
+	"+CEREG: 5,\"0140\",\"0002D10B\",7,,,\"00000110\",\"11100000\"\r\nOK\r\n",
+	"+CGEQOSRDP: 0,0,,\r\n+CGEQOSRDP: 1,2,,\r\n+CGEQOSRDP: 2,4,,,1,65280000\r\nOK\r\n",
+	"+CMT: \"12345678\", 24\r\n"
+	"06917429000171040A91747966543100009160402143708006C8329BFD0601\r\nOK\r\n",
+	"+CPSMS: 1,,,\"10101111\",\"01101100\"\r\n",
+	"+CFUN: (0,1,4,20,21,30,31,40,41,44),(0,1)\r\nOK\r\n",
+	"+CIND: (1,2,3-5,x,),(\r\n",
+	"+CGEV: ME PDN ACT 0\r\n",
+	"%XICCID: 8901234567012345678F\r\n",
+	"mfw_nrf9160_1.3.4\r\nOK\r\n",
+	"AT+CFUN=1",
+	"AT+CEREG?",
+	"AT%XSYSTEMMODE=?",
+	"AT+CLAC\r\nAT+CFUN\r\nAT%XMONITOR\r\nOK\r\n",
+	"%XMONITOR: 1,\"EDAV\",\"EDAV\",\"26295\",\"00B7\",7,4,\"00011B07\",7,2300,63,39,\"\","
+	"\"11100000\",\"11100000\",\"01001001\"\r\nOK\r\n",
+	"%XT3412: 1200\r\n%XMODEMSLEEP: 1,3600\r\n",
+	"+CSCON: -12345678901234\r\n",
+	"",
+	"\r\n\r\n",
+};
+
+static char ncellmeas[1024];
+
+/* %XMONITOR response with all parameters present. */
+static const char xmonitor[] =
+	"%XMONITOR: 1,\"Operator Name Long\",\"OpName\",\"24412\",\"0C3A\",7,20,\"021D140C\","
+	"449,5300,53,31,\"169.254.0.2 1111:2222:3333:4444:5555:6666:7777:8888\","
+	"\"11100000\",\"11100000\",\"01001001\",\"00100001\"\r\nOK\r\n";
+
+static void ncellmeas_build(void)
+{
+	size_t len;
+
+	len = snprintf(ncellmeas, sizeof(ncellmeas),
+		       "%%NCELLMEAS: 0,\"021D140C\",\"24412\",\"0C3A\",65535,5300,449,50,15,"
+		       "107785");
+
+	for (int i = 0; i < NCELLMEAS_NEIGHBORS; i++) {
+		len += snprintf(&ncellmeas[len], sizeof(ncellmeas) - len, ",%d,%d,%d,%d,%d",
+				5300 + i, 100 + i, 40 + i, 10 + i, 1000 * i);
+	}
+
+	snprintf(&ncellmeas[len], sizeof(ncellmeas) - len, ",107781\r\n");
+}
+
+static struct at_param_list list;
+AT_PARAM_VIEW_LIST_DEFINE(views, MAX_PARAMS);
+
+static void views_list_set(size_t max_params_count)
+{
+	views.param_count = max_params_count;
+}
+
+static void params_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	views_list_set(MAX_PARAMS);
+}
+
+/* Parse with both parsers and verify that they yield the same parameters. */
+static void parse_compare(const char *str, size_t max_params_count)
+{
+	char *next = NULL;
+	char *view_next = NULL;
+	int err;
+	int view_err;
+
+	zassert_ok(at_params_list_init(&list, max_params_count));
+	views_list_set(max_params_count);
+
+	err = at_parser_params_from_str(str, &next, &list);
+	view_err = at_parser_param_views_from_str(str, &view_next, &views);
+
+	zassert_equal(err, view_err, "Error %d, view error %d, %s", err, view_err, str);
+	zassert_equal_ptr(next, view_next, "%s", str);
+	zassert_equal(at_params_valid_count_get(&list), at_param_views_valid_count_get(&views),
+		      "%s", str);
+
+	for (size_t i = 0; i < max_params_count; i++) {
+		enum at_param_type type = at_params_type_get(&list, i);
+		char str_buf[128];
+		char view_str_buf[128];
+		uint32_t array[32];
+		uint32_t view_array[32];
+		size_t len = sizeof(str_buf);
+		size_t view_len = sizeof(view_str_buf);
+		int64_t value;
+		int64_t view_value;
+
+		zassert_equal(type, at_param_views_type_get(&views, i), "Index %d, %s", (int)i, str);
+
+		switch (type) {
+		case AT_PARAM_TYPE_NUM_INT:
+			zassert_ok(at_params_int64_get(&list, i, &value));
+			zassert_ok(at_param_views_int64_get(&views, i, &view_value));
+			zassert_equal(value, view_value, "Index %d, %s", (int)i, str);
+			break;
+		case AT_PARAM_TYPE_STRING:
+			zassert_ok(at_params_string_get(&list, i, str_buf, &len));
+			zassert_ok(at_param_views_string_get(&views, i, view_str_buf, &view_len));
+			zassert_equal(len, view_len, "Index %d, %s", (int)i, str);
+			zassert_mem_equal(str_buf, view_str_buf, len, "Index %d, %s", (int)i, str);
+			break;
+		case AT_PARAM_TYPE_ARRAY:
+			len = sizeof(array);
+			view_len = sizeof(view_array);
+			zassert_ok(at_params_array_get(&list, i, array, &len));
+			zassert_ok(at_param_views_array_get(&views, i, view_array, &view_len));
+			zassert_equal(len, view_len, "Index %d, %s", (int)i, str);
+			zassert_mem_equal(array, view_array, len, "Index %d, %s", (int)i, str);
+			break;
+		default:
+			break;
+		}
+	}
+
+	at_params_list_free(&list);
+}
+
+ZTEST(at_param_views, test_views_invalid)
+{
+	struct at_param_view_list empty = { 0 };
+	int32_t value;
+
+	zassert_equal(at_parser_param_views_from_str(NULL, NULL, &views), -EINVAL);
+	zassert_equal(at_parser_param_views_from_str("+CSCON: 1", NULL, NULL), -EINVAL);
+	zassert_equal(at_parser_param_views_from_str("+CSCON: 1", NULL, &empty), -EINVAL);
+
+	zassert_ok(at_parser_param_views_from_str("+CSCON: 1", NULL, &views));
+	zassert_equal(at_param_views_int_get(&views, 1, NULL), -EINVAL);
+	zassert_equal(at_param_views_int_get(&views, 0, &value), -EINVAL);
+	zassert_equal(at_param_views_int_get(&views, MAX_PARAMS, &value), -EINVAL);
+	zassert_equal(at_param_views_type_get(&views, MAX_PARAMS), AT_PARAM_TYPE_INVALID);
+}
+
+ZTEST(at_param_views, test_views_zero_copy)
+{
+	static const char cereg[] = "+CEREG: 5,\"0140\",\"0002D10B\",7,,,\"00000110\"\r\n";
+	const char *str;
+	char buf[8];
+	size_t len;
+	uint16_t tac;
+	int16_t act;
+
+	zassert_ok(at_parser_param_views_from_str(cereg, NULL, &views));
+	zassert_equal(at_param_views_valid_count_get(&views), 8);
+
+	zassert_ok(at_param_views_string_ptr_get(&views, 0, &str, &len));
+	zassert_equal_ptr(str, cereg);
+	zassert_equal(len, strlen("+CEREG"));
+
+	/* Strings point into the parsed string. */
+	zassert_ok(at_param_views_string_ptr_get(&views, 3, &str, &len));
+	zassert_equal_ptr(str, strstr(cereg, "0002D10B"));
+	zassert_equal(len, strlen("0002D10B"));
+
+	zassert_ok(at_param_views_short_get(&views, 4, &act));
+	zassert_equal(act, 7);
+	zassert_equal(at_param_views_type_get(&views, 5), AT_PARAM_TYPE_EMPTY);
+	zassert_equal(at_param_views_unsigned_short_get(&views, 5, &tac), -EINVAL);
+
+	/* Copy-out needs room for the whole string. */
+	len = 3;
+	zassert_equal(at_param_views_string_get(&views, 2, buf, &len), -ENOMEM);
+	len = sizeof(buf);
+	zassert_ok(at_param_views_string_get(&views, 2, buf, &len));
+	zassert_equal(len, 4);
+	zassert_mem_equal(buf, "0140", len);
+}
+
+ZTEST(at_param_views, test_views_array)
+{
+	static const char cfun[] = "+CFUN: (0,1,4),(0,1)\r\nOK\r\n";
+	uint32_t array[3];
+	size_t len = sizeof(uint32_t) * 2;
+
+	zassert_ok(at_parser_param_views_from_str(cfun, NULL, &views));
+	zassert_equal(at_param_views_type_get(&views, 1), AT_PARAM_TYPE_ARRAY);
+
+	zassert_equal(at_param_views_array_get(&views, 1, array, &len), -ENOMEM);
+	len = sizeof(array);
+	zassert_ok(at_param_views_array_get(&views, 1, array, &len));
+	zassert_equal(len, sizeof(array));
+	zassert_equal(array[0], 0);
+	zassert_equal(array[1], 1);
+	zassert_equal(array[2], 4);
+}
+
+ZTEST(at_param_views, test_views_compare)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(responses); i++) {
+		parse_compare(responses[i], MAX_PARAMS);
+		/* Too small lists. */
+		parse_compare(responses[i], 1);
+		parse_compare(responses[i], 3);
+	}
+
+	ncellmeas_build();
+	parse_compare(ncellmeas, MAX_PARAMS);
+	parse_compare(ncellmeas, 20);
+	parse_compare(xmonitor, MAX_PARAMS);
+}
+
+ZTEST(at_param_views, test_views_multiple_notifications)
+{
+	static const char notifs[] = "%XT3412: 1200\r\n%XMODEMSLEEP: 1,3600\r\n";
+	char *next;
+	int64_t value;
+
+	zassert_equal(at_parser_param_views_from_str(notifs, &next, &views), -EAGAIN);
+	/* The digits of the notification ID are parsed as a separate parameter. */
+	zassert_ok(at_param_views_int64_get(&views, 2, &value));
+	zassert_equal(value, 1200);
+
+	zassert_ok(at_parser_param_views_from_str(next, NULL, &views));
+	zassert_ok(at_param_views_int64_get(&views, 2, &value));
+	zassert_equal(value, 3600);
+}
+
+static uint32_t bench_params(const char *str)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		at_parser_params_from_str(str, NULL, &list);
+	}
+
+	return k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+}
+
+static uint32_t bench_views(const char *str)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		at_parser_param_views_from_str(str, NULL, &views);
+	}
+
+	return k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+}
+
+ZTEST(at_param_views, test_views_benchmark)
+{
+	ncellmeas_build();
+
+	zassert_ok(at_params_list_init(&list, MAX_PARAMS));
+
+	TC_PRINT("%%NCELLMEAS (%u bytes): params %u ns, views %u ns\n",
+		 (uint32_t)strlen(ncellmeas), bench_params(ncellmeas), bench_views(ncellmeas));
+	TC_PRINT("%%XMONITOR (%u bytes): params %u ns, views %u ns\n",
+		 (uint32_t)strlen(xmonitor), bench_params(xmonitor), bench_views(xmonitor));
+
+	at_params_list_free(&list);
+}
+
+ZTEST_SUITE(at_param_views, NULL, NULL, params_before, NULL, NULL);
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <nrf_modem_at.h>
+#include <modem/at_monitor.h>
+
+#define FUZZ_ITERATIONS  2000
+#define FUZZ_NOTIF_LEN   80
+#define BENCH_ITERATIONS 500
+
+/* at_monitor_dispatch() is called by the Modem library in an ISR. */
+extern void at_monitor_dispatch(const char *notif);
+
+struct test_monitor {
+	struct at_monitor_entry *mon;
+	const char *filter;
+	uint32_t calls;
+};
+
+static const char *expected_notif;
+
+static void handler_called(struct test_monitor *tm, const char *notif)
+{
+	if (expected_notif) {
+		zassert_true(strcmp(notif, expected_notif) == 0, "Unexpected notification %s",
+			     notif);
+	}
+	tm->calls++;
+}
+
+#define TEST_MONITOR_DEFINE(type, name, _filter)                                                   \
+	static struct test_monitor name##_test;                                                    \
+	type(name, _filter, name##_handler);                                                       \
+	static void name##_handler(const char *notif)                                              \
+	{                                                                                          \
+		handler_called(&name##_test, notif);                                               \
+	}                                                                                          \
+	static struct test_monitor name##_test = { .mon = &name, .filter = _filter }
+
+/* Filters of the libraries using the AT monitor, and a few overlapping ones. */
+TEST_MONITOR_DEFINE(AT_MONITOR, cereg, "+CEREG");
+TEST_MONITOR_DEFINE(AT_MONITOR, cereg_any_pos, "CEREG");
+TEST_MONITOR_DEFINE(AT_MONITOR, cereg_dup, "+CEREG");
+TEST_MONITOR_DEFINE(AT_MONITOR, cscon, "+CSCON");
+TEST_MONITOR_DEFINE(AT_MONITOR, cedrxp, "+CEDRXP");
+TEST_MONITOR_DEFINE(AT_MONITOR, xt3412, "%XT3412");
+TEST_MONITOR_DEFINE(AT_MONITOR, xtime, "%XTIME");
+TEST_MONITOR_DEFINE(AT_MONITOR, ncellmeas, "%NCELLMEAS");
+TEST_MONITOR_DEFINE(AT_MONITOR, cell, "CELL");
+TEST_MONITOR_DEFINE(AT_MONITOR, xmodemsleep, "%XMODEMSLEEP");
+TEST_MONITOR_DEFINE(AT_MONITOR, mdmev, "%MDMEV");
+TEST_MONITOR_DEFINE(AT_MONITOR, battery_low, "%MDMEV: ME BATTERY LOW");
+TEST_MONITOR_DEFINE(AT_MONITOR, cgev, "+CGEV");
+TEST_MONITOR_DEFINE(AT_MONITOR, cesq, "%CESQ");
+TEST_MONITOR_DEFINE(AT_MONITOR_ISR, cmt, "+CMT");
+TEST_MONITOR_DEFINE(AT_MONITOR_ISR, cds, "+CDS");
+TEST_MONITOR_DEFINE(AT_MONITOR, any, ANY);
+
+static struct test_monitor *const monitors[] = {
+	&cereg_test, &cereg_any_pos_test, &cereg_dup_test, &cscon_test, &cedrxp_test,
+	&xt3412_test, &xtime_test, &ncellmeas_test, &cell_test, &xmodemsleep_test,
+	&mdmev_test, &battery_low_test, &cgev_test, &cesq_test, &cmt_test, &cds_test,
+	&any_test,
+};
+
+static const char *const urcs[] = {
+	"+CEREG: 5,\"0140\",\"0002D10B\",7,,,\"00000110\",\"11100000\"\r\n",
+	"+CSCON: 1\r\n",
+	"%MDMEV: PRACH CE-LEVEL 0\r\n",
+	"%NCELLMEAS: 0,\"0002D10B\",\"24201\",\"0140\",64,6400,263,50,20,1380,"
+	"6400,194,46,15,0,1400,6400,88,38,8,10,1600\r\n",
+	"+CMTI: \"SM\",1\r\n",
+};
+
+int nrf_modem_at_notif_handler_set(nrf_modem_at_notif_handler_t callback)
+{
+	return 0;
+}
+
+static uint32_t lcg_state;
+
+static uint32_t lcg_next(void)
+{
+	lcg_state = lcg_state * 1103515245 + 12345;
+
+	return lcg_state >> 8;
+}
+
+static bool is_expected(const struct test_monitor *tm, const char *notif)
+{
+	if (tm->mon->flags.paused) {
+		return false;
+	}
+
+	return (tm->filter == ANY || strstr(notif, tm->filter));
+}
+
+/* Dispatch a notification and verify that exactly the monitors whose filter is found in the
+ * notification were called.
+ */
+static void dispatch_verify(const char *notif)
+{
+	uint32_t expected[ARRAY_SIZE(monitors)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(monitors); i++) {
+		expected[i] = monitors[i]->calls + is_expected(monitors[i], notif);
+	}
+
+	expected_notif = notif;
+	at_monitor_dispatch(notif);
+	k_sleep(K_MSEC(1));
+
+	for (size_t i = 0; i < ARRAY_SIZE(monitors); i++) {
+		zassert_equal(monitors[i]->calls, expected[i], "Monitor %s, notification %s",
+			      monitors[i]->filter ? monitors[i]->filter : "ANY", notif);
+	}
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (size_t i = 0; i < ARRAY_SIZE(monitors); i++) {
+		at_monitor_resume(monitors[i]->mon);
+	}
+}
+
+ZTEST(at_monitor, test_dispatch)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(urcs); i++) {
+		dispatch_verify(urcs[i]);
+	}
+
+	dispatch_verify("%MDMEV: ME BATTERY LOW\r\n");
+	dispatch_verify("%XT3412: 1000\r\n");
+	dispatch_verify("%XTIME: ,\"32501032450100\",\"01\"\r\n");
+	/* Filter following a partial match of a longer filter. */
+	dispatch_verify("%NCELL\r\n");
+	dispatch_verify("%NCELLMEA%NCELLMEAS\r\n");
+	dispatch_verify("+CEDRXP: 4,\"1000\",\"0101\",\"0011\"\r\n");
+	dispatch_verify("OK\r\n");
+	dispatch_verify("");
+}
+
+ZTEST(at_monitor, test_paused)
+{
+	at_monitor_pause(&cereg);
+	at_monitor_pause(&cmt);
+	at_monitor_pause(&any);
+
+	dispatch_verify(urcs[0]);
+	dispatch_verify("+CMT: \"+4712345678\",22\r\n");
+}
+
+ZTEST(at_monitor, test_resumed_before_workqueue)
+{
+	uint32_t calls = cereg_test.calls;
+
+	/* A monitor resumed before the notification is processed in the workqueue
+	 * receives the notification.
+	 */
+	at_monitor_pause(&cereg);
+
+	k_sched_lock();
+	expected_notif = urcs[0];
+	at_monitor_dispatch(urcs[0]);
+	at_monitor_resume(&cereg);
+	k_sched_unlock();
+
+	k_sleep(K_MSEC(1));
+
+	zassert_equal(cereg_test.calls, calls + 1);
+}
+
+ZTEST(at_monitor, test_fuzz)
+{
+	static const char *const tokens[] = {
+		"+CEREG", "CEREG", "CELL", "%N", "%NCELLMEAS", "%MDMEV", ": ME BATTERY", " LOW",
+		"+CM", "T", "%X", "T3412", "IME", "+C", "DS", "%CE", "SQ", ",", " ", "\"", "0",
+		"\r\n",
+	};
+	static char notif[FUZZ_NOTIF_LEN + 1];
+
+	lcg_state = 0x41544d4f;
+
+	for (uint32_t i = 0; i < FUZZ_ITERATIONS; i++) {
+		size_t len = 0;
+
+		notif[0] = '\0';
+
+		while (true) {
+			const char *token = tokens[lcg_next() % ARRAY_SIZE(tokens)];
+
+			if (len + strlen(token) > FUZZ_NOTIF_LEN || (lcg_next() % 8) == 0) {
+				break;
+			}
+
+			strcpy(&notif[len], token);
+			len += strlen(token);
+		}
+
+		/* Pause some monitors to cover the paused state too. */
+		for (size_t j = 0; j < ARRAY_SIZE(monitors); j++) {
+			monitors[j]->mon->flags.paused = ((lcg_next() % 4) == 0);
+		}
+
+		dispatch_verify(notif);
+	}
+}
+
+ZTEST(at_monitor, test_dispatch_benchmark)
+{
+	uint64_t ns = 0;
+
+	/* Several notifications are queued before the workqueue runs. */
+	expected_notif = NULL;
+
+	for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(urcs); j++) {
+			uint32_t start = k_cycle_get_32();
+
+			at_monitor_dispatch(urcs[j]);
+			ns += k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+		}
+
+		/* Let the workqueue free the heap. */
+		k_sleep(K_MSEC(1));
+	}
+
+	TC_PRINT("Dispatch in ISR: %u ns per notification, %u monitors\n",
+		 (uint32_t)(ns / (BENCH_ITERATIONS * ARRAY_SIZE(urcs))),
+		 (uint32_t)ARRAY_SIZE(monitors));
+}
+
+ZTEST_SUITE(at_monitor, NULL, NULL, test_before, NULL, NULL);
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <nrf_modem_at.h>
+#include <modem/modem_info.h>
+
+#define XMONITOR_REGISTERED \
+	"%XMONITOR: 1,\"Operator\",\"OP\",\"24412\",\"0C3A\",7,20,\"021D140C\"," \
+	"449,5300,53,31,\"\",\"11100000\",\"11100000\",\"01001001\"\r\nOK\r\n"
+#define XMONITOR_NOT_REGISTERED "%XMONITOR: 2\r\nOK\r\n"
+
+/* at_monitor_dispatch() is called by the Modem library in an ISR. */
+extern void at_monitor_dispatch(const char *notif);
+
+static const char *xmonitor_response;
+static uint32_t xmonitor_calls;
+static uint32_t reads[MODEM_INFO_COUNT];
+static struct modem_param_info modem;
+
+int nrf_modem_at_notif_handler_set(nrf_modem_at_notif_handler_t callback)
+{
+	return 0;
+}
+
+int nrf_modem_at_cmd(void *buf, size_t len, const char *fmt, ...)
+{
+	zassert_equal(strcmp(fmt, "AT%%XMONITOR"), 0, "Unexpected command %s", fmt);
+	zassert_true(len > strlen(xmonitor_response));
+
+	strcpy(buf, xmonitor_response);
+	xmonitor_calls++;
+
+	return 0;
+}
+
+enum at_param_type modem_info_type_get(enum modem_info info)
+{
+	switch (info) {
+	case MODEM_INFO_UE_MODE:
+	case MODEM_INFO_LTE_MODE:
+	case MODEM_INFO_NBIOT_MODE:
+	case MODEM_INFO_GPS_MODE:
+	case MODEM_INFO_BATTERY:
+		return AT_PARAM_TYPE_NUM_INT;
+	default:
+		return AT_PARAM_TYPE_STRING;
+	}
+}
+
+int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size)
+{
+	reads[info]++;
+
+	/* Values change with every read. */
+	return snprintf(buf, buf_size, "%d-%u", info, reads[info]);
+}
+
+int modem_info_short_get(enum modem_info info, uint16_t *buf)
+{
+	reads[info]++;
+	*buf = reads[info];
+
+	return sizeof(uint16_t);
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	modem_info_params_cache_invalidate();
+	memset(reads, 0, sizeof(reads));
+	xmonitor_calls = 0;
+	xmonitor_response = XMONITOR_REGISTERED;
+
+	modem_info_params_init(&modem);
+}
+
+static void notif_dispatch(const char *notif)
+{
+	at_monitor_dispatch(notif);
+	/* Let the workqueue run the monitor handlers. */
+	k_sleep(K_MSEC(1));
+}
+
+ZTEST(modem_info_cache, test_xmonitor)
+{
+	zassert_ok(modem_info_params_get(&modem));
+	zassert_equal(xmonitor_calls, 1);
+
+	zassert_equal(strcmp(modem.network.current_operator.value_string, "24412"), 0);
+	zassert_equal(strcmp(modem.network.area_code.value_string, "0C3A"), 0);
+	zassert_equal(strcmp(modem.network.cellid_hex.value_string, "021D140C"), 0);
+	zassert_equal(modem.network.current_band.value, 20);
+	zassert_equal(modem.network.rsrp.value, 53);
+	zassert_equal(modem.network.area_code.value, 0x0C3A);
+	zassert_equal(modem.network.mcc.value, 244);
+	zassert_equal(modem.network.mnc.value, 12);
+	zassert_equal(modem.network.cellid_dec, 0x021D140C);
+
+	/* Parameters read with %XMONITOR are not read separately. */
+	zassert_equal(reads[MODEM_INFO_OPERATOR], 0);
+	zassert_equal(reads[MODEM_INFO_AREA_CODE], 0);
+	zassert_equal(reads[MODEM_INFO_CELLID], 0);
+	zassert_equal(reads[MODEM_INFO_CUR_BAND], 0);
+	zassert_equal(reads[MODEM_INFO_RSRP], 0);
+}
+
+ZTEST(modem_info_cache, test_not_registered)
+{
+	xmonitor_response = XMONITOR_NOT_REGISTERED;
+
+	zassert_not_equal(modem_info_params_get(&modem), 0);
+}
+
+ZTEST(modem_info_cache, test_cached)
+{
+	zassert_ok(modem_info_params_get(&modem));
+	zassert_ok(modem_info_params_get(&modem));
+	zassert_ok(modem_info_params_get(&modem));
+
+	/* Cached parameters are read once. */
+	zassert_equal(reads[MODEM_INFO_IMEI], 1);
+	zassert_equal(reads[MODEM_INFO_ICCID], 1);
+	zassert_equal(reads[MODEM_INFO_IMSI], 1);
+	zassert_equal(reads[MODEM_INFO_FW_VERSION], 1);
+	zassert_equal(reads[MODEM_INFO_SUP_BAND], 1);
+	zassert_equal(reads[MODEM_INFO_IP_ADDRESS], 1);
+	zassert_equal(reads[MODEM_INFO_APN], 1);
+	zassert_equal(reads[MODEM_INFO_UE_MODE], 1);
+	zassert_equal(reads[MODEM_INFO_LTE_MODE], 1);
+
+	/* The cached values are returned. */
+	zassert_equal(strcmp(modem.device.imei.value_string, "19-1"), 0);
+	zassert_equal(strcmp(modem.network.ip_address.value_string, "9-1"), 0);
+	zassert_equal(modem.network.ue_mode.value, 1);
+
+	/* Volatile parameters are read every time. */
+	zassert_equal(reads[MODEM_INFO_BATTERY], 3);
+	zassert_equal(xmonitor_calls, 3);
+}
+
+ZTEST(modem_info_cache, test_network_notifications)
+{
+	static const char *const notifs[] = {
+		"+CEREG: 1,\"0C3A\",\"021D140C\",7\r\n",
+		"%XMODEMSLEEP: 1,3600000\r\n",
+		"+CGEV: ME PDN ACT 0\r\n",
+	};
+
+	zassert_ok(modem_info_params_get(&modem));
+
+	for (size_t i = 0; i < ARRAY_SIZE(notifs); i++) {
+		notif_dispatch(notifs[i]);
+
+		zassert_ok(modem_info_params_get(&modem));
+		zassert_equal(reads[MODEM_INFO_IP_ADDRESS], i + 2, "%s", notifs[i]);
+		zassert_equal(reads[MODEM_INFO_APN], i + 2, "%s", notifs[i]);
+		zassert_equal(reads[MODEM_INFO_GPS_MODE], i + 2, "%s", notifs[i]);
+	}
+
+	zassert_equal(strcmp(modem.network.ip_address.value_string, "9-4"), 0);
+
+	/* Other notifications do not invalidate the cache. */
+	notif_dispatch("+CSCON: 1\r\n");
+	zassert_ok(modem_info_params_get(&modem));
+	zassert_equal(reads[MODEM_INFO_IP_ADDRESS], 4);
+
+	/* Identity parameters are not invalidated by network notifications. */
+	zassert_equal(reads[MODEM_INFO_IMEI], 1);
+	zassert_equal(reads[MODEM_INFO_ICCID], 1);
+}
+
+ZTEST(modem_info_cache, test_invalidate)
+{
+	zassert_ok(modem_info_params_get(&modem));
+
+	modem_info_params_cache_invalidate();
+
+	zassert_ok(modem_info_params_get(&modem));
+	zassert_equal(reads[MODEM_INFO_IMEI], 2);
+	zassert_equal(reads[MODEM_INFO_IP_ADDRESS], 2);
+	zassert_equal(strcmp(modem.sim.iccid.value_string, "14-2"), 0);
+}
+
+ZTEST(modem_info_cache, test_stats)
+{
+	struct modem_info_cache_stats before;
+	struct modem_info_cache_stats after;
+	uint32_t misses;
+
+	modem_info_params_cache_stats_get(&before);
+	zassert_ok(modem_info_params_get(&modem));
+	modem_info_params_cache_stats_get(&after);
+
+	/* All parameters are read from the modem. */
+	zassert_equal(after.hits, before.hits);
+	misses = after.misses - before.misses;
+	zassert_true(misses > 0);
+
+	before = after;
+	zassert_ok(modem_info_params_get(&modem));
+	modem_info_params_cache_stats_get(&after);
+
+	/* Only the 11 cached parameters are read from the cache. */
+	zassert_equal(after.hits - before.hits, 11);
+	zassert_equal(after.misses - before.misses, misses - 11);
+
+	TC_PRINT("Parameters read from the modem: %u without cache, %u with cache\n",
+		 misses, after.misses - before.misses);
+}
+
+ZTEST_SUITE(modem_info_cache, NULL, NULL, test_before, NULL, NULL);
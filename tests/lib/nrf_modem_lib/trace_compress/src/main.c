@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <nrf_modem_trace.h>
+
+#include "nrf_modem_lib_trace_compress.h"
+
+#define BLOCK_SIZE CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_BLOCK_SIZE
+#define WRITE_ALIGN CONFIG_NRF_MODEM_LIB_TRACE_COMPRESSION_WRITE_ALIGN
+
+#define TRACE_LEN (16 * 1024)
+#define BENCH_ITERATIONS 20
+
+static uint8_t trace[TRACE_LEN];
+static uint8_t backend[2 * TRACE_LEN];
+static size_t backend_len;
+static uint8_t decoded[TRACE_LEN];
+
+static size_t processed;
+static uint32_t backend_writes;
+static size_t backend_max_write;
+static int backend_err;
+
+static uint32_t lcg_state;
+
+static uint32_t lcg_next(void)
+{
+	lcg_state = lcg_state * 1103515245 + 12345;
+
+	return lcg_state >> 8;
+}
+
+int nrf_modem_trace_processed(size_t len)
+{
+	processed += len;
+
+	return 0;
+}
+
+static int backend_write(const void *data, size_t len)
+{
+	if (backend_err) {
+		return backend_err;
+	}
+
+	/* Start of each write is aligned in the backend. */
+	zassert_equal(backend_len % WRITE_ALIGN, 0);
+
+	len = MIN(len, backend_max_write);
+	zassert_true(backend_len + len <= sizeof(backend));
+
+	memcpy(&backend[backend_len], data, len);
+	backend_len += len;
+	backend_writes++;
+
+	return len;
+}
+
+/* Trace-like data: short packets with a header, a counter and a mostly repeated payload. */
+static void trace_generate(void)
+{
+	static const char *const payloads[] = {
+		"LTE RRC ConnectionReconfiguration", "NAS EMM Attach accept",
+		"PDCP DL data", "MAC UL grant", "PHY PDSCH stat",
+	};
+	size_t len = 0;
+	uint32_t seq = 0;
+
+	lcg_state = 0x54524143;
+
+	while (len < sizeof(trace)) {
+		const char *payload = payloads[lcg_next() % ARRAY_SIZE(payloads)];
+		uint8_t pkt[64] = { 0xEF, 0xBE, 0x0D, 0xF0 };
+		size_t pkt_len = 4;
+
+		sys_put_le32(seq++, &pkt[pkt_len]);
+		pkt_len += 4;
+		sys_put_le16(lcg_next() & 0x3FF, &pkt[pkt_len]);
+		pkt_len += 2;
+		memcpy(&pkt[pkt_len], payload, strlen(payload));
+		pkt_len += strlen(payload);
+
+		pkt_len = MIN(pkt_len, sizeof(trace) - len);
+		memcpy(&trace[len], pkt, pkt_len);
+		len += pkt_len;
+	}
+}
+
+static void random_generate(void)
+{
+	lcg_state = 0x524e44;
+
+	for (size_t i = 0; i < sizeof(trace); i++) {
+		trace[i] = lcg_next();
+	}
+}
+
+static size_t lz_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap)
+{
+	const uint8_t *const iend = src + src_len;
+	size_t len = 0;
+
+	while (src < iend) {
+		uint8_t token = *src++;
+		size_t lit_len = token >> 4;
+		size_t match_len = token & 0x0F;
+		uint16_t offset;
+
+		if (lit_len == 15) {
+			do {
+				lit_len += *src;
+			} while (*src++ == 255);
+		}
+
+		zassert_true(len + lit_len <= dst_cap);
+		memcpy(&dst[len], src, lit_len);
+		len += lit_len;
+		src += lit_len;
+
+		if (src == iend) {
+			break;
+		}
+
+		offset = sys_get_le16(src);
+		src += 2;
+		zassert_true(offset > 0 && offset <= len, "Invalid offset %u", offset);
+
+		if (match_len == 15) {
+			do {
+				match_len += *src;
+			} while (*src++ == 255);
+		}
+
+		match_len += 4;
+		zassert_true(len + match_len <= dst_cap);
+
+		for (size_t i = 0; i < match_len; i++, len++) {
+			dst[len] = dst[len - offset];
+		}
+	}
+
+	return len;
+}
+
+/* Decode the blocks written to the backend. */
+static size_t backend_decode(uint32_t *blocks, uint32_t *stored)
+{
+	size_t pos = 0;
+	size_t len = 0;
+
+	*blocks = 0;
+	*stored = 0;
+
+	while (pos < backend_len) {
+		const uint8_t *hdr = &backend[pos];
+		uint16_t raw_len = sys_get_le16(&hdr[4]);
+		uint16_t data_len = sys_get_le16(&hdr[6]);
+
+		zassert_equal(hdr[0], TRACE_COMPRESS_MAGIC_0);
+		zassert_equal(hdr[1], TRACE_COMPRESS_MAGIC_1);
+		zassert_equal(1 << (hdr[2] >> TRACE_COMPRESS_FLAG_ALIGN_POS), WRITE_ALIGN);
+		zassert_true(raw_len <= BLOCK_SIZE);
+
+		if (hdr[2] & TRACE_COMPRESS_FLAG_STORED) {
+			zassert_equal(raw_len, data_len);
+			memcpy(&decoded[len], &hdr[TRACE_COMPRESS_HDR_SIZE], raw_len);
+			(*stored)++;
+		} else {
+			zassert_true(data_len < raw_len);
+			zassert_equal(lz_decompress(&hdr[TRACE_COMPRESS_HDR_SIZE], data_len,
+						    &decoded[len], sizeof(decoded) - len),
+				      raw_len);
+		}
+
+		len += raw_len;
+		pos += ROUND_UP(TRACE_COMPRESS_HDR_SIZE + data_len, WRITE_ALIGN);
+		(*blocks)++;
+	}
+
+	zassert_equal(pos, backend_len);
+
+	return len;
+}
+
+/* Pass the trace data in fragments of varying size, like the modem does. */
+static void trace_write(size_t max_frag_len)
+{
+	size_t pos = 0;
+
+	while (pos < sizeof(trace)) {
+		size_t frag_len = lcg_next() % max_frag_len + 1;
+		size_t offset = 0;
+
+		frag_len = MIN(frag_len, sizeof(trace) - pos);
+
+		while (offset < frag_len) {
+			int ret = trace_compress_write(&trace[pos + offset], frag_len - offset);
+
+			zassert_true(ret > 0, "Write failed, err %d", ret);
+			offset += ret;
+		}
+
+		pos += frag_len;
+	}
+
+	zassert_ok(trace_compress_flush());
+	zassert_false(trace_compress_pending());
+}
+
+static void roundtrip_verify(void)
+{
+	uint32_t blocks;
+	uint32_t stored;
+
+	zassert_equal(backend_decode(&blocks, &stored), sizeof(trace));
+	zassert_mem_equal(decoded, trace, sizeof(trace));
+	zassert_equal(blocks, DIV_ROUND_UP(sizeof(trace), BLOCK_SIZE));
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	trace_compress_init(backend_write);
+
+	backend_len = 0;
+	backend_writes = 0;
+	backend_max_write = SIZE_MAX;
+	backend_err = 0;
+	processed = 0;
+}
+
+ZTEST(trace_compress, test_roundtrip)
+{
+	uint32_t in;
+	uint32_t out;
+
+	trace_generate();
+	trace_write(2048);
+
+	roundtrip_verify();
+
+	/* Fragments are batched into one write per block. */
+	zassert_equal(backend_writes, DIV_ROUND_UP(sizeof(trace), BLOCK_SIZE));
+	zassert_true(backend_len < sizeof(trace) / 2, "Compressed to %u bytes", backend_len);
+
+	trace_compress_bytes_get(&in, &out);
+	zassert_true(in >= sizeof(trace));
+	zassert_true(out >= backend_len);
+}
+
+ZTEST(trace_compress, test_processed)
+{
+	trace_generate();
+	trace_write(64);
+
+	/* Everything buffered is reported as processed to the Modem library. */
+	zassert_equal(processed, sizeof(trace));
+	roundtrip_verify();
+}
+
+ZTEST(trace_compress, test_incompressible)
+{
+	uint32_t blocks;
+	uint32_t stored;
+
+	random_generate();
+	trace_write(512);
+
+	zassert_equal(backend_decode(&blocks, &stored), sizeof(trace));
+	zassert_mem_equal(decoded, trace, sizeof(trace));
+
+	/* Data which does not compress is stored with the block header only. */
+	zassert_equal(stored, blocks);
+	zassert_equal(backend_len,
+		      blocks * ROUND_UP(TRACE_COMPRESS_HDR_SIZE + BLOCK_SIZE, WRITE_ALIGN));
+}
+
+ZTEST(trace_compress, test_partial_writes)
+{
+	trace_generate();
+
+	/* The backend accepts only part of each block at a time. */
+	backend_max_write = WRITE_ALIGN * 3;
+	trace_write(300);
+
+	roundtrip_verify();
+}
+
+ZTEST(trace_compress, test_enospc)
+{
+	static const uint8_t data[BLOCK_SIZE] = { 1, 2, 3 };
+	uint32_t blocks;
+	uint32_t stored;
+
+	zassert_equal(trace_compress_write(data, sizeof(data)), sizeof(data));
+	zassert_true(trace_compress_pending());
+	zassert_equal(backend_writes, 0);
+
+	/* The block is full and the backend is full. The new data is not taken. */
+	backend_err = -ENOSPC;
+	zassert_equal(trace_compress_write(data, sizeof(data)), -ENOSPC);
+	zassert_equal(trace_compress_write(data, sizeof(data)), -ENOSPC);
+	zassert_equal(processed, sizeof(data));
+
+	/* Once the backend has space, the block is written and the data taken. */
+	backend_err = 0;
+	zassert_equal(trace_compress_write(data, sizeof(data)), sizeof(data));
+	zassert_equal(backend_writes, 1);
+	zassert_ok(trace_compress_flush());
+
+	zassert_equal(backend_decode(&blocks, &stored), 2 * sizeof(data));
+	zassert_equal(blocks, 2);
+	zassert_mem_equal(decoded, data, sizeof(data));
+	zassert_mem_equal(&decoded[sizeof(data)], data, sizeof(data));
+}
+
+ZTEST(trace_compress, test_flush_empty)
+{
+	zassert_false(trace_compress_pending());
+	zassert_ok(trace_compress_flush());
+	zassert_equal(backend_writes, 0);
+
+	/* Short blocks are stored. */
+	zassert_equal(trace_compress_write("trace", 5), 5);
+	zassert_ok(trace_compress_flush());
+	zassert_equal(backend_len, ROUND_UP(TRACE_COMPRESS_HDR_SIZE + 5, WRITE_ALIGN));
+	zassert_true(backend[2] & TRACE_COMPRESS_FLAG_STORED);
+}
+
+ZTEST(trace_compress, test_benchmark)
+{
+	uint32_t start;
+	uint32_t ns;
+
+	trace_generate();
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		backend_len = 0;
+		trace_write(1024);
+	}
+
+	ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+
+	roundtrip_verify();
+
+	TC_PRINT("Compressed %u bytes to %u bytes (%u%%) in %u us\n", (uint32_t)sizeof(trace),
+		 (uint32_t)backend_len, (uint32_t)(backend_len * 100 / sizeof(trace)), ns / 1000);
+}
+
+ZTEST_SUITE(trace_compress, NULL, NULL, test_before, NULL, NULL);
@@ -12,22 +12,36 @@
 #include <zephyr/sys/util.h>
 
 
-/* Settings of the discover mock */
+/* Simulated attribute table */
+static const struct bt_gatt_attr *discover_mock_attr;
+static size_t discover_mock_len;
+/* Number of bt_gatt_discover calls since the setup */
+static size_t discover_mock_calls;
+
+/* Settings of the discover mock, one per simultaneous discovery */
 static struct bt_discover_mock {
-	const struct bt_gatt_attr *attr;
-	size_t len;
 	struct bt_conn *conn;
 	struct bt_gatt_discover_params *params;
 	struct k_work_delayable work;
-} discover_mock_data;
+} discover_mock_data[CONFIG_BT_GATT_DM_MAX_INSTANCES];
 
 static void bt_gatt_discover_work(struct k_work *work);
 
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len)
 {
-	k_work_init_delayable(&discover_mock_data.work, bt_gatt_discover_work);
-	discover_mock_data.attr = attr;
-	discover_mock_data.len  = len;
+	for (size_t i = 0; i < ARRAY_SIZE(discover_mock_data); i++) {
+		k_work_init_delayable(&discover_mock_data[i].work,
+				      bt_gatt_discover_work);
+		discover_mock_data[i].params = NULL;
+	}
+	discover_mock_attr = attr;
+	discover_mock_len  = len;
+	discover_mock_calls = 0;
+}
+
+size_t bt_gatt_discover_mock_calls(void)
+{
+	return discover_mock_calls;
 }
 
 static bool bt_gatt_primary_check(const struct bt_gatt_attr *attr_cur,
@@ -49,7 +63,7 @@ static void bt_gatt_discover_work(struct k_work *work)
 	struct bt_discover_mock *mock_data =
 		CONTAINER_OF(dwork, struct bt_discover_mock, work);
 	const struct bt_gatt_attr *const attr_end =
-		discover_mock_data.attr + discover_mock_data.len;
+		discover_mock_attr + discover_mock_len;
 	const struct bt_gatt_attr *attr_cur;
 
 	printk("Running simulated discovery:"
@@ -58,10 +72,10 @@ static void bt_gatt_discover_work(struct k_work *work)
 	       mock_data->params->start_handle,
 	       mock_data->params->end_handle);
 
-	zassert_true(mock_data->params->start_handle <= discover_mock_data.len,
+	zassert_true(mock_data->params->start_handle <= discover_mock_len,
 		"Unexpected start handle: %u", mock_data->params->start_handle);
 
-	for (attr_cur = discover_mock_data.attr;
+	for (attr_cur = discover_mock_attr;
 	     attr_cur < attr_end;
 	     ++attr_cur) {
 		if (attr_cur->handle > mock_data->params->end_handle) {
@@ -125,10 +139,27 @@ static void bt_gatt_discover_work(struct k_work *work)
 int bt_gatt_discover(struct bt_conn *conn,
 		     struct bt_gatt_discover_params *params)
 {
+	struct bt_discover_mock *mock_data = NULL;
+
 	printk("Running %s mock\n", __func__);
-	discover_mock_data.conn = conn;
-	discover_mock_data.params = params;
 
-	k_work_schedule(&discover_mock_data.work, K_MSEC(5));
+	/* Reuse the slot of an ongoing discovery, or take a free one */
+	for (size_t i = 0; i < ARRAY_SIZE(discover_mock_data); i++) {
+		if (discover_mock_data[i].params == params) {
+			mock_data = &discover_mock_data[i];
+			break;
+		}
+		if (!mock_data && !discover_mock_data[i].params) {
+			mock_data = &discover_mock_data[i];
+		}
+	}
+
+	zassert_not_null(mock_data, "Too many simultaneous discoveries");
+
+	mock_data->conn = conn;
+	mock_data->params = params;
+	discover_mock_calls++;
+
+	k_work_schedule(&mock_data->work, K_MSEC(5));
 	return 0;
 }
@@ -18,7 +18,8 @@
 #define BT_UUID_EMPTY_CHR BT_UUID_DECLARE_16(0x1235)
 
 static char dummy_conn;
-K_SEM_DEFINE(discovery_finished, 0, 1);
+static char dummy_conn_2;
+K_SEM_DEFINE(discovery_finished, 0, 2);
 
 
 const struct bt_gatt_attr discover_sim[] = {
@@ -476,3 +477,44 @@ ZTEST(gatt_tests, test_gatt_many_serv_by_uuid)
 	zassert_equal(0, bt_gatt_dm_attr_cnt(dm), "Parameter count after clearing: %d",
 		      bt_gatt_dm_attr_cnt(dm));
 }
+
+ZTEST(gatt_tests, test_gatt_concurrent_discovery)
+{
+	struct bt_gatt_dm *dm[2];
+	int err;
+
+	BUILD_ASSERT(CONFIG_BT_GATT_DM_MAX_INSTANCES >= 2);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_HIDS,
+			       &test_hids_cb, &dm[0]);
+	zassert_ok(err, "bt_gatt_dm_start finished with error: %d", err);
+
+	/* Only one discovery per connection */
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_DIS,
+			       &test_hids_cb, &dm[1]);
+	zassert_equal(err, -EALREADY, "Unexpected result: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn_2, BT_UUID_DIS,
+			       &test_hids_cb, &dm[1]);
+	zassert_ok(err, "bt_gatt_dm_start finished with error: %d", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(dm); i++) {
+		err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+		zassert_ok(err, "It seems that no callback function was called: %d", err);
+	}
+
+	zassert_not_null(dm[0], "HIDS not found");
+	zassert_not_null(dm[1], "DIS not found");
+	zassert_not_equal(dm[0], dm[1], "Same instance used twice");
+	zassert_equal_ptr(bt_gatt_dm_conn_get(dm[0]), &dummy_conn, "Wrong connection");
+	zassert_equal_ptr(bt_gatt_dm_conn_get(dm[1]), &dummy_conn_2, "Wrong connection");
+	zassert_true(bt_uuid_cmp(bt_gatt_dm_attr_service_val(
+			bt_gatt_dm_service_get(dm[0]))->uuid, BT_UUID_HIDS) == 0,
+		     "Wrong service");
+	zassert_true(bt_uuid_cmp(bt_gatt_dm_attr_service_val(
+			bt_gatt_dm_service_get(dm[1]))->uuid, BT_UUID_DIS) == 0,
+		     "Wrong service");
+
+	zassert_ok(bt_gatt_dm_data_release(dm[0]));
+	zassert_ok(bt_gatt_dm_data_release(dm[1]));
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <zephyr/settings/settings.h>
+
+#include "bt_mock.h"
+
+#define DB_HASH_LEN 16
+#define SETTINGS_KEY_LEN 80
+#define SETTINGS_VALUE_LEN 256
+#define SETTINGS_ENTRIES 4
+
+static const bt_addr_le_t peer_addr = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 },
+};
+
+static bool peer_bonded;
+static uint8_t peer_db_hash[DB_HASH_LEN];
+static size_t db_hash_reads;
+static struct bt_conn_auth_info_cb *auth_info_cb;
+
+static struct {
+	struct bt_conn *conn;
+	struct bt_gatt_read_params *params;
+	struct k_work_delayable work;
+} read_mock;
+
+static struct settings_entry {
+	bool used;
+	char key[SETTINGS_KEY_LEN];
+	uint8_t value[SETTINGS_VALUE_LEN];
+	size_t len;
+} settings_entries[SETTINGS_ENTRIES];
+static size_t settings_saves;
+/* The storage must not be modified from the load callback. */
+static bool settings_loading;
+
+static void db_hash_read_work(struct k_work *work)
+{
+	(void)read_mock.params->func(read_mock.conn, 0, read_mock.params,
+				     peer_db_hash, sizeof(peer_db_hash));
+}
+
+void bt_mock_reset(bool bonded, uint8_t db_hash_seed)
+{
+	peer_bonded = bonded;
+	bt_mock_db_hash_set(db_hash_seed);
+	db_hash_reads = 0;
+
+	k_work_init_delayable(&read_mock.work, db_hash_read_work);
+
+	memset(settings_entries, 0, sizeof(settings_entries));
+	settings_saves = 0;
+}
+
+void bt_mock_db_hash_set(uint8_t db_hash_seed)
+{
+	memset(peer_db_hash, db_hash_seed, sizeof(peer_db_hash));
+}
+
+size_t bt_mock_db_hash_reads(void)
+{
+	return db_hash_reads;
+}
+
+size_t bt_mock_settings_saves(void)
+{
+	return settings_saves;
+}
+
+size_t bt_mock_settings_count(void)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(settings_entries); i++) {
+		count += settings_entries[i].used ? 1 : 0;
+	}
+
+	return count;
+}
+
+void bt_mock_bond_delete(void)
+{
+	zassert_not_null(auth_info_cb, "Authentication info callbacks not registered");
+
+	peer_bonded = false;
+	auth_info_cb->bond_deleted(BT_ID_DEFAULT, &peer_addr);
+}
+
+/* Bluetooth host mocks */
+
+int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->type = BT_CONN_TYPE_LE;
+	info->id = BT_ID_DEFAULT;
+	info->le.dst = &peer_addr;
+
+	return 0;
+}
+
+const bt_addr_le_t *bt_conn_get_dst(const struct bt_conn *conn)
+{
+	return &peer_addr;
+}
+
+bool bt_addr_le_is_bonded(uint8_t id, const bt_addr_le_t *addr)
+{
+	return peer_bonded && !bt_addr_le_cmp(addr, &peer_addr);
+}
+
+int bt_conn_auth_info_cb_register(struct bt_conn_auth_info_cb *cb)
+{
+	auth_info_cb = cb;
+
+	return 0;
+}
+
+int bt_gatt_read(struct bt_conn *conn, struct bt_gatt_read_params *params)
+{
+	zassert_equal(params->handle_count, 0, "Read by UUID expected");
+	zassert_ok(bt_uuid_cmp(params->by_uuid.uuid, BT_UUID_GATT_DB_HASH),
+		   "Unexpected characteristic read");
+
+	db_hash_reads++;
+	read_mock.conn = conn;
+	read_mock.params = params;
+
+	k_work_schedule(&read_mock.work, K_MSEC(5));
+
+	return 0;
+}
+
+int bt_uuid_cmp(const struct bt_uuid *u1, const struct bt_uuid *u2)
+{
+	if (u1->type != u2->type) {
+		return (int)u1->type - (int)u2->type;
+	}
+
+	switch (u1->type) {
+	case BT_UUID_TYPE_16:
+		return (int)BT_UUID_16(u1)->val - (int)BT_UUID_16(u2)->val;
+	case BT_UUID_TYPE_32:
+		return BT_UUID_32(u1)->val == BT_UUID_32(u2)->val ? 0 : 1;
+	case BT_UUID_TYPE_128:
+		return memcmp(BT_UUID_128(u1)->val, BT_UUID_128(u2)->val, BT_UUID_SIZE_128);
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Settings mocks, backed by a RAM array */
+
+static struct settings_entry *settings_entry_find(const char *key)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(settings_entries); i++) {
+		if (settings_entries[i].used && !strcmp(settings_entries[i].key, key)) {
+			return &settings_entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+int settings_save_one(const char *name, const void *value, size_t val_len)
+{
+	struct settings_entry *entry = settings_entry_find(name);
+
+	zassert_false(settings_loading, "Settings saved from the load callback");
+	zassert_true(strlen(name) < SETTINGS_KEY_LEN, "Key too long: %s", name);
+	zassert_true(val_len <= SETTINGS_VALUE_LEN, "Value too long: %zu", val_len);
+
+	for (size_t i = 0; !entry && i < ARRAY_SIZE(settings_entries); i++) {
+		if (!settings_entries[i].used) {
+			entry = &settings_entries[i];
+		}
+	}
+
+	zassert_not_null(entry, "Settings storage full");
+
+	entry->used = true;
+	strcpy(entry->key, name);
+	memcpy(entry->value, value, val_len);
+	entry->len = val_len;
+
+	settings_saves++;
+
+	return 0;
+}
+
+int settings_delete(const char *name)
+{
+	struct settings_entry *entry = settings_entry_find(name);
+
+	zassert_false(settings_loading, "Settings deleted from the load callback");
+
+	if (entry) {
+		entry->used = false;
+	}
+
+	return 0;
+}
+
+static ssize_t settings_entry_read(void *cb_arg, void *data, size_t len)
+{
+	struct settings_entry *entry = cb_arg;
+
+	len = MIN(len, entry->len);
+	memcpy(data, entry->value, len);
+
+	return len;
+}
+
+int settings_load_subtree_direct(const char *subtree, settings_load_direct_cb cb, void *param)
+{
+	size_t subtree_len = strlen(subtree);
+
+	settings_loading = true;
+
+	for (size_t i = 0; i < ARRAY_SIZE(settings_entries); i++) {
+		struct settings_entry *entry = &settings_entries[i];
+		const char *name;
+
+		if (!entry->used || strncmp(entry->key, subtree, subtree_len)) {
+			continue;
+		}
+
+		if (entry->key[subtree_len] == '\0') {
+			name = NULL;
+		} else if (entry->key[subtree_len] == '/') {
+			name = &entry->key[subtree_len + 1];
+		} else {
+			continue;
+		}
+
+		(void)cb(name, entry->len, settings_entry_read, entry, param);
+	}
+
+	settings_loading = false;
+
+	return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_MOCK_H_
+#define BT_MOCK_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Reset the peer and the settings storage.
+ *
+ * @param bonded Whether the peer is bonded.
+ * @param db_hash_seed Value the Database Hash of the peer is filled with.
+ */
+void bt_mock_reset(bool bonded, uint8_t db_hash_seed);
+
+/** @brief Change the Database Hash of the peer, as after a service change. */
+void bt_mock_db_hash_set(uint8_t db_hash_seed);
+
+/** @brief Get the number of Database Hash reads. */
+size_t bt_mock_db_hash_reads(void);
+
+/** @brief Get the number of settings entries saved. */
+size_t bt_mock_settings_saves(void);
+
+/** @brief Get the number of settings entries in the storage. */
+size_t bt_mock_settings_count(void);
+
+/** @brief Report the removal of the bond with the peer. */
+void bt_mock_bond_delete(void);
+
+#endif /* BT_MOCK_H_ */
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/gatt_dm.h>
+
+#include "gatt_discover_mock.h"
+#include "bt_mock.h"
+
+/* Timeout for the discovery in ms */
+#define SERVICE_DISCOVERY_TIMEOUT 2000
+
+#define DB_HASH_SEED 0x5a
+
+static char dummy_conn;
+static K_SEM_DEFINE(discovery_finished, 0, 1);
+/* Set while bt_gatt_dm_start() runs, the callbacks must not be called from it. */
+static bool dm_start_running;
+
+static const struct bt_gatt_attr discover_sim[] = {
+	/* HIDS, too large for the cache */
+	BT_GATT_DISCOVER_MOCK_SERV(1, BT_UUID_HIDS, 11),
+	BT_GATT_DISCOVER_MOCK_CHRC(2, BT_UUID_HIDS_INFO, BT_GATT_CHRC_READ),
+	BT_GATT_DISCOVER_MOCK_DESC(3, BT_UUID_HIDS_INFO),
+
+	BT_GATT_DISCOVER_MOCK_CHRC(4, BT_UUID_HIDS_REPORT_MAP, BT_GATT_CHRC_READ),
+	BT_GATT_DISCOVER_MOCK_DESC(5, BT_UUID_HIDS_REPORT_MAP),
+
+	BT_GATT_DISCOVER_MOCK_CHRC(6, BT_UUID_HIDS_REPORT, BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY),
+	BT_GATT_DISCOVER_MOCK_DESC(7, BT_UUID_HIDS_REPORT),
+	BT_GATT_DISCOVER_MOCK_DESC(8, BT_UUID_GATT_CCC),
+	BT_GATT_DISCOVER_MOCK_DESC(9, BT_UUID_HIDS_REPORT_REF),
+
+	BT_GATT_DISCOVER_MOCK_CHRC(10, BT_UUID_HIDS_CTRL_POINT, BT_GATT_CHRC_WRITE_WITHOUT_RESP),
+	BT_GATT_DISCOVER_MOCK_DESC(11, BT_UUID_HIDS_CTRL_POINT),
+
+	/* DIS */
+	BT_GATT_DISCOVER_MOCK_SERV(12, BT_UUID_DIS, 16),
+	BT_GATT_DISCOVER_MOCK_CHRC(13, BT_UUID_DIS_MODEL_NUMBER, BT_GATT_CHRC_READ),
+	BT_GATT_DISCOVER_MOCK_DESC(14, BT_UUID_DIS_MODEL_NUMBER),
+
+	BT_GATT_DISCOVER_MOCK_CHRC(15, BT_UUID_DIS_MANUFACTURER_NAME,
+				   BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY),
+	BT_GATT_DISCOVER_MOCK_DESC(16, BT_UUID_DIS_MANUFACTURER_NAME),
+};
+
+static void test_cb_completed(struct bt_gatt_dm *dm, void *context)
+{
+	zassert_false(dm_start_running, "Completed called from bt_gatt_dm_start");
+
+	*(struct bt_gatt_dm **)context = dm;
+	k_sem_give(&discovery_finished);
+}
+
+static void test_cb_service_not_found(struct bt_conn *conn, void *context)
+{
+	*(struct bt_gatt_dm **)context = NULL;
+	k_sem_give(&discovery_finished);
+}
+
+static void test_cb_error_found(struct bt_conn *conn, int err, void *context)
+{
+	zassert_unreachable("Discovery error: %d", err);
+}
+
+static const struct bt_gatt_dm_cb test_cb = {
+	.completed         = test_cb_completed,
+	.service_not_found = test_cb_service_not_found,
+	.error_found       = test_cb_error_found
+};
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_reset(&discovery_finished);
+	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+	bt_mock_reset(true, DB_HASH_SEED);
+}
+
+/* Discover the service and return the number of discovery procedures it took */
+static size_t run_dm(const struct bt_uuid *svc_uuid, struct bt_gatt_dm **dm)
+{
+	size_t calls = bt_gatt_discover_mock_calls();
+	int err;
+
+	dm_start_running = true;
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, svc_uuid, &test_cb, dm);
+	dm_start_running = false;
+	zassert_ok(err, "bt_gatt_dm_start finished with error: %d", err);
+
+	err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+	zassert_ok(err, "It seems that no callback function was called: %d", err);
+	zassert_not_null(*dm, "Service not found");
+
+	return bt_gatt_discover_mock_calls() - calls;
+}
+
+/* Check the discovered DIS service against the simulated attribute table */
+static void dis_check(const struct bt_gatt_dm *dm)
+{
+	const struct bt_gatt_dm_attr *attr;
+	const struct bt_gatt_service_val *service_val;
+	const struct bt_gatt_chrc *chrc;
+
+	zassert_equal(5, bt_gatt_dm_attr_cnt(dm), "Unexpected number of attributes: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+
+	attr = bt_gatt_dm_service_get(dm);
+	zassert_equal(12, attr->handle, "Unexpected service handle");
+	service_val = bt_gatt_dm_attr_service_val(attr);
+	zassert_not_null(service_val, "Service value missing");
+	zassert_ok(bt_uuid_cmp(BT_UUID_DIS, service_val->uuid), "Unexpected service UUID");
+	zassert_equal(16, service_val->end_handle, "Unexpected end handle");
+
+	attr = bt_gatt_dm_char_by_uuid(dm, BT_UUID_DIS_MODEL_NUMBER);
+	zassert_not_null(attr, "Model Number missing");
+	zassert_equal(13, attr->handle, "Unexpected handle");
+	chrc = bt_gatt_dm_attr_chrc_val(attr);
+	zassert_equal(BT_GATT_CHRC_READ, chrc->properties, "Unexpected properties");
+
+	attr = bt_gatt_dm_char_by_uuid(dm, BT_UUID_DIS_MANUFACTURER_NAME);
+	zassert_not_null(attr, "Manufacturer Name missing");
+	zassert_equal(15, attr->handle, "Unexpected handle");
+	chrc = bt_gatt_dm_attr_chrc_val(attr);
+	zassert_equal(BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY, chrc->properties,
+		      "Unexpected properties");
+
+	attr = bt_gatt_dm_desc_next(dm, attr);
+	zassert_not_null(attr, "Descriptor missing");
+	zassert_equal(16, attr->handle, "Unexpected handle");
+	zassert_ok(bt_uuid_cmp(BT_UUID_DIS_MANUFACTURER_NAME, attr->uuid), "Unexpected UUID");
+}
+
+ZTEST_SUITE(gatt_dm_cache, NULL, NULL, test_before, NULL, NULL);
+
+ZTEST(gatt_dm_cache, test_store_and_restore)
+{
+	struct bt_gatt_dm *dm;
+
+	zassert_true(run_dm(BT_UUID_DIS, &dm) > 0, "Service not discovered");
+	dis_check(dm);
+	zassert_equal(1, bt_mock_settings_saves(), "Service not stored");
+	zassert_ok(bt_gatt_dm_data_release(dm));
+
+	/* The Database Hash is unchanged, so the service is restored */
+	zassert_equal(0, run_dm(BT_UUID_DIS, &dm), "Service discovered again");
+	dis_check(dm);
+	zassert_equal(1, bt_mock_settings_saves(), "Restored service stored again");
+	zassert_ok(bt_gatt_dm_data_release(dm));
+
+	zassert_equal(2, bt_mock_db_hash_reads(), "Unexpected Database Hash reads");
+}
+
+ZTEST(gatt_dm_cache, test_db_hash_mismatch)
+{
+	struct bt_gatt_dm *dm;
+
+	zassert_true(run_dm(BT_UUID_DIS, &dm) > 0, "Service not discovered");
+	zassert_ok(bt_gatt_dm_data_release(dm));
+
+	/* The database of the peer changed, so the cache entry is not used */
+	bt_mock_db_hash_set(DB_HASH_SEED + 1);
+
+	zassert_true(run_dm(BT_UUID_DIS, &dm) > 0, "Stale service restored");
+	dis_check(dm);
+	zassert_ok(bt_gatt_dm_data_release(dm));
+
+	/* The entry is replaced with the one for the new Database Hash */
+	zassert_equal(2, bt_mock_settings_saves(), "Service not stored");
+	zassert_equal(1, bt_mock_settings_count(), "Stale entry kept");
+
+	zassert_equal(0, run_dm(BT_UUID_DIS, &dm), "Service discovered again");
+	dis_check(dm);
+	zassert_ok(bt_gatt_dm_data_release(dm));
+}
+
+ZTEST(gatt_dm_cache, test_entry_too_large)
+{
+	struct bt_gatt_dm *dm;
+
+	zassert_true(run_dm(BT_UUID_HIDS, &dm) > 0, "Service not discovered");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm), "Unexpected number of attributes");
+	zassert_ok(bt_gatt_dm_data_release(dm));
+
+	/* HIDS does not fit in CONFIG_BT_GATT_DM_CACHE_SIZE, so it is not stored */
+	zassert_equal(0, bt_mock_settings_saves(), "Truncated service stored");
+
+	zassert_true(run_dm(BT_UUID_HIDS, &dm) > 0, "Service not discovered");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm), "Unexpected number of attributes");
+	zassert_ok(bt_gatt_dm_data_release(dm));
+}
+
+ZTEST(gatt_dm_cache, test_peer_not_bonded)
+{
+	struct bt_gatt_dm *dm;
+
+	bt_mock_reset(false, DB_HASH_SEED);
+
+	zassert_true(run_dm(BT_UUID_DIS, &dm) > 0, "Service not discovered");
+	dis_check(dm);
+	zassert_ok(bt_gatt_dm_data_release(dm));
+
+	zassert_equal(0, bt_mock_db_hash_reads(), "Database Hash read");
+	zassert_equal(0, bt_mock_settings_saves(), "Service of peer without bond stored");
+}
+
+ZTEST(gatt_dm_cache, test_bond_deleted)
+{
+	struct bt_gatt_dm *dm;
+
+	zassert_true(run_dm(BT_UUID_DIS, &dm) > 0, "Service not discovered");
+	zassert_ok(bt_gatt_dm_data_release(dm));
+	zassert_equal(1, bt_mock_settings_count(), "Service not stored");
+
+	/* The entries of the peer are removed together with the bond */
+	bt_mock_bond_delete();
+	zassert_equal(0, bt_mock_settings_count(), "Entry of removed bond kept");
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+
+#define RPL_SIZE CONFIG_BT_MESH_CRPL
+#define BENCH_ROUNDS 16
+
+/* Spread the sources over the unicast range to avoid best case hashing. */
+static uint16_t test_src(int i)
+{
+	return 0x0001 + (i * 37) % 0x7fff;
+}
+
+static struct bt_mesh_net_rx test_rx(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.local_match = true,
+		.net_if = BT_MESH_NET_IF_ADV,
+	};
+
+	return rx;
+}
+
+static bool rpl_check(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = test_rx(src, seq, old_iv);
+
+	return bt_mesh_rpl_check(&rx, NULL);
+}
+
+ZTEST(bt_mesh_rpl_test, test_replay)
+{
+	zassert_false(rpl_check(test_src(0), 10, false), "New source rejected");
+	zassert_true(rpl_check(test_src(0), 10, false), "Replay not detected");
+	zassert_true(rpl_check(test_src(0), 9, false), "Old seq not detected");
+	zassert_false(rpl_check(test_src(0), 11, false), "New seq rejected");
+	zassert_false(rpl_check(test_src(1), 1, false), "Second source rejected");
+}
+
+ZTEST(bt_mesh_rpl_test, test_full)
+{
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_false(rpl_check(test_src(i), 1, false), "Source %d rejected", i);
+	}
+
+	zassert_true(rpl_check(test_src(RPL_SIZE), 1, false), "Full RPL accepted new source");
+
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_true(rpl_check(test_src(i), 1, false), "Replay %d not detected", i);
+		zassert_false(rpl_check(test_src(i), 2, false), "Source %d rejected", i);
+	}
+}
+
+ZTEST(bt_mesh_rpl_test, test_segmented_match)
+{
+	struct bt_mesh_net_rx rx = test_rx(test_src(0), 5, false);
+	struct bt_mesh_rpl *match = NULL;
+
+	/* Slot is returned, but not updated until bt_mesh_rpl_update() */
+	zassert_false(bt_mesh_rpl_check(&rx, &match), "New source rejected");
+	zassert_not_null(match, "No slot returned");
+	zassert_false(bt_mesh_rpl_check(&rx, &match), "Source stored before update");
+
+	bt_mesh_rpl_update(match, &rx);
+	zassert_true(bt_mesh_rpl_check(&rx, &match), "Replay not detected");
+	zassert_false(rpl_check(test_src(1), 1, false), "Second source rejected");
+}
+
+ZTEST(bt_mesh_rpl_test, test_iv_update_reset)
+{
+	zassert_false(rpl_check(test_src(0), 10, true), "Source rejected");
+	zassert_false(rpl_check(test_src(1), 10, false), "Source rejected");
+
+	/* Entries on the old IV index are discarded, the rest become old */
+	bt_mesh_rpl_reset();
+
+	zassert_true(rpl_check(test_src(1), 10, true), "Replay on old IV index accepted");
+	zassert_false(rpl_check(test_src(1), 1, false), "New IV index rejected");
+	zassert_false(rpl_check(test_src(0), 1, false), "Discarded source rejected");
+
+	/* The removed entry must have been compacted, so that the RPL can
+	 * still hold RPL_SIZE sources.
+	 */
+	for (int i = 2; i < RPL_SIZE; i++) {
+		zassert_false(rpl_check(test_src(i), 1, false), "Source %d rejected", i);
+	}
+
+	zassert_true(rpl_check(test_src(RPL_SIZE), 1, false), "Full RPL accepted new source");
+}
+
+ZTEST(bt_mesh_rpl_test, test_benchmark)
+{
+	uint32_t start;
+	uint64_t cycles;
+
+	for (int i = 0; i < RPL_SIZE; i++) {
+		zassert_false(rpl_check(test_src(i), 0, false), "Source %d rejected", i);
+	}
+
+	start = k_cycle_get_32();
+
+	for (int round = 1; round <= BENCH_ROUNDS; round++) {
+		for (int i = 0; i < RPL_SIZE; i++) {
+			zassert_false(rpl_check(test_src(i), round, false), "Source rejected");
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("RPL check with %d sources: %llu ns per message\n", RPL_SIZE,
+		 k_cyc_to_ns_floor64(cycles) / (BENCH_ROUNDS * RPL_SIZE));
+}
+
+static void before(void *fixture)
+{
+	bt_mesh_rpl_clear();
+}
+
+ZTEST_SUITE(bt_mesh_rpl_test, NULL, NULL, before, NULL, NULL);
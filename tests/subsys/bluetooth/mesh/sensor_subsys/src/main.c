@@ -2437,4 +2437,79 @@ ZTEST(sensor_types_test, test_present_rel_output_ripple_voltage)
 	percentage8_check(sensor_type);
 }
 
+/****************** sensor type lookup **********************************/
+
+ZTEST(sensor_types_test, test_sensor_type_list_sorted)
+{
+	const struct bt_mesh_sensor_type *prev = NULL;
+
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (prev) {
+			zassert_true(prev->id < type->id,
+				     "Sensor type 0x%04x is not sorted", type->id);
+		}
+
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "Lookup of 0x%04x failed", type->id);
+		prev = type;
+	}
+
+	zassert_is_null(bt_mesh_sensor_type_get(BT_MESH_PROP_ID_PROHIBITED), "Found unknown ID");
+	zassert_is_null(bt_mesh_sensor_type_get(0xffff), "Found unknown ID");
+}
+
+#define BENCH_SENSORS 8
+#define BENCH_ROUNDS 1000
+
+ZTEST(sensor_types_test, test_sensor_status_decode_benchmark)
+{
+	const struct bt_mesh_sensor_type *types[BENCH_SENSORS] = {
+		&bt_mesh_sensor_present_amb_temp,
+		&bt_mesh_sensor_present_amb_light_level,
+		&bt_mesh_sensor_motion_sensed,
+		&bt_mesh_sensor_people_count,
+		&bt_mesh_sensor_present_input_voltage,
+		&bt_mesh_sensor_present_input_current,
+		&bt_mesh_sensor_precise_tot_dev_energy_use,
+		&bt_mesh_sensor_time_since_motion_sensed,
+	};
+	struct sensor_value value[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX] = {};
+	NET_BUF_SIMPLE_DEFINE(msg, 128);
+	uint32_t start;
+	uint64_t cycles;
+
+	/* Build a Sensor Status message with several sensors */
+	for (int i = 0; i < BENCH_SENSORS; i++) {
+		zassert_ok(sensor_status_id_encode(&msg, sensor_value_len(types[i]),
+						   types[i]->id));
+		zassert_ok(sensor_value_encode(&msg, types[i], value));
+	}
+
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < BENCH_ROUNDS; round++) {
+		struct net_buf_simple_state state;
+
+		net_buf_simple_save(&msg, &state);
+
+		while (msg.len) {
+			const struct bt_mesh_sensor_type *type;
+			uint8_t len;
+			uint16_t id;
+
+			sensor_status_id_decode(&msg, &len, &id);
+			type = bt_mesh_sensor_type_get(id);
+			zassert_not_null(type, "Unknown sensor type 0x%04x", id);
+			zassert_ok(sensor_value_decode(&msg, type, value));
+		}
+
+		net_buf_simple_restore(&msg, &state);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("Decoded %d sensor status message with %d sensors: %llu ns per message\n",
+		 BENCH_ROUNDS, BENCH_SENSORS, k_cyc_to_ns_floor64(cycles) / BENCH_ROUNDS);
+}
+
 ZTEST_SUITE(sensor_types_test, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+/* Number of advertising reports in the replayed trace */
+#define TRACE_REPORTS 4096
+/* Number of distinct advertisers in the trace */
+#define TRACE_DEVICES 256
+/* Every n-th advertiser carries the target service UUID */
+#define TRACE_TARGET_INTERVAL 64
+#define TRACE_ROUNDS 4
+
+#define BT_UUID_TARGET_VAL \
+	BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+#define BT_UUID_TARGET BT_UUID_DECLARE_128(BT_UUID_TARGET_VAL)
+
+struct trace_report {
+	bt_addr_le_t addr;
+	uint8_t len;
+	uint8_t data[31];
+};
+
+static struct bt_le_scan_cb *scan_cb;
+static struct trace_report trace[TRACE_REPORTS];
+
+static size_t match_cnt;
+static size_t no_match_cnt;
+static struct bt_scan_filter_match last_match;
+
+/* Capture the callback registered by the Scan library. */
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	match_cnt++;
+	last_match = *filter_match;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, scan_filter_match, scan_filter_no_match, NULL, NULL);
+
+static void report_inject(const bt_addr_le_t *addr, const uint8_t *data, uint8_t len)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = addr,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+	struct net_buf_simple ad;
+
+	net_buf_simple_init_with_data(&ad, (void *)data, len);
+	scan_cb->recv(&info, &ad);
+}
+
+static void addr_make(bt_addr_le_t *addr, uint32_t id)
+{
+	addr->type = BT_ADDR_LE_RANDOM;
+	sys_put_le32(id * 2654435761U, addr->a.val);
+	sys_put_le16(0xc000 | (id & 0x3fff), &addr->a.val[4]);
+}
+
+static uint8_t ad_put(uint8_t *buf, uint8_t type, const void *data, uint8_t len)
+{
+	buf[0] = len + 1;
+	buf[1] = type;
+	memcpy(&buf[2], data, len);
+
+	return len + 2;
+}
+
+/* Build a trace that resembles a dense environment: beacons with
+ * manufacturer data, devices advertising lists of 16-bit UUIDs and names,
+ * and a few devices with the 128-bit target service UUID.
+ */
+static void trace_build(void)
+{
+	static const uint8_t flags = BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR;
+	static const uint8_t uuid128[] = { BT_UUID_TARGET_VAL };
+	static const uint8_t mfg[] = { 0x4c, 0x00, 0x02, 0x15, 0x01, 0x02, 0x03, 0x04,
+				       0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c };
+
+	for (uint32_t i = 0; i < TRACE_REPORTS; i++) {
+		struct trace_report *report = &trace[i];
+		uint32_t dev = (i * 7919) % TRACE_DEVICES;
+		uint8_t *buf = report->data;
+		uint16_t uuids[3];
+
+		addr_make(&report->addr, dev);
+		report->len = ad_put(buf, BT_DATA_FLAGS, &flags, sizeof(flags));
+
+		if ((dev % TRACE_TARGET_INTERVAL) == 0) {
+			report->len += ad_put(&buf[report->len], BT_DATA_UUID128_ALL,
+					      uuid128, sizeof(uuid128));
+		} else if (dev % 2) {
+			report->len += ad_put(&buf[report->len], BT_DATA_MANUFACTURER_DATA,
+					      mfg, sizeof(mfg));
+		} else {
+			for (size_t j = 0; j < ARRAY_SIZE(uuids); j++) {
+				uuids[j] = sys_cpu_to_le16(0x1800 + (dev + j) % 64);
+			}
+
+			report->len += ad_put(&buf[report->len], BT_DATA_UUID16_SOME,
+					      uuids, sizeof(uuids));
+			report->len += ad_put(&buf[report->len], BT_DATA_NAME_COMPLETE,
+					      "Sensor", strlen("Sensor"));
+		}
+	}
+}
+
+static void *scan_setup(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+	zassert_not_null(scan_cb, "Scan callback not registered");
+
+	trace_build();
+
+	return NULL;
+}
+
+static void scan_before(void *fixture)
+{
+	bt_scan_filter_remove_all();
+	bt_scan_filter_disable();
+	bt_scan_blocklist_clear();
+	match_cnt = 0;
+	no_match_cnt = 0;
+	memset(&last_match, 0, sizeof(last_match));
+}
+
+ZTEST_SUITE(scan_tests, NULL, scan_setup, scan_before, NULL, NULL);
+
+ZTEST(scan_tests, test_uuid_filter_any)
+{
+	const uint8_t ad[] = { 5, BT_DATA_UUID16_SOME, 0x0d, 0x18, 0x0f, 0x18 };
+	bt_addr_le_t addr;
+
+	addr_make(&addr, 1);
+
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_DIS));
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_BAS));
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS));
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER, false));
+
+	report_inject(&addr, ad, sizeof(ad));
+
+	/* The first matching filter is reported */
+	zassert_equal(match_cnt, 1, "No match");
+	zassert_true(last_match.uuid.match, "UUID not matched");
+	zassert_equal(last_match.uuid.count, 1, "Unexpected count");
+	zassert_ok(bt_uuid_cmp(last_match.uuid.uuid[0], BT_UUID_BAS), "Wrong UUID");
+}
+
+ZTEST(scan_tests, test_uuid_filter_all)
+{
+	const uint8_t ad[] = { 5, BT_DATA_UUID16_SOME, 0x0d, 0x18, 0x0f, 0x18 };
+	bt_addr_le_t addr;
+
+	addr_make(&addr, 1);
+
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS));
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_BAS));
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER, true));
+
+	report_inject(&addr, ad, sizeof(ad));
+	zassert_equal(match_cnt, 1, "No match");
+	zassert_equal(last_match.uuid.count, 2, "Unexpected count");
+
+	/* 128-bit form of a 16-bit UUID matches as well */
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID,
+				      BT_UUID_DECLARE_128(BT_UUID_128_ENCODE(
+					      0x0000180a, 0x0000, 0x1000, 0x8000,
+					      0x00805f9b34fb))));
+
+	report_inject(&addr, ad, sizeof(ad));
+	zassert_equal(no_match_cnt, 1, "Unexpected match");
+
+	const uint8_t ad_dis[] = { 7, BT_DATA_UUID16_SOME, 0x0d, 0x18, 0x0f, 0x18, 0x0a, 0x18 };
+
+	report_inject(&addr, ad_dis, sizeof(ad_dis));
+	zassert_equal(match_cnt, 2, "No match");
+	zassert_equal(last_match.uuid.count, 3, "Unexpected count");
+}
+
+ZTEST(scan_tests, test_addr_filter_and_blocklist)
+{
+	const uint8_t ad[] = { 2, BT_DATA_FLAGS, BT_LE_AD_GENERAL };
+	bt_addr_le_t addr;
+	bt_addr_le_t other;
+
+	addr_make(&addr, 10);
+	addr_make(&other, 11);
+
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr));
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false));
+
+	report_inject(&other, ad, sizeof(ad));
+	zassert_equal(no_match_cnt, 1, "Unexpected match");
+
+	report_inject(&addr, ad, sizeof(ad));
+	zassert_equal(match_cnt, 1, "No match");
+	zassert_true(last_match.addr.match, "Address not matched");
+
+	zassert_ok(bt_scan_blocklist_device_add(&addr));
+	report_inject(&addr, ad, sizeof(ad));
+	zassert_equal(match_cnt, 1, "Blocklisted device matched");
+}
+
+ZTEST(scan_tests, test_trace_replay_benchmark)
+{
+	uint32_t start;
+	uint64_t ns;
+	bt_addr_le_t blocked;
+
+	/* Typical central setup: one service UUID, a few known addresses and
+	 * a blocklist, any filter matching.
+	 */
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_TARGET));
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Keyboard"));
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_ADDRESS_CNT; i++) {
+		bt_addr_le_t addr;
+
+		addr_make(&addr, TRACE_DEVICES + i);
+		zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr));
+	}
+
+	for (uint32_t i = 0; i < CONFIG_BT_SCAN_BLOCKLIST_LEN; i++) {
+		addr_make(&blocked, 2 * TRACE_DEVICES + i);
+		zassert_ok(bt_scan_blocklist_device_add(&blocked));
+	}
+
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER | BT_SCAN_NAME_FILTER |
+					 BT_SCAN_ADDR_FILTER, false));
+
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < TRACE_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(trace); i++) {
+			report_inject(&trace[i].addr, trace[i].data, trace[i].len);
+		}
+	}
+
+	ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+
+	zassert_equal(match_cnt, TRACE_ROUNDS * TRACE_REPORTS / TRACE_TARGET_INTERVAL,
+		      "Unexpected number of matches: %zu", match_cnt);
+
+	TC_PRINT("Replayed %d reports: %llu ns per report, %llu reports/s\n",
+		 TRACE_ROUNDS * TRACE_REPORTS, ns / (TRACE_ROUNDS * TRACE_REPORTS),
+		 ns ? (uint64_t)TRACE_ROUNDS * TRACE_REPORTS * NSEC_PER_SEC / ns : 0);
+}
@@ -20,6 +20,13 @@
 
 #define BUF_LEN 14000 /* Note, not page aligned */
 
+/* Download benchmark, placed after the first half of the flash to avoid the
+ * partitions used by the test itself.
+ */
+#define BENCH_SIZE (1024*1024)
+#define BENCH_BASE (FLASH_SIZE-BENCH_SIZE)
+#define BENCH_FRAGMENT_SIZE 512
+
 static const struct device *fdev = DEVICE_DT_GET(DT_CHOSEN(zephyr_flash_controller));
 static uint8_t sbuf[128];
 static uint8_t read_buf[BUF_LEN];
@@ -246,6 +253,97 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 		      "Expected last erased page offset to be unchanged.");
 }
 
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress_dirty_tail)
+{
+	int err;
+	size_t offset;
+	size_t half_page = page_size / 2;
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_write(write_buf, half_page);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(false);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Simulate a reset after stream_flash committed more data but before
+	 * the checkpoint was stored, by programming the flash right after the
+	 * stored offset.
+	 */
+	err = flash_write(fdev, FLASH_BASE + half_page, write_buf, sizeof(sbuf));
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	/* Progress must be rolled back to the start of the dirty page */
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(0, offset, "Dirty tail was not detected");
+
+	/* Rewriting the page must erase it and give the correct content */
+	err = dfu_target_stream_write(write_buf, page_size);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = flash_read(fdev, FLASH_BASE, read_buf, page_size);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_mem_equal(read_buf, write_buf, page_size, "Incorrect value");
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress_benchmark)
+{
+	int err;
+	int64_t start;
+	int64_t duration;
+	size_t offset;
+
+	if (FLASH_SIZE < 2 * BENCH_SIZE) {
+		ztest_test_skip();
+	}
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     BENCH_BASE, BENCH_SIZE, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	start = k_uptime_get();
+
+	for (size_t i = 0; i < BENCH_SIZE; i += BENCH_FRAGMENT_SIZE) {
+		err = dfu_target_stream_write(write_buf, BENCH_FRAGMENT_SIZE);
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	duration = k_uptime_get() - start;
+
+	TC_PRINT("Wrote %d bytes in %d byte fragments in %lld ms "
+		 "(checkpoint interval: %d bytes, %d ms)\n",
+		 BENCH_SIZE, BENCH_FRAGMENT_SIZE, duration,
+		 CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_INTERVAL_BYTES,
+		 CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_INTERVAL_MS);
+
+	zassert_equal(offset, BENCH_SIZE, "Unexpected offset: %zu", offset);
+}
+
 static size_t get_flash_page_size(const struct device *dev)
 {
 	struct flash_driver_api *api = (struct flash_driver_api *) dev->api;
@@ -274,6 +372,16 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 	ztest_test_skip();
 }
 
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress_dirty_tail)
+{
+	ztest_test_skip();
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress_benchmark)
+{
+	ztest_test_skip();
+}
+
 #endif
 
 static void *setup(void)
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include "timeslot_queue.h"
+#include "time.h"
+
+#define QUEUE_LENGTH      CONFIG_DM_TIMESLOT_QUEUE_LENGTH
+#define PEER_MIN_INTERVAL CONFIG_DM_TIMESLOT_PEER_MIN_INTERVAL_US
+
+#define WINDOW_LEN_US   5000
+#define TIMESLOT_LEN_US (WINDOW_LEN_US + 400)
+/* Distance between two timeslots that do not overlap, with a margin for the tick rounding. */
+#define SLOT_SPACING_US (TIMESLOT_LEN_US + CONFIG_DM_MIN_TIME_BETWEEN_TIMESLOTS_US + 1000)
+/* Distance between two timeslots of the same peer. */
+#define PEER_SPACING_US MAX(SLOT_SPACING_US, PEER_MIN_INTERVAL + 1000)
+
+#define REF_TICK 1000
+
+/* Simulation parameters */
+#define SIM_DURATION_S     60
+#define SIM_STEP_TICKS     33 /* ~1 ms */
+#define SIM_SYNC_PERIOD_US 100000
+#define SIM_MAX_PEERS      64
+
+uint32_t sim_rtc_counter;
+
+static uint32_t lcg_state;
+
+static uint32_t lcg_next(void)
+{
+	lcg_state = lcg_state * 1103515245 + 12345;
+
+	return lcg_state >> 8;
+}
+
+static void request_init(struct dm_request *req, uint16_t peer, uint32_t delay_us,
+			 uint8_t priority)
+{
+	memset(req, 0, sizeof(*req));
+	req->role = DM_ROLE_INITIATOR;
+	req->bt_addr.type = BT_ADDR_LE_RANDOM;
+	req->bt_addr.a.val[0] = peer & 0xff;
+	req->bt_addr.a.val[1] = peer >> 8;
+	req->bt_addr.a.val[5] = 0xc0;
+	req->start_delay_us = delay_us;
+	req->priority = priority;
+}
+
+static int append(uint16_t peer, uint32_t delay_us, uint8_t priority)
+{
+	struct dm_request req;
+
+	request_init(&req, peer, delay_us, priority);
+
+	return timeslot_queue_append(&req, REF_TICK, WINDOW_LEN_US, TIMESLOT_LEN_US);
+}
+
+static uint16_t head_peer(void)
+{
+	struct timeslot_request *ts = timeslot_queue_peek();
+
+	zassert_not_null(ts, "Queue empty");
+
+	return ts->dm_req.bt_addr.a.val[0] | (ts->dm_req.bt_addr.a.val[1] << 8);
+}
+
+static void queue_clear(void *fixture)
+{
+	while (timeslot_queue_peek()) {
+		timeslot_queue_remove_first();
+	}
+
+	zassert_equal(timeslot_queue_count(), 0, "Queue not empty");
+}
+
+ZTEST(dm_timeslot_queue, test_insert_into_gap)
+{
+	zassert_ok(append(1, 0, 0));
+	zassert_ok(append(2, 4 * SLOT_SPACING_US, 0));
+
+	/* Earlier than the last timeslot, but fits into the gap. */
+	zassert_ok(append(3, 2 * SLOT_SPACING_US, 0));
+	/* Before the first timeslot. */
+	zassert_equal(append(4, 0, 0), -EBUSY, "Overlapping timeslot accepted");
+
+	zassert_equal(timeslot_queue_count(), 3);
+
+	zassert_equal(head_peer(), 1);
+	timeslot_queue_remove_first();
+	zassert_equal(head_peer(), 3);
+	timeslot_queue_remove_first();
+	zassert_equal(head_peer(), 2);
+	timeslot_queue_remove_first();
+	zassert_is_null(timeslot_queue_peek());
+}
+
+ZTEST(dm_timeslot_queue, test_insert_wrap)
+{
+	struct dm_request req;
+	uint32_t ref = RTC_COUNTER_MAX - US_TO_RTC_TICKS(CONFIG_DM_RANGING_OFFSET_US) -
+		       US_TO_RTC_TICKS(SLOT_SPACING_US / 2);
+
+	/* Only the first timeslot starts before the counter overflow. */
+	request_init(&req, 1, 0, 0);
+	zassert_ok(timeslot_queue_append(&req, ref, WINDOW_LEN_US, TIMESLOT_LEN_US));
+	request_init(&req, 2, 2 * SLOT_SPACING_US, 0);
+	zassert_ok(timeslot_queue_append(&req, ref, WINDOW_LEN_US, TIMESLOT_LEN_US));
+	request_init(&req, 3, SLOT_SPACING_US, 0);
+	zassert_ok(timeslot_queue_append(&req, ref, WINDOW_LEN_US, TIMESLOT_LEN_US));
+
+	zassert_equal(head_peer(), 1);
+	timeslot_queue_remove_first();
+	zassert_equal(head_peer(), 3);
+	timeslot_queue_remove_first();
+	zassert_equal(head_peer(), 2);
+}
+
+ZTEST(dm_timeslot_queue, test_priority)
+{
+	zassert_ok(append(1, 0, 0));
+	zassert_ok(append(2, 3 * SLOT_SPACING_US / 2, 1));
+
+	zassert_equal(append(3, 2 * SLOT_SPACING_US, 1), -EBUSY,
+		      "Timeslot overlapping the same priority accepted");
+
+	/* Overlaps both, but only the lower priority one can be dropped. */
+	zassert_equal(append(3, 3 * SLOT_SPACING_US / 4, 1), -EBUSY);
+	zassert_equal(timeslot_queue_count(), 2, "Timeslot dropped for a rejected request");
+
+	zassert_ok(append(3, 3 * SLOT_SPACING_US / 4, 2));
+	zassert_equal(timeslot_queue_count(), 1, "Overlapping timeslots not dropped");
+	zassert_equal(head_peer(), 3);
+}
+
+ZTEST(dm_timeslot_queue, test_peer_limit)
+{
+	const uint32_t cnt = CONFIG_DM_TIMESLOT_QUEUE_COUNT_SAME_PEER;
+
+	for (size_t i = 0; i < cnt; i++) {
+		zassert_ok(append(1, i * PEER_SPACING_US, 0));
+	}
+
+	zassert_equal(append(1, cnt * PEER_SPACING_US, 0), -EAGAIN,
+		      "Too many timeslots for the peer accepted");
+	zassert_ok(append(2, cnt * PEER_SPACING_US, 0));
+}
+
+ZTEST(dm_timeslot_queue, test_peer_rate_limit)
+{
+	if (PEER_MIN_INTERVAL == 0) {
+		ztest_test_skip();
+	}
+
+	zassert_ok(append(1, 0, 0));
+	zassert_equal(append(1, SLOT_SPACING_US, 0), -EAGAIN, "Rate limit not applied");
+	zassert_ok(append(2, SLOT_SPACING_US, 0));
+	zassert_ok(append(1, MAX(PEER_SPACING_US, 2 * SLOT_SPACING_US), 0));
+}
+
+ZTEST(dm_timeslot_queue, test_queue_full)
+{
+	for (size_t i = 0; i < QUEUE_LENGTH; i++) {
+		zassert_ok(append(i, i * SLOT_SPACING_US, 0));
+	}
+
+	zassert_equal(append(QUEUE_LENGTH, QUEUE_LENGTH * SLOT_SPACING_US, 0), -ENOMEM);
+
+	/* A higher priority request replaces the latest timeslot of the lowest priority. */
+	zassert_ok(append(QUEUE_LENGTH, QUEUE_LENGTH * SLOT_SPACING_US, 1));
+	zassert_equal(timeslot_queue_count(), QUEUE_LENGTH);
+
+	for (size_t i = 0; i < QUEUE_LENGTH - 1; i++) {
+		zassert_equal(head_peer(), i);
+		timeslot_queue_remove_first();
+	}
+
+	zassert_equal(head_peer(), QUEUE_LENGTH);
+}
+
+struct sim_peer {
+	struct dm_request req;
+	uint32_t next_sync;
+	uint32_t delay_us;
+};
+
+/* Every peer synchronizes periodically and requests a ranging at its own delay,
+ * as the initiator does when it receives the advertising packet of the reflector.
+ * The radio executes the timeslot at the head of the queue when it is due.
+ */
+static void simulate(size_t peer_cnt, uint32_t *measurements, uint32_t *rejected)
+{
+	static struct sim_peer peers[SIM_MAX_PEERS];
+	const uint32_t steps = SIM_DURATION_S * RTC_INPUT_FREQ / SIM_STEP_TICKS;
+	uint32_t busy_until = 0;
+
+	*measurements = 0;
+	*rejected = 0;
+	lcg_state = peer_cnt;
+	sim_rtc_counter = 0;
+
+	for (size_t i = 0; i < peer_cnt; i++) {
+		peers[i].delay_us = lcg_next() % 50000;
+		peers[i].next_sync = lcg_next() % US_TO_RTC_TICKS(SIM_SYNC_PERIOD_US);
+		request_init(&peers[i].req, i, peers[i].delay_us, 0);
+	}
+
+	for (uint32_t step = 0; step < steps; step++) {
+		uint32_t now = time_now();
+
+		for (size_t i = 0; i < peer_cnt; i++) {
+			struct sim_peer *peer = &peers[i];
+
+			if (time_is_before(now, peer->next_sync)) {
+				continue;
+			}
+
+			peer->next_sync = (now + US_TO_RTC_TICKS(SIM_SYNC_PERIOD_US) +
+					   lcg_next() % US_TO_RTC_TICKS(SIM_SYNC_PERIOD_US / 4)) %
+					  RTC_COUNTER_MAX;
+			peer->req.start_delay_us = peer->delay_us;
+
+			if (timeslot_queue_append(&peer->req, now, WINDOW_LEN_US,
+						  TIMESLOT_LEN_US)) {
+				(*rejected)++;
+			}
+		}
+
+		struct timeslot_request *ts = timeslot_queue_peek();
+
+		while (ts && !time_is_before(now, ts->start_time)) {
+			/* Timeslots missed by more than a step are not executed. */
+			if ((time_distance_get(ts->start_time, now) < SIM_STEP_TICKS) &&
+			    !time_is_before(now, busy_until)) {
+				busy_until = ts->start_time + US_TO_RTC_TICKS(TIMESLOT_LEN_US);
+				(*measurements)++;
+			}
+
+			timeslot_queue_remove_first();
+			ts = timeslot_queue_peek();
+		}
+
+		sim_rtc_counter = (sim_rtc_counter + SIM_STEP_TICKS) % RTC_COUNTER_MAX;
+	}
+}
+
+ZTEST(dm_timeslot_queue, test_simulation_throughput)
+{
+	static const size_t peer_counts[] = {1, 2, 4, 8, 16, 32, 64};
+	uint32_t measurements;
+	uint32_t rejected;
+
+	TC_PRINT("peers | measurements/s | rejected requests/s\n");
+
+	for (size_t i = 0; i < ARRAY_SIZE(peer_counts); i++) {
+		simulate(peer_counts[i], &measurements, &rejected);
+
+		TC_PRINT("%5zu | %14u | %19u\n", peer_counts[i], measurements / SIM_DURATION_S,
+			 rejected / SIM_DURATION_S);
+
+		zassert_true(measurements > 0, "No measurements");
+		queue_clear(NULL);
+	}
+}
+
+ZTEST_SUITE(dm_timeslot_queue, NULL, NULL, queue_clear, queue_clear, NULL);
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_RTC_STUB_H__
+#define NRF_RTC_STUB_H__
+
+#include <zephyr/types.h>
+
+/* Simulated 24-bit RTC running at 32768 Hz. */
+#define RTC_INPUT_FREQ 32768
+#define RTC_COUNTER_COUNTER_Pos 0
+#define RTC_COUNTER_COUNTER_Msk (0xFFFFFFUL << RTC_COUNTER_COUNTER_Pos)
+
+#define NRF_RTC0 NULL
+
+extern uint32_t sim_rtc_counter;
+
+static inline uint32_t nrf_rtc_counter_get(const void *p_reg)
+{
+	ARG_UNUSED(p_reg);
+
+	return sim_rtc_counter;
+}
+
+#endif /* NRF_RTC_STUB_H__ */
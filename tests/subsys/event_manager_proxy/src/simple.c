@@ -32,6 +32,23 @@ ZTEST(simple_tests, test_simple_ping_pong)
 	zassert_ok(err, "No pong event received");
 }
 
+ZTEST(simple_tests, test_simple_ping_pong_flush)
+{
+	struct simple_ping_event *ping = new_simple_ping_event();
+
+	k_sem_reset(&waiting_pong_sem);
+
+	/* Bypass the event manager. If the remote accepts batches, the event is sent only by
+	 * the flush or the timeout.
+	 */
+	proxy_direct_submit_event(&ping->header);
+	app_event_manager_free(ping);
+	zassert_ok(event_manager_proxy_flush(), "Cannot flush the events");
+
+	int err = k_sem_take(&waiting_pong_sem, K_SECONDS(1));
+	zassert_ok(err, "No pong event received");
+}
+
 ZTEST(simple_tests, test_simple_burst)
 {
 	uint32_t us_spent;
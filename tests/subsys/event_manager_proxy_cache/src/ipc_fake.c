@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ipc/ipc_service_backend.h>
+
+#include "ipc_fake.h"
+
+static const struct ipc_ept_cfg *ept_cfg;
+
+static int fake_init(const struct device *dev)
+{
+	return 0;
+}
+
+static int fake_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+static int fake_register_endpoint(const struct device *instance, void **token,
+				  const struct ipc_ept_cfg *cfg)
+{
+	ept_cfg = cfg;
+	*token = (void *)cfg;
+
+	return 0;
+}
+
+static int fake_send(const struct device *instance, void *token, const void *data, size_t len)
+{
+	ipc_fake_remote_receive(data, len);
+
+	return len;
+}
+
+static const struct ipc_service_backend fake_backend = {
+	.open_instance = fake_open_instance,
+	.register_endpoint = fake_register_endpoint,
+	.send = fake_send,
+};
+
+DEVICE_DEFINE(ipc_fake, "ipc_fake", fake_init, NULL, NULL, NULL, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &fake_backend);
+
+const struct device *ipc_fake_instance(void)
+{
+	return DEVICE_GET(ipc_fake);
+}
+
+void ipc_fake_bind(void)
+{
+	ept_cfg->cb.bound(ept_cfg->priv);
+}
+
+void ipc_fake_send_to_local(const void *data, size_t len)
+{
+	ept_cfg->cb.received(data, len, ept_cfg->priv);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef IPC_FAKE_H_
+#define IPC_FAKE_H_
+
+#include <zephyr/device.h>
+
+/** @brief Get the IPC instance connected to the fake remote. */
+const struct device *ipc_fake_instance(void);
+
+/** @brief Bind the registered endpoint, like the remote does after its boot. */
+void ipc_fake_bind(void);
+
+/** @brief Pass the data from the fake remote to the registered endpoint. */
+void ipc_fake_send_to_local(const void *data, size_t len);
+
+/**
+ * @brief Handle the data sent to the fake remote.
+ *
+ * Implemented by the test.
+ */
+void ipc_fake_remote_receive(const void *data, size_t len);
+
+#endif /* IPC_FAKE_H_ */
@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+
+/* Included to reach the proxy state dropped by the simulated reset. */
+#include "event_manager_proxy.c"
+
+#include "ipc_fake.h"
+
+/* Event IDs and event type signature used by the fake remote. */
+#define REMOTE_ID_A      ((const struct event_type *)0x1000)
+#define REMOTE_ID_B      ((const struct event_type *)0x2000)
+#define REMOTE_SIGNATURE 0x12345678
+
+/* Time for the system workqueue to process the events and the resubscribe work. */
+#define PROCESS_TIME K_MSEC(50)
+
+struct test_event_a {
+	struct app_event_header header;
+};
+APP_EVENT_TYPE_DECLARE(test_event_a);
+APP_EVENT_TYPE_DEFINE(test_event_a, NULL, NULL, APP_EVENT_FLAGS_CREATE());
+
+struct test_event_b {
+	struct app_event_header header;
+};
+APP_EVENT_TYPE_DECLARE(test_event_b);
+APP_EVENT_TYPE_DEFINE(test_event_b, NULL, NULL, APP_EVENT_FLAGS_CREATE());
+
+struct test_event_c {
+	struct app_event_header header;
+};
+APP_EVENT_TYPE_DECLARE(test_event_c);
+APP_EVENT_TYPE_DEFINE(test_event_c, NULL, NULL, APP_EVENT_FLAGS_CREATE());
+
+struct test_event_d {
+	struct app_event_header header;
+};
+APP_EVENT_TYPE_DECLARE(test_event_d);
+APP_EVENT_TYPE_DEFINE(test_event_d, NULL, NULL, APP_EVENT_FLAGS_CREATE());
+
+/** @brief State of the fake remote. */
+static struct {
+	/* Configuration. */
+	bool features;
+	bool cache_hit;
+
+	/* The remote sent the start command. */
+	bool started;
+
+	/* Commands and events received from the proxy. */
+	bool proxy_started;
+	size_t hello_cnt;
+	size_t subscribe_cnt;
+	size_t subscribe_hash_cnt;
+	size_t start_cnt;
+	size_t event_cnt;
+	const struct event_type *event_id;
+
+	/* Reply of the proxy to the subscribe command extension. */
+	size_t reply_cnt;
+	bool reply_cache_hit;
+} remote;
+
+static void remote_reset(bool features, bool cache_hit)
+{
+	memset(&remote, 0, sizeof(remote));
+	remote.features = features;
+	remote.cache_hit = cache_hit;
+}
+
+static void remote_reply_features(void)
+{
+	const struct emp_cmd_features reply = {
+		.code = EMP_CMD_FEATURES,
+		.features = EMP_FEATURE_SUBSCRIBE_HASH | EMP_FEATURE_CACHE,
+		.cache_hit = remote.cache_hit,
+	};
+
+	ipc_fake_send_to_local(&reply, sizeof(reply));
+}
+
+void ipc_fake_remote_receive(const void *data, size_t len)
+{
+	const struct emp_cmd *cmd = data;
+
+	if (remote.proxy_started && remote.started) {
+		const struct app_event_header *eh = data;
+
+		remote.event_cnt++;
+		remote.event_id = eh->type_id;
+		return;
+	}
+
+	switch (cmd->code) {
+	case EMP_CMD_SUBSCRIBE: {
+		const struct emp_cmd_subscribe *sub = data;
+		size_t offset = ROUND_UP(sizeof(*sub) + strlen(sub->name) + 1, sizeof(uint32_t));
+		const struct emp_subscribe_hello *hello =
+			(const struct emp_subscribe_hello *)((const uint8_t *)data + offset);
+
+		remote.subscribe_cnt++;
+		if ((len >= offset + sizeof(*hello)) && (hello->magic == EMP_HELLO_MAGIC)) {
+			zassert_equal(hello->signature, emp_signature, "Wrong signature");
+			remote.hello_cnt++;
+			if (remote.features) {
+				remote_reply_features();
+			}
+		}
+		break;
+	}
+
+	case EMP_CMD_SUBSCRIBE_HASH:
+		remote.subscribe_hash_cnt++;
+		break;
+
+	case EMP_CMD_START:
+		remote.start_cnt++;
+		remote.proxy_started = true;
+		break;
+
+	case EMP_CMD_FEATURES: {
+		const struct emp_cmd_features *reply = data;
+
+		remote.reply_cnt++;
+		remote.reply_cache_hit = reply->cache_hit;
+		break;
+	}
+
+	default:
+		zassert_unreachable("Unexpected command %u", cmd->code);
+		break;
+	}
+}
+
+/** @brief Send the subscribe command from the remote. */
+static void remote_subscribe(const struct event_type *local_et, const struct event_type *id,
+			     bool hello, uint32_t signature)
+{
+	struct emp_cmd_subscribe *cmd;
+	size_t size = ROUND_UP(sizeof(*cmd) + strlen(local_et->name) + 1, sizeof(uint32_t));
+	uint32_t buffer[(size + sizeof(struct emp_subscribe_hello)) / sizeof(uint32_t)];
+	struct emp_subscribe_hello *ext = (struct emp_subscribe_hello *)((uint8_t *)buffer + size);
+
+	memset(buffer, 0, sizeof(buffer));
+	cmd = (struct emp_cmd_subscribe *)buffer;
+	cmd->code = EMP_CMD_SUBSCRIBE;
+	cmd->id = id;
+	strcpy(cmd->name, local_et->name);
+
+	ext->magic = EMP_HELLO_MAGIC;
+	ext->features = EMP_FEATURE_SUBSCRIBE_HASH | EMP_FEATURE_CACHE;
+	ext->signature = signature;
+
+	ipc_fake_send_to_local(buffer, hello ? sizeof(buffer) : size);
+}
+
+static void remote_subscribe_hash(const struct event_type *local_et, const struct event_type *id)
+{
+	const struct emp_cmd_subscribe_hash cmd = {
+		.code = EMP_CMD_SUBSCRIBE_HASH,
+		.id = id,
+		.hash = event_name_hash(local_et->name),
+	};
+
+	ipc_fake_send_to_local(&cmd, sizeof(cmd));
+}
+
+static void remote_start(void)
+{
+	const struct emp_cmd_start cmd = {
+		.code = EMP_CMD_START,
+	};
+
+	ipc_fake_send_to_local(&cmd, sizeof(cmd));
+	remote.started = true;
+}
+
+/**
+ * @brief Simulate the reset of the local core.
+ *
+ * All the proxy data is lost, except the cache placed in the noinit memory.
+ */
+static void proxy_reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(emp_ipc_data); i++) {
+		if (emp_ipc_data[i].used) {
+			k_work_cancel_delayable(&emp_ipc_data[i].resubscribe_work);
+		}
+	}
+
+	memset(emp_ipc_data, 0, sizeof(emp_ipc_data));
+	memset(event_manager_proxy_array, 0,
+	       (uint8_t *)_event_manager_proxy_array_list_end - (uint8_t *)event_manager_proxy_array);
+	emp_started = false;
+	emp_hash_index_ready = false;
+	k_event_set(&emp_all_remotes_started, 0);
+}
+
+/** @brief Add the remote and let it send its subscriptions with the extension. */
+static void proxy_add_remote(void)
+{
+	zassert_ok(event_manager_proxy_add_remote(ipc_fake_instance()), "Cannot add remote");
+	ipc_fake_bind();
+}
+
+static void proxy_subscribe_and_start(void)
+{
+	const struct device *instance = ipc_fake_instance();
+
+	zassert_ok(event_manager_proxy_subscribe(instance, APP_EVENT_ID(test_event_c)),
+		   "Cannot subscribe");
+	zassert_ok(event_manager_proxy_subscribe(instance, APP_EVENT_ID(test_event_d)),
+		   "Cannot subscribe");
+	zassert_ok(event_manager_proxy_start(), "Cannot start");
+}
+
+/** @brief Full handshake of both cores without any cached subscriptions. */
+static void handshake(void)
+{
+	proxy_add_remote();
+
+	remote_subscribe(APP_EVENT_ID(test_event_a), REMOTE_ID_A, true, REMOTE_SIGNATURE);
+	zassert_equal(remote.reply_cnt, 1, "No features sent to remote");
+	zassert_false(remote.reply_cache_hit, "Unexpected cache hit");
+	remote_subscribe_hash(APP_EVENT_ID(test_event_b), REMOTE_ID_B);
+
+	proxy_subscribe_and_start();
+	zassert_equal(remote.hello_cnt, 1, "Extension not sent once");
+	zassert_equal(remote.subscribe_cnt, 1, "Hash not used after features exchange");
+	zassert_equal(remote.subscribe_hash_cnt, 1, "Subscription not sent");
+	zassert_equal(remote.start_cnt, 1, "Start not sent");
+
+	remote_start();
+	zassert_ok(event_manager_proxy_wait_for_remotes(K_NO_WAIT), "Remote not started");
+}
+
+/** @brief Submit the event and check the ID it was sent to the remote with. */
+static void check_event_sent(const struct event_type *et, const struct event_type *remote_id)
+{
+	size_t event_cnt = remote.event_cnt;
+
+	if (et == APP_EVENT_ID(test_event_a)) {
+		APP_EVENT_SUBMIT(new_test_event_a());
+	} else {
+		APP_EVENT_SUBMIT(new_test_event_b());
+	}
+
+	k_sleep(PROCESS_TIME);
+
+	if (remote_id) {
+		zassert_equal(remote.event_cnt, event_cnt + 1, "Event not sent to remote");
+		zassert_equal_ptr(remote.event_id, remote_id, "Wrong remote event ID");
+	} else {
+		zassert_equal(remote.event_cnt, event_cnt, "Event sent to remote");
+	}
+}
+
+ZTEST(event_manager_proxy_cache, test_cache_hit_after_reset)
+{
+	handshake();
+	check_event_sent(APP_EVENT_ID(test_event_a), REMOTE_ID_A);
+
+	/* Both cores keep the subscriptions. */
+	proxy_reset();
+	remote_reset(true, true);
+	proxy_add_remote();
+
+	remote_subscribe(APP_EVENT_ID(test_event_a), REMOTE_ID_A, true, REMOTE_SIGNATURE);
+	zassert_equal(remote.reply_cnt, 1, "No features sent to remote");
+	zassert_true(remote.reply_cache_hit, "Cached subscriptions not used");
+
+	proxy_subscribe_and_start();
+	zassert_equal(remote.subscribe_cnt, 1, "Subscription sent despite cache hit");
+	zassert_equal(remote.subscribe_hash_cnt, 0, "Subscription sent despite cache hit");
+
+	remote_start();
+	check_event_sent(APP_EVENT_ID(test_event_b), REMOTE_ID_B);
+}
+
+ZTEST(event_manager_proxy_cache, test_cache_corrupted)
+{
+	handshake();
+
+	proxy_reset();
+	remote_reset(true, false);
+	/* The CRC is not updated. */
+	emp_cache[0].entry[0].id = (const struct event_type *)0x3000;
+	proxy_add_remote();
+
+	remote_subscribe(APP_EVENT_ID(test_event_a), REMOTE_ID_A, true, REMOTE_SIGNATURE);
+	zassert_false(remote.reply_cache_hit, "Corrupted cache used");
+
+	proxy_subscribe_and_start();
+	zassert_equal(remote.subscribe_hash_cnt, 1, "Subscription not sent on cache miss");
+
+	remote_start();
+	check_event_sent(APP_EVENT_ID(test_event_a), REMOTE_ID_A);
+	check_event_sent(APP_EVENT_ID(test_event_b), NULL);
+}
+
+ZTEST(event_manager_proxy_cache, test_cache_stale_signature)
+{
+	handshake();
+
+	proxy_reset();
+	remote_reset(true, false);
+	proxy_add_remote();
+
+	/* The remote firmware changed. */
+	remote_subscribe(APP_EVENT_ID(test_event_b), REMOTE_ID_A, true, REMOTE_SIGNATURE + 1);
+	zassert_false(remote.reply_cache_hit, "Stale cache used");
+
+	proxy_subscribe_and_start();
+	remote_start();
+	check_event_sent(APP_EVENT_ID(test_event_a), NULL);
+	check_event_sent(APP_EVENT_ID(test_event_b), REMOTE_ID_A);
+}
+
+ZTEST(event_manager_proxy_cache, test_remote_restart)
+{
+	handshake();
+
+	/* Only the remote restarts and it keeps the subscriptions. */
+	remote_reset(true, true);
+	ipc_fake_bind();
+	check_event_sent(APP_EVENT_ID(test_event_a), NULL);
+
+	zassert_equal(remote.hello_cnt, 1, "Subscriptions not sent to restarted remote");
+	zassert_equal(remote.subscribe_hash_cnt, 0, "Subscription sent despite cache hit");
+	zassert_equal(remote.start_cnt, 1, "Start not sent to restarted remote");
+
+	remote_subscribe(APP_EVENT_ID(test_event_a), REMOTE_ID_A, true, REMOTE_SIGNATURE);
+	zassert_true(remote.reply_cache_hit, "Kept subscriptions not used");
+
+	remote_start();
+	check_event_sent(APP_EVENT_ID(test_event_a), REMOTE_ID_A);
+	check_event_sent(APP_EVENT_ID(test_event_b), REMOTE_ID_B);
+}
+
+ZTEST(event_manager_proxy_cache, test_remote_restart_cache_miss)
+{
+	handshake();
+
+	/* The remote restarts with the new firmware. */
+	remote_reset(true, false);
+	ipc_fake_bind();
+	k_sleep(PROCESS_TIME);
+
+	zassert_equal(remote.hello_cnt, 1, "Subscriptions not sent to restarted remote");
+	zassert_equal(remote.subscribe_hash_cnt, 1, "Subscriptions not sent on cache miss");
+	zassert_equal(remote.start_cnt, 1, "Start not sent to restarted remote");
+
+	remote_subscribe(APP_EVENT_ID(test_event_b), REMOTE_ID_A, true, REMOTE_SIGNATURE + 1);
+	zassert_false(remote.reply_cache_hit, "Stale subscriptions used");
+
+	remote_start();
+	check_event_sent(APP_EVENT_ID(test_event_a), NULL);
+	check_event_sent(APP_EVENT_ID(test_event_b), REMOTE_ID_A);
+}
+
+ZTEST(event_manager_proxy_cache, test_remote_without_features)
+{
+	remote_reset(false, false);
+	proxy_add_remote();
+
+	/* The remote with the previous version of the proxy. */
+	remote_subscribe(APP_EVENT_ID(test_event_a), REMOTE_ID_A, false, 0);
+	zassert_equal(remote.reply_cnt, 0, "Features sent without the extension");
+
+	proxy_subscribe_and_start();
+	zassert_equal(remote.hello_cnt, 1, "Extension not sent");
+	zassert_equal(remote.subscribe_cnt, 2, "Name based subscription not used");
+	zassert_equal(remote.subscribe_hash_cnt, 0, "Hash sent to remote without support");
+
+	remote_start();
+	check_event_sent(APP_EVENT_ID(test_event_a), REMOTE_ID_A);
+}
+
+static void before(void *fixture)
+{
+	proxy_reset();
+	remote_reset(true, false);
+	memset(emp_cache, 0, sizeof(emp_cache));
+}
+
+static void *setup(void)
+{
+	zassert_ok(app_event_manager_init(), "Cannot initialize Application Event Manager");
+
+	return NULL;
+}
+
+ZTEST_SUITE(event_manager_proxy_cache, NULL, setup, before, NULL, NULL);
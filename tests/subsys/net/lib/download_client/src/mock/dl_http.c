@@ -18,3 +18,8 @@ int http_get_request_send(struct download_client *client)
 {
 	return 0;
 }
+
+size_t http_recv_max(const struct download_client *client)
+{
+	return SIZE_MAX;
+}
@@ -10,5 +10,6 @@
 
 int http_parse(struct download_client *client, size_t len);
 int http_get_request_send(struct download_client *client);
+size_t http_recv_max(const struct download_client *client);
 
 #endif /* _DL_HTTP_H_ */
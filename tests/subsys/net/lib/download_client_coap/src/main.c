@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket_offload.h>
+
+#include <zephyr/ztest.h>
+#include <download_client.h>
+
+#include "mock/socket.h"
+
+#define TEST_URL "coap://10.1.0.10/large.bin"
+
+/* 33 blocks of 512 bytes, the last one incomplete */
+#define TEST_BLOCK_SIZE 512
+#define TEST_FILE_SIZE (32 * TEST_BLOCK_SIZE + 100)
+#define TEST_BLOCK_COUNT DIV_ROUND_UP(TEST_FILE_SIZE, TEST_BLOCK_SIZE)
+
+/* Round-trip time of the server stand-in, as on an NB-IoT link */
+#define TEST_LATENCY_MS 300
+
+static struct download_client client;
+static K_SEM_DEFINE(download_closed, 0, 1);
+
+static struct {
+	size_t received;
+	int errors;
+	bool done;
+} dl;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		/* The fragments are received in order */
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			zassert_equal(((const uint8_t *)event->fragment.buf)[i],
+				      mock_coap_server_byte(dl.received + i),
+				      "Wrong byte at offset %zu", dl.received + i);
+		}
+
+		dl.received += event->fragment.len;
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		dl.done = true;
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		dl.errors++;
+		/* Stop the download */
+		return -1;
+	case DOWNLOAD_CLIENT_EVT_CLOSED:
+		k_sem_give(&download_closed);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+/* Download the test file and return the time it took, in milliseconds */
+static int64_t download(size_t from)
+{
+	int err;
+	int64_t start;
+	static const struct download_client_cfg config;
+
+	dl.received = from;
+	start = k_uptime_get();
+
+	err = download_client_get(&client, TEST_URL, &config, NULL, from);
+	zassert_ok(err, NULL);
+
+	zassert_ok(k_sem_take(&download_closed, K_SECONDS(120)), "Download did not finish");
+
+	zassert_true(dl.done, "Download did not complete");
+	zassert_equal(dl.errors, 0, NULL);
+	zassert_equal(dl.received, TEST_FILE_SIZE, NULL);
+
+	return k_uptime_get() - start;
+}
+
+static void *suite_setup(void)
+{
+	int err;
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_ok(err, NULL);
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	memset(&dl, 0, sizeof(dl));
+	k_sem_reset(&download_closed);
+}
+
+ZTEST_SUITE(download_client_coap, NULL, suite_setup, test_before, NULL, NULL);
+
+ZTEST(download_client_coap, test_windowed_download)
+{
+	int64_t duration;
+	struct mock_coap_server_stats stats;
+
+	mock_coap_server_reset(TEST_FILE_SIZE, COAP_BLOCK_512, TEST_LATENCY_MS, 0);
+
+	duration = download(0);
+
+	mock_coap_server_stats_get(&stats);
+	zassert_equal(stats.requests, TEST_BLOCK_COUNT, NULL);
+	zassert_equal(stats.in_flight_max, CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE, NULL);
+
+	printk("Downloaded %d bytes with %d ms latency in %lld ms, %d ms one block at a time\n",
+	       TEST_FILE_SIZE, TEST_LATENCY_MS, duration, TEST_BLOCK_COUNT * TEST_LATENCY_MS);
+
+	/* Only the first block, which gives the file size, is requested on its own */
+	zassert_true(duration < TEST_BLOCK_COUNT * TEST_LATENCY_MS / 2, NULL);
+}
+
+ZTEST(download_client_coap, test_windowed_download_with_loss)
+{
+	int64_t duration;
+	struct mock_coap_server_stats stats;
+
+	mock_coap_server_reset(TEST_FILE_SIZE, COAP_BLOCK_512, TEST_LATENCY_MS, 10);
+
+	duration = download(0);
+
+	mock_coap_server_stats_get(&stats);
+
+	printk("Downloaded %d bytes with %d ms latency and 10%% loss in %lld ms, "
+	       "%d requests, %d lost, smallest block %d bytes\n",
+	       TEST_FILE_SIZE, TEST_LATENCY_MS, duration, stats.requests, stats.lost,
+	       stats.block_size_min);
+
+	/* Only the lost requests are retransmitted */
+	zassert_true(stats.lost > 0, NULL);
+	zassert_true(stats.requests - stats.lost >= TEST_BLOCK_COUNT, NULL);
+
+	/* The block size is reduced when requests are lost */
+	zassert_true(stats.block_size_min < TEST_BLOCK_SIZE, NULL);
+}
+
+ZTEST(download_client_coap, test_resume_within_block)
+{
+	struct mock_coap_server_stats stats;
+
+	mock_coap_server_reset(TEST_FILE_SIZE, COAP_BLOCK_512, TEST_LATENCY_MS, 0);
+
+	download(TEST_BLOCK_SIZE + 100);
+
+	/* The block holding the first byte is requested */
+	mock_coap_server_stats_get(&stats);
+	zassert_equal(stats.requests, TEST_BLOCK_COUNT - 1, NULL);
+}
+
+ZTEST(download_client_coap, test_server_block_size)
+{
+	struct mock_coap_server_stats stats;
+
+	mock_coap_server_reset(TEST_FILE_SIZE, COAP_BLOCK_256, TEST_LATENCY_MS, 0);
+
+	download(0);
+
+	/* The client switches to the block size of the server */
+	mock_coap_server_stats_get(&stats);
+	zassert_equal(stats.block_size_min, 256, NULL);
+	zassert_equal(stats.requests, DIV_ROUND_UP(TEST_FILE_SIZE, 256), NULL);
+}
+
+#define TEST_SOCKET_PRIO 40
+NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
+		    mock_socket_create);
+NET_DEVICE_OFFLOAD_INIT(mock_socket, "mock_socket", mock_nrf_modem_lib_socket_offload_init, NULL,
+			&mock_socket_iface_data, NULL, 0, &mock_if_api, 1280);
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <download_client.h>
+
+int http_parse(struct download_client *client, size_t len)
+{
+	return 0;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	return 0;
+}
+
+size_t http_recv_max(const struct download_client *client)
+{
+	return SIZE_MAX;
+}
@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/net/socket_offload.h>
+#include <sockets_internal.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/ztest.h>
+
+#include "mock/socket.h"
+
+void mock_socket_iface_init(struct net_if *iface);
+
+struct mock_socket_iface_data {
+	struct net_if *iface;
+} mock_socket_iface_data;
+
+struct net_if_api mock_if_api = {
+	.init = mock_socket_iface_init,
+};
+
+/* CoAP server stand-in. Each Block2 request is answered after a fixed
+ * latency, unless it is lost.
+ */
+#define RESPONSES_MAX 16
+#define DATAGRAM_SIZE 600
+
+struct response {
+	int64_t ready_at;
+	uint16_t len;
+	uint8_t data[DATAGRAM_SIZE];
+};
+
+static struct {
+	size_t file_size;
+	enum coap_block_size block_size_max;
+	int latency_ms;
+	int loss_percent;
+	uint32_t seed;
+	int rcv_timeout_ms;
+	struct response responses[RESPONSES_MAX];
+	size_t head;
+	size_t count;
+	struct mock_coap_server_stats stats;
+} server;
+
+void mock_coap_server_reset(size_t file_size, enum coap_block_size block_size_max,
+			    int latency_ms, int loss_percent)
+{
+	memset(&server, 0, sizeof(server));
+	server.file_size = file_size;
+	server.block_size_max = block_size_max;
+	server.latency_ms = latency_ms;
+	server.loss_percent = loss_percent;
+	server.seed = 1;
+	server.stats.block_size_min = INT_MAX;
+}
+
+uint8_t mock_coap_server_byte(size_t off)
+{
+	return (uint8_t)(off % 251);
+}
+
+void mock_coap_server_stats_get(struct mock_coap_server_stats *stats)
+{
+	*stats = server.stats;
+}
+
+static bool server_request_lost(void)
+{
+	/* Deterministic pseudo-random loss */
+	server.seed = server.seed * 1103515245 + 12345;
+
+	return ((server.seed >> 16) % 100) < server.loss_percent;
+}
+
+static ssize_t server_request_receive(const void *buf, size_t len)
+{
+	int err;
+	int block2;
+	int block_size;
+	size_t off;
+	size_t payload_len;
+	uint8_t tkl;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t req_buf[DATAGRAM_SIZE];
+	uint8_t payload[DATAGRAM_SIZE];
+	struct coap_packet req;
+	struct coap_packet rsp;
+	struct response *response;
+
+	zassert_true(len <= sizeof(req_buf), "Request too long");
+	memcpy(req_buf, buf, len);
+
+	zassert_ok(coap_packet_parse(&req, req_buf, len, NULL, 0), "Invalid request");
+	zassert_equal(coap_header_get_type(&req), COAP_TYPE_CON, NULL);
+	zassert_equal(coap_header_get_code(&req), COAP_METHOD_GET, NULL);
+
+	block2 = coap_get_option_int(&req, COAP_OPTION_BLOCK2);
+	zassert_true(block2 >= 0, "Not a Block2 request");
+
+	off = GET_BLOCK_NUM(block2) << (GET_BLOCK_SIZE(block2) + 4);
+	zassert_true(off < server.file_size, "Block past the end of the file");
+
+	server.stats.requests++;
+	server.stats.block_size_min = MIN(server.stats.block_size_min,
+					  coap_block_size_to_bytes(GET_BLOCK_SIZE(block2)));
+
+	if (server_request_lost()) {
+		server.stats.lost++;
+		return len;
+	}
+
+	zassert_true(server.count < RESPONSES_MAX, "Too many requests in flight");
+	response = &server.responses[(server.head + server.count) % RESPONSES_MAX];
+
+	/* The server may use smaller blocks than requested */
+	block_size = MIN(GET_BLOCK_SIZE(block2), server.block_size_max);
+	payload_len = MIN(coap_block_size_to_bytes(block_size), server.file_size - off);
+
+	for (size_t i = 0; i < payload_len; i++) {
+		payload[i] = mock_coap_server_byte(off + i);
+	}
+
+	tkl = coap_header_get_token(&req, token);
+
+	err = coap_packet_init(&rsp, response->data, sizeof(response->data), COAP_VERSION_1,
+			       COAP_TYPE_ACK, tkl, token, COAP_RESPONSE_CODE_CONTENT,
+			       coap_header_get_id(&req));
+	err |= coap_append_option_int(&rsp, COAP_OPTION_BLOCK2,
+				      ((off >> (block_size + 4)) << 4) |
+				      ((off + payload_len < server.file_size) << 3) |
+				      block_size);
+	err |= coap_append_option_int(&rsp, COAP_OPTION_SIZE2, server.file_size);
+	err |= coap_packet_append_payload_marker(&rsp);
+	err |= coap_packet_append_payload(&rsp, payload, payload_len);
+	zassert_ok(err, "Failed to create response");
+
+	response->len = rsp.offset;
+	response->ready_at = k_uptime_get() + server.latency_ms;
+
+	server.count++;
+	server.stats.in_flight_max = MAX(server.stats.in_flight_max, server.count);
+
+	return len;
+}
+
+static ssize_t server_response_send(uint8_t *buf, size_t len)
+{
+	struct response *response = &server.responses[server.head];
+	const int64_t deadline = k_uptime_get() + server.rcv_timeout_ms;
+
+	if (server.count == 0 || response->ready_at > deadline) {
+		k_sleep(K_TIMEOUT_ABS_MS(deadline));
+		errno = EAGAIN;
+		return -1;
+	}
+
+	k_sleep(K_TIMEOUT_ABS_MS(response->ready_at));
+
+	len = MIN(len, response->len);
+	memcpy(buf, response->data, len);
+
+	server.head = (server.head + 1) % RESPONSES_MAX;
+	server.count--;
+
+	return len;
+}
+
+static void server_connection_reset(void)
+{
+	server.head = 0;
+	server.count = 0;
+}
+
+static ssize_t mock_socket_offload_recvfrom(void *obj, void *buf, size_t len, int flags,
+					    struct sockaddr *from, socklen_t *fromlen)
+{
+	return server_response_send(buf, len);
+}
+
+static ssize_t mock_socket_offload_read(void *obj, void *buffer, size_t count)
+{
+	return mock_socket_offload_recvfrom(obj, buffer, count, 0, NULL, 0);
+}
+
+static ssize_t mock_socket_offload_sendto(void *obj, const void *buf, size_t len, int flags,
+					  const struct sockaddr *to, socklen_t tolen)
+{
+	return server_request_receive(buf, len);
+}
+
+static ssize_t mock_socket_offload_write(void *obj, const void *buffer, size_t count)
+{
+	return mock_socket_offload_sendto(obj, buffer, count, 0, NULL, 0);
+}
+
+static int mock_socket_offload_close(void *obj)
+{
+	server_connection_reset();
+	return zsock_close_ctx(obj);
+}
+
+static int mock_socket_offload_ioctl(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		return -EXDEV;
+
+	case ZFD_IOCTL_POLL_UPDATE:
+		return -EOPNOTSUPP;
+
+	default:
+		return 0;
+	}
+}
+
+static int mock_socket_offload_bind(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	return 0;
+}
+
+static int mock_socket_offload_connect(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	server_connection_reset();
+	return 0;
+}
+
+static int mock_socket_offload_listen(void *obj, int backlog)
+{
+	return 0;
+}
+
+static int mock_socket_offload_accept(void *obj, struct sockaddr *addr, socklen_t *addrlen)
+{
+	return 0;
+}
+
+static ssize_t mock_socket_offload_sendmsg(void *obj, const struct msghdr *msg, int flags)
+{
+	return 0;
+}
+
+static int mock_socket_offload_setsockopt(void *obj, int level, int optname, const void *optval,
+					  socklen_t optlen)
+{
+	const struct timeval *time = optval;
+
+	if ((level == SOL_SOCKET) && (optname == SO_RCVTIMEO)) {
+		server.rcv_timeout_ms = time->tv_sec * MSEC_PER_SEC + time->tv_usec / USEC_PER_MSEC;
+	}
+
+	return 0;
+}
+
+static int mock_socket_offload_getsockopt(void *obj, int level, int optname, void *optval,
+					  socklen_t *optlen)
+{
+	return 0;
+}
+
+static const struct socket_op_vtable mock_socket_fd_op_vtable = {
+	.fd_vtable = {
+		.read = mock_socket_offload_read,
+		.write = mock_socket_offload_write,
+		.close = mock_socket_offload_close,
+		.ioctl = mock_socket_offload_ioctl,
+	},
+	.bind = mock_socket_offload_bind,
+	.connect = mock_socket_offload_connect,
+	.listen = mock_socket_offload_listen,
+	.accept = mock_socket_offload_accept,
+	.sendto = mock_socket_offload_sendto,
+	.sendmsg = mock_socket_offload_sendmsg,
+	.recvfrom = mock_socket_offload_recvfrom,
+	.getsockopt = mock_socket_offload_getsockopt,
+	.setsockopt = mock_socket_offload_setsockopt,
+};
+
+/**
+ * There is no support for dns lookup, node has to be a valid ip address
+ * that is parseable via net_ipaddr_parse
+ */
+static int mock_socket_offload_getaddrinfo(const char *node, const char *service,
+					   const struct zsock_addrinfo *hints,
+					   struct zsock_addrinfo **res)
+{
+	struct sockaddr_in *ai_addr;
+	struct zsock_addrinfo *ai;
+	unsigned long port = 0;
+
+	if (!node) {
+		return -1;
+	}
+
+	if (service) {
+		port = strtol(service, NULL, 10);
+		if (port < 1 || port > USHRT_MAX) {
+			return -1;
+		}
+	}
+
+	if (!res) {
+		return -1;
+	}
+
+	if (hints && hints->ai_family != AF_INET) {
+		return -1;
+	}
+
+	*res = calloc(1, sizeof(struct zsock_addrinfo));
+	ai = *res;
+	if (!ai) {
+		return -1;
+	}
+
+	ai_addr = calloc(1, sizeof(*ai_addr));
+	if (!ai_addr) {
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_family = AF_INET;
+	ai->ai_socktype = hints ? hints->ai_socktype : SOCK_STREAM;
+	ai->ai_protocol = ai->ai_socktype == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP;
+
+	ai_addr->sin_family = ai->ai_family;
+	ai_addr->sin_port = htons(port);
+
+	if (!net_ipaddr_parse(node, strlen(node), (struct sockaddr *)ai_addr)) {
+		free(ai_addr);
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_addrlen = sizeof(*ai_addr);
+	ai->ai_addr = (struct sockaddr *)ai_addr;
+
+	return 0;
+}
+
+static void mock_socket_offload_freeaddrinfo(struct zsock_addrinfo *res)
+{
+	__ASSERT_NO_MSG(res);
+
+	free(res->ai_addr);
+	free(res);
+}
+
+bool mock_socket_is_supported(int family, int type, int proto)
+{
+	return true;
+}
+
+int mock_socket_create(int family, int type, int proto)
+{
+	int fd = z_reserve_fd();
+	struct net_context *ctx;
+	int res;
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	if (proto == 0) {
+		if (family == AF_INET || family == AF_INET6) {
+			if (type == SOCK_DGRAM) {
+				proto = IPPROTO_UDP;
+			} else if (type == SOCK_STREAM) {
+				proto = IPPROTO_TCP;
+			}
+		}
+	}
+
+	res = net_context_get(family, type, proto, &ctx);
+	if (res < 0) {
+		z_free_fd(fd);
+		errno = -res;
+		return -1;
+	}
+
+	/* Initialize user_data, all other calls will preserve it */
+	ctx->user_data = NULL;
+
+	/* The socket flags are stored here */
+	ctx->socket_data = NULL;
+
+	/* recv_q and accept_q are in union */
+	k_fifo_init(&ctx->recv_q);
+
+	/* Condition variable is used to avoid keeping lock for a long time
+	 * when waiting data to be received
+	 */
+	k_condvar_init(&ctx->cond.recv);
+
+	/* TCP context is effectively owned by both application
+	 * and the stack: stack may detect that peer closed/aborted
+	 * connection, but it must not dispose of the context behind
+	 * the application back. Likewise, when application "closes"
+	 * context, it's not disposed of immediately - there's yet
+	 * closing handshake for stack to perform.
+	 */
+	if (proto == IPPROTO_TCP) {
+		net_context_ref(ctx);
+	}
+
+	z_finalize_fd(fd, ctx, (const struct fd_op_vtable *)&mock_socket_fd_op_vtable);
+
+	return fd;
+}
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg)
+{
+	return 0;
+}
+
+static const struct socket_dns_offload mock_socket_dns_offload_ops = {
+	.getaddrinfo = mock_socket_offload_getaddrinfo,
+	.freeaddrinfo = mock_socket_offload_freeaddrinfo,
+};
+
+void mock_socket_iface_init(struct net_if *iface)
+{
+	mock_socket_iface_data.iface = iface;
+
+	iface->if_dev->socket_offload = mock_socket_create;
+
+	socket_offload_dns_register(&mock_socket_dns_offload_ops);
+}
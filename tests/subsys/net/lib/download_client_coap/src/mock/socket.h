@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef _SOCKET_H_
+#define _SOCKET_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap.h>
+
+extern struct mock_socket_iface_data mock_socket_iface_data;
+extern struct net_if_api mock_if_api;
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg);
+bool mock_socket_is_supported(int family, int type, int proto);
+int mock_socket_create(int family, int type, int proto);
+
+/** Statistics of the CoAP server stand-in. */
+struct mock_coap_server_stats {
+	/** Number of requests received, including the lost ones. */
+	int requests;
+	/** Number of requests that were lost. */
+	int lost;
+	/** Highest number of responses on their way at once. */
+	int in_flight_max;
+	/** Smallest block size requested, in bytes. */
+	int block_size_min;
+};
+
+/**
+ * Reset the CoAP server stand-in. The stand-in serves a file of
+ * @p file_size bytes, whose byte at offset n is mock_coap_server_byte(n),
+ * in blocks of at most @p block_size_max.
+ * Responses are sent @p latency_ms milliseconds after their request,
+ * and @p loss_percent of the requests are lost.
+ */
+void mock_coap_server_reset(size_t file_size, enum coap_block_size block_size_max,
+			    int latency_ms, int loss_percent);
+
+uint8_t mock_coap_server_byte(size_t off);
+
+void mock_coap_server_stats_get(struct mock_coap_server_stats *stats);
+
+#endif /* _SOCKET_H_ */
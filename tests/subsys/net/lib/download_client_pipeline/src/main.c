@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket_offload.h>
+
+#include <zephyr/ztest.h>
+#include <download_client.h>
+
+#include "mock/socket.h"
+
+#define TEST_HOST "http://10.1.0.10"
+#define TEST_FILE "large.bin"
+
+/* 32 fragments of CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE bytes, the last one incomplete */
+#define TEST_FILE_SIZE (31 * CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE + 100)
+
+/* Round-trip time of the server stand-in, as on an LTE-M link */
+#define TEST_LATENCY_MS 200
+
+static struct download_client client;
+static K_SEM_DEFINE(download_done, 0, 1);
+
+static struct {
+	size_t received;
+	int fragments;
+	int errors;
+	/* Refuse the fragment with this number, if set */
+	int refuse_fragment;
+} dl;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		/* The fragments are received in order */
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			zassert_equal(((const uint8_t *)event->fragment.buf)[i],
+				      mock_http_server_byte(dl.received + i),
+				      "Wrong byte at offset %zu", dl.received + i);
+		}
+
+		dl.received += event->fragment.len;
+		dl.fragments++;
+
+		if (dl.fragments == dl.refuse_fragment) {
+			k_sem_give(&download_done);
+			return -1;
+		}
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done);
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		dl.errors++;
+		k_sem_give(&download_done);
+		/* Stop the download */
+		return -1;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+static void host_set(uint8_t pipeline_depth)
+{
+	int err;
+	const struct download_client_cfg config = {
+		.http_pipeline_depth = pipeline_depth,
+	};
+
+	err = download_client_set_host(&client, TEST_HOST, &config);
+	zassert_ok(err, NULL);
+}
+
+/* Download the test file and return the time it took, in milliseconds */
+static int64_t download(size_t from)
+{
+	int err;
+	int64_t start;
+	int64_t duration;
+
+	start = k_uptime_get();
+
+	err = download_client_start(&client, TEST_FILE, from);
+	zassert_ok(err, NULL);
+
+	zassert_ok(k_sem_take(&download_done, K_SECONDS(60)), "Download did not finish");
+
+	duration = k_uptime_get() - start;
+
+	/* Let the download thread finish */
+	k_sleep(K_MSEC(100));
+
+	return duration;
+}
+
+static void *suite_setup(void)
+{
+	int err;
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_ok(err, NULL);
+
+	return NULL;
+}
+
+static void test_before(void *fixture)
+{
+	memset(&dl, 0, sizeof(dl));
+	k_sem_reset(&download_done);
+	mock_http_server_reset(TEST_FILE_SIZE, TEST_LATENCY_MS);
+}
+
+static void test_after(void *fixture)
+{
+	zassert_ok(download_client_disconnect(&client), NULL);
+
+	/* Let the download thread close the socket */
+	k_sleep(K_MSEC(100));
+}
+
+ZTEST_SUITE(download_client_pipeline, NULL, suite_setup, test_before, test_after, NULL);
+
+ZTEST(download_client_pipeline, test_pipelined_download_is_faster)
+{
+	int64_t baseline;
+	int64_t pipelined;
+	struct mock_http_server_stats stats;
+
+	host_set(1);
+	baseline = download(0);
+
+	zassert_equal(dl.received, TEST_FILE_SIZE, NULL);
+	mock_http_server_stats_get(&stats);
+	zassert_equal(stats.in_flight_max, 1, NULL);
+
+	test_after(NULL);
+	test_before(NULL);
+
+	host_set(4);
+	pipelined = download(0);
+
+	zassert_equal(dl.received, TEST_FILE_SIZE, NULL);
+	zassert_equal(dl.errors, 0, NULL);
+
+	mock_http_server_stats_get(&stats);
+	zassert_equal(stats.connects, 1, NULL);
+	zassert_equal(stats.requests, dl.fragments, NULL);
+	zassert_equal(stats.in_flight_max, 4, NULL);
+
+	printk("Downloaded %d bytes with %d ms latency: %lld ms sequential, "
+	       "%lld ms with 4 requests in flight\n",
+	       TEST_FILE_SIZE, TEST_LATENCY_MS, baseline, pipelined);
+
+	/* After the first fragment, the round trips of four fragments overlap */
+	zassert_true(pipelined < baseline / 2, NULL);
+}
+
+ZTEST(download_client_pipeline, test_resume_with_requests_in_flight)
+{
+	size_t progress;
+	struct mock_http_server_stats stats;
+
+	/* Stop while the responses to the following fragments are on their way */
+	dl.refuse_fragment = 5;
+
+	host_set(8);
+	download(0);
+
+	progress = dl.received;
+	zassert_equal(progress, 5 * CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE, NULL);
+
+	/* The responses to the pending requests are not taken for the new ones */
+	dl.refuse_fragment = 0;
+
+	download(progress);
+
+	zassert_equal(dl.received, TEST_FILE_SIZE, NULL);
+	zassert_equal(dl.errors, 0, NULL);
+
+	mock_http_server_stats_get(&stats);
+	zassert_equal(stats.connects, 2, NULL);
+}
+
+#define TEST_SOCKET_PRIO 40
+NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
+		    mock_socket_create);
+NET_DEVICE_OFFLOAD_INIT(mock_socket, "mock_socket", mock_nrf_modem_lib_socket_offload_init, NULL,
+			&mock_socket_iface_data, NULL, 0, &mock_if_api, 1280);
@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/net/socket_offload.h>
+#include <sockets_internal.h>
+#include <stdio.h>
+#include <zephyr/ztest.h>
+
+#include "mock/socket.h"
+
+void mock_socket_iface_init(struct net_if *iface);
+
+struct mock_socket_iface_data {
+	struct net_if *iface;
+} mock_socket_iface_data;
+
+struct net_if_api mock_if_api = {
+	.init = mock_socket_iface_init,
+};
+
+/* HTTP server stand-in. Each Range request is answered after a fixed
+ * latency, and the responses are streamed back to back, as they would be
+ * on a TCP connection.
+ */
+#define RESPONSES_MAX 16
+
+struct response {
+	int64_t ready_at;
+	size_t from;
+	size_t to;
+};
+
+static struct {
+	size_t file_size;
+	int latency_ms;
+	struct response responses[RESPONSES_MAX];
+	size_t head;
+	size_t count;
+	/* Header of the response at the head of the queue */
+	char header[128];
+	size_t header_len;
+	/* Number of bytes of that response which have been received */
+	size_t pos;
+	struct mock_http_server_stats stats;
+} server;
+
+void mock_http_server_reset(size_t file_size, int latency_ms)
+{
+	memset(&server, 0, sizeof(server));
+	server.file_size = file_size;
+	server.latency_ms = latency_ms;
+}
+
+uint8_t mock_http_server_byte(size_t off)
+{
+	return (uint8_t)(off % 251);
+}
+
+void mock_http_server_stats_get(struct mock_http_server_stats *stats)
+{
+	*stats = server.stats;
+}
+
+static void server_connection_reset(void)
+{
+	server.head = 0;
+	server.count = 0;
+	server.pos = 0;
+}
+
+static ssize_t server_request_receive(const char *buf, size_t len)
+{
+	char req[256];
+	const char *range;
+	struct response *rsp;
+
+	zassert_true(len < sizeof(req), "Request too long");
+	memcpy(req, buf, len);
+	req[len] = '\0';
+
+	/* Only complete requests are sent */
+	zassert_not_null(strstr(req, "\r\n\r\n"), "Incomplete request");
+
+	range = strstr(req, "Range: bytes=");
+	zassert_not_null(range, "Not a Range request");
+	zassert_true(server.count < RESPONSES_MAX, "Too many requests in flight");
+
+	rsp = &server.responses[(server.head + server.count) % RESPONSES_MAX];
+	zassert_equal(sscanf(range, "Range: bytes=%zu-%zu", &rsp->from, &rsp->to), 2, NULL);
+	zassert_true(rsp->from <= rsp->to && rsp->to < server.file_size, "Invalid range");
+	rsp->ready_at = k_uptime_get() + server.latency_ms;
+
+	server.count++;
+	server.stats.requests++;
+	server.stats.in_flight_max = MAX(server.stats.in_flight_max, server.count);
+
+	return len;
+}
+
+static ssize_t server_response_send(uint8_t *buf, size_t len)
+{
+	struct response *rsp;
+	size_t total;
+	size_t idx;
+	size_t copied = 0;
+
+	while (copied < len && server.count > 0) {
+		rsp = &server.responses[server.head];
+
+		if (rsp->ready_at > k_uptime_get()) {
+			if (copied) {
+				/* Return what is available */
+				break;
+			}
+			k_sleep(K_TIMEOUT_ABS_MS(rsp->ready_at));
+		}
+
+		if (server.pos == 0) {
+			server.header_len = snprintf(server.header, sizeof(server.header),
+				"HTTP/1.1 206 Partial Content\r\n"
+				"Content-Range: bytes %zu-%zu/%zu\r\n"
+				"Content-Length: %zu\r\n"
+				"\r\n",
+				rsp->from, rsp->to, server.file_size, rsp->to - rsp->from + 1);
+		}
+
+		total = server.header_len + rsp->to - rsp->from + 1;
+
+		for (; server.pos < total && copied < len; server.pos++, copied++) {
+			idx = server.pos;
+			if (idx < server.header_len) {
+				buf[copied] = server.header[idx];
+			} else {
+				buf[copied] = mock_http_server_byte(rsp->from + idx - server.header_len);
+			}
+		}
+
+		if (server.pos == total) {
+			server.head = (server.head + 1) % RESPONSES_MAX;
+			server.count--;
+			server.pos = 0;
+		}
+	}
+
+	if (copied == 0) {
+		/* Nothing was requested, so nothing will arrive */
+		errno = EAGAIN;
+		return -1;
+	}
+
+	return copied;
+}
+
+static ssize_t mock_socket_offload_recvfrom(void *obj, void *buf, size_t len, int flags,
+					    struct sockaddr *from, socklen_t *fromlen)
+{
+	return server_response_send(buf, len);
+}
+
+static ssize_t mock_socket_offload_read(void *obj, void *buffer, size_t count)
+{
+	return mock_socket_offload_recvfrom(obj, buffer, count, 0, NULL, 0);
+}
+
+static ssize_t mock_socket_offload_sendto(void *obj, const void *buf, size_t len, int flags,
+					  const struct sockaddr *to, socklen_t tolen)
+{
+	return server_request_receive(buf, len);
+}
+
+static ssize_t mock_socket_offload_write(void *obj, const void *buffer, size_t count)
+{
+	return mock_socket_offload_sendto(obj, buffer, count, 0, NULL, 0);
+}
+
+static int mock_socket_offload_close(void *obj)
+{
+	server_connection_reset();
+	return zsock_close_ctx(obj);
+}
+
+static int mock_socket_offload_ioctl(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		return -EXDEV;
+
+	case ZFD_IOCTL_POLL_UPDATE:
+		return -EOPNOTSUPP;
+
+	default:
+		return 0;
+	}
+}
+
+static int mock_socket_offload_bind(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	return 0;
+}
+
+static int mock_socket_offload_connect(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	/* A TCP handshake takes a round trip */
+	k_sleep(K_MSEC(server.latency_ms));
+
+	server_connection_reset();
+	server.stats.connects++;
+
+	return 0;
+}
+
+static int mock_socket_offload_listen(void *obj, int backlog)
+{
+	return 0;
+}
+
+static int mock_socket_offload_accept(void *obj, struct sockaddr *addr, socklen_t *addrlen)
+{
+	return 0;
+}
+
+static ssize_t mock_socket_offload_sendmsg(void *obj, const struct msghdr *msg, int flags)
+{
+	return 0;
+}
+
+static int mock_socket_offload_setsockopt(void *obj, int level, int optname, const void *optval,
+					  socklen_t optlen)
+{
+	return 0;
+}
+
+static int mock_socket_offload_getsockopt(void *obj, int level, int optname, void *optval,
+					  socklen_t *optlen)
+{
+	return 0;
+}
+
+static const struct socket_op_vtable mock_socket_fd_op_vtable = {
+	.fd_vtable = {
+		.read = mock_socket_offload_read,
+		.write = mock_socket_offload_write,
+		.close = mock_socket_offload_close,
+		.ioctl = mock_socket_offload_ioctl,
+	},
+	.bind = mock_socket_offload_bind,
+	.connect = mock_socket_offload_connect,
+	.listen = mock_socket_offload_listen,
+	.accept = mock_socket_offload_accept,
+	.sendto = mock_socket_offload_sendto,
+	.sendmsg = mock_socket_offload_sendmsg,
+	.recvfrom = mock_socket_offload_recvfrom,
+	.getsockopt = mock_socket_offload_getsockopt,
+	.setsockopt = mock_socket_offload_setsockopt,
+};
+
+/**
+ * There is no support for dns lookup, node has to be a valid ip address
+ * that is parseable via net_ipaddr_parse
+ */
+static int mock_socket_offload_getaddrinfo(const char *node, const char *service,
+					   const struct zsock_addrinfo *hints,
+					   struct zsock_addrinfo **res)
+{
+	struct sockaddr_in *ai_addr;
+	struct zsock_addrinfo *ai;
+	unsigned long port = 0;
+
+	if (!node) {
+		return -1;
+	}
+
+	if (service) {
+		port = strtol(service, NULL, 10);
+		if (port < 1 || port > USHRT_MAX) {
+			return -1;
+		}
+	}
+
+	if (!res) {
+		return -1;
+	}
+
+	if (hints && hints->ai_family != AF_INET) {
+		return -1;
+	}
+
+	*res = calloc(1, sizeof(struct zsock_addrinfo));
+	ai = *res;
+	if (!ai) {
+		return -1;
+	}
+
+	ai_addr = calloc(1, sizeof(*ai_addr));
+	if (!ai_addr) {
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_family = AF_INET;
+	ai->ai_socktype = hints ? hints->ai_socktype : SOCK_STREAM;
+	ai->ai_protocol = ai->ai_socktype == SOCK_STREAM ? IPPROTO_TCP : IPPROTO_UDP;
+
+	ai_addr->sin_family = ai->ai_family;
+	ai_addr->sin_port = htons(port);
+
+	if (!net_ipaddr_parse(node, strlen(node), (struct sockaddr *)ai_addr)) {
+		free(ai_addr);
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_addrlen = sizeof(*ai_addr);
+	ai->ai_addr = (struct sockaddr *)ai_addr;
+
+	return 0;
+}
+
+static void mock_socket_offload_freeaddrinfo(struct zsock_addrinfo *res)
+{
+	__ASSERT_NO_MSG(res);
+
+	free(res->ai_addr);
+	free(res);
+}
+
+bool mock_socket_is_supported(int family, int type, int proto)
+{
+	return true;
+}
+
+int mock_socket_create(int family, int type, int proto)
+{
+	int fd = z_reserve_fd();
+	struct net_context *ctx;
+	int res;
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	if (proto == 0) {
+		if (family == AF_INET || family == AF_INET6) {
+			if (type == SOCK_DGRAM) {
+				proto = IPPROTO_UDP;
+			} else if (type == SOCK_STREAM) {
+				proto = IPPROTO_TCP;
+			}
+		}
+	}
+
+	res = net_context_get(family, type, proto, &ctx);
+	if (res < 0) {
+		z_free_fd(fd);
+		errno = -res;
+		return -1;
+	}
+
+	/* Initialize user_data, all other calls will preserve it */
+	ctx->user_data = NULL;
+
+	/* The socket flags are stored here */
+	ctx->socket_data = NULL;
+
+	/* recv_q and accept_q are in union */
+	k_fifo_init(&ctx->recv_q);
+
+	/* Condition variable is used to avoid keeping lock for a long time
+	 * when waiting data to be received
+	 */
+	k_condvar_init(&ctx->cond.recv);
+
+	/* TCP context is effectively owned by both application
+	 * and the stack: stack may detect that peer closed/aborted
+	 * connection, but it must not dispose of the context behind
+	 * the application back. Likewise, when application "closes"
+	 * context, it's not disposed of immediately - there's yet
+	 * closing handshake for stack to perform.
+	 */
+	if (proto == IPPROTO_TCP) {
+		net_context_ref(ctx);
+	}
+
+	z_finalize_fd(fd, ctx, (const struct fd_op_vtable *)&mock_socket_fd_op_vtable);
+
+	return fd;
+}
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg)
+{
+	return 0;
+}
+
+static const struct socket_dns_offload mock_socket_dns_offload_ops = {
+	.getaddrinfo = mock_socket_offload_getaddrinfo,
+	.freeaddrinfo = mock_socket_offload_freeaddrinfo,
+};
+
+void mock_socket_iface_init(struct net_if *iface)
+{
+	mock_socket_iface_data.iface = iface;
+
+	iface->if_dev->socket_offload = mock_socket_create;
+
+	socket_offload_dns_register(&mock_socket_dns_offload_ops);
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef _SOCKET_H_
+#define _SOCKET_H_
+
+#include <zephyr/kernel.h>
+
+extern struct mock_socket_iface_data mock_socket_iface_data;
+extern struct net_if_api mock_if_api;
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg);
+bool mock_socket_is_supported(int family, int type, int proto);
+int mock_socket_create(int family, int type, int proto);
+
+/** Statistics of the HTTP server stand-in. */
+struct mock_http_server_stats {
+	/** Number of connections. */
+	int connects;
+	/** Number of Range requests received. */
+	int requests;
+	/** Highest number of requests in flight at once. */
+	int in_flight_max;
+};
+
+/**
+ * Reset the HTTP server stand-in. The stand-in serves a file of
+ * @p file_size bytes, whose byte at offset n is mock_http_server_byte(n).
+ * Responses are sent @p latency_ms milliseconds after their request.
+ */
+void mock_http_server_reset(size_t file_size, int latency_ms);
+
+uint8_t mock_http_server_byte(size_t off);
+
+void mock_http_server_stats_get(struct mock_http_server_stats *stats);
+
+#endif /* _SOCKET_H_ */
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <net/icalendar_parser.h>
+
+/* Size of the calendar in the benchmark, and of the chunks it is parsed in. */
+#define BENCHMARK_CALENDAR_SIZE	(4 * 1024 * 1024)
+#define BENCHMARK_CHUNK_SIZE	64
+
+/* Every ATTACHMENT_INTERVAL event has an attachment longer than the line buffer. */
+#define ATTACHMENT_INTERVAL	16
+#define ATTACHMENT_SIZE		(2 * CONFIG_ICAL_PARSER_MAX_PROPERTY_SIZE)
+
+/* Maximum length of a content line before it is folded. */
+#define LINE_LEN_MAX		75
+
+#define CALENDAR_HEADER		"BEGIN:VCALENDAR\r\n" \
+				"VERSION:2.0\r\n" \
+				"PRODID:-//Nordic Semiconductor//icalendar_parser test//EN\r\n" \
+				"BEGIN:VTIMEZONE\r\n" \
+				"TZID:Europe/Oslo\r\n" \
+				"BEGIN:STANDARD\r\n" \
+				"DTSTART:19701025T030000\r\n" \
+				"TZOFFSETFROM:+0200\r\n" \
+				"TZOFFSETTO:+0100\r\n" \
+				"END:STANDARD\r\n" \
+				"END:VTIMEZONE\r\n"
+#define CALENDAR_FOOTER		"END:VCALENDAR\r\n"
+
+/* Largest component generated, including the folded attachment. */
+#define COMPONENT_SIZE_MAX	(2 * ATTACHMENT_SIZE + 1024)
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+static struct icalendar_parser ical;
+
+/* Calendar generator, which produces the calendar piece by piece, so that it does not have to be
+ * kept in memory.
+ */
+static struct {
+	char buf[COMPONENT_SIZE_MAX];
+	size_t len;
+	size_t offset;
+	/* Number of events to generate, or zero to generate until the size is reached. */
+	int event_count;
+	size_t size;
+	size_t generated;
+	int next_event;
+	bool footer_done;
+} cal;
+
+/* Parsed events */
+static int events_parsed;
+static int timezones_parsed;
+static int event_errors;
+static int stop_at_event;
+
+/* Append a content line, folded as described in RFC 5545 3.1 Content Lines. */
+static size_t contentline_append(char *buf, const char *line)
+{
+	size_t len = strlen(line);
+	size_t written = 0;
+
+	for (size_t i = 0; i < len; i += LINE_LEN_MAX - 1) {
+		if (i > 0) {
+			memcpy(buf + written, "\r\n ", 3);
+			written += 3;
+		}
+
+		memcpy(buf + written, line + i, MIN(len - i, LINE_LEN_MAX - 1));
+		written += MIN(len - i, LINE_LEN_MAX - 1);
+	}
+
+	memcpy(buf + written, "\r\n", 2);
+
+	return written + 2;
+}
+
+static void event_expected_get(int n, struct ical_component *com)
+{
+	snprintf(com->summary, sizeof(com->summary), "Meeting %d", n);
+	snprintf(com->location, sizeof(com->location), "Room %d", n % 10);
+	snprintf(com->description, sizeof(com->description),
+		 "Event %d description, long enough to be folded over more than one content line.",
+		 n);
+	snprintf(com->dtstart, sizeof(com->dtstart), "2023%02u%02uT10%02u00",
+		 1 + (unsigned int)n % 12, 1 + (unsigned int)n % 28, (unsigned int)n % 60);
+	snprintf(com->dtend, sizeof(com->dtend), "2023%02u%02uT11%02u00",
+		 1 + (unsigned int)n % 12, 1 + (unsigned int)n % 28, (unsigned int)n % 60);
+}
+
+static size_t event_generate(int n, char *buf)
+{
+	struct ical_component com;
+	static char line[ATTACHMENT_SIZE + 64];
+	size_t len = 0;
+
+	event_expected_get(n, &com);
+
+	len += contentline_append(buf + len, "BEGIN:VEVENT");
+	snprintf(line, sizeof(line), "UID:event-%d@example.com", n);
+	len += contentline_append(buf + len, line);
+	len += contentline_append(buf + len, "DTSTAMP:20230101T000000Z");
+	snprintf(line, sizeof(line), "DTSTART;TZID=\"Europe/Oslo\":%s", com.dtstart);
+	len += contentline_append(buf + len, line);
+	snprintf(line, sizeof(line), "DTEND;TZID=Europe/Oslo:%s", com.dtend);
+	len += contentline_append(buf + len, line);
+	snprintf(line, sizeof(line), "SUMMARY:%s", com.summary);
+	len += contentline_append(buf + len, line);
+	snprintf(line, sizeof(line), "LOCATION:%s", com.location);
+	len += contentline_append(buf + len, line);
+	snprintf(line, sizeof(line), "DESCRIPTION:%s", com.description);
+	len += contentline_append(buf + len, line);
+
+	if (n % ATTACHMENT_INTERVAL == 0) {
+		size_t attach_len = snprintf(line, sizeof(line),
+					     "ATTACH;ENCODING=BASE64;VALUE=BINARY:");
+
+		memset(line + attach_len, 'A', ATTACHMENT_SIZE);
+		line[attach_len + ATTACHMENT_SIZE] = '\0';
+		len += contentline_append(buf + len, line);
+	}
+
+	/* The description of the alarm does not replace the one of the event */
+	len += contentline_append(buf + len, "BEGIN:VALARM");
+	len += contentline_append(buf + len, "ACTION:DISPLAY");
+	len += contentline_append(buf + len, "DESCRIPTION:Reminder");
+	len += contentline_append(buf + len, "TRIGGER:-PT15M");
+	len += contentline_append(buf + len, "END:VALARM");
+	len += contentline_append(buf + len, "END:VEVENT");
+
+	return len;
+}
+
+static void calendar_open(int event_count, size_t size)
+{
+	memset(&cal, 0, sizeof(cal));
+	cal.event_count = event_count;
+	cal.size = size;
+
+	strcpy(cal.buf, CALENDAR_HEADER);
+	cal.len = strlen(CALENDAR_HEADER);
+}
+
+static bool calendar_events_done(void)
+{
+	if (cal.event_count) {
+		return cal.next_event >= cal.event_count;
+	}
+
+	return cal.generated >= cal.size;
+}
+
+/* Read the next len bytes of the calendar. Return the number of bytes read. */
+static size_t calendar_read(char *buf, size_t len)
+{
+	size_t read = 0;
+
+	while (read < len) {
+		size_t copy_len;
+
+		if (cal.offset == cal.len) {
+			cal.offset = 0;
+
+			if (!calendar_events_done()) {
+				cal.len = event_generate(cal.next_event++, cal.buf);
+			} else if (!cal.footer_done) {
+				strcpy(cal.buf, CALENDAR_FOOTER);
+				cal.len = strlen(CALENDAR_FOOTER);
+				cal.footer_done = true;
+			} else {
+				cal.len = 0;
+				break;
+			}
+		}
+
+		copy_len = MIN(len - read, cal.len - cal.offset);
+		memcpy(buf + read, cal.buf + cal.offset, copy_len);
+		cal.offset += copy_len;
+		cal.generated += copy_len;
+		read += copy_len;
+	}
+
+	return read;
+}
+
+/* Parse the whole calendar in chunks of the given size. */
+static void calendar_parse(size_t chunk_size)
+{
+	static char chunk[BENCHMARK_CHUNK_SIZE * 16];
+	size_t len;
+
+	TEST_ASSERT_LESS_OR_EQUAL(sizeof(chunk), chunk_size);
+
+	while ((len = calendar_read(chunk, chunk_size)) > 0) {
+		TEST_ASSERT_EQUAL(len, ical_parser_parse(&ical, chunk, len));
+	}
+}
+
+static int ical_parser_callback(const struct ical_parser_evt *event)
+{
+	struct ical_component expected;
+
+	if (event->id == ICAL_EVT_VTIMEZONE) {
+		TEST_ASSERT_EQUAL(ICAL_ERROR_COM_NOT_SUPPORTED, event->error);
+		timezones_parsed++;
+		return 0;
+	}
+
+	TEST_ASSERT_EQUAL(ICAL_EVT_VEVENT, event->id);
+
+	if (event->error != ICAL_ERROR_NONE) {
+		event_errors++;
+		events_parsed++;
+		return 0;
+	}
+
+	event_expected_get(events_parsed, &expected);
+
+	TEST_ASSERT_EQUAL_STRING(expected.summary, event->ical_com.summary);
+	TEST_ASSERT_EQUAL_STRING(expected.location, event->ical_com.location);
+	TEST_ASSERT_EQUAL_STRING(expected.description, event->ical_com.description);
+	TEST_ASSERT_EQUAL_STRING(expected.dtstart, event->ical_com.dtstart);
+	TEST_ASSERT_EQUAL_STRING(expected.dtend, event->ical_com.dtend);
+
+	events_parsed++;
+
+	return events_parsed == stop_at_event;
+}
+
+void setUp(void)
+{
+	TEST_ASSERT_EQUAL(0, ical_parser_init(&ical, ical_parser_callback));
+
+	events_parsed = 0;
+	timezones_parsed = 0;
+	event_errors = 0;
+	stop_at_event = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_init_invalid_arguments(void)
+{
+	TEST_ASSERT_EQUAL(-EINVAL, ical_parser_init(NULL, ical_parser_callback));
+	TEST_ASSERT_EQUAL(-EINVAL, ical_parser_init(&ical, NULL));
+}
+
+void test_calendar_parsed(void)
+{
+	calendar_open(ATTACHMENT_INTERVAL + 1, 0);
+	calendar_parse(BENCHMARK_CHUNK_SIZE);
+
+	TEST_ASSERT_EQUAL(ATTACHMENT_INTERVAL + 1, events_parsed);
+	TEST_ASSERT_EQUAL(1, timezones_parsed);
+	TEST_ASSERT_EQUAL(0, event_errors);
+}
+
+/* Split the calendar at every possible point within content lines and line breaks. */
+void test_any_chunk_boundaries(void)
+{
+	for (size_t chunk_size = 1; chunk_size <= 2 * LINE_LEN_MAX; chunk_size++) {
+		setUp();
+
+		calendar_open(3, 0);
+		calendar_parse(chunk_size);
+
+		TEST_ASSERT_EQUAL(3, events_parsed);
+		TEST_ASSERT_EQUAL(1, timezones_parsed);
+		TEST_ASSERT_EQUAL(0, event_errors);
+	}
+}
+
+void test_event_sent_on_end_line(void)
+{
+	char c;
+	static char event[COMPONENT_SIZE_MAX];
+	size_t event_len;
+	const char *end;
+
+	TEST_ASSERT_EQUAL(strlen(CALENDAR_HEADER),
+			  ical_parser_parse(&ical, CALENDAR_HEADER, strlen(CALENDAR_HEADER)));
+
+	event_len = event_generate(0, event);
+	end = event + event_len;
+
+	/* The event is not sent until the last byte of END:VEVENT\r\n is parsed */
+	for (const char *p = event; p < end; p++) {
+		c = *p;
+		TEST_ASSERT_EQUAL(1, ical_parser_parse(&ical, &c, 1));
+
+		if (p < end - 1) {
+			TEST_ASSERT_EQUAL(0, events_parsed);
+		}
+	}
+
+	TEST_ASSERT_EQUAL(1, events_parsed);
+	TEST_ASSERT_EQUAL(0, event_errors);
+}
+
+void test_callback_stops_parsing(void)
+{
+	static char buf[2 * COMPONENT_SIZE_MAX];
+	size_t len;
+	size_t parsed;
+	size_t first_len;
+
+	calendar_open(2, 0);
+	len = calendar_read(buf, sizeof(buf) - 1);
+	buf[len] = '\0';
+
+	first_len = strstr(buf, "END:VEVENT\r\n") + strlen("END:VEVENT\r\n") - buf;
+
+	stop_at_event = 1;
+	parsed = ical_parser_parse(&ical, buf, len);
+
+	/* Parsing stops right after the first event */
+	TEST_ASSERT_EQUAL(first_len, parsed);
+	TEST_ASSERT_EQUAL(1, events_parsed);
+
+	/* and continues with the remaining data */
+	TEST_ASSERT_EQUAL(len - parsed, ical_parser_parse(&ical, buf + parsed, len - parsed));
+	TEST_ASSERT_EQUAL(2, events_parsed);
+}
+
+void test_property_overflow(void)
+{
+	char line[CONFIG_ICAL_PARSER_SUMMARY_SIZE + 32];
+	char event[2 * CONFIG_ICAL_PARSER_SUMMARY_SIZE + 64];
+	size_t len = 0;
+
+	memset(line, 0, sizeof(line));
+	strcpy(line, "SUMMARY:");
+	memset(line + strlen(line), 'S', sizeof(line) - strlen(line) - 1);
+
+	len += contentline_append(event + len, "BEGIN:VEVENT");
+	len += contentline_append(event + len, line);
+	len += contentline_append(event + len, "END:VEVENT");
+
+	TEST_ASSERT_EQUAL(strlen(CALENDAR_HEADER),
+			  ical_parser_parse(&ical, CALENDAR_HEADER, strlen(CALENDAR_HEADER)));
+	TEST_ASSERT_EQUAL(len, ical_parser_parse(&ical, event, len));
+
+	TEST_ASSERT_EQUAL(1, events_parsed);
+	TEST_ASSERT_EQUAL(1, event_errors);
+}
+
+void test_benchmark(void)
+{
+	int64_t start;
+	int64_t duration;
+
+	calendar_open(0, BENCHMARK_CALENDAR_SIZE);
+
+	start = k_uptime_get();
+	calendar_parse(BENCHMARK_CHUNK_SIZE);
+	duration = k_uptime_get() - start;
+
+	printk("Parsed %d events, %zu bytes in chunks of %d bytes, in %lld ms\n",
+	       events_parsed, cal.generated, BENCHMARK_CHUNK_SIZE, duration);
+	printk("Parser instance: %zu bytes, largest component: %d bytes\n",
+	       sizeof(ical), COMPONENT_SIZE_MAX);
+
+	TEST_ASSERT_EQUAL(cal.next_event, events_parsed);
+	TEST_ASSERT_EQUAL(0, event_errors);
+
+	/* The memory used does not depend on the size of the calendar or of its components */
+	TEST_ASSERT_LESS_THAN(COMPONENT_SIZE_MAX, sizeof(ical));
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -33,6 +33,9 @@
 #define TEST_PAYLOAD		"This is a test payload"
 #define TEST_PAYLOAD_LEN	(sizeof(TEST_PAYLOAD) - 1)
 
+/* Payload that is delivered in three chunks, the last one shorter than the payload buffer. */
+#define TEST_LARGE_PAYLOAD_LEN	(2 * CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN + 100)
+
 /* Pull in variables and functions from the MQTT helper library. */
 extern struct mqtt_client mqtt_client;
 extern enum mqtt_state mqtt_state;
@@ -60,6 +63,11 @@ static K_SEM_DEFINE(suback_sem, 0, 1);
 static K_SEM_DEFINE(publish_sem, 0, 1);
 static K_SEM_DEFINE(error_msg_size_sem, 0, 1);
 
+/* Number of payload bytes read by the stub, and the chunks received by the application. */
+static size_t payload_bytes_read;
+static size_t payload_chunks_received;
+static int payload_chunk_return;
+
 void setUp(void)
 {
 	__cmock_mqtt_keepalive_time_left_IgnoreAndReturn(0);
@@ -80,6 +88,22 @@ static int mqtt_readall_publish_payload_stub(struct mqtt_client *client, uint8_t
 	return 0;
 }
 
+/* Fills the buffer with a pattern that depends on the offset in the payload. */
+static int mqtt_readall_publish_payload_large_stub(struct mqtt_client *client, uint8_t *buffer,
+						   size_t length, int num_calls)
+{
+	TEST_ASSERT_LESS_OR_EQUAL(CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN, length);
+	TEST_ASSERT_LESS_OR_EQUAL(TEST_LARGE_PAYLOAD_LEN, payload_bytes_read + length);
+
+	for (size_t i = 0; i < length; i++) {
+		buffer[i] = (uint8_t)(payload_bytes_read + i);
+	}
+
+	payload_bytes_read += length;
+
+	return 0;
+}
+
 static int poll_stub_pollin(struct pollfd *fds, int nfds, int timeout, int num_calls)
 {
 	fds[0].revents = fds[0].events & POLLIN;
@@ -180,6 +204,30 @@ static void cb_on_publish(struct mqtt_helper_buf topic, struct mqtt_helper_buf p
 	k_sem_give(&publish_sem);
 }
 
+static int cb_on_publish_chunk(struct mqtt_helper_buf topic,
+			       const struct mqtt_helper_payload_chunk *chunk)
+{
+	TEST_ASSERT_EQUAL(TEST_TOPIC_1_LEN, topic.size);
+	TEST_ASSERT_EQUAL_MEMORY(TEST_TOPIC_1, topic.ptr, TEST_TOPIC_1_LEN);
+	TEST_ASSERT_EQUAL(TEST_LARGE_PAYLOAD_LEN, chunk->total_len);
+	TEST_ASSERT_EQUAL(payload_chunks_received * CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN,
+			  chunk->offset);
+	TEST_ASSERT_EQUAL(MIN(CONFIG_MQTT_HELPER_PAYLOAD_BUFFER_LEN,
+			      TEST_LARGE_PAYLOAD_LEN - chunk->offset), chunk->buf.size);
+
+	for (size_t i = 0; i < chunk->buf.size; i++) {
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(chunk->offset + i), chunk->buf.ptr[i]);
+	}
+
+	payload_chunks_received++;
+
+	if (chunk->offset + chunk->buf.size == chunk->total_len) {
+		k_sem_give(&publish_sem);
+	}
+
+	return payload_chunk_return;
+}
+
 static void cb_on_connack(enum mqtt_conn_return_code return_code)
 {
 	switch (return_code) {
@@ -393,6 +441,87 @@ void test_on_publish_too_large_incoming_msg(void)
 	TEST_ASSERT_EQUAL(0, k_sem_take(&error_msg_size_sem, K_SECONDS(1)));
 }
 
+static void publish_chunked_init(mqtt_helper_on_publish_chunk_t on_publish_chunk)
+{
+	struct mqtt_helper_cfg cfg = {
+		.cb = {
+			.on_connack = cb_on_connack,
+			.on_disconnect = cb_on_disconnect,
+			.on_publish = cb_on_publish,
+			.on_publish_chunk = on_publish_chunk,
+			.on_puback = cb_on_puback,
+			.on_suback = cb_on_suback,
+			.on_error = cb_on_error,
+		},
+	};
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+
+	payload_bytes_read = 0;
+	payload_chunks_received = 0;
+	payload_chunk_return = 0;
+}
+
+static void send_large_publish_event(void)
+{
+	struct mqtt_evt evt = {
+		.type = MQTT_EVT_PUBLISH,
+		.param.publish.message_id = TEST_MESSAGE_ID,
+		.param.publish.message = {
+			.topic = {
+				.topic = {
+					.utf8 = TEST_TOPIC_1,
+					.size = TEST_TOPIC_1_LEN,
+				},
+				.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+			},
+			.payload = {
+				.len = TEST_LARGE_PAYLOAD_LEN,
+			},
+		}
+	};
+
+	mqtt_evt_handler(&mqtt_client, &evt);
+}
+
+void test_on_publish_chunked_large_incoming_msg(void)
+{
+	publish_chunked_init(cb_on_publish_chunk);
+
+	__cmock_mqtt_readall_publish_payload_Stub(mqtt_readall_publish_payload_large_stub);
+	__cmock_mqtt_publish_qos1_ack_ExpectAnyArgsAndReturn(0);
+
+	send_large_publish_event();
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&publish_sem, K_SECONDS(1)));
+	TEST_ASSERT_EQUAL(3, payload_chunks_received);
+	TEST_ASSERT_EQUAL(TEST_LARGE_PAYLOAD_LEN, payload_bytes_read);
+
+	/* Restore the default callbacks. */
+	publish_chunked_init(NULL);
+}
+
+/* The test verifies that the rest of the payload is read, but not delivered, if the application
+ * stops consuming it, and that the message is still acknowledged.
+ */
+void test_on_publish_chunked_discard(void)
+{
+	publish_chunked_init(cb_on_publish_chunk);
+	payload_chunk_return = -ENOMEM;
+
+	__cmock_mqtt_readall_publish_payload_Stub(mqtt_readall_publish_payload_large_stub);
+	__cmock_mqtt_publish_qos1_ack_ExpectAnyArgsAndReturn(0);
+
+	send_large_publish_event();
+
+	TEST_ASSERT_EQUAL(1, payload_chunks_received);
+	TEST_ASSERT_EQUAL(TEST_LARGE_PAYLOAD_LEN, payload_bytes_read);
+	TEST_ASSERT_NOT_EQUAL(0, k_sem_take(&error_msg_size_sem, K_NO_WAIT));
+
+	/* Restore the default callbacks. */
+	publish_chunked_init(NULL);
+}
+
 void test_mqtt_helper_disconnect_when_connected(void)
 {
 	__cmock_mqtt_disconnect_ExpectAndReturn(&mqtt_client, 0);
@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <net/mqtt_helper.h>
+
+#include "zephyr/net/cmock_socket.h"
+#include "cmock_mqtt.h"
+
+#define TEST_TOPIC_STATE	"test/shadow/update"
+#define TEST_TOPIC_STATE_LEN	(sizeof(TEST_TOPIC_STATE) - 1)
+
+#define TEST_TOPIC_EVENTS	"test/events"
+#define TEST_TOPIC_EVENTS_LEN	(sizeof(TEST_TOPIC_EVENTS) - 1)
+
+/* Payload size that lets only a few messages fit in the queue. */
+#define TEST_LARGE_PAYLOAD_LEN	300
+
+/* Number of messages queued in the flush latency test. */
+#define TEST_FLUSH_COUNT	16
+
+/* Maximum number of messages recorded by the broker stand-in. */
+#define BROKER_MESSAGES_MAX	32
+
+/* Pull in variables and functions from the MQTT helper library. */
+extern struct mqtt_client mqtt_client;
+extern enum mqtt_state mqtt_state;
+extern k_tid_t mqtt_helper_thread;
+extern size_t publish_queue_count;
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+extern enum mqtt_state mqtt_state_get(void);
+extern void mqtt_evt_handler(struct mqtt_client *const mqtt_client,
+			     const struct mqtt_evt *mqtt_evt);
+
+/* Message as received by the broker stand-in. */
+struct broker_message {
+	char topic[32];
+	uint8_t payload[TEST_LARGE_PAYLOAD_LEN];
+	size_t payload_len;
+	enum mqtt_qos qos;
+	uint16_t message_id;
+};
+
+static struct broker_message broker_messages[BROKER_MESSAGES_MAX];
+static size_t broker_message_count;
+
+/* Number of publish calls the broker stand-in accepts before failing, or -1 for no limit. */
+static int broker_publish_limit;
+
+static K_SEM_DEFINE(connack_success_sem, 0, 1);
+
+static const struct mqtt_helper_buf coalesce_topics[] = {
+	{
+		.ptr = TEST_TOPIC_STATE,
+		.size = TEST_TOPIC_STATE_LEN,
+	},
+};
+
+static uint8_t large_payload[TEST_LARGE_PAYLOAD_LEN];
+
+/* Stubs */
+
+/* Broker stand-in, records the messages that are published. */
+static int mqtt_publish_stub(struct mqtt_client *client, const struct mqtt_publish_param *param,
+			     int num_calls)
+{
+	struct broker_message *msg = &broker_messages[broker_message_count];
+
+	TEST_ASSERT_EQUAL_PTR(&mqtt_client, client);
+	TEST_ASSERT_LESS_THAN(BROKER_MESSAGES_MAX, broker_message_count);
+	TEST_ASSERT_LESS_THAN(sizeof(msg->topic), param->message.topic.topic.size);
+	TEST_ASSERT_LESS_OR_EQUAL(sizeof(msg->payload), param->message.payload.len);
+
+	if (broker_publish_limit == 0) {
+		return -EAGAIN;
+	} else if (broker_publish_limit > 0) {
+		broker_publish_limit--;
+	}
+
+	memcpy(msg->topic, param->message.topic.topic.utf8, param->message.topic.topic.size);
+	msg->topic[param->message.topic.topic.size] = '\0';
+	memcpy(msg->payload, param->message.payload.data, param->message.payload.len);
+	msg->payload_len = param->message.payload.len;
+	msg->qos = param->message.topic.qos;
+	msg->message_id = param->message_id;
+
+	broker_message_count++;
+
+	return 0;
+}
+
+/* Callbacks used in tests. */
+static void cb_on_connack(enum mqtt_conn_return_code return_code)
+{
+	TEST_ASSERT_EQUAL(MQTT_CONNECTION_ACCEPTED, return_code);
+
+	/* The queue is flushed before the application is notified. */
+	TEST_ASSERT_EQUAL(0, publish_queue_count);
+
+	k_sem_give(&connack_success_sem);
+}
+
+/* Helper functions */
+static void queue_init(bool coalesce)
+{
+	struct mqtt_helper_cfg cfg = {
+		.cb = {
+			.on_connack = cb_on_connack,
+		},
+		.coalesce_topics = coalesce ? coalesce_topics : NULL,
+		.coalesce_topic_count = coalesce ? ARRAY_SIZE(coalesce_topics) : 0,
+	};
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+}
+
+static int publish(const char *topic, const void *payload, size_t payload_len, enum mqtt_qos qos,
+		   uint16_t message_id)
+{
+	struct mqtt_publish_param param = {
+		.message = {
+			.topic = {
+				.topic = {
+					.utf8 = (const uint8_t *)topic,
+					.size = strlen(topic),
+				},
+				.qos = qos,
+			},
+			.payload = {
+				.data = (uint8_t *)payload,
+				.len = payload_len,
+			},
+		},
+		.message_id = message_id,
+	};
+
+	return mqtt_helper_publish(&param);
+}
+
+static int publish_str(const char *topic, const char *payload, enum mqtt_qos qos,
+		       uint16_t message_id)
+{
+	return publish(topic, payload, strlen(payload), qos, message_id);
+}
+
+static void send_mqtt_event(enum mqtt_evt_type type, int optional_data)
+{
+	struct mqtt_evt evt = {
+		.type = type,
+		.result = 0,
+	};
+
+	switch (type) {
+	case MQTT_EVT_CONNACK:
+		evt.param.connack.return_code = optional_data;
+		break;
+	case MQTT_EVT_DISCONNECT:
+		break;
+	default:
+		/* Unhandled event type, should not happen and considered bug
+		 * in the test.
+		 */
+		TEST_ASSERT_TRUE(false);
+	}
+
+	mqtt_evt_handler(&mqtt_client, &evt);
+}
+
+static void send_connack(void)
+{
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(0, k_sem_take(&connack_success_sem, K_SECONDS(1)));
+	TEST_ASSERT_EQUAL(MQTT_STATE_CONNECTED, mqtt_state_get());
+}
+
+static void broker_message_check(size_t index, const char *topic, const char *payload,
+				 enum mqtt_qos qos, uint16_t message_id)
+{
+	struct broker_message *msg = &broker_messages[index];
+
+	TEST_ASSERT_LESS_THAN(broker_message_count, index);
+	TEST_ASSERT_EQUAL_STRING(topic, msg->topic);
+	TEST_ASSERT_EQUAL(strlen(payload), msg->payload_len);
+	TEST_ASSERT_EQUAL_MEMORY(payload, msg->payload, msg->payload_len);
+	TEST_ASSERT_EQUAL(qos, msg->qos);
+	TEST_ASSERT_EQUAL(message_id, msg->message_id);
+}
+
+void setUp(void)
+{
+	__cmock_mqtt_keepalive_time_left_IgnoreAndReturn(0);
+	__cmock_mqtt_publish_Stub(mqtt_publish_stub);
+
+	/* Suspend the polling thread to have full control over polling. */
+	k_thread_suspend(mqtt_helper_thread);
+
+	/* Deinitialize to empty the queue, and start every test in uninitialized state. */
+	mqtt_state = MQTT_STATE_DISCONNECTED;
+	TEST_ASSERT_EQUAL(0, mqtt_helper_deinit());
+
+	memset(broker_messages, 0, sizeof(broker_messages));
+	broker_message_count = 0;
+	broker_publish_limit = -1;
+
+	for (size_t i = 0; i < sizeof(large_payload); i++) {
+		large_payload[i] = (uint8_t)i;
+	}
+}
+
+void tearDown(void)
+{
+}
+
+/* Tests */
+
+void test_publish_when_uninitialized(void)
+{
+	TEST_ASSERT_EQUAL(-EOPNOTSUPP, publish_str(TEST_TOPIC_EVENTS, "1",
+						   MQTT_QOS_0_AT_MOST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_queue_count);
+}
+
+void test_publish_when_connected_is_not_queued(void)
+{
+	queue_init(false);
+	mqtt_state = MQTT_STATE_CONNECTED;
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_queue_count);
+	TEST_ASSERT_EQUAL(1, broker_message_count);
+}
+
+void test_flush_in_order(void)
+{
+	queue_init(false);
+	mqtt_state = MQTT_STATE_CONNECTING;
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "2", MQTT_QOS_0_AT_MOST_ONCE, 2));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "3", MQTT_QOS_1_AT_LEAST_ONCE, 3));
+	TEST_ASSERT_EQUAL(3, publish_queue_count);
+	TEST_ASSERT_EQUAL(0, broker_message_count);
+
+	send_connack();
+
+	/* Without coalescing, all messages are published. */
+	TEST_ASSERT_EQUAL(3, broker_message_count);
+	broker_message_check(0, TEST_TOPIC_EVENTS, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1);
+	broker_message_check(1, TEST_TOPIC_STATE, "2", MQTT_QOS_0_AT_MOST_ONCE, 2);
+	broker_message_check(2, TEST_TOPIC_STATE, "3", MQTT_QOS_1_AT_LEAST_ONCE, 3);
+}
+
+void test_coalesce_keeps_latest(void)
+{
+	queue_init(true);
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "1", MQTT_QOS_0_AT_MOST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "2", MQTT_QOS_0_AT_MOST_ONCE, 2));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "3", MQTT_QOS_0_AT_MOST_ONCE, 3));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "4", MQTT_QOS_0_AT_MOST_ONCE, 4));
+	TEST_ASSERT_EQUAL(3, publish_queue_count);
+
+	send_connack();
+
+	/* The replacing message is moved to the end of the queue. */
+	TEST_ASSERT_EQUAL(3, broker_message_count);
+	broker_message_check(0, TEST_TOPIC_EVENTS, "2", MQTT_QOS_0_AT_MOST_ONCE, 2);
+	broker_message_check(1, TEST_TOPIC_EVENTS, "3", MQTT_QOS_0_AT_MOST_ONCE, 3);
+	broker_message_check(2, TEST_TOPIC_STATE, "4", MQTT_QOS_0_AT_MOST_ONCE, 4);
+}
+
+void test_coalesce_keeps_higher_qos(void)
+{
+	queue_init(true);
+
+	/* The acknowledgment the application waits for is received for the replacing message. */
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "2", MQTT_QOS_0_AT_MOST_ONCE, 2));
+	TEST_ASSERT_EQUAL(1, publish_queue_count);
+
+	send_connack();
+
+	TEST_ASSERT_EQUAL(1, broker_message_count);
+	broker_message_check(0, TEST_TOPIC_STATE, "2", MQTT_QOS_1_AT_LEAST_ONCE, 1);
+}
+
+void test_coalesce_upgrades_qos(void)
+{
+	queue_init(true);
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "1", MQTT_QOS_0_AT_MOST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "2", MQTT_QOS_1_AT_LEAST_ONCE, 2));
+	TEST_ASSERT_EQUAL(1, publish_queue_count);
+
+	send_connack();
+
+	TEST_ASSERT_EQUAL(1, broker_message_count);
+	broker_message_check(0, TEST_TOPIC_STATE, "2", MQTT_QOS_1_AT_LEAST_ONCE, 2);
+}
+
+void test_coalesce_keeps_acked_message_id(void)
+{
+	queue_init(true);
+
+	/* The acknowledgment the application waits for is received for the replacing message. */
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_STATE, "2", MQTT_QOS_1_AT_LEAST_ONCE, 2));
+	TEST_ASSERT_EQUAL(1, publish_queue_count);
+
+	send_connack();
+
+	TEST_ASSERT_EQUAL(1, broker_message_count);
+	broker_message_check(0, TEST_TOPIC_STATE, "2", MQTT_QOS_1_AT_LEAST_ONCE, 1);
+}
+
+void test_overflow_drops_oldest_qos0(void)
+{
+	int qos0_count = 0;
+
+	queue_init(false);
+
+	TEST_ASSERT_EQUAL(0, publish(TEST_TOPIC_STATE, large_payload, sizeof(large_payload),
+				     MQTT_QOS_1_AT_LEAST_ONCE, 1));
+
+	/* Queue more QoS 0 messages than there is room for. */
+	for (int i = 0; i < 5; i++) {
+		large_payload[0] = i;
+
+		TEST_ASSERT_EQUAL(0, publish(TEST_TOPIC_EVENTS, large_payload,
+					     sizeof(large_payload), MQTT_QOS_0_AT_MOST_ONCE,
+					     2 + i));
+	}
+
+	TEST_ASSERT_LESS_THAN(6, publish_queue_count);
+
+	send_connack();
+
+	/* The QoS 1 message is kept, and the QoS 0 messages that are kept are the newest. */
+	TEST_ASSERT_EQUAL(MQTT_QOS_1_AT_LEAST_ONCE, broker_messages[0].qos);
+	TEST_ASSERT_EQUAL(1, broker_messages[0].message_id);
+
+	for (size_t i = 1; i < broker_message_count; i++) {
+		TEST_ASSERT_EQUAL(MQTT_QOS_0_AT_MOST_ONCE, broker_messages[i].qos);
+		TEST_ASSERT_EQUAL(7 - broker_message_count + i, broker_messages[i].message_id);
+		qos0_count++;
+	}
+
+	TEST_ASSERT_GREATER_THAN(0, qos0_count);
+}
+
+void test_overflow_qos1(void)
+{
+	int count = 0;
+	int err;
+
+	queue_init(false);
+
+	/* QoS 1 messages are never dropped to make room. */
+	do {
+		err = publish(TEST_TOPIC_EVENTS, large_payload, sizeof(large_payload),
+			      MQTT_QOS_1_AT_LEAST_ONCE, ++count);
+	} while ((err == 0) && (count < BROKER_MESSAGES_MAX));
+
+	TEST_ASSERT_EQUAL(-ENOMEM, err);
+	TEST_ASSERT_EQUAL(count - 1, publish_queue_count);
+
+	TEST_ASSERT_EQUAL(-ENOMEM, publish(TEST_TOPIC_EVENTS, large_payload,
+					   sizeof(large_payload), MQTT_QOS_0_AT_MOST_ONCE, 100));
+
+	send_connack();
+
+	TEST_ASSERT_EQUAL(count - 1, broker_message_count);
+}
+
+void test_connack_refused_keeps_queue(void)
+{
+	struct mqtt_helper_cfg cfg = { 0 };
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_NOT_AUTHORIZED);
+
+	TEST_ASSERT_EQUAL(MQTT_STATE_DISCONNECTED, mqtt_state_get());
+	TEST_ASSERT_EQUAL(0, broker_message_count);
+	TEST_ASSERT_EQUAL(1, publish_queue_count);
+}
+
+void test_flush_error_keeps_remaining(void)
+{
+	struct mqtt_helper_cfg cfg = { 0 };
+
+	TEST_ASSERT_EQUAL(0, mqtt_helper_init(&cfg));
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "2", MQTT_QOS_1_AT_LEAST_ONCE, 2));
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "3", MQTT_QOS_1_AT_LEAST_ONCE, 3));
+
+	/* The broker stand-in fails after the first message, the rest stays in the queue. */
+	broker_publish_limit = 1;
+
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(1, broker_message_count);
+	TEST_ASSERT_EQUAL(2, publish_queue_count);
+
+	send_mqtt_event(MQTT_EVT_DISCONNECT, 0);
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "4", MQTT_QOS_1_AT_LEAST_ONCE, 4));
+
+	broker_publish_limit = -1;
+
+	/* The remaining messages are published first on the next connection. */
+	send_mqtt_event(MQTT_EVT_CONNACK, MQTT_CONNECTION_ACCEPTED);
+
+	TEST_ASSERT_EQUAL(4, broker_message_count);
+	TEST_ASSERT_EQUAL(0, publish_queue_count);
+	broker_message_check(1, TEST_TOPIC_EVENTS, "2", MQTT_QOS_1_AT_LEAST_ONCE, 2);
+	broker_message_check(2, TEST_TOPIC_EVENTS, "3", MQTT_QOS_1_AT_LEAST_ONCE, 3);
+	broker_message_check(3, TEST_TOPIC_EVENTS, "4", MQTT_QOS_1_AT_LEAST_ONCE, 4);
+}
+
+void test_deinit_clears_queue(void)
+{
+	queue_init(false);
+
+	TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, "1", MQTT_QOS_1_AT_LEAST_ONCE, 1));
+	TEST_ASSERT_EQUAL(0, mqtt_helper_deinit());
+	TEST_ASSERT_EQUAL(0, publish_queue_count);
+
+	queue_init(false);
+	send_connack();
+
+	TEST_ASSERT_EQUAL(0, broker_message_count);
+}
+
+/* Measure the time from the connection being accepted until the queue has been handed over to
+ * the broker stand-in.
+ */
+void test_flush_latency(void)
+{
+	char payload[8];
+	uint32_t start;
+	uint32_t cycles;
+
+	queue_init(true);
+
+	for (int i = 0; i < TEST_FLUSH_COUNT; i++) {
+		snprintk(payload, sizeof(payload), "%d", i);
+
+		TEST_ASSERT_EQUAL(0, publish_str(TEST_TOPIC_EVENTS, payload,
+						 MQTT_QOS_1_AT_LEAST_ONCE, i + 1));
+	}
+
+	start = k_cycle_get_32();
+
+	send_connack();
+
+	cycles = k_cycle_get_32() - start;
+
+	printk("Flushed %d queued messages in %u us\n", TEST_FLUSH_COUNT,
+	       k_cyc_to_us_floor32(cycles));
+
+	TEST_ASSERT_EQUAL(TEST_FLUSH_COUNT, broker_message_count);
+	broker_message_check(TEST_FLUSH_COUNT - 1, TEST_TOPIC_EVENTS, "15",
+			     MQTT_QOS_1_AT_LEAST_ONCE, TEST_FLUSH_COUNT);
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <nrf_modem_gnss.h>
+#include <net/nrf_cloud_codec.h>
+#include <nrf_cloud_agps_schema_v1.h>
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+
+DEFINE_FFF_GLOBALS;
+
+/* Fake functions declaration */
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_agps_write, void *, int32_t, uint16_t);
+FAKE_VALUE_FUNC(int, nrf_cloud_error_msg_decode, const char *const, const char *const,
+		const char *const, enum nrf_cloud_error *const);
+FAKE_VOID_FUNC(agps_print, enum nrf_cloud_agps_type, void *);
+
+/* Binary A-GPS data is not JSON */
+int fake_nrf_cloud_error_msg_decode__no_json(const char *const buf, const char *const app_id,
+					     const char *const msg_type,
+					     enum nrf_cloud_error *const err)
+{
+	ARG_UNUSED(buf);
+	ARG_UNUSED(app_id);
+	ARG_UNUSED(msg_type);
+	ARG_UNUSED(err);
+
+	return -ENODATA;
+}
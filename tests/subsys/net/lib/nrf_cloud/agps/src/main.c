@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "fakes.h"
+#include "nrf_cloud_agps.c"
+
+#define AGPS_DATA_MAX_LEN	1024
+#define MODEM_WRITES_MAX	16
+#define MODEM_WRITE_MAX_LEN	256
+
+/* Elements written to the modem, in order */
+struct modem_write {
+	uint16_t type;
+	size_t len;
+	uint8_t data[MODEM_WRITE_MAX_LEN];
+};
+
+static struct {
+	struct modem_write writes[MODEM_WRITES_MAX];
+	size_t cnt;
+} modem_log, expected_log;
+
+static uint8_t agps_data[AGPS_DATA_MAX_LEN];
+static size_t agps_data_len;
+
+int32_t fake_nrf_modem_gnss_agps_write__logs(void *buf, int32_t buf_len, uint16_t type)
+{
+	struct modem_write *write = &modem_log.writes[modem_log.cnt];
+
+	zassert_true(modem_log.cnt < MODEM_WRITES_MAX, "Too many modem writes");
+	zassert_true(buf_len <= MODEM_WRITE_MAX_LEN, "Modem write too long: %d", buf_len);
+
+	write->type = type;
+	write->len = buf_len;
+	memcpy(write->data, buf, buf_len);
+	modem_log.cnt++;
+
+	return 0;
+}
+
+/* Append an array of count elements of the given type. The elements are filled with a
+ * pattern, except for the satellite ID which must be valid.
+ */
+static void agps_data_array_add(enum nrf_cloud_agps_type type, uint16_t count)
+{
+	size_t size = agps_element_size(type);
+
+	zassert_true(agps_data_len + AGPS_BIN_HEADER_SIZE + count * size <= AGPS_DATA_MAX_LEN,
+		     "A-GPS test data too long");
+
+	agps_data[agps_data_len + NRF_CLOUD_AGPS_BIN_TYPE_OFFSET] = type;
+	memcpy(&agps_data[agps_data_len + NRF_CLOUD_AGPS_BIN_COUNT_OFFSET], &count,
+	       sizeof(count));
+	agps_data_len += AGPS_BIN_HEADER_SIZE;
+
+	for (uint16_t i = 0; i < count; i++) {
+		for (size_t j = 0; j < size; j++) {
+			agps_data[agps_data_len + j] = (uint8_t)(agps_data_len + j) * 37;
+		}
+
+		if ((type == NRF_CLOUD_AGPS_EPHEMERIDES) || (type == NRF_CLOUD_AGPS_ALMANAC) ||
+		    (type == NRF_CLOUD_AGPS_GPS_TOWS)) {
+			/* The satellite ID is the first field of these elements */
+			agps_data[agps_data_len] = 3 * i + 1;
+		}
+
+		agps_data_len += size;
+	}
+}
+
+/* Build A-GPS data with arrays of all the element types */
+static void agps_data_build(void)
+{
+	agps_data_len = 0;
+	agps_data[agps_data_len++] = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
+
+	agps_data_array_add(NRF_CLOUD_AGPS_UTC_PARAMETERS, 1);
+	agps_data_array_add(NRF_CLOUD_AGPS_EPHEMERIDES, 3);
+	agps_data_array_add(NRF_CLOUD_AGPS_ALMANAC, 2);
+	agps_data_array_add(NRF_CLOUD_AGPS_KLOBUCHAR_CORRECTION, 1);
+	agps_data_array_add(NRF_CLOUD_AGPS_NEQUICK_CORRECTION, 1);
+	agps_data_array_add(NRF_CLOUD_AGPS_GPS_TOWS, 4);
+	agps_data_array_add(NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK, 1);
+	agps_data_array_add(NRF_CLOUD_AGPS_LOCATION, 1);
+	agps_data_array_add(NRF_CLOUD_AGPS_INTEGRITY, 1);
+}
+
+/* Compare the elements written to the modem with the reference. The chunk size is only
+ * reported on failure, 0 stands for chunks of different sizes.
+ */
+static void modem_log_check(size_t chunk_size)
+{
+	zassert_equal(modem_log.cnt, expected_log.cnt,
+		      "Chunk size %zu: %zu elements written, expected %zu",
+		      chunk_size, modem_log.cnt, expected_log.cnt);
+
+	for (size_t i = 0; i < expected_log.cnt; i++) {
+		const struct modem_write *write = &modem_log.writes[i];
+		const struct modem_write *expected = &expected_log.writes[i];
+
+		zassert_equal(write->type, expected->type,
+			      "Chunk size %zu: unexpected type of element %zu", chunk_size, i);
+		zassert_equal(write->len, expected->len,
+			      "Chunk size %zu: unexpected length of element %zu", chunk_size, i);
+		zassert_mem_equal(write->data, expected->data, expected->len,
+				  "Chunk size %zu: unexpected data of element %zu", chunk_size, i);
+	}
+}
+
+/* Pass the data in chunks that end at the given offsets, followed by the rest of the data */
+static void agps_data_process_split(const size_t *ends, size_t ends_cnt)
+{
+	size_t offset = 0;
+	int err;
+
+	for (size_t i = 0; i <= ends_cnt; i++) {
+		size_t end = (i < ends_cnt) ? ends[i] : agps_data_len;
+
+		err = nrf_cloud_agps_process_chunk(&agps_data[offset], end - offset, offset,
+						   agps_data_len);
+		zassert_ok(err, "Chunk at offset %zu not processed: %d", offset, err);
+		offset = end;
+	}
+}
+
+static void *nrf_cloud_agps_test_setup(void)
+{
+	agps_data_build();
+
+	/* The data processed as a whole is the reference for the chunked processing */
+	nrf_modem_gnss_agps_write_fake.custom_fake = fake_nrf_modem_gnss_agps_write__logs;
+	nrf_cloud_error_msg_decode_fake.custom_fake = fake_nrf_cloud_error_msg_decode__no_json;
+	memset(&modem_log, 0, sizeof(modem_log));
+
+	zassert_ok(nrf_cloud_agps_process(agps_data, agps_data_len),
+		   "A-GPS data not processed");
+	zassert_equal(modem_log.cnt, 11, "Unexpected number of elements: %zu", modem_log.cnt);
+
+	expected_log = modem_log;
+
+	return NULL;
+}
+
+static void nrf_cloud_agps_test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	RESET_FAKE(nrf_modem_gnss_agps_write);
+	RESET_FAKE(nrf_cloud_error_msg_decode);
+	RESET_FAKE(agps_print);
+	FFF_RESET_HISTORY();
+
+	nrf_modem_gnss_agps_write_fake.custom_fake = fake_nrf_modem_gnss_agps_write__logs;
+	nrf_cloud_error_msg_decode_fake.custom_fake = fake_nrf_cloud_error_msg_decode__no_json;
+
+	memset(&modem_log, 0, sizeof(modem_log));
+}
+
+ZTEST(nrf_cloud_agps_test, test_process_chunk_all_sizes)
+{
+	for (size_t chunk_size = 1; chunk_size <= agps_data_len; chunk_size++) {
+		memset(&modem_log, 0, sizeof(modem_log));
+
+		for (size_t offset = 0; offset < agps_data_len; offset += chunk_size) {
+			size_t len = MIN(chunk_size, agps_data_len - offset);
+			int err = nrf_cloud_agps_process_chunk(&agps_data[offset], len, offset,
+							       agps_data_len);
+
+			zassert_ok(err, "Chunk size %zu: chunk at offset %zu not processed: %d",
+				   chunk_size, offset, err);
+		}
+
+		modem_log_check(chunk_size);
+	}
+}
+
+ZTEST(nrf_cloud_agps_test, test_process_chunk_split_element)
+{
+	/* The first ephemeris follows the version, the UTC array and the array header */
+	const size_t eph_offset = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION_SIZE +
+				  AGPS_BIN_HEADER_SIZE + agps_element_size(NRF_CLOUD_AGPS_UTC_PARAMETERS) +
+				  AGPS_BIN_HEADER_SIZE;
+	const size_t eph_size = agps_element_size(NRF_CLOUD_AGPS_EPHEMERIDES);
+	/* The array header is split, and the ephemeris is reassembled from three chunks */
+	const size_t ends[] = {
+		eph_offset - 2,
+		eph_offset + 1,
+		eph_offset + eph_size / 2,
+		eph_offset + eph_size + 1,
+	};
+
+	agps_data_process_split(ends, ARRAY_SIZE(ends));
+
+	modem_log_check(0);
+}
+
+ZTEST(nrf_cloud_agps_test, test_process_chunk_out_of_sequence)
+{
+	const size_t chunk_size = 40;
+	int err;
+
+	err = nrf_cloud_agps_process_chunk(agps_data, chunk_size, 0, agps_data_len);
+	zassert_ok(err, "First chunk not processed: %d", err);
+
+	/* A chunk was skipped */
+	err = nrf_cloud_agps_process_chunk(&agps_data[2 * chunk_size], chunk_size,
+					   2 * chunk_size, agps_data_len);
+	zassert_equal(err, -EINVAL, "Chunk out of sequence accepted: %d", err);
+
+	/* The rest of the data is rejected, even if it follows the previous chunk */
+	err = nrf_cloud_agps_process_chunk(&agps_data[chunk_size], chunk_size, chunk_size,
+					   agps_data_len);
+	zassert_equal(err, -EINVAL, "Chunk after an error accepted: %d", err);
+
+	zassert_true(modem_log.cnt < expected_log.cnt, "All elements written");
+
+	/* The data is processed again from the start */
+	memset(&modem_log, 0, sizeof(modem_log));
+	agps_data_process_split(&chunk_size, 1);
+
+	modem_log_check(0);
+}
+
+ZTEST_SUITE(nrf_cloud_agps_test, NULL, nrf_cloud_agps_test_setup,
+	    nrf_cloud_agps_test_before, NULL, NULL);
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zcbor_decode.h>
+#include <zcbor_encode.h>
+#include <net/nrf_cloud_codec.h>
+
+#include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_mem.h"
+
+#define TS_MS 1681000000000LL
+
+#define JOB_ID "11a26316-4e9a-4e6b-9bd6-2de6a17c5d84"
+#define JOB_HOST "firmware.nrfcloud.com"
+#define JOB_PATH "bbfe6b73-a46a-43ad-94bd-8e4b4a7847ce/APP*1e29dfa3*v2.0.0/hello.bin"
+
+/* The same messages as JSON, as the JSON encoders output them */
+#define SENSOR_JSON \
+	"{\"appId\":\"TEMP\",\"data\":\"23.5\",\"messageType\":\"DATA\",\"ts\":1681000000000}"
+#define ALERT_JSON \
+	"{\"appId\":\"ALERT\",\"type\":5,\"value\":38.5,\"ts\":1681000000000,\"seq\":7," \
+	"\"desc\":\"Temperature above limit\"}"
+#define LOG_JSON \
+	"{\"appId\":\"LOG\",\"dom\":0,\"lvl\":3,\"src\":\"app\",\"ts\":1681000000000," \
+	"\"msg\":\"Connected to nRF Cloud\"}"
+#define SHADOW_JSON \
+	"{\"state\":{\"pairing\":null,\"control\":{\"alertsEn\":true,\"logLvl\":3}}}"
+#define FOTA_JSON \
+	"[\"" JOB_ID "\",0,385080,\"" JOB_HOST "\",\"" JOB_PATH "\"]"
+
+static uint8_t buf[256];
+
+void *nrf_cloud_malloc(size_t size)
+{
+	return k_malloc(size);
+}
+
+void *nrf_cloud_calloc(size_t count, size_t size)
+{
+	return k_calloc(count, size);
+}
+
+void nrf_cloud_free(void *ptr)
+{
+	k_free(ptr);
+}
+
+static void job_free(struct nrf_cloud_fota_job_info *job)
+{
+	nrf_cloud_free(job->id);
+	nrf_cloud_free(job->host);
+	nrf_cloud_free(job->path);
+}
+
+static void size_check(const char *name, size_t cbor_len, const char *json)
+{
+	size_t json_len = strlen(json);
+
+	TC_PRINT("%-10s JSON %3u bytes, CBOR %3u bytes (%u%%)\n", name, (uint32_t)json_len,
+		 (uint32_t)cbor_len, (uint32_t)(cbor_len * 100 / json_len));
+
+	zassert_true(cbor_len < json_len, "%s: CBOR is not smaller than JSON", name);
+}
+
+static const struct nrf_cloud_sensor_data sensor = {
+	.type = NRF_CLOUD_SENSOR_TEMP,
+	.data = {
+		.ptr = "23.5",
+		.len = sizeof("23.5") - 1
+	},
+	.ts_ms = TS_MS
+};
+
+static const struct nrf_cloud_alert_info alert = {
+	.type = ALERT_TYPE_TEMPERATURE,
+	.value = 38.5f,
+	.description = "Temperature above limit",
+	.sequence = 7,
+	.ts_ms = TS_MS
+};
+
+static uint8_t log_msg[] = "Connected to nRF Cloud";
+
+static struct nrf_cloud_log_context log_ctx = {
+	.dom_id = 0,
+	.src_name = "app",
+	.level = 3,
+	.ts = TS_MS
+};
+
+/* Common fields of device messages */
+static void msg_hdr_check(zcbor_state_t *zs, const char *app_id)
+{
+	struct zcbor_string str;
+	int64_t ts;
+
+	zassert_true(zcbor_map_start_decode(zs));
+	zassert_true(zcbor_tstr_expect_lit(zs, "appId"));
+	zassert_true(zcbor_tstr_decode(zs, &str));
+	zassert_mem_equal(str.value, app_id, str.len);
+	zassert_true(zcbor_tstr_expect_lit(zs, "messageType"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "DATA"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "ts"));
+	zassert_true(zcbor_int64_decode(zs, &ts));
+	zassert_equal(ts, TS_MS);
+	zassert_true(zcbor_tstr_expect_lit(zs, "data"));
+}
+
+ZTEST(nrf_cloud_cbor, test_sensor)
+{
+	struct nrf_cloud_data out;
+	struct zcbor_string str;
+
+	zassert_ok(nrf_cloud_sensor_data_cbor_encode(&sensor, &out));
+
+	ZCBOR_STATE_D(zs, 2, out.ptr, out.len, 1);
+
+	msg_hdr_check(zs, "TEMP");
+	zassert_true(zcbor_tstr_decode(zs, &str));
+	zassert_equal(str.len, sensor.data.len);
+	zassert_mem_equal(str.value, sensor.data.ptr, str.len);
+	zassert_true(zcbor_map_end_decode(zs));
+
+	size_check("sensor", out.len, SENSOR_JSON);
+	nrf_cloud_free((void *)out.ptr);
+}
+
+ZTEST(nrf_cloud_cbor, test_alert)
+{
+	struct nrf_cloud_data out;
+	struct zcbor_string str;
+	int32_t type;
+	float value;
+
+	zassert_ok(nrf_cloud_alert_cbor_encode(&alert, &out));
+
+	ZCBOR_STATE_D(zs, 2, out.ptr, out.len, 1);
+
+	zassert_true(zcbor_map_start_decode(zs));
+	zassert_true(zcbor_tstr_expect_lit(zs, "appId"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "ALERT"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "type"));
+	zassert_true(zcbor_int32_decode(zs, &type));
+	zassert_equal(type, alert.type);
+	zassert_true(zcbor_tstr_expect_lit(zs, "value"));
+	zassert_true(zcbor_float32_decode(zs, &value));
+	zassert_equal(value, alert.value);
+	zassert_true(zcbor_tstr_expect_lit(zs, "ts"));
+	zassert_true(zcbor_any_skip(zs, NULL));
+	zassert_true(zcbor_tstr_expect_lit(zs, "seq"));
+	zassert_true(zcbor_uint32_expect(zs, alert.sequence));
+	zassert_true(zcbor_tstr_expect_lit(zs, "desc"));
+	zassert_true(zcbor_tstr_decode(zs, &str));
+	zassert_mem_equal(str.value, alert.description, str.len);
+	zassert_true(zcbor_map_end_decode(zs));
+
+	size_check("alert", out.len, ALERT_JSON);
+	nrf_cloud_free((void *)out.ptr);
+}
+
+ZTEST(nrf_cloud_cbor, test_log)
+{
+	struct nrf_cloud_data out;
+	struct zcbor_string str;
+
+	zassert_ok(nrf_cloud_log_cbor_encode(&log_ctx, log_msg, strlen((char *)log_msg), &out));
+
+	ZCBOR_STATE_D(zs, 2, out.ptr, out.len, 1);
+
+	zassert_true(zcbor_map_start_decode(zs));
+	zassert_true(zcbor_tstr_expect_lit(zs, "appId"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "LOG"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "dom"));
+	zassert_true(zcbor_int32_expect(zs, 0));
+	zassert_true(zcbor_tstr_expect_lit(zs, "lvl"));
+	zassert_true(zcbor_int32_expect(zs, 3));
+	zassert_true(zcbor_tstr_expect_lit(zs, "src"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "app"));
+	zassert_true(zcbor_tstr_expect_lit(zs, "ts"));
+	zassert_true(zcbor_any_skip(zs, NULL));
+	zassert_true(zcbor_tstr_expect_lit(zs, "msg"));
+	zassert_true(zcbor_tstr_decode(zs, &str));
+	zassert_equal(str.len, strlen((char *)log_msg));
+	zassert_mem_equal(str.value, log_msg, str.len);
+	zassert_true(zcbor_map_end_decode(zs));
+
+	size_check("log", out.len, LOG_JSON);
+	nrf_cloud_free((void *)out.ptr);
+}
+
+/* {"<section>":{"pairing":null,"control":{"alertsEn":<alerts>,"logLvl":<level>}}} */
+static size_t shadow_encode(const char *section, bool alerts, int32_t level)
+{
+	ZCBOR_STATE_E(zs, 3, buf, sizeof(buf), 1);
+
+	zassert_true(zcbor_map_start_encode(zs, 2));
+	zassert_true(zcbor_tstr_encode_ptr(zs, section, strlen(section)));
+	zassert_true(zcbor_map_start_encode(zs, 2));
+	zassert_true(zcbor_tstr_put_lit(zs, "pairing"));
+	zassert_true(zcbor_nil_put(zs, NULL));
+	zassert_true(zcbor_tstr_put_lit(zs, "control"));
+	zassert_true(zcbor_map_start_encode(zs, 2));
+	zassert_true(zcbor_tstr_put_lit(zs, "alertsEn"));
+	zassert_true(zcbor_bool_put(zs, alerts));
+	zassert_true(zcbor_tstr_put_lit(zs, "logLvl"));
+	zassert_true(zcbor_int32_put(zs, level));
+	zassert_true(zcbor_map_end_encode(zs, 2));
+	zassert_true(zcbor_map_end_encode(zs, 2));
+	zassert_true(zcbor_map_end_encode(zs, 2));
+
+	return zs->payload - buf;
+}
+
+ZTEST(nrf_cloud_cbor, test_shadow_control)
+{
+	struct nrf_cloud_ctrl_data ctrl = {0};
+	enum nrf_cloud_ctrl_status status;
+	struct nrf_cloud_data in = { .ptr = buf };
+
+	in.len = shadow_encode("state", true, 3);
+	zassert_true(nrf_cloud_cbor_map_check(&in));
+	zassert_ok(nrf_cloud_shadow_control_cbor_decode(&in, &status, &ctrl));
+	zassert_equal(status, NRF_CLOUD_CTRL_REPLY);
+	zassert_true(ctrl.alerts_enabled);
+	zassert_equal(ctrl.log_level, 3);
+
+	size_check("shadow", in.len, SHADOW_JSON);
+
+	in.len = shadow_encode("reported", false, 1);
+	zassert_ok(nrf_cloud_shadow_control_cbor_decode(&in, &status, &ctrl));
+	zassert_equal(status, NRF_CLOUD_CTRL_REPLY);
+	zassert_false(ctrl.alerts_enabled);
+	zassert_equal(ctrl.log_level, 1);
+
+	/* Control in an unknown section is ignored */
+	in.len = shadow_encode("config", true, 4);
+	zassert_ok(nrf_cloud_shadow_control_cbor_decode(&in, &status, &ctrl));
+	zassert_equal(status, NRF_CLOUD_CTRL_NOT_PRESENT);
+	zassert_false(ctrl.alerts_enabled);
+
+	/* Truncated input */
+	in.len -= 2;
+	zassert_equal(nrf_cloud_shadow_control_cbor_decode(&in, &status, &ctrl), -ESRCH);
+
+	/* JSON is not taken for CBOR */
+	in.ptr = SHADOW_JSON;
+	in.len = strlen(SHADOW_JSON);
+	zassert_false(nrf_cloud_cbor_map_check(&in));
+	zassert_false(nrf_cloud_cbor_list_check(&in));
+}
+
+static size_t fota_job_encode(const char *id, int32_t type)
+{
+	ZCBOR_STATE_E(zs, 1, buf, sizeof(buf), 1);
+
+	zassert_true(zcbor_list_start_encode(zs, 5));
+	zassert_true(zcbor_tstr_encode_ptr(zs, id, strlen(id)));
+	zassert_true(zcbor_int32_put(zs, type));
+	zassert_true(zcbor_int32_put(zs, 385080));
+	zassert_true(zcbor_tstr_put_lit(zs, JOB_HOST));
+	zassert_true(zcbor_tstr_put_lit(zs, JOB_PATH));
+	zassert_true(zcbor_list_end_encode(zs, 5));
+
+	return zs->payload - buf;
+}
+
+ZTEST(nrf_cloud_cbor, test_fota_job)
+{
+	struct nrf_cloud_fota_job_info job;
+	struct nrf_cloud_data in = { .ptr = buf };
+
+	in.len = fota_job_encode(JOB_ID, NRF_CLOUD_FOTA_MODEM_DELTA);
+	zassert_true(nrf_cloud_cbor_list_check(&in));
+	zassert_ok(nrf_cloud_fota_job_cbor_decode(&job, NULL, &in));
+	zassert_equal(strcmp(job.id, JOB_ID), 0);
+	zassert_equal(strcmp(job.host, JOB_HOST), 0);
+	zassert_equal(strcmp(job.path, JOB_PATH), 0);
+	zassert_equal(job.type, NRF_CLOUD_FOTA_MODEM_DELTA);
+	zassert_equal(job.file_size, 385080);
+	job_free(&job);
+
+	size_check("FOTA job", in.len, FOTA_JSON);
+
+	/* An invalid job keeps the ID, so that it can be rejected */
+	in.len = fota_job_encode(JOB_ID, NRF_CLOUD_FOTA_TYPE__INVALID);
+	zassert_equal(nrf_cloud_fota_job_cbor_decode(&job, NULL, &in), -ENOMSG);
+	zassert_equal(strcmp(job.id, JOB_ID), 0);
+	zassert_is_null(job.host);
+	zassert_is_null(job.path);
+	zassert_equal(job.type, NRF_CLOUD_FOTA_TYPE__INVALID);
+	job_free(&job);
+
+	in.len = fota_job_encode(JOB_ID JOB_ID, NRF_CLOUD_FOTA_APPLICATION);
+	zassert_equal(nrf_cloud_fota_job_cbor_decode(&job, NULL, &in), -ENOMSG);
+	zassert_equal(job.type, NRF_CLOUD_FOTA_TYPE__INVALID);
+	job_free(&job);
+
+	/* A truncated job is not valid CBOR, so nothing is kept */
+	in.len = fota_job_encode(JOB_ID, NRF_CLOUD_FOTA_APPLICATION) - 1;
+	zassert_equal(nrf_cloud_fota_job_cbor_decode(&job, NULL, &in), -EINVAL);
+	zassert_is_null(job.id);
+}
+
+ZTEST_SUITE(nrf_cloud_cbor, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <math.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <cJSON.h>
+#include <net/nrf_cloud_defs.h>
+
+#include "nrf_cloud_json_writer.h"
+
+#define BENCH_ITERATIONS 200
+
+static size_t heap_used;
+static size_t heap_peak;
+static uint32_t heap_allocs;
+
+/* Heap accounting for both cJSON and the writer */
+static void *test_malloc(size_t size)
+{
+	size_t *mem = k_malloc(sizeof(size_t) + size);
+
+	if (!mem) {
+		return NULL;
+	}
+
+	*mem = size;
+	heap_used += size;
+	heap_peak = MAX(heap_peak, heap_used);
+	heap_allocs++;
+
+	return &mem[1];
+}
+
+static void test_free(void *ptr)
+{
+	size_t *mem = ptr;
+
+	if (!ptr) {
+		return;
+	}
+
+	heap_used -= mem[-1];
+	k_free(&mem[-1]);
+}
+
+void *nrf_cloud_malloc(size_t size)
+{
+	return test_malloc(size);
+}
+
+void nrf_cloud_free(void *ptr)
+{
+	test_free(ptr);
+}
+
+static void heap_stats_reset(void)
+{
+	heap_peak = heap_used;
+	heap_allocs = 0;
+}
+
+struct sensor_msg {
+	const char *app_id;
+	const char *data;
+	int64_t ts_ms;
+};
+
+struct alert_msg {
+	int type;
+	float value;
+	uint32_t sequence;
+	const char *description;
+};
+
+struct log_msg {
+	int dom_id;
+	int level;
+	const char *src_name;
+	int64_t ts;
+	const char *msg;
+};
+
+static const struct sensor_msg sensor = {
+	.app_id = NRF_CLOUD_JSON_APPID_VAL_TEMP,
+	.data = "24.5",
+	.ts_ms = 1700000000123LL,
+};
+
+static const struct alert_msg alert = {
+	.type = 2,
+	.value = 45.25f,
+	.sequence = 17,
+	.description = "Temperature \"high\"",
+};
+
+static const struct log_msg log_msg = {
+	.dom_id = 0,
+	.level = 3,
+	.src_name = "main",
+	.ts = 1700000000456LL,
+	.msg = "Sample value:\t42\r\n",
+};
+
+static const double numbers[] = {
+	0, -1, 42, 255.0, 2147483647.0, -2147483648.0, 2147483648.0, 1700000000123.0,
+	0.1, -0.5, 3.14159, 1.0 / 3.0, 1e21, 1e-7, 6.02214076e23, NAN, INFINITY,
+};
+
+static char buf[512];
+
+static void sensor_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct sensor_msg *msg = ctx;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, msg->app_id);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_DATA_KEY, msg->data);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg->ts_ms);
+	nrf_cloud_json_obj_end(w);
+}
+
+static char *sensor_cjson(const struct sensor_msg *msg)
+{
+	cJSON *root = cJSON_CreateObject();
+	char *out;
+
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_APPID_KEY, msg->app_id);
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_DATA_KEY, msg->data);
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg->ts_ms);
+
+	out = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	return out;
+}
+
+static void alert_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct alert_msg *msg = ctx;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_ALERT);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_TYPE, msg->type);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_VALUE, msg->value);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_ALERT_SEQUENCE, msg->sequence);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_ALERT_DESCRIPTION, msg->description);
+	nrf_cloud_json_obj_end(w);
+}
+
+static char *alert_cjson(const struct alert_msg *msg)
+{
+	cJSON *root = cJSON_CreateObject();
+	char *out;
+
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_ALERT);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_JSON_ALERT_TYPE, msg->type);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_JSON_ALERT_VALUE, msg->value);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_JSON_ALERT_SEQUENCE, msg->sequence);
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_ALERT_DESCRIPTION, msg->description);
+
+	out = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	return out;
+}
+
+static void log_write(struct nrf_cloud_json_writer *w, const void *ctx)
+{
+	const struct log_msg *msg = ctx;
+
+	nrf_cloud_json_obj_start(w, NULL);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_LOG);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_LOG_KEY_DOMAIN, msg->dom_id);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_JSON_LOG_KEY_LEVEL, msg->level);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_LOG_KEY_SOURCE, msg->src_name);
+	nrf_cloud_json_num_add(w, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg->ts);
+	nrf_cloud_json_str_add(w, NRF_CLOUD_JSON_LOG_KEY_MESSAGE, msg->msg);
+	nrf_cloud_json_obj_end(w);
+}
+
+static char *log_cjson(const struct log_msg *msg)
+{
+	cJSON *root = cJSON_CreateObject();
+	char *out;
+
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_LOG);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_JSON_LOG_KEY_DOMAIN, msg->dom_id);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_JSON_LOG_KEY_LEVEL, msg->level);
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_LOG_KEY_SOURCE, msg->src_name);
+	cJSON_AddNumberToObject(root, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg->ts);
+	cJSON_AddStringToObject(root, NRF_CLOUD_JSON_LOG_KEY_MESSAGE, msg->msg);
+
+	out = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	return out;
+}
+
+static void write_verify(nrf_cloud_json_write_fn write, const void *ctx, char *expected)
+{
+	struct nrf_cloud_json_writer w;
+
+	zassert_not_null(expected);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	write(&w, ctx);
+
+	zassert_equal(nrf_cloud_json_writer_finish(&w), strlen(expected));
+	zassert_equal(strcmp(buf, expected), 0, "%s != %s", buf, expected);
+
+	cJSON_free(expected);
+}
+
+static void test_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	cJSON_Hooks hooks = {
+		.malloc_fn = test_malloc,
+		.free_fn = test_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+	memset(buf, 0xAA, sizeof(buf));
+}
+
+ZTEST(json_writer, test_messages)
+{
+	write_verify(sensor_write, &sensor, sensor_cjson(&sensor));
+	write_verify(alert_write, &alert, alert_cjson(&alert));
+	write_verify(log_write, &log_msg, log_cjson(&log_msg));
+}
+
+ZTEST(json_writer, test_nested)
+{
+	struct nrf_cloud_json_writer w;
+	cJSON *root = cJSON_CreateObject();
+	cJSON *state = cJSON_AddObjectToObject(root, NRF_CLOUD_JSON_KEY_STATE);
+	cJSON *reported = cJSON_AddObjectToObject(state, NRF_CLOUD_JSON_KEY_REP);
+	cJSON *control = cJSON_AddObjectToObject(reported, NRF_CLOUD_JSON_KEY_CTRL);
+	cJSON *arr = cJSON_AddArrayToObject(reported, "arr");
+	cJSON *empty = cJSON_CreateObject();
+	char *expected;
+
+	cJSON_AddBoolToObject(control, NRF_CLOUD_JSON_KEY_ALERT, true);
+	cJSON_AddNumberToObject(control, NRF_CLOUD_JSON_KEY_LOG, 3);
+	cJSON_AddItemToArray(arr, cJSON_CreateNumber(1));
+	cJSON_AddItemToArray(arr, cJSON_CreateString("two"));
+	cJSON_AddItemToArray(arr, empty);
+	cJSON_AddItemToArray(arr, cJSON_CreateArray());
+	cJSON_AddItemToArray(arr, cJSON_CreateFalse());
+	cJSON_AddNullToObject(reported, NRF_CLOUD_JSON_KEY_CFG);
+	cJSON_AddArrayToObject(state, "empty");
+
+	expected = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_obj_start(&w, NRF_CLOUD_JSON_KEY_STATE);
+	nrf_cloud_json_obj_start(&w, NRF_CLOUD_JSON_KEY_REP);
+	nrf_cloud_json_obj_start(&w, NRF_CLOUD_JSON_KEY_CTRL);
+	nrf_cloud_json_bool_add(&w, NRF_CLOUD_JSON_KEY_ALERT, true);
+	nrf_cloud_json_num_add(&w, NRF_CLOUD_JSON_KEY_LOG, 3);
+	nrf_cloud_json_obj_end(&w);
+	nrf_cloud_json_arr_start(&w, "arr");
+	nrf_cloud_json_num_add(&w, NULL, 1);
+	nrf_cloud_json_str_add(&w, NULL, "two");
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_obj_end(&w);
+	nrf_cloud_json_arr_start(&w, NULL);
+	nrf_cloud_json_arr_end(&w);
+	nrf_cloud_json_bool_add(&w, NULL, false);
+	nrf_cloud_json_arr_end(&w);
+	nrf_cloud_json_null_add(&w, NRF_CLOUD_JSON_KEY_CFG);
+	nrf_cloud_json_obj_end(&w);
+	nrf_cloud_json_arr_start(&w, "empty");
+	nrf_cloud_json_arr_end(&w);
+	nrf_cloud_json_obj_end(&w);
+	nrf_cloud_json_obj_end(&w);
+
+	zassert_equal(nrf_cloud_json_writer_finish(&w), strlen(expected));
+	zassert_equal(strcmp(buf, expected), 0, "%s != %s", buf, expected);
+
+	cJSON_free(expected);
+}
+
+ZTEST(json_writer, test_escape)
+{
+	static const char str[] = "\"quoted\" \\ / \b\f\n\r\t \x01\x1f \xc3\xa9 end";
+	struct nrf_cloud_json_writer w;
+	cJSON *root = cJSON_CreateObject();
+	char *expected;
+
+	cJSON_AddStringToObject(root, "k\"ey\n", str);
+	cJSON_AddStringToObject(root, "empty", "");
+	expected = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_str_add(&w, "k\"ey\n", str);
+	nrf_cloud_json_str_add(&w, "empty", NULL);
+	nrf_cloud_json_obj_end(&w);
+
+	zassert_equal(nrf_cloud_json_writer_finish(&w), strlen(expected));
+	zassert_equal(strcmp(buf, expected), 0, "%s != %s", buf, expected);
+
+	cJSON_free(expected);
+}
+
+ZTEST(json_writer, test_numbers)
+{
+	struct nrf_cloud_json_writer w;
+	cJSON *arr = cJSON_CreateArray();
+	char *expected;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_arr_start(&w, NULL);
+
+	for (size_t i = 0; i < ARRAY_SIZE(numbers); i++) {
+		cJSON_AddItemToArray(arr, cJSON_CreateNumber(numbers[i]));
+		nrf_cloud_json_num_add(&w, NULL, numbers[i]);
+	}
+
+	nrf_cloud_json_arr_end(&w);
+
+	expected = cJSON_PrintUnformatted(arr);
+	cJSON_Delete(arr);
+
+	zassert_equal(nrf_cloud_json_writer_finish(&w), strlen(expected));
+	zassert_equal(strcmp(buf, expected), 0, "%s != %s", buf, expected);
+
+	cJSON_free(expected);
+}
+
+ZTEST(json_writer, test_buffer_size)
+{
+	struct nrf_cloud_json_writer w;
+	int len;
+
+	/* Length only */
+	nrf_cloud_json_writer_init(&w, NULL, 0);
+	sensor_write(&w, &sensor);
+	len = nrf_cloud_json_writer_finish(&w);
+	zassert_true(len > 0);
+
+	/* No room for the NUL terminator */
+	nrf_cloud_json_writer_init(&w, buf, len);
+	sensor_write(&w, &sensor);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -E2BIG);
+
+	/* Nothing is written past the end of the buffer */
+	zassert_equal((uint8_t)buf[len], 0xAA);
+
+	nrf_cloud_json_writer_init(&w, buf, len + 1);
+	sensor_write(&w, &sensor);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), len);
+	zassert_equal(buf[len], '\0');
+}
+
+ZTEST(json_writer, test_unbalanced)
+{
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_arr_start(&w, "arr");
+	nrf_cloud_json_arr_end(&w);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -EINVAL);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_obj_end(&w);
+	nrf_cloud_json_obj_end(&w);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -EINVAL);
+}
+
+ZTEST(json_writer, test_encode)
+{
+	struct nrf_cloud_data out;
+	char *expected = sensor_cjson(&sensor);
+
+	heap_stats_reset();
+
+	zassert_ok(nrf_cloud_json_encode(sensor_write, &sensor, buf, sizeof(buf), &out));
+	zassert_equal_ptr(out.ptr, buf);
+	zassert_equal(out.len, strlen(expected));
+	zassert_equal(strcmp(out.ptr, expected), 0);
+
+	/* The message is written once, into the caller's buffer */
+	zassert_equal(heap_allocs, 0);
+
+	/* The buffer must also hold the NUL terminator */
+	zassert_equal(nrf_cloud_json_encode(sensor_write, &sensor, buf, out.len, &out), -E2BIG);
+	zassert_equal(heap_allocs, 0);
+
+	cJSON_free(expected);
+}
+
+ZTEST(json_writer, test_encode_alloc)
+{
+	struct nrf_cloud_data out;
+	char *expected = log_cjson(&log_msg);
+	size_t len = strlen(expected);
+	size_t used = heap_used;
+
+	/* The estimated size is large enough: a single allocation and pass */
+	heap_stats_reset();
+
+	zassert_ok(nrf_cloud_json_encode(log_write, &log_msg, NULL, len + 16, &out));
+	zassert_equal(out.len, len);
+	zassert_equal(strcmp(out.ptr, expected), 0);
+	zassert_equal(heap_allocs, 1);
+	zassert_equal(heap_peak - used, len + 16);
+
+	nrf_cloud_free((void *)out.ptr);
+
+	/* The estimated size is too small: the output is allocated again with the exact size */
+	heap_stats_reset();
+
+	zassert_ok(nrf_cloud_json_encode(log_write, &log_msg, NULL, len / 2, &out));
+	zassert_equal(out.len, len);
+	zassert_equal(strcmp(out.ptr, expected), 0);
+	zassert_equal(heap_allocs, 2);
+	zassert_equal(heap_used - used, len + 1);
+
+	nrf_cloud_free((void *)out.ptr);
+	cJSON_free(expected);
+}
+
+static void benchmark(const char *name, nrf_cloud_json_write_fn write, const void *ctx,
+		      char *(*cjson_encode)(const void *ctx))
+{
+	struct nrf_cloud_data out;
+	uint32_t cjson_ns, writer_ns;
+	size_t cjson_peak, writer_peak;
+	uint32_t cjson_allocs;
+	uint32_t start;
+	char *str;
+
+	heap_stats_reset();
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		str = cjson_encode(ctx);
+		zassert_not_null(str);
+		cJSON_free(str);
+	}
+
+	cjson_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+	cjson_peak = heap_peak - heap_used;
+	cjson_allocs = heap_allocs / BENCH_ITERATIONS;
+
+	heap_stats_reset();
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		zassert_ok(nrf_cloud_json_encode(write, ctx, buf, sizeof(buf), &out));
+	}
+
+	writer_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+	writer_peak = heap_peak - heap_used;
+
+	zassert_equal(writer_peak, 0);
+
+	TC_PRINT("%s (%u bytes): cJSON %u ns, %u allocs, heap peak %u bytes; "
+		 "writer %u ns, heap peak %u bytes\n",
+		 name, (uint32_t)out.len, cjson_ns, cjson_allocs, (uint32_t)cjson_peak,
+		 writer_ns, (uint32_t)writer_peak);
+}
+
+static char *sensor_cjson_encode(const void *ctx)
+{
+	return sensor_cjson(ctx);
+}
+
+static char *alert_cjson_encode(const void *ctx)
+{
+	return alert_cjson(ctx);
+}
+
+static char *log_cjson_encode(const void *ctx)
+{
+	return log_cjson(ctx);
+}
+
+ZTEST(json_writer, test_benchmark)
+{
+	benchmark("Sensor", sensor_write, &sensor, sensor_cjson_encode);
+	benchmark("Alert", alert_write, &alert, alert_cjson_encode);
+	benchmark("Log", log_write, &log_msg, log_cjson_encode);
+}
+
+ZTEST_SUITE(json_writer, NULL, NULL, test_before, NULL, NULL);
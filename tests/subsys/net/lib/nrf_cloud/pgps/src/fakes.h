@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <nrfx_nvmc.h>
+#include <net/nrf_cloud_agps.h>
+#include <net/nrf_cloud_pgps.h>
+#include <nrf_cloud_fsm.h>
+#include <nrf_cloud_pgps_utils.h>
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+
+DEFINE_FFF_GLOBALS;
+
+/* Fake functions declaration */
+FAKE_VALUE_FUNC(uint32_t, nrfx_nvmc_flash_page_size_get);
+FAKE_VALUE_FUNC(enum nfsm_state, nfsm_get_current_state);
+FAKE_VALUE_FUNC(int, nrf_cloud_agps_process, const char *, size_t);
+FAKE_VOID_FUNC(nrf_cloud_agps_processed, struct nrf_modem_gnss_agps_data_frame *);
+FAKE_VALUE_FUNC(int, npgps_download_lock);
+FAKE_VOID_FUNC(npgps_download_unlock);
+FAKE_VALUE_FUNC(int, npgps_download_init, npgps_buffer_handler_t, npgps_eot_handler_t);
+FAKE_VALUE_FUNC(int, npgps_save_header, struct nrf_cloud_pgps_header *);
+FAKE_VALUE_FUNC(const struct nrf_cloud_pgps_header *, npgps_get_saved_header);
+FAKE_VALUE_FUNC(const struct gps_location *, npgps_get_saved_location);
+FAKE_VALUE_FUNC(int, npgps_settings_init);
+FAKE_VALUE_FUNC(int64_t, npgps_gps_day_time_to_sec, uint16_t, uint32_t);
+FAKE_VOID_FUNC(npgps_gps_sec_to_day_time, int64_t, uint16_t *, uint32_t *);
+FAKE_VALUE_FUNC(int, npgps_get_shifted_time, int64_t *, uint16_t *, uint32_t *, uint32_t);
+FAKE_VALUE_FUNC(int, npgps_get_time, int64_t *, uint16_t *, uint32_t *);
+FAKE_VALUE_FUNC(int, ngps_block_pool_init, uint32_t, int);
+FAKE_VALUE_FUNC(int, npgps_alloc_block);
+FAKE_VOID_FUNC(npgps_free_block, int);
+FAKE_VALUE_FUNC(int, npgps_get_block_extent, int);
+FAKE_VOID_FUNC(npgps_reset_block_pool);
+FAKE_VOID_FUNC(npgps_mark_block_used, int, bool);
+FAKE_VOID_FUNC(npgps_print_blocks);
+FAKE_VALUE_FUNC(int, npgps_num_free);
+FAKE_VALUE_FUNC(int, npgps_find_first_free, int);
+FAKE_VALUE_FUNC(uint32_t, npgps_block_to_offset, int);
+FAKE_VALUE_FUNC(int, npgps_pointer_to_block, uint8_t *);
+FAKE_VALUE_FUNC(void *, npgps_block_to_pointer, int);
+
+/* The time conversions are done as in nrf_cloud_pgps_utils.c */
+int64_t fake_npgps_gps_day_time_to_sec__converts(uint16_t gps_day, uint32_t gps_time_of_day)
+{
+	return (int64_t)gps_day * SEC_PER_DAY + gps_time_of_day;
+}
+
+void fake_npgps_gps_sec_to_day_time__converts(int64_t gps_sec, uint16_t *gps_day,
+					      uint32_t *gps_time_of_day)
+{
+	uint16_t day = (uint16_t)(gps_sec / SEC_PER_DAY);
+
+	if (gps_day) {
+		*gps_day = day;
+	}
+	if (gps_time_of_day) {
+		*gps_time_of_day = (uint32_t)(gps_sec - (day * SEC_PER_DAY));
+	}
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/storage/flash_map.h>
+#include "fakes.h"
+#include "nrf_cloud_pgps.c"
+
+#define TEST_GPS_DAY		15000
+#define TEST_GPS_TIME_OF_DAY	(2 * SEC_PER_HOUR)
+#define PERIOD_SEC		(PREDICTION_PERIOD * SEC_PER_MIN)
+#define BAD_PNUM		5
+
+/* Predictions are stored out of time order, as after partial downloads.
+ * The stride must not have common factors with NUM_PREDICTIONS.
+ */
+#define STORAGE_STRIDE		5
+
+BUILD_ASSERT(PREDICTION_CACHE_SIZE >= 2, "Eviction test needs at least two cache entries");
+BUILD_ASSERT(PREDICTION_CACHE_SIZE < NUM_PREDICTIONS, "Cache holds all predictions");
+
+typedef void (*prediction_modifier_t)(struct nrf_cloud_pgps_prediction *p);
+
+static uint8_t pred_buf[PGPS_PREDICTION_STORAGE_SIZE] __aligned(4);
+
+static int64_t prediction_gps_sec(int pnum)
+{
+	return index.start_sec + (int64_t)pnum * PERIOD_SEC;
+}
+
+static int prediction_slot(int pnum)
+{
+	return (pnum * STORAGE_STRIDE) % NUM_PREDICTIONS;
+}
+
+static off_t prediction_off(int pnum)
+{
+	return storage_addr + prediction_slot(pnum) * PGPS_PREDICTION_STORAGE_SIZE;
+}
+
+static void prediction_time_set(struct nrf_cloud_pgps_prediction *p, int64_t gps_sec)
+{
+	p->time.date_day = gps_sec / SEC_PER_DAY;
+	p->time.time_full_s = gps_sec % SEC_PER_DAY;
+	p->sentinel = (uint32_t)gps_sec;
+}
+
+static void sentinel_corrupt(struct nrf_cloud_pgps_prediction *p)
+{
+	p->sentinel ^= 1;
+}
+
+static void schema_corrupt(struct nrf_cloud_pgps_prediction *p)
+{
+	p->schema_version++;
+}
+
+/* A consistent prediction left from the previous set of predictions */
+static void time_stale(struct nrf_cloud_pgps_prediction *p)
+{
+	prediction_time_set(p, index.start_sec - PERIOD_SEC);
+}
+
+/* Store all predictions, applying modify to the one numbered bad_pnum, if any */
+static void predictions_store(int bad_pnum, prediction_modifier_t modify)
+{
+	struct nrf_cloud_pgps_prediction *p = (struct nrf_cloud_pgps_prediction *)pred_buf;
+	int err;
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		memset(pred_buf, 0, sizeof(pred_buf));
+		p->time_type = NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK;
+		p->time_count = 1;
+		prediction_time_set(p, prediction_gps_sec(pnum));
+		p->schema_version = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
+		p->ephemeris_type = NRF_CLOUD_AGPS_EPHEMERIDES;
+		p->ephemeris_count = NRF_CLOUD_PGPS_NUM_SV;
+		for (int i = 0; i < NRF_CLOUD_PGPS_NUM_SV; i++) {
+			p->ephemerii[i].sv_id = i + 1;
+		}
+
+		if ((pnum == bad_pnum) && modify) {
+			modify(p);
+		}
+
+		err = flash_area_write(prediction_flash_area,
+				       prediction_slot(pnum) * PGPS_PREDICTION_STORAGE_SIZE,
+				       pred_buf, sizeof(pred_buf));
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+}
+
+static void validate_expect_first_bad(int bad_pnum)
+{
+	uint16_t bad_day = 0;
+	uint32_t bad_time = 0;
+	uint16_t expected_day;
+	uint32_t expected_time;
+	int ret;
+
+	ret = validate_stored_predictions(&bad_day, &bad_time);
+	zassert_equal(ret, bad_pnum, "Unexpected number of valid predictions: %d", ret);
+
+	fake_npgps_gps_sec_to_day_time__converts(prediction_gps_sec(bad_pnum),
+						 &expected_day, &expected_time);
+	zassert_equal(bad_day, expected_day, "Unexpected first bad day: %u", bad_day);
+	zassert_equal(bad_time, expected_time, "Unexpected first bad time: %u", bad_time);
+}
+
+static void validate_expect_all_good(void)
+{
+	uint16_t bad_day;
+	uint32_t bad_time;
+	int ret;
+
+	ret = validate_stored_predictions(&bad_day, &bad_time);
+	zassert_equal(ret, NUM_PREDICTIONS, "Unexpected number of valid predictions: %d", ret);
+}
+
+static void *nrf_cloud_pgps_test_setup(void)
+{
+	int err;
+
+	err = flash_area_open(FIXED_PARTITION_ID(storage_partition), &prediction_flash_area);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_true(prediction_flash_area->fa_size >= NUM_PREDICTIONS * BLOCK_SIZE,
+		     "Storage partition is too small");
+
+	storage_addr = prediction_flash_area->fa_off;
+
+	return NULL;
+}
+
+static void nrf_cloud_pgps_test_before(void *fixture)
+{
+	int err;
+
+	ARG_UNUSED(fixture);
+
+	RESET_FAKE(npgps_gps_day_time_to_sec);
+	RESET_FAKE(npgps_gps_sec_to_day_time);
+	RESET_FAKE(npgps_reset_block_pool);
+	RESET_FAKE(npgps_mark_block_used);
+	RESET_FAKE(npgps_find_first_free);
+	RESET_FAKE(npgps_pointer_to_block);
+	RESET_FAKE(npgps_print_blocks);
+	FFF_RESET_HISTORY();
+
+	npgps_gps_day_time_to_sec_fake.custom_fake = fake_npgps_gps_day_time_to_sec__converts;
+	npgps_gps_sec_to_day_time_fake.custom_fake = fake_npgps_gps_sec_to_day_time__converts;
+
+	err = flash_area_erase(prediction_flash_area, 0, NUM_PREDICTIONS * BLOCK_SIZE);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	index.header = (struct nrf_cloud_pgps_header) {
+		.schema_version = NRF_CLOUD_PGPS_BIN_SCHEMA_VERSION,
+		.array_type = NRF_CLOUD_PGPS_PREDICTION_HEADER,
+		.num_items = 1,
+		.prediction_count = NUM_PREDICTIONS,
+		.prediction_size = PGPS_PREDICTION_STORAGE_SIZE,
+		.prediction_period_min = PREDICTION_PERIOD,
+		.gps_day = TEST_GPS_DAY,
+		.gps_time_of_day = TEST_GPS_TIME_OF_DAY
+	};
+	index.start_sec = (int64_t)TEST_GPS_DAY * SEC_PER_DAY + TEST_GPS_TIME_OF_DAY;
+
+	discard_prediction_buffer();
+	prediction_cache_clock = 0;
+	prediction_flash_reads = 0;
+}
+
+ZTEST(nrf_cloud_pgps_test, test_validate_stored_predictions)
+{
+	predictions_store(-1, NULL);
+
+	validate_expect_all_good();
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_equal((off_t)index.predictions[pnum], prediction_off(pnum),
+			      "Prediction %d not found in its slot", pnum);
+	}
+	zassert_equal(npgps_mark_block_used_fake.call_count, NUM_PREDICTIONS,
+		      "Not all blocks are marked as used");
+
+	/* Only the fields needed for validation are read, not the ephemerides */
+	zassert_equal(prediction_flash_reads, 2 * NUM_PREDICTIONS,
+		      "Unexpected number of flash reads: %u", prediction_flash_reads);
+}
+
+ZTEST(nrf_cloud_pgps_test, test_validate_stored_predictions_corrupt_sentinel)
+{
+	predictions_store(BAD_PNUM, sentinel_corrupt);
+
+	validate_expect_first_bad(BAD_PNUM);
+
+	zassert_equal((off_t)index.predictions[BAD_PNUM], prediction_off(BAD_PNUM),
+		      "Corrupt prediction not found in its slot");
+}
+
+ZTEST(nrf_cloud_pgps_test, test_validate_stored_predictions_corrupt_schema)
+{
+	predictions_store(BAD_PNUM, schema_corrupt);
+
+	validate_expect_first_bad(BAD_PNUM);
+}
+
+ZTEST(nrf_cloud_pgps_test, test_validate_stored_predictions_stale)
+{
+	predictions_store(BAD_PNUM, time_stale);
+
+	validate_expect_first_bad(BAD_PNUM);
+
+	/* The stale prediction is out of the time range, so it is missing */
+	zassert_is_null(index.predictions[BAD_PNUM], "Stale prediction is used");
+}
+
+ZTEST(nrf_cloud_pgps_test, test_validate_stored_predictions_first_stale)
+{
+	predictions_store(0, time_stale);
+
+	validate_expect_first_bad(0);
+}
+
+ZTEST(nrf_cloud_pgps_test, test_get_cached_prediction_hit)
+{
+	struct nrf_cloud_pgps_prediction *p1;
+	struct nrf_cloud_pgps_prediction *p2;
+	struct prediction_summary summary;
+	uint32_t reads;
+	int err;
+
+	predictions_store(-1, NULL);
+	validate_expect_all_good();
+	reads = prediction_flash_reads;
+
+	p1 = get_prediction(0);
+	zassert_not_null(p1, "Prediction not read");
+	zassert_equal(prediction_flash_reads, reads + 1, "Prediction not read from flash");
+	zassert_equal(p1->sentinel, (uint32_t)prediction_gps_sec(0), "Wrong prediction read");
+
+	p2 = get_prediction(0);
+	zassert_equal_ptr(p1, p2, "Cached prediction not used");
+	zassert_equal(prediction_flash_reads, reads + 1, "Cached prediction read again");
+
+	/* The summary of a cached prediction is taken from the cache */
+	err = get_prediction_summary(prediction_off(0), &summary);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(prediction_flash_reads, reads + 1, "Cached summary read from flash");
+	zassert_equal(summary.sentinel, p1->sentinel, "Wrong summary");
+
+	/* The summary of another prediction does not replace the cached one */
+	err = get_prediction_summary(prediction_off(1), &summary);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(prediction_flash_reads, reads + 3, "Summary not read from flash");
+	zassert_equal(summary.sentinel, (uint32_t)prediction_gps_sec(1), "Wrong summary");
+
+	p2 = get_prediction(0);
+	zassert_equal_ptr(p1, p2, "Cached prediction not used");
+	zassert_equal(prediction_flash_reads, reads + 3, "Cached prediction read again");
+}
+
+ZTEST(nrf_cloud_pgps_test, test_get_cached_prediction_eviction)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	uint32_t reads;
+	int pnum;
+
+	predictions_store(-1, NULL);
+	validate_expect_all_good();
+	reads = prediction_flash_reads;
+
+	for (pnum = 0; pnum < PREDICTION_CACHE_SIZE; pnum++) {
+		zassert_not_null(get_prediction(pnum), "Prediction %d not read", pnum);
+	}
+	zassert_equal(prediction_flash_reads, reads + PREDICTION_CACHE_SIZE,
+		      "Unexpected number of flash reads: %u", prediction_flash_reads - reads);
+
+	/* Use the first prediction again, so the second one is least recently used */
+	zassert_not_null(get_prediction(0), "Prediction 0 not read");
+	zassert_equal(prediction_flash_reads, reads + PREDICTION_CACHE_SIZE,
+		      "Cached prediction read again");
+
+	p = get_prediction(PREDICTION_CACHE_SIZE);
+	zassert_not_null(p, "Prediction %d not read", PREDICTION_CACHE_SIZE);
+	zassert_equal(p->sentinel, (uint32_t)prediction_gps_sec(PREDICTION_CACHE_SIZE),
+		      "Wrong prediction read");
+	zassert_equal(prediction_flash_reads, reads + PREDICTION_CACHE_SIZE + 1,
+		      "Prediction not read from flash");
+	zassert_is_null(find_cached_prediction(prediction_off(1)),
+			"Least recently used prediction not replaced");
+
+	for (pnum = 0; pnum <= PREDICTION_CACHE_SIZE; pnum++) {
+		if (pnum != 1) {
+			zassert_not_null(find_cached_prediction(prediction_off(pnum)),
+					 "Prediction %d replaced", pnum);
+		}
+	}
+
+	p = get_prediction(1);
+	zassert_not_null(p, "Prediction 1 not read");
+	zassert_equal(p->sentinel, (uint32_t)prediction_gps_sec(1), "Wrong prediction read");
+	zassert_equal(prediction_flash_reads, reads + PREDICTION_CACHE_SIZE + 2,
+		      "Prediction not read from flash");
+}
+
+ZTEST(nrf_cloud_pgps_test, test_validate_stored_predictions_duration)
+{
+	uint16_t bad_day;
+	uint32_t bad_time;
+	uint32_t reads;
+	int64_t start;
+	int64_t duration;
+	int ret;
+
+	predictions_store(-1, NULL);
+
+	start = k_uptime_get();
+	ret = validate_stored_predictions(&bad_day, &bad_time);
+	duration = k_uptime_get() - start;
+
+	TC_PRINT("Validated %d predictions in %lld ms with %u flash reads\n",
+		 ret, duration, prediction_flash_reads);
+	zassert_equal(ret, NUM_PREDICTIONS, "Unexpected number of valid predictions: %d", ret);
+
+	/* For comparison, read the full predictions, as validation would without summaries */
+	reads = prediction_flash_reads;
+	start = k_uptime_get();
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_not_null(get_prediction(pnum), "Prediction %d not read", pnum);
+	}
+	duration = k_uptime_get() - start;
+
+	TC_PRINT("Read %d full predictions in %lld ms with %u flash reads\n",
+		 NUM_PREDICTIONS, duration, prediction_flash_reads - reads);
+}
+
+ZTEST_SUITE(nrf_cloud_pgps_test, NULL, nrf_cloud_pgps_test_setup,
+	    nrf_cloud_pgps_test_before, NULL, NULL);
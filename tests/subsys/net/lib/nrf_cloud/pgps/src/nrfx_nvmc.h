@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Stand-in for the nrfx NVMC driver header, which is not available on native_posix */
+
+#ifndef NRFX_NVMC_H__
+#define NRFX_NVMC_H__
+
+#include <stdint.h>
+
+uint32_t nrfx_nvmc_flash_page_size_get(void);
+
+#endif /* NRFX_NVMC_H__ */
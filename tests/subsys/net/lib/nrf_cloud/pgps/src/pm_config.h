@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Stand-in for the Partition Manager configuration, which is not generated on native_posix.
+ * The predictions are stored in the storage partition of the flash simulator.
+ */
+
+#ifndef PM_CONFIG_H__
+#define PM_CONFIG_H__
+
+#include <zephyr/storage/flash_map.h>
+
+/* Use the flash map of the devicetree instead of the one of the Partition Manager */
+#define FLASH_MAP_PM_H_
+
+#undef FLASH_AREA_ID
+#undef FLASH_AREA_DEVICE
+#define FLASH_AREA_ID(label) FIXED_PARTITION_ID(storage_partition)
+#define FLASH_AREA_DEVICE(label) FIXED_PARTITION_DEVICE(storage_partition)
+
+#endif /* PM_CONFIG_H__ */
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <net/rest_client.h>
+
+#include "zephyr/net/cmock_socket.h"
+#include "zephyr/net/http/cmock_client.h"
+
+#define TEST_HOST		"api.nrfcloud.com"
+#define TEST_HOST_2		"api.example.com"
+#define TEST_HOST_3		"api.example.net"
+#define TEST_PORT		443
+#define TEST_SEC_TAG		42
+#define TEST_LOCATION_URL	"/v1/location/ground-fix"
+#define TEST_LOCATION_BODY	"{\"lte\":[{\"mcc\":242,\"mnc\":1,\"eci\":21858829,\"tac\":2305}]}"
+#define TEST_LOCATION_RESULT	"{\"lat\":63.4,\"lon\":10.4,\"uncertainty\":1000}"
+
+#define RESPONSE_HEADERS	"HTTP/1.1 200 OK\r\n" \
+				"Content-Type: application/json\r\n" \
+				"Content-Length: 42\r\n"
+#define RESPONSE_KEEP_ALIVE	RESPONSE_HEADERS "\r\n" TEST_LOCATION_RESULT
+#define RESPONSE_CLOSE		RESPONSE_HEADERS "Connection: close\r\n\r\n" TEST_LOCATION_RESULT
+
+/* Simulated cost of DNS, TCP and TLS connection setup, and of a request round trip. */
+#define STANDIN_CONNECT_MS	300
+#define STANDIN_ROUND_TRIP_MS	50
+
+/* Number of sequential requests in the latency tests. */
+#define TEST_REQUEST_COUNT	5
+
+#define TEST_RX_BUF_SIZE	512
+
+/* It is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+/* State of the HTTPS server stand-in. */
+static int next_socket;
+static int sockets_open;
+static int connect_count;
+static int close_count;
+static bool standin_close_connection;
+/* Socket on which the stand-in has closed the connection while it was idle. */
+static int standin_closed_socket;
+/* Socket on which the stand-in does not respond. */
+static int standin_timeout_socket;
+static int request_count;
+/* Method of the requests sent by the test. */
+static enum http_method request_method;
+
+static struct sockaddr_in standin_addr = {
+	.sin_family = AF_INET,
+};
+static struct addrinfo standin_addrinfo = {
+	.ai_family = AF_INET,
+	.ai_socktype = SOCK_STREAM,
+	.ai_addr = (struct sockaddr *)&standin_addr,
+	.ai_addrlen = sizeof(standin_addr),
+};
+
+static char rx_buf[TEST_RX_BUF_SIZE];
+
+/* Stubs */
+static int getaddrinfo_stub(const char *host, const char *service,
+			    const struct addrinfo *hints, struct addrinfo **res, int num_calls)
+{
+	*res = &standin_addrinfo;
+
+	return 0;
+}
+
+static int socket_stub(int family, int type, int proto, int num_calls)
+{
+	sockets_open++;
+
+	return next_socket++;
+}
+
+static int connect_stub(int sock, const struct sockaddr *addr, socklen_t addrlen, int num_calls)
+{
+	k_sleep(K_MSEC(STANDIN_CONNECT_MS));
+
+	connect_count++;
+
+	return 0;
+}
+
+static int close_stub(int sock, int num_calls)
+{
+	sockets_open--;
+	close_count++;
+
+	return 0;
+}
+
+static int http_client_req_stub(int sock, struct http_request *req, int32_t timeout,
+				void *user_data, int num_calls)
+{
+	struct http_response *rsp = &req->internal.response;
+	struct http_parser_settings settings;
+	const char *reply = standin_close_connection ? RESPONSE_CLOSE : RESPONSE_KEEP_ALIVE;
+	size_t reply_len = strlen(reply);
+	const char *body = strstr(reply, "\r\n\r\n") + 4;
+
+	k_sleep(K_MSEC(STANDIN_ROUND_TRIP_MS));
+
+	request_count++;
+
+	if (sock == standin_closed_socket) {
+		return -ECONNRESET;
+	}
+
+	if (sock == standin_timeout_socket) {
+		return -ETIMEDOUT;
+	}
+
+	TEST_ASSERT_EQUAL(request_method, req->method);
+	TEST_ASSERT_EQUAL_STRING(TEST_LOCATION_URL, req->url);
+	TEST_ASSERT_LESS_THAN(req->recv_buf_len, reply_len);
+
+	/* Parse the reply like the HTTP client does, to get the keep-alive state. */
+	http_parser_init(&req->internal.parser, HTTP_RESPONSE);
+	http_parser_settings_init(&settings);
+	TEST_ASSERT_EQUAL(reply_len, http_parser_execute(&req->internal.parser, &settings, reply,
+							 reply_len));
+
+	memcpy(req->recv_buf, reply, reply_len);
+
+	memset(rsp, 0, sizeof(*rsp));
+	rsp->recv_buf = req->recv_buf;
+	rsp->body_found = 1;
+	rsp->body_frag_start = req->recv_buf + (body - reply);
+	rsp->data_len = reply_len;
+	rsp->processed = strlen(body);
+	rsp->http_status_code = req->internal.parser.status_code;
+	strcpy(rsp->http_status, "OK");
+
+	req->response(rsp, HTTP_DATA_FINAL, user_data);
+
+	return reply_len;
+}
+
+/* Helper functions */
+static int location_request(const char *host, bool keep_alive,
+			    struct rest_client_resp_context *resp)
+{
+	struct rest_client_req_context req;
+
+	memset(resp, 0, sizeof(*resp));
+	rest_client_request_defaults_set(&req);
+
+	req.host = host;
+	req.port = TEST_PORT;
+	req.sec_tag = TEST_SEC_TAG;
+	req.url = TEST_LOCATION_URL;
+	req.http_method = request_method;
+	req.body = (request_method == HTTP_POST) ? TEST_LOCATION_BODY : NULL;
+	req.keep_alive = keep_alive;
+	req.resp_buff = rx_buf;
+	req.resp_buff_len = sizeof(rx_buf);
+
+	return rest_client_request(&req, resp);
+}
+
+static void location_request_check(const char *host)
+{
+	struct rest_client_resp_context resp;
+
+	TEST_ASSERT_EQUAL(0, location_request(host, false, &resp));
+	TEST_ASSERT_EQUAL(REST_CLIENT_HTTP_STATUS_OK, resp.http_status_code);
+	TEST_ASSERT_EQUAL(strlen(TEST_LOCATION_RESULT), resp.response_len);
+	TEST_ASSERT_EQUAL_STRING(TEST_LOCATION_RESULT, resp.response);
+}
+
+/* Send sequential location requests and return the average latency in milliseconds. */
+static int64_t location_requests_measure(void)
+{
+	int64_t start;
+	int64_t latency;
+	int64_t total = 0;
+
+	for (int i = 0; i < TEST_REQUEST_COUNT; i++) {
+		start = k_uptime_get();
+
+		location_request_check(TEST_HOST);
+
+		latency = k_uptime_get() - start;
+		total += latency;
+
+		printk("Request %d: %lld ms\n", i, latency);
+	}
+
+	return total / TEST_REQUEST_COUNT;
+}
+
+void setUp(void)
+{
+	__cmock_getaddrinfo_Stub(getaddrinfo_stub);
+	__cmock_freeaddrinfo_Ignore();
+	__cmock_inet_ntop_IgnoreAndReturn(NULL);
+	__cmock_socket_Stub(socket_stub);
+	__cmock_setsockopt_IgnoreAndReturn(0);
+	__cmock_connect_Stub(connect_stub);
+	__cmock_close_Stub(close_stub);
+	__cmock_http_client_req_Stub(http_client_req_stub);
+
+	/* Start every test without pooled connections. */
+	(void)rest_client_conn_pool_flush();
+
+	next_socket = 10;
+	sockets_open = 0;
+	connect_count = 0;
+	close_count = 0;
+	standin_close_connection = false;
+	standin_closed_socket = -1;
+	standin_timeout_socket = -1;
+	request_count = 0;
+	request_method = HTTP_POST;
+}
+
+void tearDown(void)
+{
+	(void)rest_client_conn_pool_flush();
+
+	/* No socket is leaked. */
+	TEST_ASSERT_EQUAL(0, sockets_open);
+}
+
+/* Tests */
+
+void test_sequential_requests_reuse_connection(void)
+{
+	int64_t pooled;
+	int64_t baseline;
+
+	/* A server that closes the connection after each response is the baseline. */
+	standin_close_connection = true;
+	baseline = location_requests_measure();
+
+	TEST_ASSERT_EQUAL(TEST_REQUEST_COUNT, connect_count);
+	TEST_ASSERT_EQUAL(TEST_REQUEST_COUNT, close_count);
+
+	connect_count = 0;
+	standin_close_connection = false;
+	pooled = location_requests_measure();
+
+	printk("Average latency of %d sequential requests: %lld ms pooled, %lld ms baseline\n",
+	       TEST_REQUEST_COUNT, pooled, baseline);
+
+	/* Only the first request connects. */
+	TEST_ASSERT_EQUAL(1, connect_count);
+	TEST_ASSERT_EQUAL(1, sockets_open);
+	TEST_ASSERT_LESS_THAN(baseline, pooled);
+}
+
+void test_pooled_socket_is_reported_alive(void)
+{
+	struct rest_client_resp_context resp;
+
+	TEST_ASSERT_EQUAL(0, location_request(TEST_HOST, false, &resp));
+	TEST_ASSERT_TRUE(resp.used_socket_is_alive);
+
+	/* A connection that the server closes is not kept. */
+	standin_close_connection = true;
+
+	TEST_ASSERT_EQUAL(0, location_request(TEST_HOST, false, &resp));
+	TEST_ASSERT_FALSE(resp.used_socket_is_alive);
+	TEST_ASSERT_EQUAL(0, sockets_open);
+}
+
+void test_idle_connection_is_closed(void)
+{
+	location_request_check(TEST_HOST);
+
+	k_sleep(K_MSEC(CONFIG_REST_CLIENT_CONN_POOL_IDLE_TIMEOUT * MSEC_PER_SEC + 100));
+
+	location_request_check(TEST_HOST);
+
+	TEST_ASSERT_EQUAL(2, connect_count);
+	TEST_ASSERT_EQUAL(1, close_count);
+}
+
+void test_reconnect_when_closed_by_server(void)
+{
+	struct rest_client_resp_context resp;
+
+	location_request_check(TEST_HOST);
+
+	/* The server closes the connection while it is idle in the pool. */
+	standin_closed_socket = next_socket - 1;
+
+	TEST_ASSERT_EQUAL(0, location_request(TEST_HOST, false, &resp));
+	TEST_ASSERT_EQUAL(REST_CLIENT_HTTP_STATUS_OK, resp.http_status_code);
+	TEST_ASSERT_EQUAL(next_socket - 1, resp.used_socket_id);
+
+	TEST_ASSERT_EQUAL(2, connect_count);
+	TEST_ASSERT_EQUAL(1, close_count);
+}
+
+void test_post_not_sent_again_after_timeout(void)
+{
+	struct rest_client_resp_context resp;
+
+	location_request_check(TEST_HOST);
+
+	/* The server may have processed the request, a POST must not be duplicated. */
+	standin_timeout_socket = next_socket - 1;
+
+	TEST_ASSERT_EQUAL(-ETIMEDOUT, location_request(TEST_HOST, false, &resp));
+	TEST_ASSERT_EQUAL(2, request_count);
+	TEST_ASSERT_EQUAL(1, connect_count);
+
+	/* The failed connection is not kept in the pool. */
+	TEST_ASSERT_EQUAL(1, close_count);
+}
+
+void test_get_sent_again_after_timeout(void)
+{
+	struct rest_client_resp_context resp;
+
+	request_method = HTTP_GET;
+	location_request_check(TEST_HOST);
+
+	standin_timeout_socket = next_socket - 1;
+
+	TEST_ASSERT_EQUAL(0, location_request(TEST_HOST, false, &resp));
+	TEST_ASSERT_EQUAL(REST_CLIENT_HTTP_STATUS_OK, resp.http_status_code);
+	TEST_ASSERT_EQUAL(3, request_count);
+	TEST_ASSERT_EQUAL(2, connect_count);
+	TEST_ASSERT_EQUAL(1, close_count);
+}
+
+void test_least_recently_used_connection_is_replaced(void)
+{
+	location_request_check(TEST_HOST);
+	location_request_check(TEST_HOST_2);
+	location_request_check(TEST_HOST);
+
+	/* The pool is full, the connection to TEST_HOST_2 is the least recently used. */
+	location_request_check(TEST_HOST_3);
+	TEST_ASSERT_EQUAL(3, connect_count);
+	TEST_ASSERT_EQUAL(1, close_count);
+
+	location_request_check(TEST_HOST);
+	TEST_ASSERT_EQUAL(3, connect_count);
+	TEST_ASSERT_EQUAL(2, sockets_open);
+}
+
+void test_caller_managed_keep_alive_is_not_pooled(void)
+{
+	struct rest_client_resp_context resp;
+
+	TEST_ASSERT_EQUAL(0, location_request(TEST_HOST, true, &resp));
+	TEST_ASSERT_TRUE(resp.used_socket_is_alive);
+
+	/* The socket belongs to the caller, so the next request does not reuse it. */
+	location_request_check(TEST_HOST);
+	TEST_ASSERT_EQUAL(2, connect_count);
+
+	TEST_ASSERT_EQUAL(0, close(resp.used_socket_id));
+}
+
+void test_pool_flush(void)
+{
+	location_request_check(TEST_HOST);
+	location_request_check(TEST_HOST_2);
+
+	TEST_ASSERT_EQUAL(2, rest_client_conn_pool_flush());
+	TEST_ASSERT_EQUAL(0, sockets_open);
+	TEST_ASSERT_EQUAL(0, rest_client_conn_pool_flush());
+}
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
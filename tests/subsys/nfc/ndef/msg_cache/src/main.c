@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include <nfc/ndef/msg.h>
+#include <nfc/ndef/uri_rec.h>
+#include <nfc/t4t/ndef_file.h>
+
+#define MAX_RECORDS      16
+#define URI_MAX_LEN      48
+#define BUF_SIZE         1024
+#define BENCH_ITERATIONS 1000
+
+static uint8_t uri_data[MAX_RECORDS][URI_MAX_LEN];
+static struct nfc_ndef_uri_rec_payload uri_payload[MAX_RECORDS];
+static struct nfc_ndef_record_desc uri_record[MAX_RECORDS];
+
+static struct nfc_ndef_record_desc const *record_array[MAX_RECORDS];
+static struct nfc_ndef_msg_desc msg = {
+	.record = record_array,
+	.max_record_count = MAX_RECORDS,
+};
+
+NFC_NDEF_MSG_CACHE_DEF(cache, MAX_RECORDS);
+
+static uint8_t buf[BUF_SIZE];
+static uint8_t ref_buf[BUF_SIZE];
+
+static void uri_set(uint32_t idx, uint32_t counter)
+{
+	uri_payload[idx].uri_data_len = snprintf((char *)uri_data[idx], URI_MAX_LEN,
+						 "example.com/r%u?c=%u", idx, counter);
+}
+
+static void msg_prepare(uint32_t record_cnt)
+{
+	nfc_ndef_msg_clear(&msg);
+
+	for (uint32_t i = 0; i < record_cnt; i++) {
+		uri_payload[i].uri_id_code = NFC_URI_HTTPS_WWW;
+		uri_payload[i].uri_data = uri_data[i];
+		uri_set(i, 0);
+
+		uri_record[i] = (struct nfc_ndef_record_desc) {
+			.tnf = TNF_WELL_KNOWN,
+			.type = &nfc_ndef_uri_rec_type,
+			.type_length = sizeof(nfc_ndef_uri_rec_type),
+			.payload_constructor =
+				(payload_constructor_t)nfc_ndef_uri_rec_payload_encode,
+			.payload_descriptor = &uri_payload[i],
+		};
+
+		zassert_ok(nfc_ndef_msg_record_add(&msg, &uri_record[i]));
+	}
+}
+
+static uint32_t msg_cache_encode(uint8_t *msg_buf, uint32_t size)
+{
+	uint32_t len = size;
+
+	zassert_ok(nfc_ndef_msg_cache_encode(&NFC_NDEF_MSG_CACHE(cache), &msg, msg_buf, &len));
+
+	return len;
+}
+
+/* Compare the cached message with a message encoded from scratch. */
+static void msg_verify(uint32_t len)
+{
+	uint32_t ref_len = sizeof(ref_buf);
+
+	zassert_ok(nfc_ndef_msg_encode(&msg, ref_buf, &ref_len));
+	zassert_equal(len, ref_len, "Message length %u, expected %u", len, ref_len);
+	zassert_mem_equal(buf, ref_buf, len);
+}
+
+ZTEST(nfc_ndef_msg_cache, test_encode)
+{
+	msg_prepare(4);
+	msg_verify(msg_cache_encode(buf, sizeof(buf)));
+}
+
+ZTEST(nfc_ndef_msg_cache, test_update_same_len)
+{
+	uint32_t len;
+
+	msg_prepare(4);
+	msg_cache_encode(buf, sizeof(buf));
+
+	uri_set(2, 7);
+	zassert_ok(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 2, &len));
+	msg_verify(len);
+}
+
+ZTEST(nfc_ndef_msg_cache, test_update_len_change)
+{
+	uint32_t len;
+
+	msg_prepare(4);
+	msg_cache_encode(buf, sizeof(buf));
+
+	/* Grow the first record, then the last one, then shrink them back. */
+	uri_set(0, 123456);
+	zassert_ok(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 0, &len));
+	msg_verify(len);
+
+	uri_set(3, 98765);
+	zassert_ok(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 3, &len));
+	msg_verify(len);
+
+	uri_set(0, 1);
+	zassert_ok(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 0, &len));
+	msg_verify(len);
+
+	uri_set(1, 4242);
+	zassert_ok(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 1, &len));
+	msg_verify(len);
+}
+
+ZTEST(nfc_ndef_msg_cache, test_update_invalid)
+{
+	uint32_t len;
+
+	zassert_equal(nfc_ndef_msg_cache_record_update(NULL, 0, &len), -EINVAL);
+
+	msg_prepare(2);
+	msg_cache_encode(buf, sizeof(buf));
+
+	zassert_equal(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 2, &len),
+		      -EINVAL);
+}
+
+ZTEST(nfc_ndef_msg_cache, test_update_no_space)
+{
+	uint32_t encoded_len;
+	uint32_t len;
+
+	msg_prepare(2);
+	encoded_len = msg_cache_encode(buf, sizeof(buf));
+	/* Limit the buffer to the encoded message. */
+	encoded_len = msg_cache_encode(buf, encoded_len);
+
+	uri_set(0, 100000);
+	zassert_equal(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 0, &len),
+		      -ENOSR);
+
+	/* The cache is still valid after a rejected update. */
+	uri_set(0, 1);
+	zassert_ok(nfc_ndef_msg_cache_record_update(&NFC_NDEF_MSG_CACHE(cache), 0, &len));
+	zassert_equal(len, encoded_len);
+	msg_verify(len);
+}
+
+ZTEST(nfc_ndef_msg_cache, test_t4t_ndef_file_update)
+{
+	static uint8_t file_buf[BUF_SIZE];
+	static uint8_t ref_file_buf[BUF_SIZE];
+	uint32_t size;
+	uint32_t ref_size = nfc_t4t_ndef_file_msg_size_get(sizeof(ref_file_buf));
+
+	msg_prepare(3);
+
+	size = msg_cache_encode(nfc_t4t_ndef_file_msg_get(file_buf),
+				nfc_t4t_ndef_file_msg_size_get(sizeof(file_buf)));
+	zassert_ok(nfc_t4t_ndef_file_encode(file_buf, &size));
+
+	uri_set(1, 31337);
+	zassert_ok(nfc_t4t_ndef_file_record_update(file_buf, &NFC_NDEF_MSG_CACHE(cache), 1,
+						   &size));
+
+	zassert_ok(nfc_ndef_msg_encode(&msg, nfc_t4t_ndef_file_msg_get(ref_file_buf),
+				       &ref_size));
+	zassert_ok(nfc_t4t_ndef_file_encode(ref_file_buf, &ref_size));
+
+	zassert_equal(size, ref_size);
+	zassert_mem_equal(file_buf, ref_file_buf, size);
+
+	/* The buffer must hold the cached message. */
+	zassert_equal(nfc_t4t_ndef_file_record_update(ref_file_buf, &NFC_NDEF_MSG_CACHE(cache),
+						      1, &size),
+		      -EINVAL);
+}
+
+static uint32_t bench_full_encode(uint32_t idx)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+		uint32_t size = nfc_t4t_ndef_file_msg_size_get(sizeof(buf));
+
+		uri_set(idx, i * 10);
+		zassert_ok(nfc_ndef_msg_encode(&msg, nfc_t4t_ndef_file_msg_get(buf), &size));
+		zassert_ok(nfc_t4t_ndef_file_encode(buf, &size));
+	}
+
+	return k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+}
+
+static uint32_t bench_record_update(uint32_t idx)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+		uint32_t size;
+
+		uri_set(idx, i * 10);
+		zassert_ok(nfc_t4t_ndef_file_record_update(buf, &NFC_NDEF_MSG_CACHE(cache), idx,
+							   &size));
+	}
+
+	return k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+}
+
+ZTEST(nfc_ndef_msg_cache, test_update_latency_benchmark)
+{
+	TC_PRINT("records | full encode [ns] | update first [ns] | update last [ns]\n");
+
+	for (uint32_t record_cnt = 1; record_cnt <= MAX_RECORDS; record_cnt *= 2) {
+		uint32_t full_ns;
+		uint32_t first_ns;
+		uint32_t last_ns;
+		uint32_t size;
+
+		msg_prepare(record_cnt);
+		full_ns = bench_full_encode(0);
+
+		size = msg_cache_encode(nfc_t4t_ndef_file_msg_get(buf),
+					nfc_t4t_ndef_file_msg_size_get(sizeof(buf)));
+		zassert_ok(nfc_t4t_ndef_file_encode(buf, &size));
+
+		/* Counters grow from 1 to 5 digits, so the updates also move the tail. */
+		first_ns = bench_record_update(0);
+		last_ns = bench_record_update(record_cnt - 1);
+
+		TC_PRINT("%7u | %16u | %17u | %16u\n", record_cnt, full_ns, first_ns, last_ns);
+
+		size = nfc_t4t_ndef_file_msg_size_get(sizeof(ref_buf));
+		zassert_ok(nfc_ndef_msg_encode(&msg, nfc_t4t_ndef_file_msg_get(ref_buf), &size));
+		zassert_ok(nfc_t4t_ndef_file_encode(ref_buf, &size));
+		zassert_mem_equal(buf, ref_buf, size);
+	}
+}
+
+ZTEST_SUITE(nfc_ndef_msg_cache, NULL, NULL, NULL, NULL, NULL);
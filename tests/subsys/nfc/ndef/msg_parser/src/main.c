@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <nfc/ndef/msg_parser.h>
+
+#define RAW_BUF_SIZE     256
+/* Every record takes at least 3 bytes, so the parser never runs out of descriptors. */
+#define MAX_RECORDS      (RAW_BUF_SIZE / 3 + 1)
+#define FUZZ_ITERATIONS  20000
+#define FUZZ_MAX_RECORDS 8
+
+#define BENCH_RECORDS     16
+#define BENCH_PAYLOAD_LEN 96
+#define BENCH_ITERATIONS  1000
+
+static uint8_t raw[BENCH_RECORDS * (BENCH_PAYLOAD_LEN + 64)];
+static uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MAX_RECORDS)] __aligned(4);
+
+static const uint8_t bench_type[] = "application/vnd.bluetooth.le.oob";
+
+static uint32_t lcg_state;
+
+static uint32_t lcg_next(void)
+{
+	lcg_state = lcg_state * 1103515245 + 12345;
+
+	return lcg_state >> 8;
+}
+
+static uint32_t record_put(uint8_t *buf, uint8_t location, enum nfc_ndef_record_tnf tnf,
+			   bool short_record, const uint8_t *type, uint8_t type_len,
+			   uint8_t id_len, uint32_t payload_len)
+{
+	uint8_t *p = buf;
+
+	*p++ = location | tnf | (short_record ? NDEF_RECORD_SR_MASK : 0) |
+	       (id_len ? NDEF_RECORD_IL_MASK : 0);
+	*p++ = type_len;
+
+	if (short_record) {
+		*p++ = payload_len;
+	} else {
+		sys_put_be32(payload_len, p);
+		p += NDEF_RECORD_PAYLOAD_LEN_LONG_SIZE;
+	}
+
+	if (id_len) {
+		*p++ = id_len;
+	}
+
+	if (type_len) {
+		memcpy(p, type, type_len);
+		p += type_len;
+	}
+
+	for (uint32_t i = 0; i < id_len + payload_len; i++) {
+		*p++ = i;
+	}
+
+	return p - buf;
+}
+
+static uint8_t record_location(uint32_t idx, uint32_t cnt)
+{
+	if (cnt == 1) {
+		return NDEF_LONE_RECORD;
+	} else if (idx == 0) {
+		return NDEF_FIRST_RECORD;
+	} else if (idx == cnt - 1) {
+		return NDEF_LAST_RECORD;
+	}
+
+	return NDEF_MIDDLE_RECORD;
+}
+
+static uint32_t random_msg_put(uint8_t *buf)
+{
+	static const uint8_t type[] = "Type";
+	uint32_t cnt = 1 + lcg_next() % FUZZ_MAX_RECORDS;
+	uint32_t len = 0;
+
+	for (uint32_t i = 0; i < cnt; i++) {
+		len += record_put(&buf[len], record_location(i, cnt), lcg_next() % 8,
+				  lcg_next() & 1, type, lcg_next() % sizeof(type),
+				  lcg_next() % 3, lcg_next() % 12);
+	}
+
+	return len;
+}
+
+static void view_verify(const struct nfc_ndef_record_view *view,
+			const struct nfc_ndef_record_desc *rec_desc)
+{
+	const struct nfc_ndef_bin_payload_desc *bin_pay_desc = rec_desc->payload_descriptor;
+
+	zassert_equal(view->tnf, rec_desc->tnf);
+	zassert_equal(view->type_length, rec_desc->type_length);
+	zassert_equal_ptr(view->type, rec_desc->type);
+	zassert_equal(view->id_length, rec_desc->id_length);
+	zassert_equal_ptr(view->id, rec_desc->id);
+	zassert_equal(view->payload_length, bin_pay_desc->payload_length);
+	zassert_equal_ptr(view->payload, bin_pay_desc->payload);
+}
+
+/* Parse the data with both parsers and compare the results. */
+static void parsers_compare(const uint8_t *data, uint32_t len)
+{
+	const struct nfc_ndef_msg_desc *msg = (const struct nfc_ndef_msg_desc *)desc_buf;
+	uint32_t desc_buf_len = sizeof(desc_buf);
+	uint32_t msg_len = len;
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_view view;
+	int ref_err;
+	int err;
+
+	ref_err = nfc_ndef_msg_parse(desc_buf, &desc_buf_len, data, &msg_len);
+
+	nfc_ndef_msg_iter_init(&iter, data, len);
+
+	while ((err = nfc_ndef_msg_iter_next(&iter, &view)) == 0) {
+		if (!ref_err) {
+			zassert_true(iter.record_count <= msg->record_count);
+			view_verify(&view, msg->record[iter.record_count - 1]);
+		}
+	}
+
+	if (err == -ENOENT) {
+		zassert_ok(ref_err, "Iterator accepted a message rejected with %d", ref_err);
+		zassert_equal(iter.record_count, msg->record_count);
+		zassert_equal(iter.offset, msg_len);
+	} else {
+		zassert_equal(err, ref_err, "Iterator error %d, parser error %d", err, ref_err);
+	}
+}
+
+ZTEST(nfc_ndef_msg_parser, test_iter_lone_record)
+{
+	static const uint8_t type[] = "U";
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_view view;
+	uint32_t len;
+
+	len = record_put(raw, NDEF_LONE_RECORD, TNF_WELL_KNOWN, true, type, 1, 2, 5);
+
+	nfc_ndef_msg_iter_init(&iter, raw, len + 10);
+
+	zassert_ok(nfc_ndef_msg_iter_next(&iter, &view));
+	zassert_equal(view.location, NDEF_LONE_RECORD);
+	zassert_true(nfc_ndef_record_view_type_match(&view, TNF_WELL_KNOWN, type, 1));
+	zassert_false(nfc_ndef_record_view_type_match(&view, TNF_MEDIA_TYPE, type, 1));
+	zassert_equal(view.id_length, 2);
+	zassert_equal(view.payload_length, 5);
+	zassert_equal(view.payload[0], 2);
+
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &view), -ENOENT);
+	zassert_equal(iter.offset, len);
+	zassert_equal(iter.record_count, 1);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_iter_errors)
+{
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_view view;
+	uint32_t len;
+
+	/* Message without the last record. */
+	len = record_put(raw, NDEF_FIRST_RECORD, TNF_UNKNOWN_TYPE, true, NULL, 0, 0, 1);
+	nfc_ndef_msg_iter_init(&iter, raw, len);
+	zassert_ok(nfc_ndef_msg_iter_next(&iter, &view));
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &view), -EFAULT);
+
+	/* Message starting with a middle record. */
+	len = record_put(raw, NDEF_MIDDLE_RECORD, TNF_UNKNOWN_TYPE, true, NULL, 0, 0, 1);
+	nfc_ndef_msg_iter_init(&iter, raw, len);
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &view), -EFAULT);
+
+	/* Payload length exceeding the data, including a wrap of the record size. */
+	len = record_put(raw, NDEF_LONE_RECORD, TNF_UNKNOWN_TYPE, false, NULL, 0, 0, 1);
+	sys_put_be32(UINT32_MAX, &raw[2]);
+	nfc_ndef_msg_iter_init(&iter, raw, len);
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &view), -EINVAL);
+
+	nfc_ndef_msg_iter_init(&iter, raw, 0);
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &view), -EFAULT);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_iter_desc_get)
+{
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_view view;
+	struct nfc_ndef_record_desc rec_desc;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
+	uint8_t payload[8];
+	uint32_t payload_len = sizeof(payload);
+	uint32_t len;
+
+	len = record_put(raw, NDEF_LONE_RECORD, TNF_MEDIA_TYPE, false, bench_type,
+			 sizeof(bench_type), 0, sizeof(payload));
+
+	nfc_ndef_msg_iter_init(&iter, raw, len);
+	zassert_ok(nfc_ndef_msg_iter_next(&iter, &view));
+
+	nfc_ndef_record_view_desc_get(&view, &bin_pay_desc, &rec_desc);
+	view_verify(&view, &rec_desc);
+
+	zassert_ok(rec_desc.payload_constructor(rec_desc.payload_descriptor, payload,
+						&payload_len));
+	zassert_equal(payload_len, sizeof(payload));
+	zassert_mem_equal(payload, view.payload, sizeof(payload));
+}
+
+ZTEST(nfc_ndef_msg_parser, test_fuzz_against_parser)
+{
+	static uint8_t data[RAW_BUF_SIZE];
+
+	lcg_state = 0x4e444546;
+
+	for (uint32_t i = 0; i < FUZZ_ITERATIONS; i++) {
+		uint32_t len = random_msg_put(data);
+		uint32_t cnt = 1 + lcg_next() % 3;
+
+		switch (lcg_next() % 4) {
+		case 0:
+			/* Valid message. */
+			break;
+		case 1:
+			/* Truncated message. */
+			len = lcg_next() % (len + 1);
+			break;
+		case 2:
+			/* Corrupted bytes. */
+			for (uint32_t j = 0; j < cnt; j++) {
+				data[lcg_next() % len] = lcg_next();
+			}
+			break;
+		default:
+			/* Random data. */
+			len = lcg_next() % sizeof(data);
+			for (uint32_t j = 0; j < len; j++) {
+				data[j] = lcg_next();
+			}
+			break;
+		}
+
+		parsers_compare(data, len);
+	}
+}
+
+static uint32_t bench_msg_put(uint32_t record_cnt)
+{
+	static const uint8_t other_type[] = "application/vnd.wfa.wsc";
+	uint32_t len = 0;
+
+	/* The record looked for is the last one. */
+	for (uint32_t i = 0; i < record_cnt; i++) {
+		bool last = (i == record_cnt - 1);
+
+		len += record_put(&raw[len], record_location(i, record_cnt), TNF_MEDIA_TYPE,
+				  false, last ? bench_type : other_type,
+				  last ? sizeof(bench_type) : sizeof(other_type), 1,
+				  BENCH_PAYLOAD_LEN);
+	}
+
+	return len;
+}
+
+static const uint8_t *bench_parser_find(uint32_t len)
+{
+	const struct nfc_ndef_msg_desc *msg = (const struct nfc_ndef_msg_desc *)desc_buf;
+	uint32_t desc_buf_len = sizeof(desc_buf);
+
+	zassert_ok(nfc_ndef_msg_parse(desc_buf, &desc_buf_len, raw, &len));
+
+	for (uint32_t i = 0; i < msg->record_count; i++) {
+		const struct nfc_ndef_record_desc *rec_desc = msg->record[i];
+
+		if ((rec_desc->tnf == TNF_MEDIA_TYPE) &&
+		    (rec_desc->type_length == sizeof(bench_type)) &&
+		    !memcmp(rec_desc->type, bench_type, sizeof(bench_type))) {
+			return ((const struct nfc_ndef_bin_payload_desc *)
+				rec_desc->payload_descriptor)->payload;
+		}
+	}
+
+	return NULL;
+}
+
+static const uint8_t *bench_iter_find(uint32_t len)
+{
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_view view;
+
+	nfc_ndef_msg_iter_init(&iter, raw, len);
+
+	while (nfc_ndef_msg_iter_next(&iter, &view) == 0) {
+		if (nfc_ndef_record_view_type_match(&view, TNF_MEDIA_TYPE, bench_type,
+						    sizeof(bench_type))) {
+			return view.payload;
+		}
+	}
+
+	return NULL;
+}
+
+ZTEST(nfc_ndef_msg_parser, test_benchmark)
+{
+	TC_PRINT("records | parser [ns] | parser RAM [B] | iterator [ns] | iterator RAM [B]\n");
+
+	for (uint32_t record_cnt = 1; record_cnt <= BENCH_RECORDS; record_cnt *= 2) {
+		uint32_t len = bench_msg_put(record_cnt);
+		const uint8_t *expected = bench_iter_find(len);
+		uint32_t parser_ns;
+		uint32_t iter_ns;
+		uint32_t start;
+
+		zassert_not_null(expected);
+		zassert_equal_ptr(bench_parser_find(len), expected);
+
+		start = k_cycle_get_32();
+		for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+			zassert_equal_ptr(bench_parser_find(len), expected);
+		}
+		parser_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+
+		start = k_cycle_get_32();
+		for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+			zassert_equal_ptr(bench_iter_find(len), expected);
+		}
+		iter_ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start) / BENCH_ITERATIONS;
+
+		TC_PRINT("%7u | %11u | %14u | %13u | %16u\n", record_cnt, parser_ns,
+			 (uint32_t)NFC_NDEF_PARSER_REQUIRED_MEM(record_cnt), iter_ns,
+			 (uint32_t)(sizeof(struct nfc_ndef_msg_iter) +
+				    sizeof(struct nfc_ndef_record_view)));
+	}
+}
+
+ZTEST_SUITE(nfc_ndef_msg_parser, NULL, NULL, NULL, NULL, NULL);